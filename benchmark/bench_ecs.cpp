@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "engine/component.h"
+#include "engine/sparse_component.h"
+#include "mathematics/vector.h"
+
+using namespace neko;
+
+const neko::Index entitiesNmb = 100'000;
+
+using DensePositionManager = ComponentManager<Vec3f, EntityMask(ComponentType::POSITION3D)>;
+using DenseVelocityManager = ComponentManager<Vec3f, EntityMask(ComponentType::OTHER_TYPE)>;
+using SparsePositionManager = SparseComponentManager<Vec3f, EntityMask(ComponentType::POSITION3D)>;
+using SparseVelocityManager = SparseComponentManager<Vec3f, EntityMask(ComponentType::OTHER_TYPE)>;
+
+/**
+ * \brief Give the two components to density percent of the entities, randomly spread
+ */
+template<typename TPositionManager, typename TVelocityManager>
+void FillEntities(EntityManager& entityManager,
+                  TPositionManager& positionManager,
+                  TVelocityManager& velocityManager,
+                  int density)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution(0, 99);
+    for (Index i = 0; i < entitiesNmb; i++)
+    {
+        const auto entity = entityManager.CreateEntity(i);
+        if (distribution(generator) < density)
+        {
+            positionManager.AddComponent(entity);
+            positionManager.SetComponent(entity, Vec3f::zero);
+            velocityManager.AddComponent(entity);
+            velocityManager.SetComponent(entity, Vec3f::one);
+        }
+    }
+}
+
+static void BM_DenseComponentIterate(benchmark::State& state)
+{
+    EntityManager entityManager;
+    DensePositionManager positionManager(entityManager);
+    DenseVelocityManager velocityManager(entityManager);
+    FillEntities(entityManager, positionManager, velocityManager, static_cast<int>(state.range(0)));
+    const auto mask = EntityMask(ComponentType::POSITION3D) | EntityMask(ComponentType::OTHER_TYPE);
+    for (auto _ : state)
+    {
+        for (Entity entity = 0; entity < entityManager.GetEntitiesSize(); entity++)
+        {
+            if (!entityManager.HasComponent(entity, mask))
+                continue;
+            positionManager.SetComponent(entity,
+                positionManager.GetComponent(entity) + velocityManager.GetComponent(entity));
+        }
+        benchmark::DoNotOptimize(positionManager.GetComponentsVector().data());
+    }
+    state.SetItemsProcessed(state.iterations() * entitiesNmb);
+}
+BENCHMARK(BM_DenseComponentIterate)->Arg(1)->Arg(5)->Arg(10);
+
+static void BM_SparseComponentView(benchmark::State& state)
+{
+    EntityManager entityManager;
+    SparsePositionManager positionManager(entityManager);
+    SparseVelocityManager velocityManager(entityManager);
+    FillEntities(entityManager, positionManager, velocityManager, static_cast<int>(state.range(0)));
+    View view(positionManager, velocityManager);
+    for (auto _ : state)
+    {
+        view.ForEach([](Entity, Vec3f& position, const Vec3f& velocity)
+        {
+            position += velocity;
+        });
+        benchmark::DoNotOptimize(positionManager.GetComponentsVector().data());
+    }
+    state.SetItemsProcessed(state.iterations() * entitiesNmb);
+}
+BENCHMARK(BM_SparseComponentView)->Arg(1)->Arg(5)->Arg(10);
@@ -0,0 +1,59 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "engine/entity.h"
+
+using namespace neko;
+
+const long operationsNmb = 1'000'000;
+const long fromRange = 1'000;
+const long toRange = 100'000;
+
+/**
+ * \brief Keep liveEntities alive and destroy then create a random one, like bullets being fired
+ */
+static void BM_EntityChurn(benchmark::State& state)
+{
+    const auto liveEntities = static_cast<std::size_t>(state.range(0));
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<std::size_t> distribution(0, liveEntities - 1);
+    std::vector<std::size_t> destroyedIndices(operationsNmb / 2);
+    for (auto& index : destroyedIndices)
+    {
+        index = distribution(generator);
+    }
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        EntityManager entityManager;
+        auto entities = entityManager.CreateEntities(liveEntities);
+        state.ResumeTiming();
+        for (const auto index : destroyedIndices)
+        {
+            entityManager.DestroyEntity(entities[index]);
+            entities[index] = entityManager.CreateEntity();
+        }
+        benchmark::DoNotOptimize(entities.data());
+    }
+    state.SetItemsProcessed(state.iterations() * operationsNmb);
+}
+BENCHMARK(BM_EntityChurn)->Range(fromRange, toRange)->Unit(benchmark::kMillisecond);
+
+static void BM_EntityBatchChurn(benchmark::State& state)
+{
+    const auto batchSize = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        EntityManager entityManager;
+        for (long i = 0; i < operationsNmb / 2; i += batchSize)
+        {
+            const auto entities = entityManager.CreateEntities(batchSize);
+            entityManager.DestroyEntities(entities);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * operationsNmb);
+}
+BENCHMARK(BM_EntityBatchChurn)->Range(fromRange, toRange)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,224 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "engine/jobsystem.h"
+
+const long fromRange = 8;
+const long toRange = 1024;
+const int workPerJob = 256;
+
+/**
+ * \brief Copy of the previous JobSystem scheduling, one mutex-protected queue shared by all workers,
+ * jobs are re-pushed when their dependencies have not started yet
+ */
+class LegacyJobSystem
+{
+public:
+    explicit LegacyJobSystem(unsigned workerNmb)
+    {
+        workers_.reserve(workerNmb);
+        for (unsigned i = 0; i < workerNmb; i++)
+        {
+            workers_.emplace_back([this] { Work(); });
+        }
+    }
+
+    ~LegacyJobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(jobs_.mutex_);
+            isRunning_ = false;
+            jobs_.cv_.notify_all();
+        }
+        for (auto& worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    void ScheduleJob(neko::Job* job)
+    {
+        std::lock_guard<std::mutex> lock(jobs_.mutex_);
+        jobs_.jobs_.push_back(job);
+        jobs_.cv_.notify_one();
+    }
+
+private:
+    void Work()
+    {
+        while (true)
+        {
+            neko::Job* job = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(jobs_.mutex_);
+                if (!isRunning_)
+                    return;
+                if (!jobs_.jobs_.empty())
+                {
+                    job = jobs_.jobs_.front();
+                    jobs_.jobs_.erase(jobs_.jobs_.cbegin());
+                    lock.unlock();
+                    if (!job->CheckDependenciesStarted())
+                    {
+                        lock.lock();
+                        if (jobs_.jobs_.empty())
+                        {
+                            jobs_.cv_.wait_for(lock, std::chrono::microseconds(100));
+                        }
+                        jobs_.jobs_.push_back(job);
+                        continue;
+                    }
+                }
+                else
+                {
+                    jobs_.cv_.wait(lock);
+                    continue;
+                }
+            }
+            job->Execute();
+        }
+    }
+
+    neko::JobQueue jobs_;
+    bool isRunning_ = true;
+    std::vector<std::thread> workers_;
+};
+
+static void DoWork(std::atomic<int>& result)
+{
+    int local = 0;
+    for (int i = 0; i < workPerJob; i++)
+    {
+        benchmark::DoNotOptimize(local += i);
+    }
+    result += local;
+}
+
+enum class GraphType
+{
+    FAN_OUT,
+    FAN_IN,
+    CHAIN
+};
+
+static void BuildGraph(GraphType graphType, std::vector<std::unique_ptr<neko::Job>>& jobs)
+{
+    const auto n = jobs.size();
+    for (auto& job : jobs)
+    {
+        job->Reset();
+    }
+    switch (graphType)
+    {
+        case GraphType::FAN_OUT:
+            for (std::size_t i = 1; i < n; i++)
+            {
+                jobs[i]->AddDependency(jobs[0].get());
+            }
+            break;
+        case GraphType::FAN_IN:
+            for (std::size_t i = 0; i < n - 1; i++)
+            {
+                jobs[n - 1]->AddDependency(jobs[i].get());
+            }
+            break;
+        case GraphType::CHAIN:
+            for (std::size_t i = 1; i < n; i++)
+            {
+                jobs[i]->AddDependency(jobs[i - 1].get());
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static std::vector<std::unique_ptr<neko::Job>> CreateJobs(std::size_t n, std::atomic<int>& result)
+{
+    std::vector<std::unique_ptr<neko::Job>> jobs(n);
+    for (auto& job : jobs)
+    {
+        job = std::make_unique<neko::Job>([&result] { DoWork(result); });
+    }
+    return jobs;
+}
+
+template<GraphType graphType>
+static void BM_LegacyJobSystem(benchmark::State& state)
+{
+    std::atomic<int> result = 0;
+    auto jobs = CreateJobs(state.range(0), result);
+    neko::JobSystem jobSystem;
+    jobSystem.Init();
+    const auto workerNmb = jobSystem.GetWorkersNumber() - static_cast<unsigned>(neko::JobThreadType::OTHER_THREAD);
+    jobSystem.Destroy();
+    LegacyJobSystem legacyJobSystem(workerNmb);
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        BuildGraph(graphType, jobs);
+        state.ResumeTiming();
+        for (auto& job : jobs)
+        {
+            legacyJobSystem.ScheduleJob(job.get());
+        }
+        for (auto& job : jobs)
+        {
+            job->Join();
+        }
+    }
+    benchmark::DoNotOptimize(result.load());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<GraphType graphType>
+static void BM_WorkStealingJobSystem(benchmark::State& state)
+{
+    std::atomic<int> result = 0;
+    auto jobs = CreateJobs(state.range(0), result);
+    neko::JobSystem jobSystem;
+    jobSystem.Init();
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        BuildGraph(graphType, jobs);
+        state.ResumeTiming();
+        for (auto& job : jobs)
+        {
+            jobSystem.ScheduleJob(job.get(), neko::JobThreadType::OTHER_THREAD);
+        }
+        for (auto& job : jobs)
+        {
+            job->Join();
+        }
+    }
+    jobSystem.Destroy();
+    benchmark::DoNotOptimize(result.load());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_LegacyJobSystem, GraphType::FAN_OUT)->Range(fromRange, toRange)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_WorkStealingJobSystem, GraphType::FAN_OUT)->Range(fromRange, toRange)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_LegacyJobSystem, GraphType::FAN_IN)->Range(fromRange, toRange)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_WorkStealingJobSystem, GraphType::FAN_IN)->Range(fromRange, toRange)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_LegacyJobSystem, GraphType::CHAIN)->Range(fromRange, toRange)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_WorkStealingJobSystem, GraphType::CHAIN)->Range(fromRange, toRange)->UseRealTime();
+
+template<GraphType graphType>
+static void BM_BuildGraph(benchmark::State& state)
+{
+    std::atomic<int> result = 0;
+    auto jobs = CreateJobs(state.range(0), result);
+    for (auto _ : state)
+    {
+        BuildGraph(graphType, jobs);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_BuildGraph, GraphType::FAN_IN)->Range(fromRange, toRange);
+BENCHMARK_TEMPLATE(BM_BuildGraph, GraphType::CHAIN)->Range(fromRange, toRange);
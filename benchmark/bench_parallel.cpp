@@ -0,0 +1,142 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "engine/jobsystem.h"
+#include "engine/task_graph.h"
+#include "mathematics/transform.h"
+
+using namespace neko;
+
+const long fromRange = 10'000;
+const long toRange = 1'000'000;
+const std::size_t grainSize = 4'096;
+
+struct Entities
+{
+    explicit Entities(std::size_t n) : positions(n), scales(n, Vec3f::one), rotations(n), transforms(n)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            positions[i] = Vec3f(float(rand() % 100), float(rand() % 100), float(rand() % 100));
+            rotations[i] = EulerAngles(degree_t(float(rand() % 360)), degree_t(0.0f), degree_t(0.0f));
+        }
+    }
+    void UpdateTransforms(std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; i++)
+        {
+            Mat4f transform = Mat4f::Identity;
+            transform = Transform3d::Rotate(transform, rotations[i]);
+            transform = Transform3d::Scale(transform, scales[i]);
+            transforms[i] = Transform3d::Translate(transform, positions[i]);
+        }
+    }
+    [[nodiscard]] float SumPositions(std::size_t begin, std::size_t end) const
+    {
+        float sum = 0.0f;
+        for (std::size_t i = begin; i < end; i++)
+        {
+            sum += positions[i].x + positions[i].y + positions[i].z;
+        }
+        return sum;
+    }
+    std::vector<Vec3f> positions;
+    std::vector<Vec3f> scales;
+    std::vector<EulerAngles> rotations;
+    std::vector<Mat4f> transforms;
+};
+
+static void BM_SerialTransforms(benchmark::State& state)
+{
+    Entities entities(state.range(0));
+    for (auto _ : state)
+    {
+        entities.UpdateTransforms(0, state.range(0));
+        benchmark::DoNotOptimize(entities.transforms.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SerialTransforms)->Range(fromRange, toRange)->UseRealTime();
+
+static void BM_ParallelForTransforms(benchmark::State& state)
+{
+    Entities entities(state.range(0));
+    JobSystem jobSystem;
+    jobSystem.Init();
+    for (auto _ : state)
+    {
+        jobSystem.ParallelFor(0, state.range(0), grainSize, [&entities](std::size_t begin, std::size_t end)
+        {
+            entities.UpdateTransforms(begin, end);
+        });
+        benchmark::DoNotOptimize(entities.transforms.data());
+    }
+    jobSystem.Destroy();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParallelForTransforms)->Range(fromRange, toRange)->UseRealTime();
+
+static void BM_SerialReduce(benchmark::State& state)
+{
+    Entities entities(state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(entities.SumPositions(0, state.range(0)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SerialReduce)->Range(fromRange, toRange)->UseRealTime();
+
+static void BM_ParallelReduce(benchmark::State& state)
+{
+    Entities entities(state.range(0));
+    JobSystem jobSystem;
+    jobSystem.Init();
+    for (auto _ : state)
+    {
+        const auto sum = jobSystem.ParallelReduce(0, state.range(0), grainSize, 0.0f,
+              [&entities](std::size_t begin, std::size_t end)
+              {
+                  return entities.SumPositions(begin, end);
+              },
+              [](float a, float b) { return a + b; });
+        benchmark::DoNotOptimize(sum);
+    }
+    jobSystem.Destroy();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParallelReduce)->Range(fromRange, toRange)->UseRealTime();
+
+static void BM_TaskGraphTransforms(benchmark::State& state)
+{
+    Entities entities(state.range(0));
+    const std::size_t n = state.range(0);
+    const std::size_t quarter = n / 4;
+    TaskGraph taskGraph;
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        const auto begin = i * quarter;
+        const auto end = i == 3 ? n : begin + quarter;
+        taskGraph.AddNode("transforms" + std::to_string(i), [&entities, begin, end] { entities.UpdateTransforms(begin, end); });
+    }
+    float sum = 0.0f;
+    const auto sumNode = taskGraph.AddNode("sum", [&entities, &sum, n] { sum = entities.SumPositions(0, n); });
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        taskGraph.AddEdge(i, sumNode);
+    }
+    taskGraph.Build();
+    JobSystem jobSystem;
+    jobSystem.Init();
+    for (auto _ : state)
+    {
+        taskGraph.Schedule(jobSystem);
+        taskGraph.Join(jobSystem);
+        benchmark::DoNotOptimize(sum);
+    }
+    jobSystem.Destroy();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TaskGraphTransforms)->Range(fromRange, toRange)->UseRealTime();
@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "engine/transform.h"
+
+using namespace neko;
+
+const Index nodesNmb = 100'000;
+//Percentage of the nodes moved each frame
+const int movedPercentage = 5;
+
+/**
+ * \brief Random tree where each node has a parent among the previous nodes, so depth grows like log(n)
+ */
+static void BM_SceneGraphUpdate(benchmark::State& state)
+{
+    EntityManager entityManager;
+    Transform3dManager transformManager(entityManager);
+    const auto entities = entityManager.CreateEntities(nodesNmb);
+    std::mt19937 generator(42);
+    for (Index i = 0; i < nodesNmb; i++)
+    {
+        transformManager.AddComponent(entities[i]);
+        if (i > 0)
+        {
+            std::uniform_int_distribution<Index> parentDistribution(0, i - 1);
+            entityManager.SetEntityParent(entities[i], entities[parentDistribution(generator)]);
+        }
+    }
+    transformManager.Update();
+
+    const auto movedNmb = nodesNmb * movedPercentage / 100;
+    std::uniform_int_distribution<Index> distribution(0, nodesNmb - 1);
+    std::vector<Entity> movedEntities(movedNmb);
+    float offset = 0.0f;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (auto& entity : movedEntities)
+        {
+            entity = entities[distribution(generator)];
+        }
+        offset += 1.0f;
+        state.ResumeTiming();
+        for (const auto entity : movedEntities)
+        {
+            transformManager.SetPosition(entity, Vec3f(offset, 0.0f, 0.0f));
+        }
+        transformManager.Update();
+        benchmark::DoNotOptimize(transformManager.GetComponentsVector().data());
+    }
+    state.SetItemsProcessed(state.iterations() * movedNmb);
+}
+BENCHMARK(BM_SceneGraphUpdate)->Unit(benchmark::kMillisecond);
+
+/**
+ * \brief Wide and shallow graph, a few roots with all the other nodes as direct children
+ */
+static void BM_SceneGraphUpdateShallow(benchmark::State& state)
+{
+    EntityManager entityManager;
+    Transform3dManager transformManager(entityManager);
+    const auto entities = entityManager.CreateEntities(nodesNmb);
+    const Index rootsNmb = 1'000;
+    for (Index i = 0; i < nodesNmb; i++)
+    {
+        transformManager.AddComponent(entities[i]);
+        if (i >= rootsNmb)
+        {
+            entityManager.SetEntityParent(entities[i], entities[i % rootsNmb]);
+        }
+    }
+    transformManager.Update();
+
+    const auto movedNmb = nodesNmb * movedPercentage / 100;
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<Index> distribution(rootsNmb, nodesNmb - 1);
+    float offset = 0.0f;
+    for (auto _ : state)
+    {
+        offset += 1.0f;
+        for (Index i = 0; i < movedNmb; i++)
+        {
+            transformManager.SetPosition(entities[distribution(generator)], Vec3f(offset, 0.0f, 0.0f));
+        }
+        transformManager.Update();
+        benchmark::DoNotOptimize(transformManager.GetComponentsVector().data());
+    }
+    state.SetItemsProcessed(state.iterations() * movedNmb);
+}
+BENCHMARK(BM_SceneGraphUpdateShallow)->Unit(benchmark::kMillisecond);
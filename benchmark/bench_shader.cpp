@@ -0,0 +1,149 @@
+#include <benchmark/benchmark.h>
+
+#ifdef NEKO_GLES3
+#include <array>
+#include <cstring>
+#include <string_view>
+
+#include "engine/engine.h"
+#include "gl/shader.h"
+
+using namespace neko;
+
+namespace
+{
+/**
+ * \brief Uniforms of the mocked program, the driver lookup is a string comparison with each of them
+ */
+const std::array<const char*, 8> mockUniforms =
+{
+    "model", "view", "projection", "normalMatrix", "spriteTexture", "spriteColor", "lights[0]", "viewPos"
+};
+
+GLint MockGetUniformLocation([[maybe_unused]] GLuint program, const GLchar* name)
+{
+    for (GLint i = 0; i < GLint(mockUniforms.size()); i++)
+    {
+        if (std::strcmp(mockUniforms[i], name) == 0)
+        {
+            return i;
+        }
+    }
+    return gl::INVALID_UNIFORM_LOCATION;
+}
+
+void MockGetProgramiv([[maybe_unused]] GLuint program, GLenum pname, GLint* params)
+{
+    if (pname == GL_ACTIVE_UNIFORMS)
+    {
+        *params = GLint(mockUniforms.size());
+    }
+}
+
+void MockGetActiveUniform([[maybe_unused]] GLuint program, GLuint index, GLsizei bufSize, GLsizei* length,
+                          GLint* size, GLenum* type, GLchar* name)
+{
+    const auto uniformLength = std::strlen(mockUniforms[index]);
+    std::strncpy(name, mockUniforms[index], bufSize);
+    *length = GLsizei(uniformLength);
+    *size = 1;
+    *type = GL_FLOAT_MAT4;
+}
+
+void MockUniformMatrix4fv(GLint location, [[maybe_unused]] GLsizei count,
+                          [[maybe_unused]] GLboolean transpose, const GLfloat* value)
+{
+    benchmark::DoNotOptimize(location);
+    benchmark::DoNotOptimize(value);
+}
+
+GLenum MockGetError()
+{
+    return GL_NO_ERROR;
+}
+
+void MockDeleteProgram([[maybe_unused]] GLuint program)
+{
+}
+
+class HeadlessEngine : public BasicEngine
+{
+public:
+    explicit HeadlessEngine(const FilesystemInterface& filesystem) : BasicEngine(filesystem) {}
+    void ManageEvent() override {}
+};
+
+/**
+ * \brief Replace the OpenGL functions used by the shader uniforms with the mocked ones
+ */
+void MockGlFunctions()
+{
+    glad_glGetUniformLocation = &MockGetUniformLocation;
+    glad_glGetProgramiv = &MockGetProgramiv;
+    glad_glGetActiveUniform = &MockGetActiveUniform;
+    glad_glUniformMatrix4fv = &MockUniformMatrix4fv;
+    glad_glGetError = &MockGetError;
+    glad_glDeleteProgram = &MockDeleteProgram;
+}
+
+const std::array<std::string_view, 3> usedUniforms = { "model", "view", "projection" };
+}
+
+static void BM_UniformDriverLookup(benchmark::State& state)
+{
+    MockGlFunctions();
+    const Mat4f mat = Mat4f::Identity;
+    for (auto _ : state)
+    {
+        for (const auto uniform : usedUniforms)
+        {
+            glUniformMatrix4fv(glGetUniformLocation(1, uniform.data()), 1, GL_FALSE, &mat[0][0]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * usedUniforms.size());
+}
+BENCHMARK(BM_UniformDriverLookup);
+
+static void BM_UniformCachedLookup(benchmark::State& state)
+{
+    MockGlFunctions();
+    Filesystem filesystem;
+    HeadlessEngine engine(filesystem);
+    gl::Shader shader;
+    shader.LoadFromProgram(1);
+    const Mat4f mat = Mat4f::Identity;
+    for (auto _ : state)
+    {
+        for (const auto uniform : usedUniforms)
+        {
+            shader.SetMat4(uniform, mat);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * usedUniforms.size());
+}
+BENCHMARK(BM_UniformCachedLookup);
+
+static void BM_UniformHandle(benchmark::State& state)
+{
+    MockGlFunctions();
+    Filesystem filesystem;
+    HeadlessEngine engine(filesystem);
+    gl::Shader shader;
+    shader.LoadFromProgram(1);
+    std::array<gl::UniformHandle<Mat4f>, usedUniforms.size()> handles;
+    for (std::size_t i = 0; i < usedUniforms.size(); i++)
+    {
+        handles[i] = shader.GetUniformHandle<Mat4f>(usedUniforms[i]);
+    }
+    const Mat4f mat = Mat4f::Identity;
+    for (auto _ : state)
+    {
+        for (const auto handle : handles)
+        {
+            shader.SetUniform(handle, mat);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * usedUniforms.size());
+}
+BENCHMARK(BM_UniformHandle);
+#endif
@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "graphics/sprite.h"
+#include "mathematics/transform.h"
+
+using namespace neko;
+
+const long fromRange = 1'000;
+const long toRange = 100'000;
+
+struct Sprites
+{
+    Sprites(std::size_t n, std::uint32_t texturesNmb) : textures(n), models(n), colors(n)
+    {
+        std::mt19937 generator(0);
+        std::uniform_int_distribution<std::uint32_t> textureDistribution(1, texturesNmb);
+        std::uniform_real_distribution<float> positionDistribution(-100.0f, 100.0f);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            textures[i] = textureDistribution(generator);
+            models[i] = Transform3d::Translate(Mat4f::Identity,
+                Vec3f(positionDistribution(generator), positionDistribution(generator), 0.0f));
+            colors[i] = Color4(Color::white, 1.0f);
+        }
+    }
+    std::vector<std::uint32_t> textures;
+    std::vector<Mat4f> models;
+    std::vector<Color4> colors;
+};
+
+//What the renderer did before batching, one command with its uniforms per sprite
+struct SpriteCommand
+{
+    std::uint32_t texture;
+    Mat4f model;
+    Color4 color;
+};
+
+static void BM_SpriteCommandsPerSprite(benchmark::State& state)
+{
+    const std::size_t n = state.range(0);
+    Sprites sprites(n, 16);
+    std::vector<SpriteCommand> commands;
+    commands.reserve(n);
+    for (auto _ : state)
+    {
+        commands.clear();
+        for (std::size_t i = 0; i < n; i++)
+        {
+            commands.push_back({sprites.textures[i], sprites.models[i], sprites.colors[i]});
+        }
+        benchmark::DoNotOptimize(commands.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_SpriteCommandsPerSprite)->Range(fromRange, toRange);
+
+static void BM_SpriteBatcher(benchmark::State& state)
+{
+    const std::size_t n = state.range(0);
+    Sprites sprites(n, std::uint32_t(state.range(1)));
+    SpriteBatcher spriteBatcher;
+    spriteBatcher.Reserve(n);
+    for (auto _ : state)
+    {
+        spriteBatcher.Clear();
+        for (std::size_t i = 0; i < n; i++)
+        {
+            spriteBatcher.AddSprite(sprites.textures[i], sprites.models[i], sprites.colors[i]);
+        }
+        spriteBatcher.Build();
+        benchmark::DoNotOptimize(spriteBatcher.GetInstances().data());
+        benchmark::DoNotOptimize(spriteBatcher.GetBatches().data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.counters["batches"] = double(spriteBatcher.GetBatches().size());
+}
+BENCHMARK(BM_SpriteBatcher)->Ranges({{fromRange, toRange}, {1, 64}});
@@ -155,4 +155,58 @@ static void BM_RotateUsingQuaternion(benchmark::State& s)
 
 BENCHMARK(BM_RotateUsingQuaternion)->Range(from, to);
 
-BENCHMARK_MAIN();
\ No newline at end of file
+const long fromEntities = 1'000;
+const long toEntities = 1'000'000;
+
+struct TransformEntities
+{
+    explicit TransformEntities(std::size_t n) : positions(n), angles(n), scales(n), transforms(n)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            positions[i] = Vec3f(float(rand() % 100), float(rand() % 100), float(rand() % 100));
+            angles[i] = EulerAngles(degree_t(float(rand() % 360)), degree_t(float(rand() % 360)), degree_t(float(rand() % 360)));
+            scales[i] = Vec3f(float(rand() % 10 + 1), float(rand() % 10 + 1), float(rand() % 10 + 1));
+        }
+    }
+    std::vector<Vec3f> positions;
+    std::vector<EulerAngles> angles;
+    std::vector<Vec3f> scales;
+    std::vector<Mat4f> transforms;
+};
+
+static void BM_ComputeTransformsScalar(benchmark::State& s)
+{
+    const auto n = static_cast<std::size_t>(s.range(0));
+    TransformEntities entities(n);
+    for (auto _ : s)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            Mat4f transform = Transform3d::Rotate(Mat4f::Identity, entities.angles[i]);
+            transform = Transform3d::Scale(transform, entities.scales[i]);
+            entities.transforms[i] = Transform3d::Translate(transform, entities.positions[i]);
+        }
+        benchmark::DoNotOptimize(entities.transforms.data());
+    }
+    s.SetItemsProcessed(s.iterations() * n);
+}
+
+BENCHMARK(BM_ComputeTransformsScalar)->Range(fromEntities, toEntities);
+
+static void BM_ComputeTransformsBatch(benchmark::State& s)
+{
+    const auto n = static_cast<std::size_t>(s.range(0));
+    TransformEntities entities(n);
+    for (auto _ : s)
+    {
+        Transform3d::ComputeTransforms(entities.positions.data(), entities.angles.data(), entities.scales.data(),
+                                       entities.transforms.data(), n);
+        benchmark::DoNotOptimize(entities.transforms.data());
+    }
+    s.SetItemsProcessed(s.iterations() * n);
+}
+
+BENCHMARK(BM_ComputeTransformsBatch)->Range(fromEntities, toEntities);
+
+BENCHMARK_MAIN();
@@ -23,6 +23,7 @@
  SOFTWARE.
  */
 #include <string>
+#include <unordered_map>
 #include <graphics/shader.h>
 #include "gl/texture.h"
 #include "gl/gles3_include.h"
@@ -52,6 +53,19 @@ GLuint CreateShaderProgram(
 
 void DeleteShader(GLuint shader);
 
+const GLint INVALID_UNIFORM_LOCATION = -1;
+
+/**
+ * \brief Uniform location typed with the value it receives.
+ * Get it once with Shader::GetUniformHandle and keep it instead of the uniform name.
+ */
+template<typename T>
+struct UniformHandle
+{
+    GLint location = INVALID_UNIFORM_LOCATION;
+    [[nodiscard]] bool IsValid() const { return location != INVALID_UNIFORM_LOCATION; }
+};
+
 class Shader : public neko::Shader
 {
 public:
@@ -59,6 +73,10 @@ public:
     ~Shader() override;
 
     void LoadFromFile(std::string_view vertexShaderPath, std::string_view fragmentShaderPath) override;
+    /**
+     * \brief Take the ownership of an already linked program
+     */
+    void LoadFromProgram(GLuint program);
 
 
     void Bind() const;
@@ -92,8 +110,47 @@ public:
 
 	void SetTexture(const std::string_view name, TextureName texture, unsigned int slot = 0) const;
 	void SetCubemap(const std::string_view name, TextureName texture, unsigned int slot = 0) const;
+    /**
+     * \brief Get the uniform location from the table filled at link time,
+     * uniforms not listed by the driver (e.g. array elements) are asked once to OpenGL
+     */
+    [[nodiscard]] GLint GetUniformLocation(std::string_view name) const;
+
+    template<typename T>
+    [[nodiscard]] UniformHandle<T> GetUniformHandle(std::string_view name) const
+    {
+        return UniformHandle<T>{GetUniformLocation(name)};
+    }
+
+    void SetUniform(UniformHandle<bool> uniform, bool value) const;
+
+    void SetUniform(UniformHandle<int> uniform, int value) const;
+
+    void SetUniform(UniformHandle<float> uniform, float value) const;
+
+    void SetUniform(UniformHandle<Vec2f> uniform, const Vec2f& value) const;
+
+    void SetUniform(UniformHandle<Vec3f> uniform, const Vec3f& value) const;
+
+    void SetUniform(UniformHandle<Vec4f> uniform, const Vec4f& value) const;
+
+    void SetUniform(UniformHandle<Mat4f> uniform, const Mat4f& value) const;
+
+    void SetTexture(UniformHandle<TextureName> uniform, TextureName texture, unsigned int slot = 0) const;
+
+    void SetCubemap(UniformHandle<TextureName> uniform, TextureName texture, unsigned int slot = 0) const;
 private:
+    /**
+     * \brief Fill the uniform table with the active uniforms of the program
+     */
+    void ReflectUniforms();
+    static std::uint64_t HashUniformName(std::string_view name);
+
     const FilesystemInterface& filesystem_;
     GLuint shaderProgram_ = 0;
+    /**
+     * \brief Uniform locations by name hash, filled when linking and completed by GetUniformLocation
+     */
+    mutable std::unordered_map<std::uint64_t, GLint> uniformLocations_;
 };
 }
\ No newline at end of file
@@ -27,6 +27,7 @@
 #include "gl/shape.h"
 #include "engine/transform.h"
 #include "graphics/color.h"
+#include "graphics/sprite.h"
 
 
 namespace neko::gl
@@ -75,7 +76,19 @@ public:
     void Render() override;
 	
 private:
+    /**
+     * \brief Point the instance attributes at the first instance of the batch,
+     * GLES3 has no base instance parameter in its draw calls
+     */
+    void BindInstanceAttributes(std::uint32_t firstInstance) const;
+
     gl::Shader spriteShader_;
+    UniformHandle<Mat4f> viewUniform_;
+    UniformHandle<Mat4f> projectionUniform_;
+    UniformHandle<TextureName> textureUniform_;
     gl::RenderQuad spriteQuad_{Vec3f::zero, Vec2f::one};
+    SpriteBatcher spriteBatcher_;
+    GLuint instanceVbo_ = 0;
+    std::size_t instanceCapacity_ = 0;
 };
 }
@@ -0,0 +1,75 @@
+#pragma once
+
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <array>
+#include <cstddef>
+
+#include "gl/gles3_include.h"
+
+namespace neko::gl
+{
+
+/**
+ * \brief Staging buffer split in a ring of segments, one per frame in flight.
+ * Data is written in the segment of the current frame with an unsynchronized mapping
+ * and copied on the GPU to its destination buffer, the segment is fenced at the end of the frame
+ * and only reused once the GPU is done with it.
+ */
+class UploadRingBuffer
+{
+public:
+    static constexpr std::size_t segmentsNmb = 3;
+
+    void Init(std::size_t segmentSize);
+    void Destroy();
+    /**
+     * \brief Wait for the GPU to release the segment of the new frame, must be called before any Upload
+     */
+    void BeginFrame();
+    /**
+     * \brief Copy the data to the destination buffer, returns false when the segment of the frame is full.
+     * Data bigger than a segment is uploaded directly.
+     */
+    bool Upload(GLuint dstBuffer, GLintptr dstOffset, const void* data, std::size_t size);
+    /**
+     * \brief Whether an Upload of this size succeeds in the current frame
+     */
+    [[nodiscard]] bool CanUpload(std::size_t size) const;
+    /**
+     * \brief Fence the copies of the frame and move to the next segment
+     */
+    void EndFrame();
+    [[nodiscard]] std::size_t GetFrameUploadedBytes() const { return frameUploadedBytes_; }
+    [[nodiscard]] std::size_t GetSegmentSize() const { return segmentSize_; }
+private:
+    GLuint buffer_ = 0;
+    std::size_t segmentSize_ = 0;
+    std::size_t currentSegment_ = 0;
+    std::size_t segmentOffset_ = 0;
+    std::size_t frameUploadedBytes_ = 0;
+    std::array<GLsync, segmentsNmb> fences_{};
+};
+}
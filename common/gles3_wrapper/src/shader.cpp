@@ -25,7 +25,9 @@
 #include <utils/file_utility.h>
 #include <sstream>
 #include <engine/log.h>
+#include <engine/engine.h>
 #include <fmt/format.h>
+#include <xxhash.hpp>
 namespace neko::gl
 {
 
@@ -57,10 +59,72 @@ void Shader::LoadFromFile(const std::string_view vertexShaderPath, const std::st
         logDebug(fmt::format("[Error] Loading shader program with vertex: {} and fragment {}",
                              vertexShaderPath, fragmentShaderPath));
     }
+    else
+    {
+        ReflectUniforms();
+    }
     DeleteShader(vertexShader);
     DeleteShader(fragmentShader);
 }
 
+void Shader::LoadFromProgram(GLuint program)
+{
+    Destroy();
+    shaderProgram_ = program;
+    ReflectUniforms();
+}
+
+void Shader::ReflectUniforms()
+{
+    uniformLocations_.clear();
+    GLint uniformsNmb = 0;
+    glGetProgramiv(shaderProgram_, GL_ACTIVE_UNIFORMS, &uniformsNmb);
+    uniformLocations_.reserve(uniformsNmb);
+    for (GLint i = 0; i < uniformsNmb; i++)
+    {
+        char name[256];
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(shaderProgram_, static_cast<GLuint>(i), sizeof(name), &length, &size, &type, name);
+        const GLint location = glGetUniformLocation(shaderProgram_, name);
+        if (location == INVALID_UNIFORM_LOCATION)
+        {
+            //Uniforms in uniform blocks do not have a location
+            continue;
+        }
+        const std::string_view uniformName(name, length);
+        uniformLocations_[HashUniformName(uniformName)] = location;
+        //Arrays are listed as "name[0]", the name alone is also valid
+        const auto arrayIndex = uniformName.rfind("[0]");
+        if (arrayIndex != std::string_view::npos && arrayIndex + 3 == uniformName.size())
+        {
+            uniformLocations_[HashUniformName(uniformName.substr(0, arrayIndex))] = location;
+        }
+    }
+    glCheckError();
+}
+
+std::uint64_t Shader::HashUniformName(std::string_view name)
+{
+    return xxh::xxhash<64>(name.data(), name.size());
+}
+
+GLint Shader::GetUniformLocation(std::string_view name) const
+{
+    const auto hash = HashUniformName(name);
+    const auto it = uniformLocations_.find(hash);
+    if (it != uniformLocations_.end())
+    {
+        return it->second;
+    }
+    //The name might not be null-terminated
+    const std::string uniformName(name);
+    const GLint location = glGetUniformLocation(shaderProgram_, uniformName.c_str());
+    uniformLocations_[hash] = location;
+    return location;
+}
+
 void Shader::Bind() const
 {
     glUseProgram(shaderProgram_);
@@ -75,64 +139,64 @@ GLuint Shader::GetProgram() const
 
 void Shader::SetBool(const std::string_view attributeName, bool value) const
 {
-    glUniform1i(glGetUniformLocation(shaderProgram_, attributeName.data()), (int) value);
+    glUniform1i(GetUniformLocation(attributeName), (int) value);
     glCheckError();
 }
 
 void Shader::SetInt(const std::string_view attributeName, int value) const
 {
-    glUniform1i(glGetUniformLocation(shaderProgram_, attributeName.data()), value);
+    glUniform1i(GetUniformLocation(attributeName), value);
     glCheckError();
 }
 
 void Shader::SetFloat(const std::string_view attributeName, float value) const
 {
-    glUniform1f(glGetUniformLocation(shaderProgram_, attributeName.data()), value);
+    glUniform1f(GetUniformLocation(attributeName), value);
     glCheckError();
 }
 
 // ------------------------------------------------------------------------
 void Shader::SetVec2(const std::string_view name, const Vec2f& value) const
 {
-    glUniform2fv(glGetUniformLocation(shaderProgram_, name.data()), 1, &value[0]);
+    glUniform2fv(GetUniformLocation(name), 1, &value[0]);
     glCheckError();
 }
 
 void Shader::SetVec2(const std::string_view name, float x, float y) const
 {
-    glUniform2f(glGetUniformLocation(shaderProgram_, name.data()), x, y);
+    glUniform2f(GetUniformLocation(name), x, y);
     glCheckError();
 }
 
 // ------------------------------------------------------------------------
 void Shader::SetVec3(const std::string_view name, const Vec3f& value) const
 {
-    glUniform3fv(glGetUniformLocation(shaderProgram_, name.data()), 1, &value[0]);
+    glUniform3fv(GetUniformLocation(name), 1, &value[0]);
     glCheckError();
 }
 
 void Shader::SetVec3(const std::string_view name, const float* value) const
 {
-    glUniform3fv(glGetUniformLocation(shaderProgram_, name.data()), 1, value);
+    glUniform3fv(GetUniformLocation(name), 1, value);
     glCheckError();
 }
 
 void Shader::SetVec3(const std::string_view name, float x, float y, float z) const
 {
-    glUniform3f(glGetUniformLocation(shaderProgram_, name.data()), x, y, z);
+    glUniform3f(GetUniformLocation(name), x, y, z);
     glCheckError();
 }
 
 // ------------------------------------------------------------------------
 void Shader::SetVec4(const std::string_view name, const Vec4f& value) const
 {
-    glUniform4fv(glGetUniformLocation(shaderProgram_, name.data()), 1, &value[0]);
+    glUniform4fv(GetUniformLocation(name), 1, &value[0]);
     glCheckError();
 }
 
 void Shader::SetVec4(const std::string_view name, float x, float y, float z, float w)
 {
-    glUniform4f(glGetUniformLocation(shaderProgram_, name.data()), x, y, z, w);
+    glUniform4f(GetUniformLocation(name), x, y, z, w);
     glCheckError();
 }
 
@@ -143,32 +207,33 @@ void Shader::Destroy()
         glDeleteProgram(shaderProgram_);
         shaderProgram_ = 0;
     }
+    uniformLocations_.clear();
 }
 
 /*
 // ------------------------------------------------------------------------
 void Shader::SetMat2(const std::string& name, const glm::mat2& mat) const
 {
-    glUniformMatrix2fv(glGetUniformLocation(shaderProgram_, name.data()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix2fv(GetUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
 
 // ------------------------------------------------------------------------
 void Shader::SetMat3(const std::string& name, const glm::mat3& mat) const
 {
-    glUniformMatrix3fv(glGetUniformLocation(shaderProgram_, name.data()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix3fv(GetUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
 */
 // ------------------------------------------------------------------------
 void Shader::SetMat4(const std::string_view name, const Mat4f& mat) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram_, name.data()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
     glCheckError();
 }
 
 
 void Shader::SetTexture(const std::string_view name, TextureName texture, unsigned slot) const
 {
-    glUniform1i(glGetUniformLocation(shaderProgram_, name.data()), slot);
+    glUniform1i(GetUniformLocation(name), slot);
     glActiveTexture(GL_TEXTURE0 + slot);
     glBindTexture(GL_TEXTURE_2D, texture);
 }
@@ -176,7 +241,63 @@ void Shader::SetTexture(const std::string_view name, TextureName texture, unsign
 
 void Shader::SetCubemap(const std::string_view name, TextureName texture, unsigned slot) const
 {
-    glUniform1i(glGetUniformLocation(shaderProgram_, name.data()), slot);
+    glUniform1i(GetUniformLocation(name), slot);
+    glActiveTexture(GL_TEXTURE0 + slot);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+}
+
+void Shader::SetUniform(UniformHandle<bool> uniform, bool value) const
+{
+    glUniform1i(uniform.location, static_cast<int>(value));
+    glCheckError();
+}
+
+void Shader::SetUniform(UniformHandle<int> uniform, int value) const
+{
+    glUniform1i(uniform.location, value);
+    glCheckError();
+}
+
+void Shader::SetUniform(UniformHandle<float> uniform, float value) const
+{
+    glUniform1f(uniform.location, value);
+    glCheckError();
+}
+
+void Shader::SetUniform(UniformHandle<Vec2f> uniform, const Vec2f& value) const
+{
+    glUniform2fv(uniform.location, 1, &value[0]);
+    glCheckError();
+}
+
+void Shader::SetUniform(UniformHandle<Vec3f> uniform, const Vec3f& value) const
+{
+    glUniform3fv(uniform.location, 1, &value[0]);
+    glCheckError();
+}
+
+void Shader::SetUniform(UniformHandle<Vec4f> uniform, const Vec4f& value) const
+{
+    glUniform4fv(uniform.location, 1, &value[0]);
+    glCheckError();
+}
+
+void Shader::SetUniform(UniformHandle<Mat4f> uniform, const Mat4f& value) const
+{
+    glUniformMatrix4fv(uniform.location, 1, GL_FALSE, &value[0][0]);
+    glCheckError();
+}
+
+void Shader::SetTexture(UniformHandle<TextureName> uniform, TextureName texture, unsigned slot) const
+{
+    glUniform1i(uniform.location, slot);
+    glActiveTexture(GL_TEXTURE0 + slot);
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void Shader::SetCubemap(UniformHandle<TextureName> uniform, TextureName texture, unsigned slot) const
+{
+    glUniform1i(uniform.location, slot);
     glActiveTexture(GL_TEXTURE0 + slot);
     glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
 }
@@ -27,6 +27,8 @@
 #include "graphics/camera.h"
 #include "engine/engine.h"
 
+#include <cstddef>
+
 #ifdef EASY_PROFILE_USE
 #include "easy/profiler.h"
 #endif
@@ -59,12 +61,38 @@ void SpriteManagerInterface::Update([[maybe_unused]]neko::seconds dt)
     }
 }
 
+namespace
+{
+//The render quad uses the locations 0 to 3
+constexpr GLuint instanceModelLocation = 4;
+constexpr GLuint instanceColorLocation = instanceModelLocation + 4;
+}
+
 void SpriteManager::Init()
 {
     const auto& config = BasicEngine::GetInstance()->GetConfig();
     spriteShader_.LoadFromFile(config.dataRootPath + "shaders/engine/sprite.vert",
         config.dataRootPath + "shaders/engine/sprite.frag");
+    viewUniform_ = spriteShader_.GetUniformHandle<Mat4f>("view");
+    projectionUniform_ = spriteShader_.GetUniformHandle<Mat4f>("projection");
+    textureUniform_ = spriteShader_.GetUniformHandle<TextureName>("spriteTexture");
     spriteQuad_.Init();
+
+    glBindVertexArray(spriteQuad_.VAO);
+    glGenBuffers(1, &instanceVbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVbo_);
+    for (GLuint i = 0; i < 4; i++)
+    {
+        glEnableVertexAttribArray(instanceModelLocation + i);
+        glVertexAttribDivisor(instanceModelLocation + i, 1);
+    }
+    glEnableVertexAttribArray(instanceColorLocation);
+    glVertexAttribDivisor(instanceColorLocation, 1);
+    BindInstanceAttributes(0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    instanceCapacity_ = 0;
+    glCheckError();
 }
 
 void SpriteManager::Destroy()
@@ -74,39 +102,73 @@ void SpriteManager::Destroy()
         sprite.textureId = INVALID_TEXTURE_ID;
         sprite.texture.name = INVALID_TEXTURE_NAME;
     }
+    glDeleteBuffers(1, &instanceVbo_);
+    instanceVbo_ = 0;
+    instanceCapacity_ = 0;
     spriteQuad_.Destroy();
     spriteShader_.Destroy();
 }
 
+void SpriteManager::BindInstanceAttributes(std::uint32_t firstInstance) const
+{
+    const auto offset = std::size_t(firstInstance) * sizeof(SpriteInstance);
+    for (GLuint i = 0; i < 4; i++)
+    {
+        glVertexAttribPointer(instanceModelLocation + i, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+                              reinterpret_cast<void*>(offset + offsetof(SpriteInstance, model) + i * sizeof(Vec4f)));
+    }
+    glVertexAttribPointer(instanceColorLocation, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+                          reinterpret_cast<void*>(offset + offsetof(SpriteInstance, color)));
+}
+
 void SpriteManager::Render()
 {
 #ifdef EASY_PROFILE_USE
     EASY_BLOCK("Render Sprite Manager");
 #endif
-    //TODO batch sprite with the same texture together
-    spriteShader_.Bind();
-    const auto& camera = CameraLocator::get();
-    spriteShader_.SetMat4("view", camera.GenerateViewMatrix());
-    spriteShader_.SetMat4("projection", camera.GenerateProjectionMatrix());
+    spriteBatcher_.Clear();
     for (Entity entity = 0; entity < entityManager_.get().GetEntitiesSize(); entity++)
     {
-        if (entityManager_.get().HasComponent(entity,EntityMask(ComponentType::SPRITE2D)))
+        if (!entityManager_.get().HasComponent(entity, EntityMask(ComponentType::SPRITE2D)))
         {
-            if (!entityManager_.get().HasComponent(entity, EntityMask(ComponentType::TRANSFORM2D)))
-            {
-                spriteShader_.SetMat4("model", Mat4f::Identity);
-            }
-            else
-            {
-                const auto& transform = transformManager_.GetComponent(entity);
-                spriteShader_.SetMat4("model", transform);
-            }
-            const auto& sprite = GetComponent(entity);
-            spriteShader_.SetTexture("spriteTexture", sprite.texture.name);
-            spriteShader_.SetVec4("spriteColor", sprite.color);
-            spriteQuad_.Draw();
+            continue;
         }
+        const auto& sprite = GetComponent(entity);
+        const auto& model = entityManager_.get().HasComponent(entity, EntityMask(ComponentType::TRANSFORM2D)) ?
+                            transformManager_.GetComponent(entity) : Mat4f::Identity;
+        spriteBatcher_.AddSprite(sprite.texture.name, model, sprite.color);
+    }
+    spriteBatcher_.Build();
+    const auto& instances = spriteBatcher_.GetInstances();
+    if (instances.empty())
+    {
+        return;
+    }
+
+    spriteShader_.Bind();
+    const auto& camera = CameraLocator::get();
+    spriteShader_.SetUniform(viewUniform_, camera.GenerateViewMatrix());
+    spriteShader_.SetUniform(projectionUniform_, camera.GenerateProjectionMatrix());
+
+    //The instance buffer is only reallocated when it grows
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVbo_);
+    const auto instancesSize = instances.size() * sizeof(SpriteInstance);
+    if (instances.size() > instanceCapacity_)
+    {
+        instanceCapacity_ = instances.capacity();
+        glBufferData(GL_ARRAY_BUFFER, instanceCapacity_ * sizeof(SpriteInstance), nullptr, GL_DYNAMIC_DRAW);
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instancesSize, instances.data());
+
+    glBindVertexArray(spriteQuad_.VAO);
+    for (const auto& batch : spriteBatcher_.GetBatches())
+    {
+        BindInstanceAttributes(batch.first);
+        spriteShader_.SetTexture(textureUniform_, batch.texture);
+        glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr, batch.count);
     }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 SpriteManager::SpriteManager(EntityManager& entityManager, TextureManagerInterface& textureManager,
@@ -0,0 +1,153 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "gl/upload_ring_buffer.h"
+
+#include <cstring>
+
+#ifdef EASY_PROFILE_USE
+#include <easy/profiler.h>
+#endif
+
+namespace neko::gl
+{
+
+void UploadRingBuffer::Init(std::size_t segmentSize)
+{
+    segmentSize_ = segmentSize;
+    glGenBuffers(1, &buffer_);
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer_);
+    glBufferData(GL_COPY_READ_BUFFER, GLsizeiptr(segmentSize_ * segmentsNmb), nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glCheckError();
+}
+
+void UploadRingBuffer::Destroy()
+{
+    for (auto& fence : fences_)
+    {
+        if (fence != nullptr)
+        {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    glDeleteBuffers(1, &buffer_);
+    buffer_ = 0;
+}
+
+void UploadRingBuffer::BeginFrame()
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Wait Upload Segment");
+#endif
+    segmentOffset_ = 0;
+    frameUploadedBytes_ = 0;
+    auto& fence = fences_[currentSegment_];
+    if (fence == nullptr)
+    {
+        return;
+    }
+    //With three segments the GPU is usually done with the frame before last
+    constexpr GLuint64 waitTimeout = 1'000'000; //1ms
+    GLenum waitResult = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, waitTimeout);
+    while (waitResult == GL_TIMEOUT_EXPIRED)
+    {
+        waitResult = glClientWaitSync(fence, 0, waitTimeout);
+    }
+    if (waitResult == GL_WAIT_FAILED)
+    {
+        logDebug("[Error] Could not wait for the upload segment fence");
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+bool UploadRingBuffer::Upload(GLuint dstBuffer, GLintptr dstOffset, const void* data, std::size_t size)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Upload Ring Buffer");
+#endif
+    if (size == 0)
+    {
+        return true;
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, dstBuffer);
+#ifndef EMSCRIPTEN
+    if (size <= segmentSize_)
+    {
+        if (segmentOffset_ + size > segmentSize_)
+        {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            return false;
+        }
+        const auto srcOffset = GLintptr(currentSegment_ * segmentSize_ + segmentOffset_);
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer_);
+        //The fence of the segment guarantees that the GPU does not read this range anymore
+        auto* mappedData = glMapBufferRange(GL_COPY_READ_BUFFER, srcOffset, GLsizeiptr(size),
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (mappedData != nullptr)
+        {
+            std::memcpy(mappedData, data, size);
+            if (glUnmapBuffer(GL_COPY_READ_BUFFER) == GL_TRUE)
+            {
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, srcOffset, dstOffset, GLsizeiptr(size));
+                glBindBuffer(GL_COPY_READ_BUFFER, 0);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+                segmentOffset_ += size;
+                frameUploadedBytes_ += size;
+                return true;
+            }
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        logDebug("[Error] Could not map the upload ring buffer");
+    }
+#endif
+    //WebGL cannot map buffers, too big data or a failed mapping falls back on a synchronized upload
+    glBufferSubData(GL_COPY_WRITE_BUFFER, dstOffset, GLsizeiptr(size), data);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    frameUploadedBytes_ += size;
+    return true;
+}
+
+bool UploadRingBuffer::CanUpload(std::size_t size) const
+{
+#ifndef EMSCRIPTEN
+    //Data bigger than a segment does not go through the ring
+    return size > segmentSize_ || segmentOffset_ + size <= segmentSize_;
+#else
+    (void)size;
+    return true;
+#endif
+}
+
+void UploadRingBuffer::EndFrame()
+{
+    if (segmentOffset_ > 0)
+    {
+        fences_[currentSegment_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    currentSegment_ = (currentSegment_ + 1) % segmentsNmb;
+}
+}
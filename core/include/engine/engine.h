@@ -77,6 +77,7 @@ public:
     void ScheduleJob(Job* job, JobThreadType threadType);
 
     [[nodiscard]] std::uint8_t GetWorkersNumber() const { return jobSystem_.GetWorkersNumber(); }
+    JobSystem& GetJobSystem() { return jobSystem_; }
 
     //template <typename T = BasicEngine>
     //static T* GetInstance(){ return dynamic_cast<T*>(instance_);};
@@ -87,6 +88,7 @@ protected:
     Renderer* renderer_ = nullptr;
     Window* window_ = nullptr;
     JobSystem jobSystem_;
+    JobPool frameJobPool_;
 	bool isRunning_ = false;
     float dt_ = 0.0f;
     Action<> initAction_;
@@ -45,9 +45,18 @@ using EntityHash = xxh::hash_t<64>;
  * \brief EntityMask is a bitmask representation of the activated components
  */
 using EntityMask = std::uint32_t;
+/**
+ * \brief Incremented each time an entity slot is destroyed
+ */
+using EntityGeneration = std::uint32_t;
+/**
+ * \brief Entity with its generation in the high 32 bits, used to detect references to destroyed entities
+ */
+using EntityHandle = std::uint64_t;
 const Entity INVALID_ENTITY = std::numeric_limits<Index>::max();
 const EntityMask INVALID_ENTITY_MASK = 0u;
 const EntityHash INVALID_ENTITY_HASH = EntityHash(0);
+const EntityHandle INVALID_ENTITY_HANDLE = std::numeric_limits<EntityHandle>::max();
 enum class ComponentType : std::uint32_t;
 
 template<typename T, EntityMask componentType>
@@ -63,13 +72,31 @@ public:
 
     EntityMask GetMask(Entity entity);
     /**
-     * \brief create an empty entity (non-null EntityMask)
+     * \brief create an empty entity (non-null EntityMask), the lowest free entity is reused
+     * so that entity creation stays deterministic after a rollback
      */
     Entity CreateEntity(Entity entity = INVALID_ENTITY);
+    /**
+     * \brief create entitiesNmb empty entities, growing the entity arrays at most once
+     */
+    std::vector<Entity> CreateEntities(size_t entitiesNmb);
 
     Entity GetLastEntity();
 
     void DestroyEntity(Entity entity);
+
+    void DestroyEntities(const std::vector<Entity>& entities);
+
+    [[nodiscard]] EntityHandle GetEntityHandle(Entity entity) const;
+    /**
+     * \brief Return false if the entity of the handle was destroyed since the handle was taken
+     */
+    [[nodiscard]] bool IsEntityHandleValid(EntityHandle entityHandle) const;
+
+    [[nodiscard]] static Entity GetEntity(EntityHandle entityHandle)
+    { return static_cast<Entity>(entityHandle & std::numeric_limits<Entity>::max()); }
+
+    [[nodiscard]] EntityGeneration GetEntityGeneration(Entity entity) const;
     /**
      *
      */
@@ -99,8 +126,12 @@ public:
 
     [[nodiscard]] Entity FindEntityByName(const std::string& entityName);
 
-    template<typename T, EntityMask componentType>
-    void RegisterComponentManager(ComponentManager<T, componentType>& componentManager)
+    /**
+     * \brief Destroy the component of the component manager when the entity is destroyed,
+     * works with any manager exposing DestroyComponent(Entity) (ComponentManager, SparseComponentManager)
+     */
+    template<typename TComponentManager>
+    void RegisterComponentManager(TComponentManager& componentManager)
     {
         onDestroyEntity.RegisterCallback(
                 [&componentManager](Entity entity) { componentManager.DestroyComponent(entity); });
@@ -122,20 +153,49 @@ public:
     [[nodiscard]] Entity GetFirstRoot() const;
 
 private:
+    Entity PopFreeEntity();
+    void PushFreeEntities(Entity begin, Entity end);
+    /**
+     * \brief Grow the entity arrays so that entity is a valid index and add the new slots to the free list
+     */
+    void ResizeEntities(Entity entity);
+
     Action<Entity> onDestroyEntity;
     Action<Entity, Entity, Entity> onChangeParent;
     std::vector<Entity> parentEntities_;
     std::vector<EntityMask> entityMaskArray_;
     std::vector<EntityHash> entityHashArray_;
+    std::vector<EntityGeneration> entityGenerations_;
+    /**
+     * \brief Min-heap of the free entities, may contain entities created with an explicit index
+     */
+    std::vector<Entity> freeEntities_;
+    /**
+     * \brief Whether the entity is in freeEntities_, so that it is never pushed twice
+     */
+    std::vector<bool> isInFreeList_;
 };
 
+/**
+ * \brief Keep track of the dirty entities and update them with their children, parents before children
+ */
 class DirtyManager
 {
 public:
     explicit DirtyManager(EntityManager& entityManager);
     DirtyManager( const DirtyManager & ) = default;
+    /**
+     * \brief Mark the entity as dirty in O(1), its children are marked when updating
+     */
     void SetDirty(Entity entity);
-
+    /**
+     * \brief Keep the children links up to date and mark the entity as dirty,
+     * needs to be called by the OnChangeParent of the component manager
+     */
+    void OnChangeParent(Entity entity, Entity newParent, Entity oldParent);
+    /**
+     * \brief Propagate to the children and update each dirty entity once, sorted by depth
+     */
     void UpdateDirtyEntities();
 	
     template<typename T, EntityMask componentType>
@@ -144,12 +204,33 @@ public:
         updateDirtyEntity.RegisterCallback(
             [componentManager](Entity entity) { componentManager->UpdateDirtyComponent(entity); });
     }
+    /**
+     * \brief The component manager receives the dirty entities of the same depth together,
+     * after their parents were updated
+     */
+    template<typename TComponentManager>
+    void RegisterBatchComponentManager(TComponentManager* componentManager)
+    {
+        updateDirtyEntities.RegisterCallback(
+            [componentManager](const Entity* entities, size_t count) { componentManager->UpdateDirtyComponents(entities, count); });
+    }
 	
 private:
+    void ResizeEntities(Entity entity);
 	
     std::reference_wrapper<EntityManager> entityManager_;
     Action<Entity> updateDirtyEntity;
+    Action<const Entity*, size_t> updateDirtyEntities;
     std::vector<Entity> dirtyEntities_;
+    std::vector<Entity> updatedEntities_;
+    std::vector<bool> dirtyFlags_;
+    std::vector<Entity> firstChildren_;
+    std::vector<Entity> nextSiblings_;
+    std::vector<Entity> previousSiblings_;
+    /**
+     * \brief Depth and entity, sorted before calling the update
+     */
+    std::vector<std::pair<Index, Entity>> sortedDirtyEntities_;
 };
 
 class OnChangeParentInterface
@@ -23,16 +23,22 @@
  SOFTWARE.
  */
 
+#include <algorithm>
+#include <array>
 #include <functional>
 #include <thread>
-#include <future>
+#include <mutex>
 #include <condition_variable>
+#include <atomic>
+#include <memory>
 
 #include <vector>
 #include "engine/system.h"
+#include "utils/small_function.h"
 
 namespace neko
 {
+class JobSystem;
 
 enum class JobThreadType : int8_t
 {
@@ -45,20 +51,22 @@ enum class JobThreadType : int8_t
 class Job
 {
 public:
+    using Task = SmallFunction<void()>;
     enum class JobType
     {
         MANDATORY,
         DEPENDABLE,
         NICE_TO_HAVE
     };
-    enum JobStatus : std::uint8_t
+    enum JobStatus : std::uint32_t
     {
         NONE = 0u,
         STARTED = 1u << 0u,
-        DONE = 1u << 1u
+        DONE = 1u << 1u,
+        WAITING = 1u << 2u //Set when a thread sleeps in Join
     };
     Job():Job([]{}){};
-    explicit Job(std::function<void()> task);
+    explicit Job(Task task);
     virtual ~Job() = default;
     Job(const Job&) = delete;
     Job& operator=(const Job&) = delete;
@@ -82,24 +90,81 @@ public:
 	 *  used when we want to start the job to know if we should join or wait for other dependencies
 	 */
     [[nodiscard]] bool CheckDependenciesStarted() const;
+    /**
+     * \brief Check if all dependencies are done, used by jobs executed outside of the JobSystem
+     * to not block on Join
+     */
+    [[nodiscard]] bool AreDependenciesDone() const;
     [[nodiscard]] bool IsDone() const;
     [[nodiscard]] bool HasStarted() const;
+    /**
+     * \brief Add a job that needs to be done before this one.
+     * Cycles and redundant dependencies are only checked in debug.
+     */
     void AddDependency(const Job* dep);
+    /**
+     * \brief Walks the whole dependency tree, returns true if job is this one or one of its dependencies
+     */
+    [[nodiscard]] bool IsInDependencyTree(const Job* job) const;
 
-    std::function<void()> GetTask() const { return task_; }
-    void SetTask(std::function<void()> task) { task_ = std::move(task); }
+    void SetTask(Task task) { task_ = std::move(task); }
     virtual void Reset();
 
 protected:
-    std::vector<const Job*> dependencies_;
-    std::function<void()> task_;
-    mutable std::promise<void> promise_;
-    mutable std::shared_future<void> taskDoneFuture_;
-    mutable std::mutex statusLock_;
-    std::uint8_t status_= NONE;
+    friend class JobSystem;
+    /**
+     * \brief Edge of the dependency graph, stored in the dependent job
+     * and linked in the dependents list of the dependency when scheduled
+     */
+    struct DependencyNode
+    {
+        const Job* dependency = nullptr;
+        Job* dependent = nullptr;
+        DependencyNode* next = nullptr;
+    };
+    /**
+     * \brief Register a job waiting for this one to be done,
+     * returns false if this job has already finished its task
+     */
+    bool AddDependent(DependencyNode* node) const;
+    /**
+     * \brief Called by the JobSystem when scheduling the job,
+     * returns true if all dependencies are already done
+     */
+    bool RegisterToDependencies(JobSystem* jobSystem, JobThreadType threadType);
+    /**
+     * \brief Called when one of the dependencies is done,
+     * pushes the job in its queue when it was the last one
+     */
+    void OnDependencyDone();
+
+    //Marks the dependents list as closed when the task is over
+    static DependencyNode closedDependents_;
+
+    std::vector<DependencyNode> dependencies_;
+    mutable std::atomic<DependencyNode*> dependents_{nullptr};
+    Task task_;
+    mutable std::atomic<std::uint32_t> status_{NONE};
+    std::atomic<int> unfinishedDependencies_{0};
+    JobSystem* jobSystem_ = nullptr;
+    JobThreadType threadType_ = JobThreadType::OTHER_THREAD;
 
 };
 
+/**
+ * \brief Pool of jobs reused every frame, so that the engine loop does not allocate jobs.
+ * All the jobs of the previous frame needs to be done when calling Clear.
+ */
+class JobPool
+{
+public:
+    Job* CreateJob(Job::Task task);
+    void Clear() { jobsUsed_ = 0; }
+private:
+    std::vector<std::unique_ptr<Job>> jobs_;
+    std::size_t jobsUsed_ = 0;
+};
+
 struct JobQueue
 {
     std::mutex mutex_;
@@ -107,6 +172,80 @@ struct JobQueue
     std::vector<Job*> jobs_;
 };
 
+/**
+ * \brief Chase-Lev work-stealing deque with a fixed capacity.
+ * Only the owner thread can Push and Pop at the bottom,
+ * other workers Steal at the top.
+ */
+class WorkStealingQueue
+{
+public:
+    static constexpr std::int64_t capacity = 1 << 12;
+
+    WorkStealingQueue();
+    /**
+     * \brief Owner only, returns false when the queue is full
+     */
+    bool Push(Job* job);
+    /**
+     * \brief Owner only, returns nullptr when empty
+     */
+    Job* Pop();
+    /**
+     * \brief Any thread, returns nullptr when empty or when losing the race
+     */
+    Job* Steal();
+    [[nodiscard]] bool IsEmpty() const;
+private:
+    static constexpr std::int64_t mask = capacity - 1;
+    static_assert((capacity & mask) == 0, "WorkStealingQueue capacity needs to be a power of two");
+    alignas(64) std::atomic<std::int64_t> top_{0};
+    alignas(64) std::atomic<std::int64_t> bottom_{0};
+    std::unique_ptr<std::atomic<Job*>[]> buffer_;
+};
+
+/**
+ * \brief Lock-free queue with several producers and a single consumer, the nodes are intrusive.
+ * T needs a T* next member, a node can only be in one queue at a time.
+ */
+template<typename T>
+class MpscQueue
+{
+public:
+    /**
+     * \brief Any thread, the writes done before pushing are visible to the consumer
+     */
+    void Push(T* node)
+    {
+        auto* head = head_.load(std::memory_order_relaxed);
+        do
+        {
+            node->next = head;
+        } while (!head_.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+    }
+    /**
+     * \brief Consumer only, takes all the pushed nodes at once.
+     * Returns the first pushed node linked to the next ones, or nullptr when empty
+     */
+    T* PopAll()
+    {
+        auto* node = head_.exchange(nullptr, std::memory_order_acquire);
+        //The nodes are pushed at the head, reversing the list gives the push order
+        T* first = nullptr;
+        while (node != nullptr)
+        {
+            auto* next = node->next;
+            node->next = first;
+            first = node;
+            node = next;
+        }
+        return first;
+    }
+    [[nodiscard]] bool IsEmpty() const { return head_.load(std::memory_order_relaxed) == nullptr; }
+private:
+    std::atomic<T*> head_{nullptr};
+};
+
 class JobSystem : SystemInterface
 {
     enum Status : std::uint8_t
@@ -125,18 +264,118 @@ public:
 
     void Destroy() override;
     [[nodiscard]] std::uint8_t GetWorkersNumber() const { return numberOfWorkers; }
+    /**
+     * \brief Wait for the job to be done while executing OTHER_THREAD jobs,
+     * avoids deadlocks when waiting from a worker
+     */
+    void WaitJob(const Job* job);
+
+    /**
+     * \brief Split [begin, end) in chunks of grain elements, executed by the OTHER_THREAD workers
+     * and the calling thread. func is called as func(chunkBegin, chunkEnd).
+     */
+    template<typename Func>
+    void ParallelFor(std::size_t begin, std::size_t end, std::size_t grain, const Func& func)
+    {
+        ParallelChunks(begin, end, grain,
+                       [&func](std::size_t, std::size_t chunkBegin, std::size_t chunkEnd)
+                       {
+                           func(chunkBegin, chunkEnd);
+                       });
+    }
+
+    /**
+     * \brief Same split as ParallelFor, map(chunkBegin, chunkEnd) returns the partial result of a chunk.
+     * Partial results are combined with reduce in an unspecified order, so reduce needs to be associative and commutative.
+     */
+    template<typename T, typename MapFunc, typename ReduceFunc>
+    T ParallelReduce(std::size_t begin, std::size_t end, std::size_t grain,
+                     T identity, const MapFunc& map, const ReduceFunc& reduce)
+    {
+        std::array<T, maxParallelJobs + 1> partialResults;
+        partialResults.fill(identity);
+        const auto participantNmb = ParallelChunks(begin, end, grain,
+                       [&partialResults, &map, &reduce](std::size_t participant, std::size_t chunkBegin, std::size_t chunkEnd)
+                       {
+                           partialResults[participant] = reduce(partialResults[participant], map(chunkBegin, chunkEnd));
+                       });
+        T result = identity;
+        for (std::size_t i = 0; i < participantNmb; i++)
+        {
+            result = reduce(result, partialResults[i]);
+        }
+        return result;
+    }
+
+    static constexpr std::size_t maxParallelJobs = 64;
 private:
+    friend class Job;
+    /**
+     * \brief Execute func(participant, chunkBegin, chunkEnd) on each chunk,
+     * returns the number of participants, the calling thread being the last one
+     */
+    template<typename Func>
+    std::size_t ParallelChunks(std::size_t begin, std::size_t end, std::size_t grain, const Func& func)
+    {
+        if (begin >= end)
+        {
+            return 0;
+        }
+        grain = std::max<std::size_t>(grain, 1);
+        const auto chunkNmb = (end - begin + grain - 1) / grain;
+        std::atomic<std::size_t> nextChunk{0};
+        auto work = [&nextChunk, &func, chunkNmb, begin, end, grain](std::size_t participant)
+        {
+            for (auto chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+                 chunk < chunkNmb;
+                 chunk = nextChunk.fetch_add(1, std::memory_order_relaxed))
+            {
+                const auto chunkBegin = begin + chunk * grain;
+                func(participant, chunkBegin, std::min(chunkBegin + grain, end));
+            }
+        };
+        const auto helperNmb = IsRunning() ?
+                std::min({chunkNmb - 1, workStealingQueues_.size(), maxParallelJobs}) : 0;
+        std::array<Job, maxParallelJobs> helperJobs;
+        for (std::size_t i = 0; i < helperNmb; i++)
+        {
+            helperJobs[i].SetTask([&work, i] { work(i); });
+            ScheduleJob(&helperJobs[i], JobThreadType::OTHER_THREAD);
+        }
+        work(helperNmb);
+        for (std::size_t i = 0; i < helperNmb; i++)
+        {
+            WaitJob(&helperJobs[i]);
+        }
+        return helperNmb + 1;
+    }
+    /**
+     * \brief Push a job whose dependencies are all done in the right queue
+     */
+    void EnqueueReadyJob(Job* job, JobThreadType threadType);
 	void Work(JobQueue& jobQueue);
+    /**
+     * \brief Worker loop of OTHER_THREAD, pops its own deque first,
+     * then the shared queue and finally steals from the other workers
+     */
+    void WorkStealing(std::size_t workerIndex);
+    /**
+     * \brief Pops the deque of the current worker if any, then the shared queue and steals from the workers
+     */
+    Job* PopOtherJob();
 
     [[nodiscard]] bool IsRunning() const;
 
-    Status status_ = NONE;
-    JobQueue jobs_; // Managed via mutex. // TODO: replace with custom queue when those are implemented.
+    std::atomic<std::uint8_t> status_ = NONE;
+    JobQueue jobs_; // Shared queue used when scheduling from a thread that is not an OTHER_THREAD worker
     JobQueue renderJobs_; // Managed via mutex. // TODO: replace with custom queue when those are implemented.
     JobQueue resourceJobs_; // Managed via mutex. // TODO: replace with custom queue when those are implemented.
+    std::vector<std::unique_ptr<WorkStealingQueue>> workStealingQueues_;
+    std::atomic<int> queuedOtherJobs_{0};
+    std::atomic<int> scheduledJobs_{0};
     std::uint8_t workersStarted_ = 0;
     [[nodiscard]] std::uint8_t CountStartedWorkers() const;
-    std::uint8_t numberOfWorkers;
+    std::uint8_t numberOfWorkers = 0;
     std::vector<std::thread> workers_; // TODO: replace with fixed vector when those are implemented.
     mutable std::mutex statusMutex_;
 };
@@ -0,0 +1,194 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "engine/entity.h"
+#include "utils/vector_utility.h"
+
+namespace neko
+{
+
+/**
+ * \brief Sparse set alternative to ComponentManager. Components are packed in a dense array
+ * and an entity indexed sparse array points into it, so iterating only touches the entities
+ * that have the component. Destroying a component moves the last one in its place.
+ */
+template<typename T, EntityMask componentType>
+class SparseComponentManager
+{
+public:
+    using ValueType = T;
+    static constexpr EntityMask mask = componentType;
+
+    explicit SparseComponentManager(EntityManager& entityManager) :
+        entityManager_(entityManager)
+    {
+        entityManager_.get().RegisterComponentManager(*this);
+        ResizeIfNecessary(sparse_, INIT_ENTITY_NMB - 1, INVALID_INDEX);
+    }
+
+    virtual ~SparseComponentManager() = default;
+
+    /**
+     * \brief Add a default component and its type to the entity manager
+     */
+    virtual void AddComponent(Entity entity);
+    /**
+     * \brief Remove the component and its type from the entity manager
+     */
+    virtual void DestroyComponent(Entity entity);
+    /**
+     * \brief Copy the value component (Warning! the entity needs to have the component)
+     */
+    virtual void SetComponent(Entity entity, const T& component);
+
+    [[nodiscard]] bool HasComponent(Entity entity) const
+    { return entity < sparse_.size() && sparse_[entity] != INVALID_INDEX; }
+
+    [[nodiscard]] const T& GetComponent(Entity entity) const
+    { return components_[sparse_[entity]]; }
+
+    [[nodiscard]] T& GetComponent(Entity entity)
+    { return components_[sparse_[entity]]; }
+
+    [[nodiscard]] std::size_t GetComponentsNmb() const
+    { return components_.size(); }
+    /**
+     * \brief Entities owning a component, in the same order as GetComponentsVector
+     */
+    [[nodiscard]] const std::vector<Entity>& GetEntities() const
+    { return entities_; }
+
+    [[nodiscard]] const std::vector<T>& GetComponentsVector() const
+    { return components_; }
+
+    [[nodiscard]] std::vector<T>& GetComponentsVector()
+    { return components_; }
+
+    virtual void UpdateDirtyComponent([[maybe_unused]]Entity entity){};
+protected:
+    std::vector<T> components_;
+    std::vector<Entity> entities_;
+    std::vector<Index> sparse_;
+    std::reference_wrapper<EntityManager> entityManager_;
+};
+
+template<typename T, EntityMask componentType>
+void SparseComponentManager<T, componentType>::AddComponent(Entity entity)
+{
+    ResizeIfNecessary(sparse_, entity, INVALID_INDEX);
+    if (sparse_[entity] == INVALID_INDEX)
+    {
+        sparse_[entity] = static_cast<Index>(components_.size());
+        components_.push_back(T{});
+        entities_.push_back(entity);
+    }
+    entityManager_.get().AddComponentType(entity, componentType);
+}
+
+template<typename T, EntityMask componentType>
+void SparseComponentManager<T, componentType>::DestroyComponent(Entity entity)
+{
+    if (HasComponent(entity))
+    {
+        const auto index = sparse_[entity];
+        const auto lastEntity = entities_.back();
+        components_[index] = std::move(components_.back());
+        entities_[index] = lastEntity;
+        sparse_[lastEntity] = index;
+        sparse_[entity] = INVALID_INDEX;
+        components_.pop_back();
+        entities_.pop_back();
+    }
+    entityManager_.get().RemoveComponentType(entity, componentType);
+}
+
+template<typename T, EntityMask componentType>
+void SparseComponentManager<T, componentType>::SetComponent(Entity entity, const T& component)
+{
+    components_[sparse_[entity]] = component;
+}
+
+/**
+ * \brief Query over several SparseComponentManager, e.g. View<Position3dSparseManager, Scale3dSparseManager>.
+ * It iterates the dense entities of the smallest manager and only checks the others,
+ * so the cost depends on the number of matching entities and not on GetEntitiesSize.
+ * Adding or destroying components of the viewed managers while iterating is not allowed.
+ */
+template<typename ... TComponentManagers>
+class View
+{
+public:
+    explicit View(TComponentManagers& ... componentManagers) :
+        componentManagers_(componentManagers...)
+    {
+    }
+    /**
+     * \brief Call func(entity, component...) for each entity having all the components
+     */
+    template<typename Func>
+    void ForEach(Func&& func)
+    {
+        ForEach(std::forward<Func>(func), std::index_sequence_for<TComponentManagers...>{});
+    }
+    /**
+     * \brief Number of entities having all the components
+     */
+    [[nodiscard]] std::size_t Count()
+    {
+        std::size_t count = 0;
+        ForEach([&count](Entity, auto& ...) { count++; });
+        return count;
+    }
+private:
+    template<typename Func, std::size_t ... Is>
+    void ForEach(Func&& func, std::index_sequence<Is...>)
+    {
+        std::size_t smallest = 0;
+        std::size_t smallestSize = std::get<0>(componentManagers_).GetComponentsNmb();
+        ((std::get<Is>(componentManagers_).GetComponentsNmb() < smallestSize ?
+          (smallest = Is, smallestSize = std::get<Is>(componentManagers_).GetComponentsNmb()) : 0), ...);
+        ((smallest == Is ? (Iterate<Is>(func, std::index_sequence<Is...>{}), 0) : 0), ...);
+    }
+
+    template<std::size_t Driver, typename Func, std::size_t ... Is>
+    void Iterate(Func& func, std::index_sequence<Is...>)
+    {
+        for (const auto entity : std::get<Driver>(componentManagers_).GetEntities())
+        {
+            if ((std::get<Is>(componentManagers_).HasComponent(entity) && ...))
+            {
+                func(entity, std::get<Is>(componentManagers_).GetComponent(entity)...);
+            }
+        }
+    }
+
+    std::tuple<TComponentManagers& ...> componentManagers_;
+};
+
+}
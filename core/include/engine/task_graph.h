@@ -0,0 +1,82 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "engine/jobsystem.h"
+
+namespace neko
+{
+
+/**
+ * \brief Graph of named jobs built once and scheduled every frame.
+ * Cycles are checked when building the graph, not when scheduling it.
+ */
+class TaskGraph
+{
+public:
+    using NodeIndex = std::size_t;
+    static constexpr NodeIndex INVALID_NODE = std::numeric_limits<NodeIndex>::max();
+
+    NodeIndex AddNode(std::string_view name, Job::Task task,
+                      JobThreadType threadType = JobThreadType::OTHER_THREAD);
+    /**
+     * \brief The job of the node to waits for the job of the node from
+     */
+    void AddEdge(NodeIndex from, NodeIndex to);
+    void AddEdge(std::string_view from, std::string_view to);
+    [[nodiscard]] NodeIndex GetNodeIndex(std::string_view name) const;
+    [[nodiscard]] Job* GetJob(NodeIndex node) { return nodes_[node].job.get(); }
+    [[nodiscard]] std::size_t GetNodesNmb() const { return nodes_.size(); }
+    /**
+     * \brief Sort the nodes in topological order, returns false if the graph contains a cycle
+     */
+    bool Build();
+    /**
+     * \brief Reset and schedule all the jobs, the previous submission needs to be done
+     */
+    void Schedule(JobSystem& jobSystem);
+    /**
+     * \brief Wait for all the jobs of the graph
+     */
+    void Join(JobSystem& jobSystem) const;
+private:
+    struct Node
+    {
+        std::string name;
+        std::unique_ptr<Job> job;
+        JobThreadType threadType = JobThreadType::OTHER_THREAD;
+        std::vector<NodeIndex> dependencies;
+    };
+    std::vector<Node> nodes_;
+    std::vector<NodeIndex> sortedNodes_;
+    bool isBuilt_ = false;
+};
+
+}
@@ -127,6 +127,10 @@ public:
 	 * \brief This function is called by the Dirty Manager
 	 */
     void UpdateDirtyComponent(Entity entity) override;
+    /**
+     * \brief Called by the Dirty Manager with entities of the same depth, computes their transforms in batch
+     */
+    void UpdateDirtyComponents(const Entity* entities, size_t count);
     void Update() override;
     void AddComponent(Entity entity) override;
 protected:
@@ -136,6 +140,10 @@ protected:
     Scale3dManager scale3DManager_;
     Rotation3dManager rotation3DManager_;
     DirtyManager dirtyManager_;
+    std::vector<Vec3f> batchPositions_;
+    std::vector<EulerAngles> batchAngles_;
+    std::vector<Vec3f> batchScales_;
+    std::vector<Mat4f> batchTransforms_;
 };
 
 class Transform3dViewer : public DrawImGuiInterface
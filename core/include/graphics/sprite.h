@@ -0,0 +1,83 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "graphics/color.h"
+#include "mathematics/matrix.h"
+
+namespace neko
+{
+
+/**
+ * \brief Per-instance data of a sprite, uploaded as is in the instance buffer
+ */
+struct SpriteInstance
+{
+    Mat4f model = Mat4f::Identity;
+    Color4 color = Color4(Color::white, 1.0f);
+};
+
+/**
+ * \brief Contiguous range of instances sharing the same texture, drawn with one instanced call
+ */
+struct SpriteBatch
+{
+    std::uint32_t texture = 0;
+    std::uint32_t first = 0;
+    std::uint32_t count = 0;
+};
+
+/**
+ * \brief Build the sprite draw commands of a frame without touching the graphics API.
+ * Sprites are sorted by texture, keeping their submission order inside a batch.
+ */
+class SpriteBatcher
+{
+public:
+    using TextureKey = std::uint32_t;
+
+    void Clear();
+    void Reserve(std::size_t spritesNmb);
+    void AddSprite(TextureKey texture, const Mat4f& model, const Color4& color);
+    /**
+     * \brief Sort the sprites added since the last Clear and fill the instances and batches
+     */
+    void Build();
+
+    [[nodiscard]] const std::vector<SpriteInstance>& GetInstances() const { return instances_; }
+    [[nodiscard]] const std::vector<SpriteBatch>& GetBatches() const { return batches_; }
+    [[nodiscard]] std::size_t GetSpritesNmb() const { return sortKeys_.size(); }
+private:
+    //texture in the high bits and submission index in the low bits
+    std::vector<std::uint64_t> sortKeys_;
+    std::vector<std::uint64_t> sortKeysBuffer_;
+    std::vector<SpriteInstance> sprites_;
+    std::vector<SpriteInstance> instances_;
+    std::vector<SpriteBatch> batches_;
+};
+
+}
@@ -54,6 +54,13 @@ Mat4f Rotate(const Mat4f& transform, const Quaternion& quaternion);
 
 Mat4f Rotate(const Mat4f& transform, const EulerAngles eulerAngles);
 
+/**
+ * \brief Same result as Translate(Scale(Rotate(Mat4f::Identity, angles), scale), position) for each entity,
+ * computed four (SSE, NEON) or eight (AVX2) entities at a time
+ */
+void ComputeTransforms(const Vec3f* positions, const EulerAngles* angles, const Vec3f* scales,
+                       Mat4f* transforms, std::size_t count);
+
 
 Mat4f Perspective(radian_t fovy, float aspect, float near, float far);
 Mat4f Orthographic(float left, float right, float bottom, float top, float nearPlane = 0.0f, float farPlane = 100.0f);
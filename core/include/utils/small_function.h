@@ -0,0 +1,145 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace neko
+{
+
+template<typename Signature, std::size_t BufferSize = 64>
+class SmallFunction;
+
+/**
+ * \brief Move-only replacement of std::function that stores the callable in an inline buffer.
+ * It never allocates, callables bigger than the buffer do not compile.
+ */
+template<typename R, typename ... Args, std::size_t BufferSize>
+class SmallFunction<R(Args...), BufferSize>
+{
+public:
+    SmallFunction() = default;
+
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, SmallFunction>>>
+    SmallFunction(F&& func)
+    {
+        using Func = std::decay_t<F>;
+        static_assert(sizeof(Func) <= BufferSize, "Callable is too big for SmallFunction buffer");
+        static_assert(alignof(Func) <= alignof(std::max_align_t), "Callable alignment is not supported");
+        new(&buffer_) Func(std::forward<F>(func));
+        invoke_ = &Invoke<Func>;
+        manage_ = &Manage<Func>;
+    }
+
+    SmallFunction(SmallFunction&& other) noexcept
+    {
+        MoveFrom(other);
+    }
+
+    SmallFunction& operator=(SmallFunction&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Destroy();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    SmallFunction(const SmallFunction&) = delete;
+    SmallFunction& operator=(const SmallFunction&) = delete;
+
+    ~SmallFunction()
+    {
+        Destroy();
+    }
+
+    R operator()(Args... args)
+    {
+        return invoke_(&buffer_, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const { return invoke_ != nullptr; }
+
+private:
+    enum class Operation
+    {
+        MOVE,
+        DESTROY
+    };
+    using InvokeFunc = R(*)(void*, Args&&...);
+    using ManageFunc = void (*)(Operation, void*, void*);
+
+    template<typename Func>
+    static R Invoke(void* func, Args&& ... args)
+    {
+        return (*static_cast<Func*>(func))(std::forward<Args>(args)...);
+    }
+
+    template<typename Func>
+    static void Manage(Operation operation, void* dst, void* src)
+    {
+        switch (operation)
+        {
+            case Operation::MOVE:
+                new(dst) Func(std::move(*static_cast<Func*>(src)));
+                static_cast<Func*>(src)->~Func();
+                break;
+            case Operation::DESTROY:
+                static_cast<Func*>(dst)->~Func();
+                break;
+            default:
+                break;
+        }
+    }
+
+    void MoveFrom(SmallFunction& other)
+    {
+        if (other.manage_ != nullptr)
+        {
+            other.manage_(Operation::MOVE, &buffer_, &other.buffer_);
+        }
+        invoke_ = other.invoke_;
+        manage_ = other.manage_;
+        other.invoke_ = nullptr;
+        other.manage_ = nullptr;
+    }
+
+    void Destroy()
+    {
+        if (manage_ != nullptr)
+        {
+            manage_(Operation::DESTROY, &buffer_, nullptr);
+        }
+        invoke_ = nullptr;
+        manage_ = nullptr;
+    }
+
+    std::aligned_storage_t<BufferSize, alignof(std::max_align_t)> buffer_;
+    InvokeFunc invoke_ = nullptr;
+    ManageFunc manage_ = nullptr;
+};
+}
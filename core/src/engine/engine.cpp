@@ -119,33 +119,35 @@ void BasicEngine::Update(seconds dt)
         renderer_->ResetJobs();
     if (window_)
         window_->ResetJobs();
+    //Jobs of the previous frame are done after joining the swap buffer job
+    frameJobPool_.Clear();
 
-    Job eventJob([this]
+    Job* eventJob = frameJobPool_.CreateJob([this]
         {
             ManageEvent();
         });
     Job* swapBufferJob = nullptr;
-    Job updateJob([this, &dt] { updateAction_.Execute(dt); });
-    updateJob.AddDependency(&eventJob);
+    Job* updateJob = frameJobPool_.CreateJob([this, dt] { updateAction_.Execute(dt); });
+    updateJob->AddDependency(eventJob);
     if (renderer_)
     {
         Job* rendererSyncJob = renderer_->GetSyncJob();
-        updateJob.AddDependency(rendererSyncJob);
+        updateJob->AddDependency(rendererSyncJob);
 
         Job* renderJob = renderer_->GetRenderAllJob();
-        renderJob->AddDependency(&eventJob);
+        renderJob->AddDependency(eventJob);
 
         swapBufferJob = window_->GetSwapBufferJob();
         swapBufferJob->AddDependency(renderJob);
-        //swapBufferJob->AddDependency(&updateJob);
+        //swapBufferJob->AddDependency(updateJob);
 
         renderer_->ScheduleJobs();
         jobSystem_.ScheduleJob(swapBufferJob, JobThreadType::RENDER_THREAD);
 
 
     }
-    jobSystem_.ScheduleJob(&eventJob, JobThreadType::MAIN_THREAD);
-    jobSystem_.ScheduleJob(&updateJob, JobThreadType::MAIN_THREAD);
+    jobSystem_.ScheduleJob(eventJob, JobThreadType::MAIN_THREAD);
+    jobSystem_.ScheduleJob(updateJob, JobThreadType::MAIN_THREAD);
 #ifdef EASY_PROFILE_USE
     EASY_END_BLOCK
     EASY_BLOCK("Waiting for Swap Buffer");
@@ -24,6 +24,7 @@
 #include <engine/entity.h>
 #include "engine/globals.h"
 #include <algorithm>
+#include <functional>
 #include <utils/vector_utility.h>
 #include <engine/component.h>
 #include <sstream>
@@ -40,6 +41,10 @@ EntityManager::EntityManager()
     entityMaskArray_.resize(INIT_ENTITY_NMB);
 	entityHashArray_.resize(INIT_ENTITY_NMB);
     parentEntities_.resize(INIT_ENTITY_NMB, INVALID_ENTITY);
+    entityGenerations_.resize(INIT_ENTITY_NMB, 0);
+    isInFreeList_.resize(INIT_ENTITY_NMB, false);
+    freeEntities_.reserve(INIT_ENTITY_NMB);
+    PushFreeEntities(0, INIT_ENTITY_NMB);
 }
 
 EntityMask EntityManager::GetMask(Entity entity)
@@ -51,27 +56,15 @@ Entity EntityManager::CreateEntity(Entity entity)
 {
     if(entity == INVALID_ENTITY)
     {
-        const auto entityMaskIt = std::find_if(entityMaskArray_.begin(), entityMaskArray_.end(),
-                                               [](EntityMask entityMask)
-                                               {
-                                                   return entityMask == INVALID_ENTITY_MASK;
-                                               });
-        if (entityMaskIt == entityMaskArray_.end())
-        {
-            const auto newEntity = entityMaskArray_.size();
-            ResizeIfNecessary(entityMaskArray_, newEntity, INVALID_ENTITY_MASK);
-            ResizeIfNecessary(parentEntities_, newEntity, INVALID_ENTITY);
-			ResizeIfNecessary(entityHashArray_, newEntity, INVALID_ENTITY_HASH);
-        	AddComponentType(static_cast<Entity>(newEntity), static_cast<EntityMask>(ComponentType::EMPTY));
-            return static_cast<Entity>(newEntity);
-        }
-        const auto newEntity = std::distance(entityMaskArray_.begin(),entityMaskIt);
-        AddComponentType(static_cast<Entity>(newEntity), static_cast<EntityMask>(ComponentType::EMPTY));
-        return static_cast<Entity>(newEntity);
+        const auto newEntity = PopFreeEntity();
+        AddComponentType(newEntity, static_cast<EntityMask>(ComponentType::EMPTY));
+        return newEntity;
     }
-    ResizeIfNecessary(entityMaskArray_, entity, INVALID_ENTITY_MASK);
-    ResizeIfNecessary(parentEntities_, entity, INVALID_ENTITY);
-    ResizeIfNecessary(entityHashArray_, entity, INVALID_ENTITY_HASH);
+    if (entity >= entityMaskArray_.size())
+    {
+        ResizeEntities(entity);
+    }
+    //The entity stays in the free list, it is skipped when popped and not pushed again when destroyed
     if(!EntityExists(entity))
     {
         AddComponentType(entity, static_cast<EntityMask>(ComponentType::EMPTY));
@@ -80,14 +73,106 @@ Entity EntityManager::CreateEntity(Entity entity)
     return CreateEntity(INVALID_ENTITY);
 }
 
+std::vector<Entity> EntityManager::CreateEntities(size_t entitiesNmb)
+{
+    std::vector<Entity> entities(entitiesNmb);
+    if (freeEntities_.size() < entitiesNmb)
+    {
+        //Only one resize for the whole batch
+        ResizeEntities(entityMaskArray_.size() + entitiesNmb - freeEntities_.size());
+    }
+    for (auto& entity : entities)
+    {
+        entity = PopFreeEntity();
+        AddComponentType(entity, static_cast<EntityMask>(ComponentType::EMPTY));
+    }
+    return entities;
+}
+
 void EntityManager::DestroyEntity(Entity entity)
 {
+    if (EntityExists(entity))
+    {
+        entityGenerations_[entity]++;
+        if (!isInFreeList_[entity])
+        {
+            isInFreeList_[entity] = true;
+            freeEntities_.push_back(entity);
+            std::push_heap(freeEntities_.begin(), freeEntities_.end(), std::greater<>());
+        }
+    }
     entityMaskArray_[entity] = INVALID_ENTITY_MASK;
 	entityHashArray_[entity] = INVALID_ENTITY_HASH;
 
 	onDestroyEntity.Execute(entity);
 }
 
+void EntityManager::DestroyEntities(const std::vector<Entity>& entities)
+{
+    for (const auto entity : entities)
+    {
+        DestroyEntity(entity);
+    }
+}
+
+EntityHandle EntityManager::GetEntityHandle(Entity entity) const
+{
+    return (static_cast<EntityHandle>(entityGenerations_[entity]) << 32u) | entity;
+}
+
+bool EntityManager::IsEntityHandleValid(EntityHandle entityHandle) const
+{
+    const auto entity = GetEntity(entityHandle);
+    return entity < entityMaskArray_.size() &&
+        EntityExists(entity) &&
+        GetEntityHandle(entity) == entityHandle;
+}
+
+EntityGeneration EntityManager::GetEntityGeneration(Entity entity) const
+{
+    return entityGenerations_[entity];
+}
+
+Entity EntityManager::PopFreeEntity()
+{
+    while (!freeEntities_.empty())
+    {
+        std::pop_heap(freeEntities_.begin(), freeEntities_.end(), std::greater<>());
+        const auto entity = freeEntities_.back();
+        freeEntities_.pop_back();
+        isInFreeList_[entity] = false;
+        //Entities created with an explicit index are still in the free list
+        if (!EntityExists(entity))
+        {
+            return entity;
+        }
+    }
+    const auto newEntity = static_cast<Entity>(entityMaskArray_.size());
+    ResizeEntities(newEntity);
+    return PopFreeEntity();
+}
+
+void EntityManager::PushFreeEntities(Entity begin, Entity end)
+{
+    for (Entity entity = begin; entity < end; entity++)
+    {
+        freeEntities_.push_back(entity);
+        isInFreeList_[entity] = true;
+    }
+    std::make_heap(freeEntities_.begin(), freeEntities_.end(), std::greater<>());
+}
+
+void EntityManager::ResizeEntities(Entity entity)
+{
+    const auto previousSize = static_cast<Entity>(entityMaskArray_.size());
+    ResizeIfNecessary(entityMaskArray_, entity, INVALID_ENTITY_MASK);
+    ResizeIfNecessary(parentEntities_, entity, INVALID_ENTITY);
+    ResizeIfNecessary(entityHashArray_, entity, INVALID_ENTITY_HASH);
+    ResizeIfNecessary(entityGenerations_, entity, EntityGeneration(0));
+    ResizeIfNecessary(isInFreeList_, entity, false);
+    PushFreeEntities(previousSize, static_cast<Entity>(entityMaskArray_.size()));
+}
+
 bool EntityManager::HasComponent(Entity entity, EntityMask componentType) const
 {
 	if (entity >= entityMaskArray_.size())
@@ -144,39 +229,107 @@ Entity EntityManager::GetFirstRoot() const
 
 DirtyManager::DirtyManager(EntityManager& entityManager) : entityManager_(entityManager)
 {
+    ResizeEntities(INIT_ENTITY_NMB - 1);
 }
 
 void DirtyManager::SetDirty(Entity entity)
 {
-    if (std::find(dirtyEntities_.cbegin(), dirtyEntities_.cend(), entity) == dirtyEntities_.cend())
+    ResizeEntities(entity);
+    if (!dirtyFlags_[entity])
     {
+        dirtyFlags_[entity] = true;
     	dirtyEntities_.push_back(entity);
     }
 }
 
+void DirtyManager::OnChangeParent(Entity entity, Entity newParent, Entity oldParent)
+{
+    ResizeEntities(std::max(entity, newParent == INVALID_ENTITY ? entity : newParent));
+    //Unlink the entity from the children of the old parent
+    const auto previousSibling = previousSiblings_[entity];
+    const auto nextSibling = nextSiblings_[entity];
+    if (previousSibling != INVALID_ENTITY)
+    {
+        nextSiblings_[previousSibling] = nextSibling;
+    }
+    else if (oldParent != INVALID_ENTITY && oldParent < firstChildren_.size() && firstChildren_[oldParent] == entity)
+    {
+        firstChildren_[oldParent] = nextSibling;
+    }
+    if (nextSibling != INVALID_ENTITY)
+    {
+        previousSiblings_[nextSibling] = previousSibling;
+    }
+    previousSiblings_[entity] = INVALID_ENTITY;
+    nextSiblings_[entity] = INVALID_ENTITY;
+    //Link it as first child of the new parent
+    if (newParent != INVALID_ENTITY)
+    {
+        const auto firstChild = firstChildren_[newParent];
+        nextSiblings_[entity] = firstChild;
+        if (firstChild != INVALID_ENTITY)
+        {
+            previousSiblings_[firstChild] = entity;
+        }
+        firstChildren_[newParent] = entity;
+    }
+    SetDirty(entity);
+}
+
 void DirtyManager::UpdateDirtyEntities()
 {
-    //Fill the dirty entities with all the children in O(n)
-    for (Entity entity = 0; entity < entityManager_.get().GetEntitiesSize(); entity++)
+    const auto& entityManager = entityManager_.get();
+    //Fill the dirty entities with all the children, dirtyEntities_ grows while iterating
+    for (size_t i = 0; i < dirtyEntities_.size(); i++)
     {
-    	if(!entityManager_.get().EntityExists(entity))
-            continue;
-        auto parent = entityManager_.get().GetEntityParent(entity);
-        while (parent != INVALID_ENTITY)
+        for (auto child = firstChildren_[dirtyEntities_[i]]; child != INVALID_ENTITY; child = nextSiblings_[child])
         {
-            if (std::find(dirtyEntities_.cbegin(), dirtyEntities_.cend(), parent) != dirtyEntities_.end())
+            if (entityManager.EntityExists(child))
             {
-                SetDirty(entity);
-                break;
+                SetDirty(child);
             }
-            parent = entityManager_.get().GetEntityParent(parent);
         }
     }
-    for (auto entity : dirtyEntities_)
+    //Parents before children, so each transform uses the already updated parent transform
+    sortedDirtyEntities_.clear();
+    for (const auto entity : dirtyEntities_)
     {
-        updateDirtyEntity.Execute(entity);
+        Index depth = 0;
+        for (auto parent = entityManager.GetEntityParent(entity);
+             parent != INVALID_ENTITY;
+             parent = entityManager.GetEntityParent(parent))
+        {
+            depth++;
+        }
+        sortedDirtyEntities_.emplace_back(depth, entity);
+        dirtyFlags_[entity] = false;
     }
     dirtyEntities_.clear();
+    std::sort(sortedDirtyEntities_.begin(), sortedDirtyEntities_.end());
+    updatedEntities_.clear();
+    for (const auto& dirtyEntity : sortedDirtyEntities_)
+    {
+        updatedEntities_.push_back(dirtyEntity.second);
+    }
+    for (size_t begin = 0; begin < sortedDirtyEntities_.size();)
+    {
+        auto end = begin;
+        while (end < sortedDirtyEntities_.size() && sortedDirtyEntities_[end].first == sortedDirtyEntities_[begin].first)
+        {
+            updateDirtyEntity.Execute(updatedEntities_[end]);
+            end++;
+        }
+        updateDirtyEntities.Execute(updatedEntities_.data() + begin, end - begin);
+        begin = end;
+    }
+}
+
+void DirtyManager::ResizeEntities(Entity entity)
+{
+    ResizeIfNecessary(dirtyFlags_, entity, false);
+    ResizeIfNecessary(firstChildren_, entity, INVALID_ENTITY);
+    ResizeIfNecessary(nextSiblings_, entity, INVALID_ENTITY);
+    ResizeIfNecessary(previousSiblings_, entity, INVALID_ENTITY);
 }
 
 EntityHierarchy::EntityHierarchy(EntityManager& entityManager) : entityManager_(entityManager)
@@ -489,7 +642,7 @@ Entity EntityManager::GetEntityParent(Entity entity) const
 bool EntityManager::SetEntityParent(Entity child, Entity parent)
 {
 	const auto oldParent = GetEntityParent(child);
-    auto p = GetEntityParent(parent);
+    auto p = parent == INVALID_ENTITY ? INVALID_ENTITY : GetEntityParent(parent);
     while (p != INVALID_ENTITY)
     {
 	    if(p == child)
@@ -23,8 +23,20 @@
  */
 
 #include <engine/jobsystem.h>
+#include <engine/engine.h>
+#include <engine/assert.h>
 
 #include <utility>
+#include <climits>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <Windows.h>
+#pragma comment(lib, "Synchronization.lib")
+#endif
 
 #ifdef EASY_PROFILE_USE
 #include <easy/profiler.h>
@@ -33,6 +45,113 @@
 namespace neko
 {
 
+namespace
+{
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+
+/**
+ * \brief Block the thread while the status is equal to the expected value,
+ * can return spuriously
+ */
+void WaitStatus(std::atomic<std::uint32_t>& status, std::uint32_t expected)
+{
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&status), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+    WaitOnAddress(&status, &expected, sizeof(expected), INFINITE);
+#else
+    if (status.load(std::memory_order_acquire) == expected)
+    {
+        std::this_thread::yield();
+    }
+#endif
+}
+
+/**
+ * \brief Wake all the threads waiting on the status, only uses its address
+ */
+void WakeStatus([[maybe_unused]] std::atomic<std::uint32_t>& status)
+{
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&status), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+    WakeByAddressAll(&status);
+#endif
+}
+
+// Set for each OTHER_THREAD worker, used to push ready jobs on the local deque
+thread_local JobSystem* currentJobSystem = nullptr;
+thread_local std::size_t currentWorkerIndex = 0;
+}
+
+WorkStealingQueue::WorkStealingQueue() :
+    buffer_(std::make_unique<std::atomic<Job*>[]>(capacity))
+{
+}
+
+bool WorkStealingQueue::Push(Job* job)
+{
+    const auto bottom = bottom_.load(std::memory_order_relaxed);
+    const auto top = top_.load(std::memory_order_acquire);
+    if (bottom - top > mask)
+    {
+        return false;
+    }
+    buffer_[bottom & mask].store(job, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+}
+
+Job* WorkStealingQueue::Pop()
+{
+    const auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = top_.load(std::memory_order_relaxed);
+    if (top > bottom)
+    {
+        //Empty queue
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    Job* job = buffer_[bottom & mask].load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+        //Last element, racing against thieves
+        if (!top_.compare_exchange_strong(top, top + 1,
+                                          std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            job = nullptr;
+        }
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+Job* WorkStealingQueue::Steal()
+{
+    auto top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom)
+    {
+        return nullptr;
+    }
+    Job* job = buffer_[top & mask].load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(top, top + 1,
+                                      std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        return nullptr;
+    }
+    return job;
+}
+
+bool WorkStealingQueue::IsEmpty() const
+{
+    return bottom_.load(std::memory_order_acquire) <= top_.load(std::memory_order_acquire);
+}
+
 JobSystem::JobSystem()
 {
 
@@ -45,19 +164,29 @@ JobSystem::~JobSystem()
 
 void JobSystem::ScheduleJob(Job* func, JobThreadType threadType)
 {
-    auto scheduleJobFunc = [&func](JobQueue& jobQueue)
+    if (threadType == JobThreadType::MAIN_THREAD)
+    {
+        func->Execute();
+        return;
+    }
+    ++scheduledJobs_;
+    //The job only enters a queue when all its dependencies are done
+    if (func->RegisterToDependencies(this, threadType))
+    {
+        EnqueueReadyJob(func, threadType);
+    }
+}
+
+void JobSystem::EnqueueReadyJob(Job* job, JobThreadType threadType)
+{
+    auto scheduleJobFunc = [job](JobQueue& jobQueue)
     {
         std::lock_guard<std::mutex> lock(jobQueue.mutex_);
-        jobQueue.jobs_.push_back(func);
+        jobQueue.jobs_.push_back(job);
         jobQueue.cv_.notify_one();
     };
 	switch (threadType)
 	{
-    case JobThreadType::MAIN_THREAD:
-    {
-        func->Execute();
-        break;
-    }
     case JobThreadType::RENDER_THREAD:
 	{
         scheduleJobFunc(renderJobs_);
@@ -70,7 +199,18 @@ void JobSystem::ScheduleJob(Job* func, JobThreadType threadType)
     }
     case JobThreadType::OTHER_THREAD:
 	{
-        scheduleJobFunc(jobs_);
+        if (currentJobSystem != this ||
+            !workStealingQueues_[currentWorkerIndex]->Push(job))
+        {
+            std::lock_guard<std::mutex> lock(jobs_.mutex_);
+            jobs_.jobs_.push_back(job);
+        }
+        ++queuedOtherJobs_;
+        {
+            //Taking the lock avoids missing the wake-up of a worker going to sleep
+            std::lock_guard<std::mutex> lock(jobs_.mutex_);
+            jobs_.cv_.notify_one();
+        }
         break;
     }
 	default: ;
@@ -94,22 +234,6 @@ void JobSystem::Work(JobQueue& jobQueue)
             {
                 job = jobQueue.jobs_.front();
                 jobQueue.jobs_.erase(jobQueue.jobs_.cbegin());
-                lock.unlock();
-                if (!job->CheckDependenciesStarted())
-                {
-                    lock.lock();
-                	if(jobQueue.jobs_.empty())
-                	{
-#ifdef EASY_PROFILE_USE
-                        EASY_BLOCK("Wait for Dependencies");
-#endif
-
-                        jobQueue.cv_.wait_for(lock, std::chrono::microseconds(100));
-
-                	}
-                    jobQueue.jobs_.push_back(job);
-                    continue;
-                }
             }
             else
             {
@@ -122,19 +246,106 @@ void JobSystem::Work(JobQueue& jobQueue)
             }
         }// !CRITICAL
         job->Execute();
+        --scheduledJobs_;
+    }
+}
+
+Job* JobSystem::PopOtherJob()
+{
+    const auto workStealingQueuesNmb = workStealingQueues_.size();
+    const bool isWorker = currentJobSystem == this;
+    const auto workerIndex = isWorker ? currentWorkerIndex : 0;
+    Job* job = isWorker ? workStealingQueues_[workerIndex]->Pop() : nullptr;
+    if (job == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(jobs_.mutex_);
+        if (!jobs_.jobs_.empty())
+        {
+            job = jobs_.jobs_.back();
+            jobs_.jobs_.pop_back();
+        }
+    }
+    for (std::size_t i = isWorker ? 1 : 0; job == nullptr && i < workStealingQueuesNmb; i++)
+    {
+        job = workStealingQueues_[(workerIndex + i) % workStealingQueuesNmb]->Steal();
+    }
+    if (job != nullptr)
+    {
+        --queuedOtherJobs_;
+    }
+    return job;
+}
+
+void JobSystem::WaitJob(const Job* job)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Wait Job");
+#endif
+    while (!job->IsDone())
+    {
+        Job* otherJob = IsRunning() ? PopOtherJob() : nullptr;
+        if (otherJob != nullptr)
+        {
+            otherJob->Execute();
+            --scheduledJobs_;
+        }
+        else if (job->HasStarted())
+        {
+            job->Join();
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::WorkStealing(std::size_t workerIndex)
+{
+    currentJobSystem = this;
+    currentWorkerIndex = workerIndex;
+    {
+        std::lock_guard<std::mutex> lock(statusMutex_);
+        ++workersStarted_;
+    }
+    while (IsRunning())
+    {
+        Job* job = PopOtherJob();
+        if (job == nullptr)
+        {
+#ifdef EASY_PROFILE_USE
+            EASY_BLOCK("Wait for Jobs");
+#endif
+            std::unique_lock<std::mutex> lock(jobs_.mutex_);
+            jobs_.cv_.wait(lock, [this]
+            {
+                return queuedOtherJobs_.load() > 0 || !IsRunning();
+            });
+            continue;
+        }
+        job->Execute();
+        --scheduledJobs_;
     }
+    currentJobSystem = nullptr;
 }
 
 void JobSystem::Init()
 {
     status_ = RUNNING;
-    const auto& config = BasicEngine::GetInstance()->GetConfig();
+    auto* engine = BasicEngine::GetInstance();
+    const auto workerNumber = engine != nullptr ? engine->GetConfig().workerNumber : 0u;
     const auto minWorkerNumber = 3u;
-    numberOfWorkers = config.workerNumber < minWorkerNumber ?
+    numberOfWorkers = workerNumber < minWorkerNumber ?
             std::max(minWorkerNumber, std::thread::hardware_concurrency() - 1):
-            config.workerNumber;
+            workerNumber;
 
     workers_.resize(numberOfWorkers);
+    const auto otherWorkersNmb = numberOfWorkers - static_cast<std::size_t>(JobThreadType::OTHER_THREAD);
+    workStealingQueues_.resize(otherWorkersNmb);
+    for (auto& workStealingQueue : workStealingQueues_)
+    {
+        workStealingQueue = std::make_unique<WorkStealingQueue>();
+    }
 
     const size_t len = numberOfWorkers;
     for (size_t i = 0; i < len; ++i)
@@ -153,7 +364,8 @@ void JobSystem::Init()
             }
             default:
             {
-                workers_[i] = std::thread([this] { Work(jobs_); }); // Kick the thread => sys call
+                const auto workerIndex = i - static_cast<std::size_t>(JobThreadType::OTHER_THREAD);
+                workers_[i] = std::thread([this, workerIndex] { WorkStealing(workerIndex); }); // Kick the thread => sys call
                 break;
             }
         }
@@ -168,29 +380,34 @@ void JobSystem::Destroy()
     {
         std::lock_guard<std::mutex> lock(statusMutex_);
         return workersStarted_ != numberOfWorkers ||
-                  !jobs_.jobs_.empty() ||
-                  !renderJobs_.jobs_.empty() ||
-                  !resourceJobs_.jobs_.empty();
+                  scheduledJobs_.load() != 0;
     };
     while (checkFunc())
     {
         std::this_thread::sleep_for(std::chrono::milliseconds (1));
     }
     status_ = NONE;
-    renderJobs_.cv_.notify_all();
-    resourceJobs_.cv_.notify_all();
-	jobs_.cv_.notify_all(); // Wake all workers.
+    auto wakeWorkers = [](JobQueue& jobQueue)
+    {
+        std::lock_guard<std::mutex> lock(jobQueue.mutex_);
+        jobQueue.cv_.notify_all();
+    };
+    wakeWorkers(renderJobs_);
+    wakeWorkers(resourceJobs_);
+	wakeWorkers(jobs_); // Wake all workers.
     const size_t len = numberOfWorkers;
     for (size_t i = 0; i < len; ++i)
     {
         workers_[i].join(); // Join all workers.
     }
+    workers_.clear();
+    workStealingQueues_.clear();
+    workersStarted_ = 0;
 }
 
 bool JobSystem::IsRunning() const
 {
-    std::lock_guard<std::mutex> lock(statusMutex_);
-    return status_ & Status::RUNNING;
+    return status_.load() & Status::RUNNING;
 }
 std::uint8_t JobSystem::CountStartedWorkers() const
 {
@@ -198,10 +415,10 @@ std::uint8_t JobSystem::CountStartedWorkers() const
     return workersStarted_;
 }
 
-Job::Job(std::function<void()> task) :
-        task_(std::move(task)),
-        taskDoneFuture_(promise_.get_future()),
-        status_(0)
+Job::DependencyNode Job::closedDependents_;
+
+Job::Job(Task task) :
+        task_(std::move(task))
 {
 
 }
@@ -209,58 +426,117 @@ Job::Job(std::function<void()> task) :
 Job::Job(Job&& job) noexcept
 {
     dependencies_ = std::move(job.dependencies_);
+    dependents_ = job.dependents_.load();
     task_ = std::move(job.task_);
-    status_ = job.status_;
-    promise_ = std::move(job.promise_);
-    taskDoneFuture_ = std::move(job.taskDoneFuture_);
+    status_ = job.status_.load();
+    unfinishedDependencies_ = job.unfinishedDependencies_.load();
+    jobSystem_ = job.jobSystem_;
+    threadType_ = job.threadType_;
 }
 
 Job& Job::operator=(Job&& job) noexcept
 {
     dependencies_ = std::move(job.dependencies_);
+    dependents_ = job.dependents_.load();
     task_ = std::move(job.task_);
-    status_ = job.status_;
+    status_ = job.status_.load();
+    unfinishedDependencies_ = job.unfinishedDependencies_.load();
+    jobSystem_ = job.jobSystem_;
+    threadType_ = job.threadType_;
     return *this;
 }
 
 void Job::Join() const
 {
-    if(!IsDone())
+    auto status = status_.load(std::memory_order_acquire);
+    while (!(status & DONE))
     {
-        taskDoneFuture_.get();
+        if (!(status & WAITING))
+        {
+            status = status_.fetch_or(WAITING, std::memory_order_acq_rel) | WAITING;
+            continue;
+        }
+        WaitStatus(status_, status);
+        status = status_.load(std::memory_order_acquire);
     }
 }
 
 
 void Job::Execute()
 {
+    //Only needed when the job is not executed by the JobSystem
     for (auto& dep : dependencies_)
     {
-        if (!dep->IsDone())
+        if (!dep.dependency->IsDone())
         {
-            dep->Join();
+            dep.dependency->Join();
         }
     }
 
+    status_.fetch_or(STARTED, std::memory_order_acq_rel);
+    task_();
+    //Close the dependents list, jobs scheduled after that will see the task as done
+    auto* node = dependents_.exchange(&closedDependents_, std::memory_order_acq_rel);
+    while (node != nullptr)
     {
-        std::lock_guard<std::mutex> lock(statusLock_);
-        status_ |= STARTED;
+        //The node belongs to the dependent that can be executed as soon as it is notified
+        auto* next = node->next;
+        node->dependent->OnDependencyDone();
+        node = next;
     }
-    task_();
+    //The job can be destroyed by a joining thread as soon as DONE is set
+    auto* status = &status_;
+    if (status->fetch_or(DONE, std::memory_order_acq_rel) & WAITING)
     {
-        std::lock_guard<std::mutex> lock(statusLock_);
-        status_ |= DONE;
+        WakeStatus(*status);
+    }
+}
+
+bool Job::AddDependent(DependencyNode* node) const
+{
+    auto* head = dependents_.load(std::memory_order_acquire);
+    do
+    {
+        if (head == &closedDependents_)
+        {
+            return false;
+        }
+        node->next = head;
+    } while (!dependents_.compare_exchange_weak(head, node,
+                                                std::memory_order_acq_rel, std::memory_order_acquire));
+    return true;
+}
+
+bool Job::RegisterToDependencies(JobSystem* jobSystem, JobThreadType threadType)
+{
+    jobSystem_ = jobSystem;
+    threadType_ = threadType;
+    //One extra count so that the job is not pushed while still registering
+    unfinishedDependencies_ = static_cast<int>(dependencies_.size()) + 1;
+    for (auto& dep : dependencies_)
+    {
+        dep.dependent = this;
+        if (!dep.dependency->AddDependent(&dep))
+        {
+            --unfinishedDependencies_;
+        }
+    }
+    return unfinishedDependencies_.fetch_sub(1) == 1;
+}
+
+void Job::OnDependencyDone()
+{
+    if (unfinishedDependencies_.fetch_sub(1) == 1)
+    {
+        jobSystem_->EnqueueReadyJob(this, threadType_);
     }
-    promise_.set_value();
 }
 
 bool Job::CheckDependenciesStarted() const
 {
-    if (dependencies_.empty())
-        return true;
 	for(const auto& dep : dependencies_)
 	{
-		if(!dep->HasStarted())
+		if(!dep.dependency->HasStarted())
             return false;
 	}
     return true;
@@ -268,50 +544,90 @@ bool Job::CheckDependenciesStarted() const
 
 bool Job::HasStarted() const
 {
-    std::lock_guard<std::mutex> lock(statusLock_);
-    return status_ & STARTED;
+    return status_.load(std::memory_order_acquire) & STARTED;
 }
 
 bool Job::IsDone() const
 {
-    std::lock_guard<std::mutex> lock(statusLock_);
-    return status_ & DONE;
+    return status_.load(std::memory_order_acquire) & DONE;
 }
 
 void Job::AddDependency(const Job* dependentJob)
 {
+#ifdef __neko_dbg__
 #ifdef EASY_PROFILE_USE
     EASY_BLOCK("Jobsystem Add Dependency");
 #endif
-    //Be sure to not create a cycle of dependencies which would deadlock the thread
-	//Also check if the dependencies is not already in the dependency tree
-    std::function<bool(const std::vector<const Job*>&, const Job*)> checkDependencies =
-            [&checkDependencies, dependentJob](const std::vector<const Job*>& dependencies, const Job* job) {
-                for(const auto& dep : dependencies)
-                {
-                    if(dep == job || dep == dependentJob)
-                        return false;
-                    const bool recursiveDep = checkDependencies(dep->dependencies_, job);
-                    if(!recursiveDep)
-                        return false;
-                }
-                return true;
-            };
-    if(checkDependencies(dependencies_, this))
+    //Be sure to not create a cycle of dependencies which would deadlock the thread,
+    //walking the dependency tree is only done in debug, the TaskGraph checks cycles when built
+    neko_assert(!dependentJob->IsInDependencyTree(this), "Job dependency would create a cycle");
+    //Also check if the dependency is not already in the dependency tree
+    if (IsInDependencyTree(dependentJob))
     {
-        dependencies_.push_back(dependentJob);
+        return;
     }
+#endif
+    dependencies_.push_back({dependentJob, this, nullptr});
+}
+
+bool Job::IsInDependencyTree(const Job* job) const
+{
+    //Reused buffers keep the capacity of the previous walks, AddDependency is called every frame in debug
+    thread_local std::vector<const Job*> visitedJobs;
+    thread_local std::vector<const Job*> jobsToVisit;
+    visitedJobs.clear();
+    jobsToVisit.clear();
+    jobsToVisit.push_back(this);
+    while (!jobsToVisit.empty())
+    {
+        const auto* currentJob = jobsToVisit.back();
+        jobsToVisit.pop_back();
+        if (currentJob == job)
+        {
+            return true;
+        }
+        if (std::find(visitedJobs.cbegin(), visitedJobs.cend(), currentJob) != visitedJobs.cend())
+        {
+            continue;
+        }
+        visitedJobs.push_back(currentJob);
+        for (const auto& dep : currentJob->dependencies_)
+        {
+            jobsToVisit.push_back(dep.dependency);
+        }
+    }
+    return false;
+}
+
+bool Job::AreDependenciesDone() const
+{
+    for (const auto& dep : dependencies_)
+    {
+        if (!dep.dependency->IsDone())
+            return false;
+    }
+    return true;
 }
 
 void Job::Reset()
 {
-    promise_ = std::promise<void>();
-    taskDoneFuture_ = promise_.get_future();
     status_ = NONE;
+    //Keeps the capacity of the dependencies to not allocate when reused
     dependencies_.clear();
+    dependents_ = nullptr;
+    unfinishedDependencies_ = 0;
 }
 
-
-
+Job* JobPool::CreateJob(Job::Task task)
+{
+    if (jobsUsed_ == jobs_.size())
+    {
+        jobs_.push_back(std::make_unique<Job>());
+    }
+    auto* job = jobs_[jobsUsed_++].get();
+    job->Reset();
+    job->SetTask(std::move(task));
+    return job;
+}
 
 }
@@ -0,0 +1,150 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "engine/task_graph.h"
+
+#include <algorithm>
+
+#include "engine/assert.h"
+#include "engine/log.h"
+
+#ifdef EASY_PROFILE_USE
+#include <easy/profiler.h>
+#endif
+
+namespace neko
+{
+
+TaskGraph::NodeIndex TaskGraph::AddNode(std::string_view name, Job::Task task, JobThreadType threadType)
+{
+    isBuilt_ = false;
+    nodes_.push_back({std::string(name), std::make_unique<Job>(std::move(task)), threadType, {}});
+    return nodes_.size() - 1;
+}
+
+void TaskGraph::AddEdge(NodeIndex from, NodeIndex to)
+{
+    neko_assert(from < nodes_.size() && to < nodes_.size(), "Task graph edge with invalid node");
+    isBuilt_ = false;
+    auto& dependencies = nodes_[to].dependencies;
+    if (std::find(dependencies.cbegin(), dependencies.cend(), from) == dependencies.cend())
+    {
+        dependencies.push_back(from);
+    }
+}
+
+void TaskGraph::AddEdge(std::string_view from, std::string_view to)
+{
+    AddEdge(GetNodeIndex(from), GetNodeIndex(to));
+}
+
+TaskGraph::NodeIndex TaskGraph::GetNodeIndex(std::string_view name) const
+{
+    const auto it = std::find_if(nodes_.cbegin(), nodes_.cend(), [name](const Node& node)
+    {
+        return node.name == name;
+    });
+    if (it == nodes_.cend())
+    {
+        return INVALID_NODE;
+    }
+    return static_cast<NodeIndex>(std::distance(nodes_.cbegin(), it));
+}
+
+bool TaskGraph::Build()
+{
+    //Kahn's algorithm, the nodes left with dependencies are part of a cycle
+    const auto nodesNmb = nodes_.size();
+    std::vector<std::size_t> remainingDependencies(nodesNmb);
+    std::vector<std::vector<NodeIndex>> dependents(nodesNmb);
+    for (NodeIndex i = 0; i < nodesNmb; i++)
+    {
+        remainingDependencies[i] = nodes_[i].dependencies.size();
+        for (const auto dependency : nodes_[i].dependencies)
+        {
+            dependents[dependency].push_back(i);
+        }
+    }
+    sortedNodes_.clear();
+    sortedNodes_.reserve(nodesNmb);
+    for (NodeIndex i = 0; i < nodesNmb; i++)
+    {
+        if (remainingDependencies[i] == 0)
+        {
+            sortedNodes_.push_back(i);
+        }
+    }
+    for (std::size_t i = 0; i < sortedNodes_.size(); i++)
+    {
+        for (const auto dependent : dependents[sortedNodes_[i]])
+        {
+            if (--remainingDependencies[dependent] == 0)
+            {
+                sortedNodes_.push_back(dependent);
+            }
+        }
+    }
+    isBuilt_ = sortedNodes_.size() == nodesNmb;
+    if (!isBuilt_)
+    {
+        logDebug("[Error] Task graph contains a cycle");
+        sortedNodes_.clear();
+    }
+    return isBuilt_;
+}
+
+void TaskGraph::Schedule(JobSystem& jobSystem)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Schedule Task Graph");
+#endif
+    neko_assert(isBuilt_, "Task graph needs to be built before being scheduled");
+    for (const auto nodeIndex : sortedNodes_)
+    {
+        auto& node = nodes_[nodeIndex];
+        node.job->Reset();
+        for (const auto dependency : node.dependencies)
+        {
+            node.job->AddDependency(nodes_[dependency].job.get());
+        }
+    }
+    //Topological order so that main thread jobs never wait for a job not scheduled yet
+    for (const auto nodeIndex : sortedNodes_)
+    {
+        jobSystem.ScheduleJob(nodes_[nodeIndex].job.get(), nodes_[nodeIndex].threadType);
+    }
+}
+
+void TaskGraph::Join(JobSystem& jobSystem) const
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Join Task Graph");
+#endif
+    for (const auto& node : nodes_)
+    {
+        jobSystem.WaitJob(node.job.get());
+    }
+}
+
+}
@@ -91,10 +91,10 @@ Vec2f Transform2dManager::GetScale(Entity entity) const
     return scaleManager_.GetComponent(entity);
 }
 
-void Transform2dManager::OnChangeParent(Entity entity, [[maybe_unused]] Entity newParent, [[maybe_unused]] Entity oldParent)
+void Transform2dManager::OnChangeParent(Entity entity, Entity newParent, Entity oldParent)
 {
     //TODO change local transform to not change the global transform when changing parent
-    dirtyManager_.SetDirty(entity);
+    dirtyManager_.OnChangeParent(entity, newParent, oldParent);
 }
 
 void Transform2dManager::UpdateDirtyComponent(Entity entity)
@@ -147,7 +147,7 @@ Transform3dManager::Transform3dManager(EntityManager& entityManager) :
 	dirtyManager_(entityManager)
 {
 	entityManager_.get().RegisterOnChangeParent(this);
-	dirtyManager_.RegisterComponentManager(this);
+	dirtyManager_.RegisterBatchComponentManager(this);
 }
 
 void Transform3dManager::Init()
@@ -236,9 +236,9 @@ EulerAngles Transform3dManager::GetAngles(Entity entity) const
 	return rotation3DManager_.GetComponent(entity);
 }
 
-void Transform3dManager::OnChangeParent(Entity entity, [[maybe_unused]] Entity newParent, [[maybe_unused]] Entity oldParent)
+void Transform3dManager::OnChangeParent(Entity entity, Entity newParent, Entity oldParent)
 {
-	dirtyManager_.SetDirty(entity);
+	dirtyManager_.OnChangeParent(entity, newParent, oldParent);
 }
 
 void Transform3dManager::UpdateDirtyComponent(Entity entity)
@@ -246,6 +246,35 @@ void Transform3dManager::UpdateDirtyComponent(Entity entity)
 	UpdateTransform(entity);
 }
 
+void Transform3dManager::UpdateDirtyComponents(const Entity* entities, size_t count)
+{
+	batchPositions_.resize(count);
+	batchAngles_.resize(count);
+	batchScales_.resize(count);
+	batchTransforms_.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		batchPositions_[i] = position3DManager_.GetComponent(entities[i]);
+		batchAngles_[i] = rotation3DManager_.GetComponent(entities[i]);
+		batchScales_[i] = scale3DManager_.GetComponent(entities[i]);
+	}
+	Transform3d::ComputeTransforms(batchPositions_.data(), batchAngles_.data(), batchScales_.data(),
+		batchTransforms_.data(), count);
+	for (size_t i = 0; i < count; i++)
+	{
+		//Parents have a lower depth, they are already updated
+		const auto parent = entityManager_.get().GetEntityParent(entities[i]);
+		if (parent != INVALID_ENTITY)
+		{
+			SetComponent(entities[i], GetComponent(parent) * batchTransforms_[i]);
+		}
+		else
+		{
+			SetComponent(entities[i], batchTransforms_[i]);
+		}
+	}
+}
+
 void Transform3dManager::Update()
 {
 #ifdef EASY_PROFILE_USE
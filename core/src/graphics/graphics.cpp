@@ -106,48 +106,26 @@ void Renderer::PreRender()
 #ifdef EASY_PROFILE_USE
     EASY_BLOCK("Renderer Pre Render");
 #endif
-    using namespace std::chrono_literals;
-    microseconds availableLoadingTime(8000);
-    bool preRenderJobEmpty = false;
+    const microseconds availableLoadingTime(8000);
+    const auto start = std::chrono::system_clock::now();
+    while (std::chrono::system_clock::now() - start < availableLoadingTime)
     {
-        std::lock_guard<std::mutex> lock(preRenderJobsMutex_);
-        if (preRenderJobs_.empty())
-        {
-            preRenderJobEmpty = true;
-        }
-    }
-    while (!preRenderJobEmpty && availableLoadingTime < 8001us)
-    {
-        std::chrono::time_point<std::chrono::system_clock> start =
-            std::chrono::system_clock::now();
-
-
         Job* job = nullptr;
         {
+            //Jobs waiting for their dependencies stay in the queue instead of blocking the render thread
             std::lock_guard<std::mutex> lock(preRenderJobsMutex_);
-            if (!preRenderJobs_.empty())
+            const auto it = std::find_if(preRenderJobs_.begin(), preRenderJobs_.end(), [](const Job* preRenderJob)
             {
-                job = preRenderJobs_.front();
-                preRenderJobs_.erase(preRenderJobs_.begin());
-            }
-            else
+                return preRenderJob->AreDependenciesDone();
+            });
+            if (it == preRenderJobs_.end())
             {
-                preRenderJobEmpty = true;
+                break;
             }
+            job = *it;
+            preRenderJobs_.erase(it);
         }
-
-        if (job != nullptr && job->CheckDependenciesStarted())
-        {
-            job->Execute();
-        }
-        else
-        {
-            break;
-        }
-
-        std::chrono::time_point<std::chrono::system_clock> end = std::chrono::system_clock::now();
-        const auto duration = std::chrono::duration_cast<microseconds>(end - start);
-        availableLoadingTime -= duration;
+        job->Execute();
     }
 }
 
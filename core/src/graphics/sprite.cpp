@@ -0,0 +1,119 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "graphics/sprite.h"
+
+#include <array>
+#include <utility>
+
+#ifdef EASY_PROFILE_USE
+#include <easy/profiler.h>
+#endif
+
+namespace neko
+{
+
+void SpriteBatcher::Clear()
+{
+    sortKeys_.clear();
+    sprites_.clear();
+    instances_.clear();
+    batches_.clear();
+}
+
+void SpriteBatcher::Reserve(std::size_t spritesNmb)
+{
+    sortKeys_.reserve(spritesNmb);
+    sortKeysBuffer_.reserve(spritesNmb);
+    sprites_.reserve(spritesNmb);
+    instances_.reserve(spritesNmb);
+}
+
+void SpriteBatcher::AddSprite(TextureKey texture, const Mat4f& model, const Color4& color)
+{
+    const auto index = static_cast<std::uint64_t>(sprites_.size());
+    sortKeys_.push_back(static_cast<std::uint64_t>(texture) << 32u | index);
+    sprites_.push_back({model, color});
+}
+
+void SpriteBatcher::Build()
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Build Sprite Batches");
+#endif
+    //LSD radix sort on the texture bytes, stable so the submission order is kept
+    bool isSorted = true;
+    sortKeysBuffer_.resize(sortKeys_.size());
+    for (unsigned shift = 32; shift < 64 && !sortKeys_.empty(); shift += 8)
+    {
+        std::array<std::uint32_t, 256> offsets{};
+        for (const auto key : sortKeys_)
+        {
+            offsets[(key >> shift) & 0xFFu]++;
+        }
+        //All the keys share this byte, nothing to move
+        if (offsets[(sortKeys_[0] >> shift) & 0xFFu] == sortKeys_.size())
+        {
+            continue;
+        }
+        std::uint32_t offset = 0;
+        for (auto& count : offsets)
+        {
+            const auto bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+        for (const auto key : sortKeys_)
+        {
+            sortKeysBuffer_[offsets[(key >> shift) & 0xFFu]++] = key;
+        }
+        std::swap(sortKeys_, sortKeysBuffer_);
+        isSorted = false;
+    }
+    batches_.clear();
+    if (isSorted)
+    {
+        //Sprites already submitted by texture, no need to reorder them
+        std::swap(instances_, sprites_);
+    }
+    else
+    {
+        instances_.clear();
+        for (const auto key : sortKeys_)
+        {
+            instances_.push_back(sprites_[static_cast<std::uint32_t>(key)]);
+        }
+    }
+    for (std::size_t i = 0; i < sortKeys_.size(); i++)
+    {
+        const auto texture = static_cast<TextureKey>(sortKeys_[i] >> 32u);
+        if (batches_.empty() || batches_.back().texture != texture)
+        {
+            batches_.push_back({texture, static_cast<std::uint32_t>(i), 0});
+        }
+        batches_.back().count++;
+    }
+}
+
+}
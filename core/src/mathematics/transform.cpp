@@ -28,9 +28,169 @@
 #include "mathematics/const.h"
 #include "mathematics/angle.h"
 #include "mathematics/quaternion.h"
+#include "mathematics/vector_nvec.h"
 
 namespace neko::Transform3d
 {
+namespace
+{
+#if defined(__AVX2__)
+constexpr int transformBatchSize = 8;
+inline __m256 Load(const float* values) { return _mm256_load_ps(values); }
+inline void Store(float* values, __m256 v) { _mm256_store_ps(values, v); }
+inline __m256 Set(float value) { return _mm256_set1_ps(value); }
+inline __m256 Add(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+inline __m256 Sub(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+inline __m256 Mul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+inline __m256 Min(__m256 a, __m256 b) { return _mm256_min_ps(a, b); }
+inline __m256 Max(__m256 a, __m256 b) { return _mm256_max_ps(a, b); }
+inline __m256 Round(__m256 a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+#elif defined(__SSE__)
+constexpr int transformBatchSize = 4;
+inline __m128 Load(const float* values) { return _mm_load_ps(values); }
+inline void Store(float* values, __m128 v) { _mm_store_ps(values, v); }
+inline __m128 Set(float value) { return _mm_set1_ps(value); }
+inline __m128 Add(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+inline __m128 Sub(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+inline __m128 Mul(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+inline __m128 Min(__m128 a, __m128 b) { return _mm_min_ps(a, b); }
+inline __m128 Max(__m128 a, __m128 b) { return _mm_max_ps(a, b); }
+inline __m128 Round(__m128 a) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(a)); }
+#elif defined(__arm__) || defined(__aarch64__)
+//GCC vector extensions are lowered to NEON
+constexpr int transformBatchSize = 4;
+inline v4f Load(const float* values) { return *reinterpret_cast<const v4f*>(values); }
+inline void Store(float* values, v4f v) { *reinterpret_cast<v4f*>(values) = v; }
+inline v4f Set(float value) { return v4f{value, value, value, value}; }
+inline v4f Add(v4f a, v4f b) { return a + b; }
+inline v4f Sub(v4f a, v4f b) { return a - b; }
+inline v4f Mul(v4f a, v4f b) { return a * b; }
+inline v4f Min(v4f a, v4f b) { return a < b ? a : b; }
+inline v4f Max(v4f a, v4f b) { return a > b ? a : b; }
+inline v4f Round(v4f a)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        a[i] = std::nearbyint(a[i]);
+    }
+    return a;
+}
+#endif
+
+#if defined(__SSE__) || defined(__arm__) || defined(__aarch64__)
+using TransformVec3 = NVec3<float, transformBatchSize>;
+
+/**
+ * \brief Sine of each lane, the angle is reduced to [-PI/2, PI/2] and the Taylor series
+ * to the 11th order is below float precision on this range
+ */
+template<typename Register>
+Register SinLanes(Register angle)
+{
+    //Reduce to [-PI, PI]
+    angle = Sub(angle, Mul(Set(2.0f * PI), Round(Mul(angle, Set(1.0f / (2.0f * PI))))));
+    //sin(x) = sin(PI - x) = sin(-PI - x)
+    angle = Min(angle, Sub(Set(PI), angle));
+    angle = Max(angle, Sub(Set(-PI), angle));
+    const auto angle2 = Mul(angle, angle);
+    auto result = Set(-1.0f / 39916800.0f);
+    result = Add(Mul(result, angle2), Set(1.0f / 362880.0f));
+    result = Add(Mul(result, angle2), Set(-1.0f / 5040.0f));
+    result = Add(Mul(result, angle2), Set(1.0f / 120.0f));
+    result = Add(Mul(result, angle2), Set(-1.0f / 6.0f));
+    result = Add(Mul(result, angle2), Set(1.0f));
+    return Mul(result, angle);
+}
+
+/**
+ * \brief Compute transformBatchSize transforms with one instruction for all the entities,
+ * only the loads and stores of the components are done per entity
+ */
+void ComputeTransformsBatch(const Vec3f* positions, const EulerAngles* angles, const Vec3f* scales, Mat4f* transforms)
+{
+    constexpr int n = transformBatchSize;
+    const TransformVec3 scale(scales);
+    TransformVec3 halfAngles;
+    for (int i = 0; i < n; i++)
+    {
+        halfAngles.xs[i] = radian_t(angles[i].x * 0.5f).value();
+        halfAngles.ys[i] = radian_t(angles[i].y * 0.5f).value();
+        halfAngles.zs[i] = radian_t(angles[i].z * 0.5f).value();
+    }
+    const auto halfPi = Set(PI * 0.5f);
+    const auto halfX = Load(halfAngles.xs.data());
+    const auto halfY = Load(halfAngles.ys.data());
+    const auto halfZ = Load(halfAngles.zs.data());
+    const auto sy = SinLanes(halfX);
+    const auto sp = SinLanes(halfY);
+    const auto sr = SinLanes(halfZ);
+    const auto cy = SinLanes(Add(halfX, halfPi));
+    const auto cp = SinLanes(Add(halfY, halfPi));
+    const auto cr = SinLanes(Add(halfZ, halfPi));
+    //Same terms as Quaternion::FromEuler
+    const auto cycp = Mul(cy, cp);
+    const auto sysp = Mul(sy, sp);
+    const auto sycp = Mul(sy, cp);
+    const auto cysp = Mul(cy, sp);
+    const auto qx = Add(Mul(cycp, cr), Mul(sysp, sr));
+    const auto qy = Sub(Mul(cycp, sr), Mul(sysp, cr));
+    const auto qz = Add(Mul(sycp, sr), Mul(cysp, cr));
+    const auto qw = Sub(Mul(sycp, cr), Mul(cysp, sr));
+
+    //Same matrix as RotationMatrixFrom(quaternion) for a unit quaternion, each row scaled
+    const auto one = Set(1.0f);
+    const auto two = Set(2.0f);
+    const auto xx = Mul(qx, qx);
+    const auto yy = Mul(qy, qy);
+    const auto zz = Mul(qz, qz);
+    const auto xy = Mul(qx, qy);
+    const auto xz = Mul(qx, qz);
+    const auto yz = Mul(qy, qz);
+    const auto wx = Mul(qw, qx);
+    const auto wy = Mul(qw, qy);
+    const auto wz = Mul(qw, qz);
+    const auto scaleX = Load(scale.xs.data());
+    const auto scaleY = Load(scale.ys.data());
+    const auto scaleZ = Load(scale.zs.data());
+    alignas(n * sizeof(float)) std::array<std::array<float, n>, 9> m{};
+    Store(m[0].data(), Mul(scaleX, Sub(one, Mul(two, Add(yy, zz)))));
+    Store(m[1].data(), Mul(scaleY, Mul(two, Sub(xy, wz))));
+    Store(m[2].data(), Mul(scaleZ, Mul(two, Add(xz, wy))));
+    Store(m[3].data(), Mul(scaleX, Mul(two, Add(xy, wz))));
+    Store(m[4].data(), Mul(scaleY, Sub(one, Mul(two, Add(xx, zz)))));
+    Store(m[5].data(), Mul(scaleZ, Mul(two, Sub(yz, wx))));
+    Store(m[6].data(), Mul(scaleX, Mul(two, Sub(xz, wy))));
+    Store(m[7].data(), Mul(scaleY, Mul(two, Add(yz, wx))));
+    Store(m[8].data(), Mul(scaleZ, Sub(one, Mul(two, Add(xx, yy)))));
+    for (int i = 0; i < n; i++)
+    {
+        transforms[i] = Mat4f(std::array<Vec4f, 4>{
+            Vec4f(m[0][i], m[1][i], m[2][i], 0.0f),
+            Vec4f(m[3][i], m[4][i], m[5][i], 0.0f),
+            Vec4f(m[6][i], m[7][i], m[8][i], 0.0f),
+            Vec4f(positions[i].x, positions[i].y, positions[i].z, 1.0f)});
+    }
+}
+#endif
+}
+
+void ComputeTransforms(const Vec3f* positions, const EulerAngles* angles, const Vec3f* scales,
+                       Mat4f* transforms, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(__SSE__) || defined(__arm__) || defined(__aarch64__)
+    for (; i + transformBatchSize <= count; i += transformBatchSize)
+    {
+        ComputeTransformsBatch(positions + i, angles + i, scales + i, transforms + i);
+    }
+#endif
+    for (; i < count; i++)
+    {
+        Mat4f transform = Rotate(Mat4f::Identity, angles[i]);
+        transform = Scale(transform, scales[i]);
+        transforms[i] = Translate(transform, positions[i]);
+    }
+}
 
 
 Mat4f const TranslationMatrixFrom(const Vec3f translation)
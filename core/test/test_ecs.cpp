@@ -22,9 +22,12 @@
  SOFTWARE.
  */
 
+#include <algorithm>
+
 #include <gtest/gtest.h>
 #include <engine/entity.h>
 #include <engine/transform.h>
+#include <engine/sparse_component.h>
 
 TEST(Entity, EntityManager)
 {
@@ -68,3 +71,173 @@ TEST(Entity, EntityManager)
     EXPECT_EQ(entityManager.GetLastEntity(), entityNmb-1);
 }
 
+
+TEST(Entity, EntityFreeList)
+{
+    neko::EntityManager entityManager;
+    const size_t entityNmb = 100u;
+    const auto entities = entityManager.CreateEntities(entityNmb);
+    ASSERT_EQ(entities.size(), entityNmb);
+    for (neko::Index i = 0u; i < entityNmb; i++)
+    {
+        EXPECT_EQ(entities[i], i);
+    }
+    EXPECT_EQ(entityManager.GetEntitiesNmb(), entityNmb);
+
+    const auto handle = entityManager.GetEntityHandle(42);
+    EXPECT_TRUE(entityManager.IsEntityHandleValid(handle));
+    EXPECT_EQ(neko::EntityManager::GetEntity(handle), 42u);
+
+    //The lowest free entity is reused whatever the destruction order
+    entityManager.DestroyEntities({ 57, 42, 90 });
+    EXPECT_EQ(entityManager.GetEntitiesNmb(), entityNmb - 3);
+    EXPECT_FALSE(entityManager.IsEntityHandleValid(handle));
+    EXPECT_EQ(entityManager.CreateEntity(), 42u);
+    EXPECT_FALSE(entityManager.IsEntityHandleValid(handle));
+    EXPECT_NE(entityManager.GetEntityHandle(42), handle);
+    EXPECT_EQ(entityManager.GetEntityGeneration(42), 1u);
+
+    //An entity created with an explicit index is not given again
+    EXPECT_EQ(entityManager.CreateEntity(90), 90u);
+    EXPECT_EQ(entityManager.CreateEntity(), 57u);
+    EXPECT_EQ(entityManager.CreateEntity(), entityNmb);
+    EXPECT_EQ(entityManager.GetEntitiesNmb(), entityNmb + 1);
+}
+
+TEST(Entity, ExplicitEntityFreeList)
+{
+    neko::EntityManager entityManager;
+    //Rollback recreates destroyed entities with their index, the free list must not get duplicates
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(entityManager.CreateEntity(5), 5u);
+        entityManager.DestroyEntity(5);
+    }
+    std::vector<neko::Entity> entities;
+    for (neko::Index i = 0u; i < neko::INIT_ENTITY_NMB + 1; i++)
+    {
+        entities.push_back(entityManager.CreateEntity());
+    }
+    std::sort(entities.begin(), entities.end());
+    EXPECT_EQ(std::adjacent_find(entities.begin(), entities.end()), entities.end());
+    EXPECT_EQ(entityManager.GetEntitiesNmb(), neko::INIT_ENTITY_NMB + 1);
+}
+
+namespace
+{
+using SparsePositionManager = neko::SparseComponentManager<neko::Vec3f, neko::EntityMask(neko::ComponentType::POSITION3D)>;
+using SparseScaleManager = neko::SparseComponentManager<neko::Vec3f, neko::EntityMask(neko::ComponentType::SCALE3D)>;
+}
+
+TEST(Entity, SparseComponentManager)
+{
+    neko::EntityManager entityManager;
+    SparsePositionManager positionManager(entityManager);
+    const neko::Index entityNmb = 64u;
+    for (neko::Index i = 0u; i < entityNmb; i++)
+    {
+        const auto entity = entityManager.CreateEntity();
+        if (entity % 4 == 0)
+        {
+            positionManager.AddComponent(entity);
+            positionManager.SetComponent(entity, neko::Vec3f(float(entity), 0.0f, 0.0f));
+        }
+    }
+    EXPECT_EQ(positionManager.GetComponentsNmb(), entityNmb / 4);
+    EXPECT_EQ(entityManager.GetEntitiesNmb(neko::EntityMask(neko::ComponentType::POSITION3D)), entityNmb / 4);
+
+    //Destroying a component moves the last one in its place
+    positionManager.DestroyComponent(0);
+    entityManager.DestroyEntity(8);
+    EXPECT_FALSE(positionManager.HasComponent(0));
+    EXPECT_FALSE(positionManager.HasComponent(8));
+    EXPECT_FALSE(entityManager.HasComponent(0, neko::EntityMask(neko::ComponentType::POSITION3D)));
+    EXPECT_EQ(positionManager.GetComponentsNmb(), entityNmb / 4 - 2);
+    for (neko::Index i = 0u; i < positionManager.GetComponentsNmb(); i++)
+    {
+        const auto entity = positionManager.GetEntities()[i];
+        EXPECT_EQ(entity % 4, 0);
+        EXPECT_EQ(positionManager.GetComponentsVector()[i].x, float(entity));
+        EXPECT_EQ(positionManager.GetComponent(entity).x, float(entity));
+    }
+}
+
+TEST(Entity, SparseComponentView)
+{
+    neko::EntityManager entityManager;
+    SparsePositionManager positionManager(entityManager);
+    SparseScaleManager scaleManager(entityManager);
+    const neko::Index entityNmb = 1'000u;
+    for (neko::Index i = 0u; i < entityNmb; i++)
+    {
+        const auto entity = entityManager.CreateEntity();
+        if (entity % 2 == 0)
+        {
+            positionManager.AddComponent(entity);
+            positionManager.SetComponent(entity, neko::Vec3f::one);
+        }
+        if (entity % 3 == 0)
+        {
+            scaleManager.AddComponent(entity);
+            scaleManager.SetComponent(entity, neko::Vec3f(2.0f, 2.0f, 2.0f));
+        }
+    }
+    neko::View view(positionManager, scaleManager);
+    const auto expectedCount = entityManager.FilterEntities(
+        neko::EntityMask(neko::ComponentType::POSITION3D) | neko::EntityMask(neko::ComponentType::SCALE3D)).size();
+    EXPECT_EQ(view.Count(), expectedCount);
+
+    std::size_t visited = 0;
+    view.ForEach([&visited](neko::Entity entity, neko::Vec3f& position, const neko::Vec3f& scale)
+    {
+        EXPECT_EQ(entity % 6, 0);
+        position = position * scale.x;
+        visited++;
+    });
+    EXPECT_EQ(visited, expectedCount);
+    for (neko::Entity entity = 0; entity < entityNmb; entity++)
+    {
+        if (positionManager.HasComponent(entity))
+        {
+            EXPECT_EQ(positionManager.GetComponent(entity).x, entity % 3 == 0 ? 2.0f : 1.0f);
+        }
+    }
+}
+
+TEST(Entity, DirtyTransformHierarchy)
+{
+    neko::EntityManager entityManager;
+    neko::Transform3dManager transformManager(entityManager);
+    const auto entities = entityManager.CreateEntities(4);
+    for (const auto entity : entities)
+    {
+        transformManager.AddComponent(entity);
+    }
+    //Parents are set from the deepest entity so that the dirty list is in child first order
+    entityManager.SetEntityParent(entities[3], entities[2]);
+    entityManager.SetEntityParent(entities[2], entities[1]);
+    entityManager.SetEntityParent(entities[1], entities[0]);
+    for (const auto entity : entities)
+    {
+        transformManager.SetPosition(entity, neko::Vec3f(1.0f, 0.0f, 0.0f));
+    }
+    transformManager.Update();
+    for (neko::Index i = 0u; i < entities.size(); i++)
+    {
+        EXPECT_FLOAT_EQ(transformManager.GetComponent(entities[i])[3][0], float(i + 1));
+    }
+
+    //Moving the root only updates its children through the propagation
+    transformManager.SetPosition(entities[0], neko::Vec3f(10.0f, 0.0f, 0.0f));
+    transformManager.Update();
+    EXPECT_FLOAT_EQ(transformManager.GetComponent(entities[3])[3][0], 13.0f);
+
+    //Reparenting a subtree moves it from the children of its previous parent
+    entityManager.SetEntityParent(entities[2], neko::INVALID_ENTITY);
+    transformManager.Update();
+    EXPECT_FLOAT_EQ(transformManager.GetComponent(entities[3])[3][0], 2.0f);
+    transformManager.SetPosition(entities[1], neko::Vec3f(5.0f, 0.0f, 0.0f));
+    transformManager.Update();
+    EXPECT_FLOAT_EQ(transformManager.GetComponent(entities[1])[3][0], 15.0f);
+    EXPECT_FLOAT_EQ(transformManager.GetComponent(entities[3])[3][0], 2.0f);
+}
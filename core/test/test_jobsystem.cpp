@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <engine/jobsystem.h>
+#include <engine/task_graph.h>
 #include <atomic>
 #include <thread>
 //#include <easy/profiler.h>
@@ -51,7 +52,175 @@ TEST(Engine, TestJobSystem)
 #endif
 
     // JobSystem must make main thread wait until all tasks are done before self-destructing.
-    //EXPECT_EQ(TASKS_COUNT, doneTasks);
+    EXPECT_EQ(TASKS_COUNT, doneTasks);
 }
 
+TEST(Engine, TestJobSystemDependencies)
+{
+    const size_t TASKS_COUNT = 64;
+    std::atomic<unsigned int> counter = 0;
+    std::vector<unsigned int> chainOrder(TASKS_COUNT);
+    std::vector<std::unique_ptr<Job>> chainJobs(TASKS_COUNT);
+    for (size_t i = 0; i < TASKS_COUNT; i++)
+    {
+        chainJobs[i] = std::make_unique<Job>([&counter, &chainOrder, i]
+        {
+            chainOrder[i] = counter++;
+        });
+        if (i > 0)
+        {
+            chainJobs[i]->AddDependency(chainJobs[i - 1].get());
+        }
+    }
+    std::atomic<unsigned int> fanInDone = 0;
+    std::vector<std::unique_ptr<Job>> fanInJobs(TASKS_COUNT);
+    std::generate(fanInJobs.begin(), fanInJobs.end(),
+                  [&fanInDone] { return std::make_unique<Job>([&fanInDone] { ++fanInDone; }); });
+    unsigned int fanInResult = 0;
+    Job sinkJob([&fanInDone, &fanInResult] { fanInResult = fanInDone; });
+    for (auto& job : fanInJobs)
+    {
+        sinkJob.AddDependency(job.get());
+    }
+
+    JobSystem jobSystem;
+    jobSystem.Init();
+    //Scheduling the chain in reverse order forces the jobs to wait for their dependencies
+    for (size_t i = 0; i < TASKS_COUNT; ++i)
+    {
+        jobSystem.ScheduleJob(chainJobs[TASKS_COUNT - 1 - i].get(), JobThreadType::OTHER_THREAD);
+    }
+    jobSystem.ScheduleJob(&sinkJob, JobThreadType::OTHER_THREAD);
+    for (auto& job : fanInJobs)
+    {
+        jobSystem.ScheduleJob(job.get(), JobThreadType::OTHER_THREAD);
+    }
+    sinkJob.Join();
+    chainJobs.back()->Join();
+    jobSystem.Destroy();
+
+    for (size_t i = 1; i < TASKS_COUNT; i++)
+    {
+        EXPECT_LT(chainOrder[i - 1], chainOrder[i]);
+    }
+    EXPECT_EQ(TASKS_COUNT, fanInResult);
+}
+
+TEST(Engine, TestParallelFor)
+{
+    const size_t elementsNmb = 100'000;
+    std::vector<unsigned> values(elementsNmb, 0u);
+    JobSystem jobSystem;
+    jobSystem.Init();
+    jobSystem.ParallelFor(0, elementsNmb, 1'000, [&values](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            values[i] += static_cast<unsigned>(i % 7);
+        }
+    });
+    const auto sum = jobSystem.ParallelReduce<std::uint64_t>(0, elementsNmb, 1'000, 0u,
+         [&values](size_t begin, size_t end)
+         {
+             std::uint64_t partialSum = 0;
+             for (size_t i = begin; i < end; i++)
+             {
+                 partialSum += values[i];
+             }
+             return partialSum;
+         },
+         [](std::uint64_t a, std::uint64_t b) { return a + b; });
+    jobSystem.Destroy();
+
+    std::uint64_t expectedSum = 0;
+    for (size_t i = 0; i < elementsNmb; i++)
+    {
+        EXPECT_EQ(i % 7, values[i]);
+        expectedSum += i % 7;
+    }
+    EXPECT_EQ(expectedSum, sum);
+}
+
+TEST(Engine, TestTaskGraph)
+{
+    std::atomic<unsigned> counter = 0;
+    unsigned loadOrder = 0, updateOrder = 0, physicsOrder = 0, renderOrder = 0;
+    TaskGraph taskGraph;
+    taskGraph.AddNode("render", [&] { renderOrder = counter++; });
+    taskGraph.AddNode("physics", [&] { physicsOrder = counter++; });
+    taskGraph.AddNode("update", [&] { updateOrder = counter++; }, JobThreadType::MAIN_THREAD);
+    taskGraph.AddNode("load", [&] { loadOrder = counter++; });
+    taskGraph.AddEdge("load", "update");
+    taskGraph.AddEdge("update", "physics");
+    taskGraph.AddEdge("physics", "render");
+    taskGraph.AddEdge("update", "render");
+    ASSERT_TRUE(taskGraph.Build());
+
+    JobSystem jobSystem;
+    jobSystem.Init();
+    const unsigned framesNmb = 16;
+    for (unsigned frame = 0; frame < framesNmb; frame++)
+    {
+        taskGraph.Schedule(jobSystem);
+        taskGraph.Join(jobSystem);
+        EXPECT_LT(loadOrder, updateOrder);
+        EXPECT_LT(updateOrder, physicsOrder);
+        EXPECT_LT(physicsOrder, renderOrder);
+    }
+    jobSystem.Destroy();
+    EXPECT_EQ(framesNmb * taskGraph.GetNodesNmb(), counter);
+
+    taskGraph.AddEdge("render", "load");
+    EXPECT_FALSE(taskGraph.Build());
+}
+
+TEST(Engine, TestMpscQueue)
+{
+    struct Node
+    {
+        std::size_t producer = 0;
+        std::size_t index = 0;
+        Node* next = nullptr;
+    };
+    const std::size_t producersNmb = 8;
+    const std::size_t nodesNmb = 10'000;
+    std::vector<std::vector<Node>> nodes(producersNmb, std::vector<Node>(nodesNmb));
+    MpscQueue<Node> queue;
+    EXPECT_TRUE(queue.IsEmpty());
+    EXPECT_EQ(nullptr, queue.PopAll());
+    std::vector<std::thread> producers;
+    for (std::size_t producer = 0; producer < producersNmb; producer++)
+    {
+        producers.emplace_back([&nodes, &queue, producer]
+        {
+            for (std::size_t i = 0; i < nodesNmb; i++)
+            {
+                nodes[producer][i].producer = producer;
+                nodes[producer][i].index = i;
+                queue.Push(&nodes[producer][i]);
+            }
+        });
+    }
+    std::vector<std::size_t> nextIndices(producersNmb, 0);
+    std::size_t poppedNmb = 0;
+    while (poppedNmb < producersNmb * nodesNmb)
+    {
+        for (auto* node = queue.PopAll(); node != nullptr; node = node->next)
+        {
+            //Each node once, in the order of its producer
+            EXPECT_EQ(nextIndices[node->producer], node->index);
+            nextIndices[node->producer] = node->index + 1;
+            poppedNmb++;
+        }
+    }
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+    EXPECT_TRUE(queue.IsEmpty());
+    for (const auto nextIndex : nextIndices)
+    {
+        EXPECT_EQ(nodesNmb, nextIndex);
+    }
+}
 }
@@ -13,6 +13,7 @@
 #include <mathematics/quaternion.h>
 #include <mathematics/matrix.h>
 #include "mathematics/vector.h"
+#include "mathematics/transform.h"
 
 
 const float maxNmb = 100.0f;
@@ -738,3 +739,39 @@ TEST(Engine, TestMatrix4)
 	EXPECT_LT(neko::Mat4f::MatrixDifference(mInvCalculus, mInv), 0.01f);
 	EXPECT_GT(neko::Mat4f::MatrixDifference(mInvCalculus, neko::Mat4f::Identity), 0.01f);
 }
+
+TEST(Engine, ComputeTransforms)
+{
+    //Not a multiple of the batch size to also test the remaining scalar transforms
+    const size_t count = 37;
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> distribution(-maxNmb, maxNmb);
+    std::uniform_real_distribution<float> angleDistribution(-180.0f, 180.0f);
+    std::vector<neko::Vec3f> positions(count);
+    std::vector<neko::EulerAngles> angles(count);
+    std::vector<neko::Vec3f> scales(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        positions[i] = neko::Vec3f(distribution(generator), distribution(generator), distribution(generator));
+        angles[i] = neko::EulerAngles(
+            neko::degree_t(angleDistribution(generator)),
+            neko::degree_t(angleDistribution(generator)),
+            neko::degree_t(angleDistribution(generator)));
+        scales[i] = neko::Vec3f(distribution(generator), distribution(generator), distribution(generator)) * 0.1f;
+    }
+    std::vector<neko::Mat4f> transforms(count);
+    neko::Transform3d::ComputeTransforms(positions.data(), angles.data(), scales.data(), transforms.data(), count);
+    for (size_t i = 0; i < count; i++)
+    {
+        neko::Mat4f expected = neko::Transform3d::Rotate(neko::Mat4f::Identity, angles[i]);
+        expected = neko::Transform3d::Scale(expected, scales[i]);
+        expected = neko::Transform3d::Translate(expected, positions[i]);
+        for (int column = 0; column < 4; column++)
+        {
+            for (int row = 0; row < 4; row++)
+            {
+                EXPECT_NEAR(expected[column][row], transforms[i][column][row], 1e-3f);
+            }
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <graphics/sprite.h>
+#include <mathematics/transform.h>
+
+namespace neko
+{
+
+TEST(Graphics, SpriteBatcher)
+{
+    const std::uint32_t texturesNmb = 3;
+    const std::size_t spritesNmb = 32;
+    SpriteBatcher spriteBatcher;
+    for (int frame = 0; frame < 2; frame++)
+    {
+        spriteBatcher.Clear();
+        for (std::size_t i = 0; i < spritesNmb; i++)
+        {
+            const auto position = Vec3f(float(i), 0.0f, 0.0f);
+            spriteBatcher.AddSprite(std::uint32_t(texturesNmb - i % texturesNmb),
+                                    Transform3d::Translate(Mat4f::Identity, position),
+                                    Color4(float(i), 0.0f, 0.0f, 1.0f));
+        }
+        spriteBatcher.Build();
+
+        const auto& batches = spriteBatcher.GetBatches();
+        const auto& instances = spriteBatcher.GetInstances();
+        ASSERT_EQ(texturesNmb, batches.size());
+        ASSERT_EQ(spritesNmb, instances.size());
+        std::uint32_t first = 0;
+        for (std::uint32_t batchIndex = 0; batchIndex < texturesNmb; batchIndex++)
+        {
+            const auto& batch = batches[batchIndex];
+            EXPECT_EQ(batchIndex + 1, batch.texture);
+            EXPECT_EQ(first, batch.first);
+            for (std::uint32_t i = batch.first; i < batch.first + batch.count; i++)
+            {
+                //Submission order is kept inside a batch
+                const auto spriteIndex = std::size_t(instances[i].color.x);
+                EXPECT_EQ(batch.texture, texturesNmb - spriteIndex % texturesNmb);
+                EXPECT_FLOAT_EQ(float(spriteIndex), instances[i].model[3][0]);
+                if (i > batch.first)
+                {
+                    EXPECT_LT(instances[i - 1].color.x, instances[i].color.x);
+                }
+            }
+            first += batch.count;
+        }
+        EXPECT_EQ(spritesNmb, first);
+    }
+}
+
+}
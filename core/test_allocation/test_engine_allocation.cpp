@@ -0,0 +1,77 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <engine/engine.h>
+#include <engine/filesystem.h>
+
+#include "allocation_counter.h"
+
+namespace neko
+{
+namespace
+{
+class HeadlessEngine : public BasicEngine
+{
+public:
+    explicit HeadlessEngine(const FilesystemInterface& filesystem) : BasicEngine(filesystem) {}
+    void ManageEvent() override {}
+};
+
+class CounterSystem : public SystemInterface
+{
+public:
+    void Init() override {}
+    void Update([[maybe_unused]] seconds dt) override { ++updateCount; }
+    void Destroy() override {}
+    int updateCount = 0;
+};
+}
+
+TEST(Engine, TestEngineLoopNoAllocation)
+{
+    Filesystem filesystem;
+    HeadlessEngine engine(filesystem);
+    CounterSystem counterSystem;
+    engine.RegisterSystem(counterSystem);
+    engine.Init();
+    //The warm-up frames also grow the scratch of the __neko_dbg__ dependency cycle check,
+    //so the frame loop stays allocation-free in Debug and RelWithDebInfo too
+    const int warmUpFrames = 4;
+    const int frames = 256;
+    for (int i = 0; i < warmUpFrames; i++)
+    {
+        engine.Update(seconds(0.016f));
+    }
+    StartCountingAllocations();
+    for (int i = 0; i < frames; i++)
+    {
+        engine.Update(seconds(0.016f));
+    }
+    const auto allocationsNmb = StopCountingAllocations();
+    engine.Destroy();
+    EXPECT_EQ(0u, allocationsNmb);
+    EXPECT_EQ(warmUpFrames + frames, counterSystem.updateCount);
+}
+}
@@ -3,10 +3,10 @@ precision mediump float;
 
 out vec4 FragColor;
 in vec2 TexCoords;
-uniform vec4 spriteColor;
+in vec4 SpriteColor;
 uniform sampler2D spriteTexture;
 
 void main()
 {
-    FragColor = texture(spriteTexture, TexCoords) * spriteColor;
+    FragColor = texture(spriteTexture, TexCoords) * SpriteColor;
 }
\ No newline at end of file
@@ -2,14 +2,17 @@
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec2 aTexCoords;
 layout(location = 2) in vec3 aNormal;
+layout(location = 4) in mat4 aModel;
+layout(location = 8) in vec4 aColor;
 
 out vec2 TexCoords;
-uniform mat4 model;
+out vec4 SpriteColor;
 uniform mat4 view;
 uniform mat4 projection;
 
 void main()
 {
     TexCoords = aTexCoords;
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    SpriteColor = aColor;
+    gl_Position = projection * view * aModel * vec4(aPos, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <random>
+
+#include "asteroid/physics_manager.h"
+
+using namespace neko;
+using namespace neko::asteroid;
+
+namespace
+{
+const long fromBodies = 1'000;
+const long toBodies = 10'000;
+
+struct CollisionCounter : OnCollisionInterface
+{
+    void OnCollision([[maybe_unused]] Entity entity1, [[maybe_unused]] Entity entity2) override
+    {
+        collisionsNmb++;
+    }
+    std::size_t collisionsNmb = 0;
+};
+
+/**
+ * \brief Bullet sized bodies scattered at the same density whatever their number
+ */
+struct AsteroidBodies
+{
+    explicit AsteroidBodies(std::size_t bodiesNmb) : physicsManager(entityManager)
+    {
+        physicsManager.RegisterCollisionListener(collisionCounter);
+        const float worldSize = std::sqrt(float(bodiesNmb)) * 0.5f;
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> positionDistribution(-worldSize, worldSize);
+        std::uniform_real_distribution<float> velocityDistribution(-2.0f, 2.0f);
+        for (std::size_t i = 0; i < bodiesNmb; i++)
+        {
+            const auto entity = entityManager.CreateEntity();
+            Body body;
+            body.position = Vec2f(positionDistribution(generator), positionDistribution(generator));
+            body.velocity = Vec2f(velocityDistribution(generator), velocityDistribution(generator));
+            Box box;
+            box.extends = Vec2f::one * 0.1f;
+            physicsManager.AddBody(entity);
+            physicsManager.SetBody(entity, body);
+            physicsManager.AddBox(entity);
+            physicsManager.SetBox(entity, box);
+        }
+    }
+    EntityManager entityManager;
+    PhysicsManager physicsManager;
+    CollisionCounter collisionCounter;
+};
+
+/**
+ * \brief The every body against every other body loop the broadphase replaced
+ */
+void BruteForceCollisions(AsteroidBodies& bodies)
+{
+    const auto& entityManager = bodies.entityManager;
+    const auto& physicsManager = bodies.physicsManager;
+    const auto bodyBoxMask = EntityMask(neko::ComponentType::BODY2D) | EntityMask(neko::ComponentType::BOX_COLLIDER2D);
+    for (Entity entity = 0; entity < entityManager.GetEntitiesSize(); entity++)
+    {
+        if (!entityManager.HasComponent(entity, bodyBoxMask))
+            continue;
+        for (Entity otherEntity = entity + 1; otherEntity < entityManager.GetEntitiesSize(); otherEntity++)
+        {
+            if (!entityManager.HasComponent(otherEntity, bodyBoxMask))
+                continue;
+            const Body& body1 = physicsManager.GetBody(entity);
+            const Box& box1 = physicsManager.GetBox(entity);
+            const Body& body2 = physicsManager.GetBody(otherEntity);
+            const Box& box2 = physicsManager.GetBox(otherEntity);
+            if (Box2Box(
+                body1.position.x - box1.extends.x,
+                body1.position.y - box1.extends.y,
+                box1.extends.x * 2.0f,
+                box1.extends.y * 2.0f,
+                body2.position.x - box2.extends.x,
+                body2.position.y - box2.extends.y,
+                box2.extends.x * 2.0f,
+                box2.extends.y * 2.0f))
+            {
+                bodies.collisionCounter.OnCollision(entity, otherEntity);
+            }
+        }
+    }
+}
+}
+
+static void BM_BruteForceCollisions(benchmark::State& state)
+{
+    AsteroidBodies bodies(state.range(0));
+    for (auto _ : state)
+    {
+        BruteForceCollisions(bodies);
+        benchmark::DoNotOptimize(bodies.collisionCounter.collisionsNmb);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BruteForceCollisions)->RangeMultiplier(2)->Range(fromBodies, toBodies);
+
+static void BM_PhysicsFixedUpdate(benchmark::State& state)
+{
+    AsteroidBodies bodies(state.range(0));
+    for (auto _ : state)
+    {
+        //Zero delta time, the bodies stay in place as in the brute force benchmark
+        bodies.physicsManager.FixedUpdate(seconds(0.0f));
+        benchmark::DoNotOptimize(bodies.collisionCounter.collisionsNmb);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PhysicsFixedUpdate)->RangeMultiplier(2)->Range(fromBodies, toBodies);
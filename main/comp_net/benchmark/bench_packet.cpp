@@ -0,0 +1,213 @@
+#include <benchmark/benchmark.h>
+
+#include "SFML/Network/Packet.hpp"
+#include "asteroid/packet_type.h"
+#include "engine/conversion.h"
+
+using namespace neko;
+using namespace neko::asteroid;
+
+namespace
+{
+//The legacy input packets always sent their whole window of one byte per input
+const std::size_t legacyMaxInputNmb = 50;
+//The legacy validate packets sent a 16 bits checksum of each player body
+using LegacyPhysicsState = std::uint16_t;
+/**
+ * \brief The packets encoded field by field with ConvertToBinary and streamed in a sf::Packet, as before
+ * the fixed layout packets
+ */
+struct LegacyPlayerInputPacket : TypedPacket<PacketType::INPUT>
+{
+    net::PlayerNumber playerNumber = net::INVALID_PLAYER;
+    std::array<std::uint8_t, sizeof(net::Frame)> currentFrame{};
+    std::array<std::uint8_t, legacyMaxInputNmb> inputs{};
+};
+
+struct LegacyValidateFramePacket : TypedPacket<PacketType::VALIDATE_STATE>
+{
+    std::array<std::uint8_t, sizeof(net::Frame)> newValidateFrame{};
+    std::array<std::uint8_t, sizeof(LegacyPhysicsState) * maxPlayerNmb> physicsState{};
+};
+
+template<typename T, size_t N>
+sf::Packet& operator<<(sf::Packet& packet, const std::array<T, N>& t)
+{
+    for (auto& tmp : t)
+    {
+        packet << tmp;
+    }
+    return packet;
+}
+
+template<typename T, size_t N>
+sf::Packet& operator>>(sf::Packet& packet, std::array<T, N>& t)
+{
+    for (auto& tmp : t)
+    {
+        packet >> tmp;
+    }
+    return packet;
+}
+
+void LegacyGeneratePacket(sf::Packet& packet, const LegacyPlayerInputPacket& inputPacket)
+{
+    packet << static_cast<std::uint8_t>(inputPacket.packetType) << inputPacket.playerNumber <<
+        inputPacket.currentFrame << inputPacket.inputs;
+}
+
+void LegacyGeneratePacket(sf::Packet& packet, const LegacyValidateFramePacket& validatePacket)
+{
+    packet << static_cast<std::uint8_t>(validatePacket.packetType) <<
+        validatePacket.newValidateFrame << validatePacket.physicsState;
+}
+
+template<typename T>
+std::unique_ptr<T> LegacyGenerateReceivedPacket(sf::Packet& packet);
+
+template<>
+std::unique_ptr<LegacyPlayerInputPacket> LegacyGenerateReceivedPacket(sf::Packet& packet)
+{
+    std::uint8_t packetType;
+    packet >> packetType;
+    auto inputPacket = std::make_unique<LegacyPlayerInputPacket>();
+    packet >> inputPacket->playerNumber >> inputPacket->currentFrame >> inputPacket->inputs;
+    return inputPacket;
+}
+
+template<>
+std::unique_ptr<LegacyValidateFramePacket> LegacyGenerateReceivedPacket(sf::Packet& packet)
+{
+    std::uint8_t packetType;
+    packet >> packetType;
+    auto validatePacket = std::make_unique<LegacyValidateFramePacket>();
+    packet >> validatePacket->newValidateFrame >> validatePacket->physicsState;
+    return validatePacket;
+}
+
+LegacyPlayerInputPacket CreateLegacyPacket(const PlayerInputPacket& inputPacket)
+{
+    LegacyPlayerInputPacket legacyPacket;
+    legacyPacket.playerNumber = inputPacket.playerNumber;
+    legacyPacket.currentFrame = ConvertToBinary(inputPacket.currentFrame);
+    std::copy_n(inputPacket.inputs.begin(), legacyMaxInputNmb, legacyPacket.inputs.begin());
+    return legacyPacket;
+}
+
+LegacyValidateFramePacket CreateLegacyPacket(const ValidateFramePacket& validatePacket)
+{
+    LegacyValidateFramePacket legacyPacket;
+    legacyPacket.newValidateFrame = ConvertToBinary(validatePacket.newValidateFrame);
+    legacyPacket.physicsState = ConvertToBinary(std::array<LegacyPhysicsState, maxPlayerNmb>{ 42, 24 });
+    return legacyPacket;
+}
+
+/**
+ * \brief Input packet of inputsNmb inputs, the player changes its input every inputPeriod frames
+ */
+PlayerInputPacket CreateInputPacket(std::size_t inputsNmb, std::size_t inputPeriod)
+{
+    const std::array<net::PlayerInput, 3> inputs{{
+        PlayerInput::UP,
+        PlayerInput::UP | PlayerInput::SHOOT,
+        PlayerInput::LEFT}};
+    PlayerInputPacket inputPacket;
+    inputPacket.playerNumber = 1;
+    inputPacket.currentFrame = 12'345;
+    inputPacket.inputsNmb = std::uint8_t(inputsNmb);
+    for (std::size_t i = 0; i < inputPacket.inputs.size(); i++)
+    {
+        inputPacket.inputs[i] = inputs[(i / inputPeriod) % inputs.size()];
+    }
+    return inputPacket;
+}
+
+ValidateFramePacket CreateValidatePacket()
+{
+    ValidateFramePacket validatePacket;
+    validatePacket.newValidateFrame = 12'345;
+    validatePacket.stateHashes = { 42, 24, 4'242, 2'424, 424'242 };
+    return validatePacket;
+}
+
+/**
+ * \brief Encoded and sent to all the players as the server does, the legacy path generated one sf::Packet per player
+ */
+template<typename T>
+void BM_LegacyEncode(benchmark::State& state, T packet)
+{
+    const auto legacyPacket = CreateLegacyPacket(packet);
+    for (auto _ : state)
+    {
+        for (std::uint32_t playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+        {
+            sf::Packet sendingPacket;
+            LegacyGeneratePacket(sendingPacket, legacyPacket);
+            benchmark::DoNotOptimize(sendingPacket.getData());
+        }
+    }
+    sf::Packet sentPacket;
+    LegacyGeneratePacket(sentPacket, legacyPacket);
+    state.counters["bytes"] = double(sentPacket.getDataSize());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_LegacyEncode, Input, CreateInputPacket(legacyMaxInputNmb, 10));
+BENCHMARK_CAPTURE(BM_LegacyEncode, Validate, CreateValidatePacket());
+
+template<typename T>
+void BM_Encode(benchmark::State& state, T packet)
+{
+    PacketBuffer sendBuffer{};
+    for (auto _ : state)
+    {
+        const auto packetSize = GeneratePacket(sendBuffer, packet);
+        benchmark::DoNotOptimize(packetSize);
+        benchmark::ClobberMemory();
+    }
+    state.counters["bytes"] = double(GeneratePacket(sendBuffer, packet));
+    state.SetItemsProcessed(state.iterations());
+}
+//Client input packet with the inputs not yet acknowledged by the server
+BENCHMARK_CAPTURE(BM_Encode, InputAcknowledged, CreateInputPacket(3, 10));
+BENCHMARK_CAPTURE(BM_Encode, InputLegacyWindow, CreateInputPacket(legacyMaxInputNmb, 10));
+//Input packet sent back by the server with the whole window
+BENCHMARK_CAPTURE(BM_Encode, InputFullWindow, CreateInputPacket(maxInputNmb, 10));
+BENCHMARK_CAPTURE(BM_Encode, InputFullWindowNoRepeat, CreateInputPacket(maxInputNmb, 1));
+BENCHMARK_CAPTURE(BM_Encode, Validate, CreateValidatePacket());
+
+template<typename T>
+void BM_LegacyDecode(benchmark::State& state, T packet)
+{
+    const auto legacyPacket = CreateLegacyPacket(packet);
+    sf::Packet sentPacket;
+    LegacyGeneratePacket(sentPacket, legacyPacket);
+    for (auto _ : state)
+    {
+        //Received from the socket in a sf::Packet
+        sf::Packet receivedPacket;
+        receivedPacket.append(sentPacket.getData(), sentPacket.getDataSize());
+        auto decodedPacket = LegacyGenerateReceivedPacket<std::decay_t<decltype(legacyPacket)>>(receivedPacket);
+        benchmark::DoNotOptimize(decodedPacket);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_LegacyDecode, Input, CreateInputPacket(legacyMaxInputNmb, 10));
+BENCHMARK_CAPTURE(BM_LegacyDecode, Validate, CreateValidatePacket());
+
+template<typename T>
+void BM_Decode(benchmark::State& state, T packet)
+{
+    PacketBuffer receiveBuffer{};
+    const auto packetSize = GeneratePacket(receiveBuffer, packet);
+    for (auto _ : state)
+    {
+        //Decoded in place from the receive buffer
+        auto decodedPacket = GenerateReceivedPacket(receiveBuffer.data(), packetSize);
+        benchmark::DoNotOptimize(decodedPacket);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_Decode, InputAcknowledged, CreateInputPacket(3, 10));
+BENCHMARK_CAPTURE(BM_Decode, InputFullWindow, CreateInputPacket(maxInputNmb, 10));
+BENCHMARK_CAPTURE(BM_Decode, Validate, CreateValidatePacket());
+}
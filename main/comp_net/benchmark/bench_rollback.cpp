@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include "asteroid/game_manager.h"
+
+using namespace neko;
+using namespace neko::asteroid;
+
+namespace
+{
+/**
+ * \brief Headless game with bullets frozen in place, the frames of the rollback window
+ * are simulated once before the measure
+ */
+class RollbackGameManager : public GameManager
+{
+public:
+    RollbackGameManager(std::size_t bulletsNmb, net::Frame rollbackDepth)
+    {
+        Init();
+        for (net::PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+        {
+            SpawnPlayer(playerNumber, spawnPositions[playerNumber] * 3.0f, spawnRotations[playerNumber]);
+        }
+        for (std::size_t i = 0; i < bulletsNmb; i++)
+        {
+            const auto position = Vec2f(float(i % 100) - 50.0f, float(i / 100) + 5.0f);
+            SpawnBullet(net::PlayerNumber(i % maxPlayerNmb), position, Vec2f::zero);
+        }
+        currentFrame_ = rollbackDepth + 1;
+        rollbackManager_.StartNewFrame(currentFrame_);
+        for (net::PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+        {
+            SetPlayerInput(playerNumber, 0, 1);
+        }
+        Validate(1);
+        rollbackManager_.SimulateToCurrentFrame();
+    }
+
+    /**
+     * \brief Receive a different remote input for the oldest frame of the window and simulate back to the current frame
+     */
+    void Rollback()
+    {
+        remoteInput_ = remoteInput_ == PlayerInput::LEFT ? PlayerInput::RIGHT : PlayerInput::LEFT;
+        SetPlayerInput(1, remoteInput_, rollbackManager_.GetLastValidateFrame() + 1);
+        rollbackManager_.SimulateToCurrentFrame();
+    }
+
+    void SimulateToCurrentFrame()
+    {
+        rollbackManager_.SimulateToCurrentFrame();
+    }
+
+    StateHashes ComputeStateHashes()
+    {
+        return rollbackManager_.ComputeStateHashes();
+    }
+private:
+    net::PlayerInput remoteInput_ = 0;
+};
+}
+
+static void BM_RollbackSimulation(benchmark::State& state)
+{
+    RollbackGameManager gameManager(state.range(0), net::Frame(state.range(1)));
+    for (auto _ : state)
+    {
+        gameManager.Rollback();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_RollbackSimulation)->ArgsProduct({{100, 1'000, 10'000}, {5, 10, 25, 50}})->Unit(benchmark::kMicrosecond);
+
+static void BM_RollbackNoNewInput(benchmark::State& state)
+{
+    RollbackGameManager gameManager(state.range(0), net::Frame(state.range(1)));
+    for (auto _ : state)
+    {
+        //Rendering frames without new fixed frame nor new input
+        gameManager.SimulateToCurrentFrame();
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_RollbackNoNewInput)->ArgsProduct({{100, 1'000, 10'000}, {5, 50}})->Unit(benchmark::kMicrosecond);
+
+static void BM_StateHash(benchmark::State& state)
+{
+    RollbackGameManager gameManager(state.range(0), 1);
+    for (auto _ : state)
+    {
+        //Hashed at each validated frame
+        const auto stateHashes = gameManager.ComputeStateHashes();
+        benchmark::DoNotOptimize(stateHashes);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StateHash)->Arg(100)->Arg(1'000)->Arg(10'000)->Unit(benchmark::kMicrosecond);
@@ -26,6 +26,7 @@
 #include "game.h"
 #include "engine/component.h"
 #include "comp_net/type.h"
+#include "asteroid/rollback_history.h"
 
 namespace neko::asteroid
 {
@@ -35,12 +36,17 @@ struct Bullet
     net::PlayerNumber playerNumber = net::INVALID_PLAYER;
 };
 class GameManager;
-class BulletManager : public ComponentManager<Bullet, static_cast<EntityMask>(ComponentType::BULLET)>
+class BulletManager : public RollbackComponentManager<Bullet, static_cast<EntityMask>(ComponentType::BULLET)>
 {
 public:
-    explicit BulletManager(EntityManager& entityManager, GameManager& gameManager);
+    /**
+     * \brief The entity mask history records the bullets destroyed at the end of their period
+     */
+    explicit BulletManager(EntityManager& entityManager, GameManager& gameManager,
+        ComponentHistory<EntityMask>& entityMaskHistory);
     void FixedUpdate(seconds dt);
 private:
     std::reference_wrapper<GameManager> gameManager_;
+    std::reference_wrapper<ComponentHistory<EntityMask>> entityMaskHistory_;
 };
 }
\ No newline at end of file
@@ -96,7 +96,11 @@ public:
 	void FixedUpdate();
 	void SetPlayerInput(net::PlayerNumber playerNumber, net::PlayerInput playerInput, std::uint32_t inputFrame) override;
     void DrawImGui() override;
-    void ConfirmValidateFrame(net::Frame newValidateFrame, const std::array<PhysicsState, maxPlayerNmb>& physicsStates);
+    void ConfirmValidateFrame(net::Frame newValidateFrame, const StateHashes& stateHashes);
+    /**
+     * \brief Called when the server sends back the inputs of the client player, the inputs up to inputFrame are not resent
+     */
+    void AcknowledgeInputFrame(net::Frame inputFrame);
 	[[nodiscard]] net::PlayerNumber GetPlayerNumber() const { return clientPlayer_; }
     void WinGame(net::PlayerNumber winner) override;
     [[nodiscard]] std::uint32_t GetState() const {return state_;}
@@ -111,6 +115,8 @@ protected:
     float fixedTimer_ = 0.0f;
     unsigned long long startingTime_ = 0;
 	std::uint32_t state_ = 0;
+    //The client player inputs are sent from this frame to the current frame
+    net::Frame firstUnacknowledgedInputFrame_ = 0;
 
     gl::TextureId shipTextureId_ = gl::INVALID_TEXTURE_ID;
     gl::TextureId bulletTextureId_ = gl::INVALID_TEXTURE_ID;
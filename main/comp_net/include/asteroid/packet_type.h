@@ -21,14 +21,19 @@
  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  SOFTWARE.
  */
-
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
 
 #include "game.h"
+#include "comp_net/packet.h"
 #include "comp_net/type.h"
-#include "SFML/Network/Packet.hpp"
+#include "engine/assert.h"
 
 
 namespace neko::asteroid
@@ -46,7 +51,21 @@ enum class PacketType : std::uint8_t
     NONE,
 };
 
-using PhysicsState = std::uint16_t;
+/**
+ * \brief Component arrays of the rollback state, each one is hashed separately so that a desync can be traced
+ * back to its component
+ */
+enum class StateComponent : std::uint8_t
+{
+    ENTITY_MASK = 0u,
+    BODY,
+    BOX,
+    PLAYER_CHARACTER,
+    BULLET,
+    LENGTH
+};
+using StateHash = std::uint64_t;
+using StateHashes = std::array<StateHash, static_cast<std::size_t>(StateComponent::LENGTH)>;
 
 struct Packet
 {
@@ -54,45 +73,95 @@ struct Packet
     PacketType packetType = PacketType::NONE;
 };
 
-inline sf::Packet& operator<<(sf::Packet& packetReceived, Packet& packet)
-{
-    const std::uint8_t packetType = static_cast<std::uint8_t>(packet.packetType);
-    packetReceived << packetType;
-    return packetReceived;
-}
-
-inline sf::Packet& operator>>(sf::Packet& packetReceived, Packet& packet)
-{
-    std::uint8_t packetType;
-    packetReceived >> packetType;
-    packet.packetType = static_cast<PacketType>(packetType);
-    return packetReceived;
-}
-
 template<PacketType type>
 struct TypedPacket : Packet
 {
     TypedPacket() { packetType = type; }
 };
 
-template<typename T, size_t N>
-sf::Packet& operator<<(sf::Packet& packet, const std::array<T, N>& t)
+/**
+ * \brief Writes the packet fields one after the other in a flat buffer, without padding and in the host byte order
+ */
+class PacketWriter
 {
-    for (auto& tmp : t)
+public:
+    PacketWriter(std::uint8_t* data, std::size_t capacity) : data_(data), capacity_(capacity) {}
+    void Write(const void* value, std::size_t size)
     {
-        packet << tmp;
+        neko_assert(size_ + size <= capacity_, "Packet does not fit in the send buffer");
+        std::memcpy(data_ + size_, value, size);
+        size_ += size;
     }
-    return packet;
-}
+    /**
+     * \brief Mark the next bytes as written by another writer, with GetCurrent and GetRemainingSize
+     */
+    void Skip(std::size_t size)
+    {
+        neko_assert(size_ + size <= capacity_, "Packet does not fit in the send buffer");
+        size_ += size;
+    }
+    [[nodiscard]] std::uint8_t* GetCurrent() const { return data_ + size_; }
+    [[nodiscard]] std::size_t GetRemainingSize() const { return capacity_ - size_; }
+    [[nodiscard]] std::size_t GetSize() const { return size_; }
+private:
+    std::uint8_t* data_;
+    std::size_t capacity_;
+    std::size_t size_ = 0;
+};
 
-template <typename T, size_t N>
-sf::Packet& operator>>(sf::Packet& packet, std::array<T, N>& t)
+/**
+ * \brief Reads the packet fields written by a PacketWriter, reading past the end of the data invalidates the reader
+ */
+class PacketReader
 {
-    for (auto& tmp : t)
+public:
+    PacketReader(const std::uint8_t* data, std::size_t size) : data_(data), size_(size) {}
+    void Read(void* value, std::size_t size)
     {
-        packet >> tmp;
+        if (readPos_ + size > size_)
+        {
+            isValid_ = false;
+            return;
+        }
+        std::memcpy(value, data_ + readPos_, size);
+        readPos_ += size;
     }
-    return packet;
+    /**
+     * \brief Mark the next bytes as read by another reader, with GetCurrent and GetRemainingSize
+     */
+    void Skip(std::size_t size)
+    {
+        if (readPos_ + size > size_)
+        {
+            isValid_ = false;
+            return;
+        }
+        readPos_ += size;
+    }
+    void Invalidate() { isValid_ = false; }
+    [[nodiscard]] const std::uint8_t* GetCurrent() const { return data_ + readPos_; }
+    [[nodiscard]] std::size_t GetRemainingSize() const { return size_ - readPos_; }
+    [[nodiscard]] bool IsValid() const { return isValid_; }
+    [[nodiscard]] bool IsAtEnd() const { return readPos_ == size_; }
+private:
+    const std::uint8_t* data_;
+    std::size_t size_;
+    std::size_t readPos_ = 0;
+    bool isValid_ = true;
+};
+
+template<typename T, typename = std::enable_if_t<std::is_trivially_copyable_v<T>>>
+PacketWriter& operator<<(PacketWriter& writer, const T& value)
+{
+    writer.Write(&value, sizeof(T));
+    return writer;
+}
+
+template<typename T, typename = std::enable_if_t<std::is_trivially_copyable_v<T>>>
+PacketReader& operator>>(PacketReader& reader, T& value)
+{
+    reader.Read(&value, sizeof(T));
+    return reader;
 }
 
 /**
@@ -100,239 +169,279 @@ sf::Packet& operator>>(sf::Packet& packet, std::array<T, N>& t)
  */
 struct JoinPacket : TypedPacket<PacketType::JOIN>
 {
-    std::array<std::uint8_t, sizeof(net::ClientId)> clientId{};
-    std::array<std::uint8_t, sizeof(unsigned long)> startTime{};
+    static constexpr std::size_t wireSize = sizeof(PacketType) + sizeof(net::ClientId) + sizeof(std::uint64_t);
+    net::ClientId clientId = 0;
+    std::uint64_t startTime = 0;
 };
 
-inline sf::Packet& operator<<(sf::Packet& packet, const JoinPacket& joinPacket)
+inline PacketWriter& operator<<(PacketWriter& writer, const JoinPacket& joinPacket)
 {
-    return packet << joinPacket.clientId << joinPacket.startTime;
+    return writer << joinPacket.clientId << joinPacket.startTime;
 }
 
-inline sf::Packet& operator>>(sf::Packet& packet, JoinPacket& joinPacket)
+inline PacketReader& operator>>(PacketReader& reader, JoinPacket& joinPacket)
 {
-    return packet >> joinPacket.clientId >> joinPacket.startTime;
+    return reader >> joinPacket.clientId >> joinPacket.startTime;
 }
 /**
  * \brief TCP Packet sent by the server to the client to answer a join packet
  */
 struct JoinAckPacket : TypedPacket<PacketType::JOIN_ACK>
 {
-    std::array<std::uint8_t, sizeof(net::ClientId)> clientId{};
-    std::array<std::uint8_t, sizeof(unsigned short)> udpPort{};
+    static constexpr std::size_t wireSize = sizeof(PacketType) + sizeof(net::ClientId) + sizeof(std::uint16_t);
+    net::ClientId clientId = 0;
+    std::uint16_t udpPort = 0;
 };
 
 
-inline sf::Packet& operator<<(sf::Packet& packet, const JoinAckPacket& spawnPlayerPacket)
+inline PacketWriter& operator<<(PacketWriter& writer, const JoinAckPacket& joinAckPacket)
 {
-    return packet << spawnPlayerPacket.clientId << spawnPlayerPacket.udpPort;
+    return writer << joinAckPacket.clientId << joinAckPacket.udpPort;
 }
 
-inline sf::Packet& operator>>(sf::Packet& packet, JoinAckPacket& joinPacket)
+inline PacketReader& operator>>(PacketReader& reader, JoinAckPacket& joinAckPacket)
 {
-    return packet >> joinPacket.clientId >> joinPacket.udpPort;
+    return reader >> joinAckPacket.clientId >> joinAckPacket.udpPort;
 }
 /**
  * \brief Packet sent by the server to all clients to notify of the spawn of a new player
  */
 struct SpawnPlayerPacket : TypedPacket<PacketType::SPAWN_PLAYER>
 {
-    std::array<std::uint8_t, sizeof(net::ClientId)> clientId{};
+    static constexpr std::size_t wireSize = sizeof(PacketType) + sizeof(net::ClientId) +
+        sizeof(net::PlayerNumber) + sizeof(Vec2f) + sizeof(degree_t);
+    net::ClientId clientId = 0;
     net::PlayerNumber playerNumber = net::INVALID_PLAYER;
-    std::array<std::uint8_t, sizeof(Vec2f)> pos{};
-    std::array<std::uint8_t, sizeof(degree_t)> angle{};
+    Vec2f pos{};
+    degree_t angle{};
 };
 
-inline sf::Packet& operator<<(sf::Packet& packet, const SpawnPlayerPacket& spawnPlayerPacket)
+inline PacketWriter& operator<<(PacketWriter& writer, const SpawnPlayerPacket& spawnPlayerPacket)
 {
-    return packet << spawnPlayerPacket.clientId << spawnPlayerPacket.playerNumber <<
+    return writer << spawnPlayerPacket.clientId << spawnPlayerPacket.playerNumber <<
         spawnPlayerPacket.pos << spawnPlayerPacket.angle;
 }
 
-inline sf::Packet& operator>>(sf::Packet& packet, SpawnPlayerPacket& spawnPlayerPacket)
+inline PacketReader& operator>>(PacketReader& reader, SpawnPlayerPacket& spawnPlayerPacket)
 {
-    return packet >> spawnPlayerPacket.clientId >> spawnPlayerPacket.playerNumber >>
+    return reader >> spawnPlayerPacket.clientId >> spawnPlayerPacket.playerNumber >>
         spawnPlayerPacket.pos >> spawnPlayerPacket.angle;
 }
 
-//
-const size_t maxInputNmb = 50;
+//Number of inputs of the redundancy window, the player input history is resent until the server acknowledges it
+const size_t maxInputNmb = 128;
+//PlayerInput only uses its 5 lowest bits
+constexpr std::uint32_t inputBitsNmb = 5;
+//Repeated inputs are sent once with the length of the run, from minRunLength to maxRunLength
+constexpr std::uint32_t runLengthBitsNmb = 5;
+constexpr std::size_t minRunLength = 2;
+constexpr std::size_t maxRunLength = minRunLength + (1u << runLengthBitsNmb) - 1u;
 /**
  * \brief Packet sent by the player client and then replicated by the server to all clients to share the currentFrame
- * and all the previous ones player inputs.
+ * and the inputsNmb - 1 previous ones player inputs.
+ * The inputs are bit-packed and run-length encoded: each run is its input on 5 bits, followed by a repeat bit and
+ * the run length on 5 bits if the input is repeated.
  */
 struct PlayerInputPacket : TypedPacket<PacketType::INPUT>
 {
+    //Largest encoded size, when no input is repeated
+    static constexpr std::size_t wireSize = sizeof(PacketType) + sizeof(net::PlayerNumber) +
+        sizeof(net::Frame) + sizeof(std::uint8_t) + (maxInputNmb * (inputBitsNmb + 1u) + 7u) / 8u;
     net::PlayerNumber playerNumber = net::INVALID_PLAYER;
-    std::array<std::uint8_t, sizeof(net::Frame)> currentFrame{};
-    std::array<std::uint8_t, maxInputNmb> inputs{};
+    net::Frame currentFrame = 0;
+    //inputs[i] is the input of the frame currentFrame - i
+    std::uint8_t inputsNmb = 0;
+    std::array<net::PlayerInput, maxInputNmb> inputs{};
 };
 
-inline sf::Packet& operator<<(sf::Packet& packet, const PlayerInputPacket& playerInputPacket)
+inline PacketWriter& operator<<(PacketWriter& writer, const PlayerInputPacket& playerInputPacket)
 {
-    return packet << playerInputPacket.playerNumber <<
-        playerInputPacket.currentFrame << playerInputPacket.inputs;
+    writer << playerInputPacket.playerNumber << playerInputPacket.currentFrame << playerInputPacket.inputsNmb;
+    const std::size_t inputsNmb = playerInputPacket.inputsNmb;
+    neko_assert(inputsNmb <= maxInputNmb, "Too many inputs in the input packet");
+    net::BitWriter bitWriter(writer.GetCurrent(), writer.GetRemainingSize());
+    std::size_t index = 0;
+    while (index < inputsNmb)
+    {
+        const auto input = playerInputPacket.inputs[index];
+        neko_assert(input < 1u << inputBitsNmb, "Player input does not fit in its bits");
+        std::size_t runLength = 1;
+        while (runLength < maxRunLength && index + runLength < inputsNmb &&
+            playerInputPacket.inputs[index + runLength] == input)
+        {
+            runLength++;
+        }
+        bitWriter.Write(input, inputBitsNmb);
+        bitWriter.Write(runLength >= minRunLength, 1);
+        if (runLength >= minRunLength)
+        {
+            bitWriter.Write(std::uint32_t(runLength - minRunLength), runLengthBitsNmb);
+        }
+        index += runLength;
+    }
+    writer.Skip(bitWriter.GetSize());
+    return writer;
 }
 
-inline sf::Packet& operator>>(sf::Packet& packet, PlayerInputPacket& playerInputPacket)
+inline PacketReader& operator>>(PacketReader& reader, PlayerInputPacket& playerInputPacket)
 {
-    return packet >> playerInputPacket.playerNumber >>
-        playerInputPacket.currentFrame >> playerInputPacket.inputs;
+    reader >> playerInputPacket.playerNumber >> playerInputPacket.currentFrame >> playerInputPacket.inputsNmb;
+    const std::size_t inputsNmb = playerInputPacket.inputsNmb;
+    if (!reader.IsValid() || inputsNmb > maxInputNmb)
+    {
+        reader.Invalidate();
+        return reader;
+    }
+    net::BitReader bitReader(reader.GetCurrent(), reader.GetRemainingSize());
+    std::size_t index = 0;
+    while (index < inputsNmb && bitReader.IsValid())
+    {
+        const auto input = net::PlayerInput(bitReader.Read(inputBitsNmb));
+        std::size_t runLength = 1;
+        if (bitReader.Read(1) != 0)
+        {
+            runLength = bitReader.Read(runLengthBitsNmb) + minRunLength;
+        }
+        if (index + runLength > inputsNmb)
+        {
+            reader.Invalidate();
+            return reader;
+        }
+        std::fill_n(playerInputPacket.inputs.begin() + index, runLength, input);
+        index += runLength;
+    }
+    if (!bitReader.IsValid())
+    {
+        reader.Invalidate();
+        return reader;
+    }
+    reader.Skip(bitReader.GetSize());
+    return reader;
 }
 
 struct StartGamePacket : TypedPacket<PacketType::START_GAME>
 {
-    std::array<std::uint8_t, sizeof(unsigned long)> startTime{};
+    static constexpr std::size_t wireSize = sizeof(PacketType) + sizeof(std::uint64_t);
+    std::uint64_t startTime = 0;
 };
 
 
-inline sf::Packet& operator<<(sf::Packet& packet, const StartGamePacket& startGamePacket)
+inline PacketWriter& operator<<(PacketWriter& writer, const StartGamePacket& startGamePacket)
 {
-    return packet << startGamePacket.startTime;
+    return writer << startGamePacket.startTime;
 }
 
-inline sf::Packet& operator>>(sf::Packet& packet, StartGamePacket& startGamePacket)
+inline PacketReader& operator>>(PacketReader& reader, StartGamePacket& startGamePacket)
 {
-    return packet >> startGamePacket.startTime;
+    return reader >> startGamePacket.startTime;
 }
 
 struct ValidateFramePacket : TypedPacket<PacketType::VALIDATE_STATE>
 {
-    std::array<std::uint8_t, sizeof(net::Frame)> newValidateFrame{};
-    std::array<std::uint8_t, sizeof(asteroid::PhysicsState)* maxPlayerNmb> physicsState{};
+    static constexpr std::size_t wireSize = sizeof(PacketType) + sizeof(net::Frame) + sizeof(StateHashes);
+    net::Frame newValidateFrame = 0;
+    //Hashes of the whole game state at the validated frame
+    StateHashes stateHashes{};
 };
 
-inline sf::Packet& operator<<(sf::Packet& packet, const ValidateFramePacket& validateFramePacket)
+inline PacketWriter& operator<<(PacketWriter& writer, const ValidateFramePacket& validateFramePacket)
 {
-    return packet << validateFramePacket.newValidateFrame << validateFramePacket.physicsState;
+    return writer << validateFramePacket.newValidateFrame << validateFramePacket.stateHashes;
 }
 
-inline sf::Packet& operator>>(sf::Packet& packet, ValidateFramePacket& ValidateFramePacket)
+inline PacketReader& operator>>(PacketReader& reader, ValidateFramePacket& validateFramePacket)
 {
-    return packet >> ValidateFramePacket.newValidateFrame >> ValidateFramePacket.physicsState;
+    return reader >> validateFramePacket.newValidateFrame >> validateFramePacket.stateHashes;
 }
 
 struct WinGamePacket : TypedPacket<PacketType::WIN_GAME>
 {
+    static constexpr std::size_t wireSize = sizeof(PacketType) + sizeof(net::PlayerNumber);
     net::PlayerNumber winner = net::INVALID_PLAYER;
 };
 
-inline sf::Packet& operator<<(sf::Packet& packet, const WinGamePacket& winGamePacket)
+inline PacketWriter& operator<<(PacketWriter& writer, const WinGamePacket& winGamePacket)
 {
-    return packet << winGamePacket.winner;
+    return writer << winGamePacket.winner;
 }
 
-inline sf::Packet& operator>>(sf::Packet& packet, WinGamePacket& winGamePacket)
+inline PacketReader& operator>>(PacketReader& reader, WinGamePacket& winGamePacket)
 {
-    return packet >> winGamePacket.winner;
+    return reader >> winGamePacket.winner;
 }
 
-inline void GeneratePacket(sf::Packet& packet, asteroid::Packet& sendingPacket)
+constexpr std::size_t maxPacketSize = std::max({
+    JoinPacket::wireSize,
+    JoinAckPacket::wireSize,
+    SpawnPlayerPacket::wireSize,
+    PlayerInputPacket::wireSize,
+    StartGamePacket::wireSize,
+    ValidateFramePacket::wireSize,
+    WinGamePacket::wireSize});
+/**
+ * \brief Reusable buffer big enough for any packet, a packet is encoded once and sent to all its recipients
+ */
+using PacketBuffer = std::array<std::uint8_t, maxPacketSize>;
+
+template<typename T>
+std::size_t WritePacket(PacketBuffer& buffer, const Packet& sendingPacket)
+{
+    PacketWriter writer(buffer.data(), buffer.size());
+    writer << sendingPacket.packetType << static_cast<const T&>(sendingPacket);
+    neko_assert(writer.GetSize() <= T::wireSize, "Packet wire size does not match its fields");
+    return writer.GetSize();
+}
+
+/**
+ * \brief Encode the packet at the start of the buffer, returns the encoded size
+ */
+inline std::size_t GeneratePacket(PacketBuffer& buffer, const Packet& sendingPacket)
 {
-    packet << sendingPacket;
     switch (sendingPacket.packetType)
     {
-    case PacketType::JOIN:
-    {
-        auto& packetTmp = static_cast<JoinPacket&>(sendingPacket);
-        packet << packetTmp;
-        break;
-    }
-    case PacketType::SPAWN_PLAYER:
-    {
-        auto& packetTmp = static_cast<SpawnPlayerPacket&>(sendingPacket);
-        packet << packetTmp;
-        break;
-    }
-    case PacketType::INPUT:
-    {
-        auto& packetTmp = static_cast<PlayerInputPacket&>(sendingPacket);
-        packet << packetTmp;
-        break;
-    }
-    case PacketType::VALIDATE_STATE:
-    {
-        auto& packetTmp = static_cast<ValidateFramePacket&>(sendingPacket);
-        packet << packetTmp;
-        break;
-    }
-    case PacketType::START_GAME:
-    {
-        auto& packetTmp = static_cast<StartGamePacket&>(sendingPacket);
-        packet << packetTmp;
-        break;
-    }
-    case PacketType::JOIN_ACK:
-    {
-        auto& packetTmp = static_cast<JoinAckPacket&>(sendingPacket);
-        packet << packetTmp;
-        break;
-    }
-    case PacketType::WIN_GAME:
-    {
-        auto& packetTmp = static_cast<WinGamePacket&>(sendingPacket);
-        packet << packetTmp;
-        break;
-    }
-
+    case PacketType::JOIN: return WritePacket<JoinPacket>(buffer, sendingPacket);
+    case PacketType::SPAWN_PLAYER: return WritePacket<SpawnPlayerPacket>(buffer, sendingPacket);
+    case PacketType::INPUT: return WritePacket<PlayerInputPacket>(buffer, sendingPacket);
+    case PacketType::VALIDATE_STATE: return WritePacket<ValidateFramePacket>(buffer, sendingPacket);
+    case PacketType::START_GAME: return WritePacket<StartGamePacket>(buffer, sendingPacket);
+    case PacketType::JOIN_ACK: return WritePacket<JoinAckPacket>(buffer, sendingPacket);
+    case PacketType::WIN_GAME: return WritePacket<WinGamePacket>(buffer, sendingPacket);
     default:;
     }
+    return 0;
 }
-inline std::unique_ptr<Packet> GenerateReceivedPacket(sf::Packet& packet)
+
+template<typename T>
+std::unique_ptr<Packet> ReadPacket(PacketReader& reader, std::size_t size)
 {
-    Packet packetTmp;
-    packet >> packetTmp;
-    switch (packetTmp.packetType)
-    {
-    case PacketType::JOIN:
-    {
-        auto joinPacket = std::make_unique<JoinPacket>();
-        joinPacket->packetType = packetTmp.packetType;
-        packet >> *joinPacket;
-        return joinPacket;
-    }
-    case PacketType::SPAWN_PLAYER:
-    {
-        auto spawnPlayerPacket = std::make_unique<SpawnPlayerPacket>();
-        spawnPlayerPacket->packetType = packetTmp.packetType;
-        packet >> *spawnPlayerPacket;
-        return spawnPlayerPacket;
-    }
-    case PacketType::INPUT:
-    {
-        auto playerInputPacket = std::make_unique<PlayerInputPacket>();
-        playerInputPacket->packetType = packetTmp.packetType;
-        packet >> *playerInputPacket;
-        return playerInputPacket;
-    }
-    case PacketType::VALIDATE_STATE:
-    {
-        auto validateFramePacket = std::make_unique<ValidateFramePacket>();
-        validateFramePacket->packetType = packetTmp.packetType;
-        packet >> *validateFramePacket;
-        return validateFramePacket;
-    }
-    case PacketType::START_GAME:
-    {
-        auto startGamePacket = std::make_unique<StartGamePacket>();
-        startGamePacket->packetType = packetTmp.packetType;
-        packet >> *startGamePacket;
-        return startGamePacket;
-    }
-    case PacketType::JOIN_ACK:
-    {
-        auto joinAckPacket = std::make_unique<JoinAckPacket>();
-        joinAckPacket->packetType = packetTmp.packetType;
-        packet >> *joinAckPacket;
-        return joinAckPacket;
-    }
-    case PacketType::WIN_GAME:
+    if (size > T::wireSize)
+        return nullptr;
+    auto packet = std::make_unique<T>();
+    reader >> *packet;
+    if (!reader.IsValid() || !reader.IsAtEnd())
+        return nullptr;
+    return packet;
+}
+
+/**
+ * \brief Decode a received packet, returns nullptr if the data is not a valid packet
+ */
+inline std::unique_ptr<Packet> GenerateReceivedPacket(const std::uint8_t* data, std::size_t size)
+{
+    PacketReader reader(data, size);
+    PacketType packetType = PacketType::NONE;
+    reader >> packetType;
+    if (!reader.IsValid())
+        return nullptr;
+    switch (packetType)
     {
-        auto winGamePacket = std::make_unique<WinGamePacket>();
-        winGamePacket->packetType = packetTmp.packetType;
-        packet >> *winGamePacket;
-        return winGamePacket;
-    }
+    case PacketType::JOIN: return ReadPacket<JoinPacket>(reader, size);
+    case PacketType::SPAWN_PLAYER: return ReadPacket<SpawnPlayerPacket>(reader, size);
+    case PacketType::INPUT: return ReadPacket<PlayerInputPacket>(reader, size);
+    case PacketType::VALIDATE_STATE: return ReadPacket<ValidateFramePacket>(reader, size);
+    case PacketType::START_GAME: return ReadPacket<StartGamePacket>(reader, size);
+    case PacketType::JOIN_ACK: return ReadPacket<JoinAckPacket>(reader, size);
+    case PacketType::WIN_GAME: return ReadPacket<WinGamePacket>(reader, size);
     default:;
     }
     return nullptr;
@@ -25,6 +25,7 @@
 #pragma once
 #include "mathematics/vector.h"
 #include "engine/component.h"
+#include "asteroid/rollback_history.h"
 
 namespace neko::asteroid
 {
@@ -49,19 +50,24 @@ struct Box
     bool isTrigger = false;
 };
 
+/**
+ * \brief Inclusive overlap test of two rectangles given by their bottom left corner and size
+ */
+bool Box2Box(float r1x, float r1y, float r1w, float r1h, float r2x, float r2y, float r2w, float r2h);
+
 class OnCollisionInterface
 {
 public:
     virtual void OnCollision(Entity entity1, Entity entity2) = 0;
 };
 
-class BodyManager : public ComponentManager<Body, EntityMask(neko::ComponentType::BODY2D)>
+class BodyManager : public RollbackComponentManager<Body, EntityMask(neko::ComponentType::BODY2D)>
 {
-    using ComponentManager::ComponentManager;
+    using RollbackComponentManager::RollbackComponentManager;
 };
-class BoxManager : public ComponentManager<Box, EntityMask(neko::ComponentType::BOX_COLLIDER2D)>
+class BoxManager : public RollbackComponentManager<Box, EntityMask(neko::ComponentType::BOX_COLLIDER2D)>
 {
-    using ComponentManager::ComponentManager;
+    using RollbackComponentManager::RollbackComponentManager;
 };
 
 class PhysicsManager
@@ -69,6 +75,11 @@ class PhysicsManager
 public:
     explicit PhysicsManager(EntityManager& entityManager);
     PhysicsManager (const PhysicsManager& physicsManager) = default;
+    /**
+     * \brief Integrate the bodies and call the collision listeners, a sort and sweep broadphase
+     * finds the overlapping boxes and the pairs are reported in increasing (entity, otherEntity) order
+     * like a brute force loop would, so that the rollback resimulation stays deterministic
+     */
     void FixedUpdate(seconds dt);
     [[nodiscard]] const Body& GetBody(Entity entity) const;
     void SetBody(Entity entity, const Body& body);
@@ -79,7 +90,20 @@ public:
     [[nodiscard]] const Box& GetBox(Entity entity) const;
 
     void RegisterCollisionListener(OnCollisionInterface& collisionInterface);
+    /**
+     * \brief Record the bodies and boxes overwritten during the simulated frame
+     */
+    void StartFrame(net::Frame frame);
+    void StopRecording();
+    /**
+     * \brief Restore the bodies and boxes as they were at the end of frame
+     */
+    void Rewind(net::Frame frame);
+    void ClearHistory();
 private:
+    void FindCollisionPairs() const;
+    void ExecuteCollisionPairs();
+
     std::reference_wrapper<EntityManager> entityManager_;
     BodyManager bodyManager_;
     BoxManager boxManager_;
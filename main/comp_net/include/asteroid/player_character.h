@@ -39,7 +39,7 @@ struct PlayerCharacter
     float invincibilityTime = 0.0f;
 };
 class GameManager;
-class PlayerCharacterManager : public ComponentManager<PlayerCharacter, EntityMask(ComponentType::PLAYER_CHARACTER)>
+class PlayerCharacterManager : public RollbackComponentManager<PlayerCharacter, EntityMask(ComponentType::PLAYER_CHARACTER)>
 {
 public:
     explicit PlayerCharacterManager(EntityManager& entityManager, PhysicsManager& physicsManager, GameManager& gameManager);
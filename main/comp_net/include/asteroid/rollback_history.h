@@ -0,0 +1,146 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#pragma once
+#include <limits>
+#include <vector>
+
+#include "engine/component.h"
+#include "comp_net/type.h"
+
+namespace neko::asteroid
+{
+
+/**
+ * \brief Undo log of a component array ordered by simulated frame. The first write on an entity
+ * during a frame saves its previous value, rewinding to an older frame copies back only the values
+ * changed since, newest frame first.
+ */
+template<typename T>
+class ComponentHistory
+{
+public:
+    /**
+     * \brief Start to record the writes of the simulated frame, frames have to be recorded in increasing order
+     */
+    void StartFrame(net::Frame frame)
+    {
+        recordingFrame_ = frame;
+        isRecording_ = true;
+    }
+    void StopRecording() { isRecording_ = false; }
+
+    void Record(Entity entity, const T& previousValue)
+    {
+        if (!isRecording_)
+            return;
+        if (entity >= recordedFrames_.size())
+        {
+            recordedFrames_.resize(std::size_t(entity) + 1, INVALID_FRAME);
+        }
+        if (recordedFrames_[entity] == recordingFrame_)
+            return;
+        recordedFrames_[entity] = recordingFrame_;
+        records_.push_back({ previousValue, entity, recordingFrame_ });
+    }
+
+    /**
+     * \brief Undo all the frames after frame by calling restore(entity, previousValue)
+     */
+    template<typename RestoreFunc>
+    void Rewind(net::Frame frame, RestoreFunc restore)
+    {
+        while (!records_.empty() && records_.back().frame > frame)
+        {
+            const auto& record = records_.back();
+            restore(record.entity, record.previousValue);
+            recordedFrames_[record.entity] = INVALID_FRAME;
+            records_.pop_back();
+        }
+    }
+
+    /**
+     * \brief Forget the recorded frames once they are validated, the capacity is kept for the next frames
+     */
+    void Clear()
+    {
+        for (const auto& record : records_)
+        {
+            recordedFrames_[record.entity] = INVALID_FRAME;
+        }
+        records_.clear();
+    }
+
+    template<typename Func>
+    void ForEachRecordedEntity(Func func) const
+    {
+        for (const auto& record : records_)
+        {
+            func(record.entity);
+        }
+    }
+
+    [[nodiscard]] std::size_t GetRecordsNmb() const { return records_.size(); }
+private:
+    static constexpr net::Frame INVALID_FRAME = std::numeric_limits<net::Frame>::max();
+    struct Entry
+    {
+        T previousValue;
+        Entity entity;
+        net::Frame frame;
+    };
+    std::vector<Entry> records_;
+    std::vector<net::Frame> recordedFrames_;
+    net::Frame recordingFrame_ = INVALID_FRAME;
+    bool isRecording_ = false;
+};
+
+/**
+ * \brief Component manager keeping the history of its writes for the rollback
+ */
+template<typename T, EntityMask componentType>
+class RollbackComponentManager : public ComponentManager<T, componentType>
+{
+public:
+    using ComponentManager<T, componentType>::ComponentManager;
+
+    void SetComponent(Entity entity, const T& component) override
+    {
+        history_.Record(entity, this->components_[entity]);
+        this->components_[entity] = component;
+    }
+    void StartFrame(net::Frame frame) { history_.StartFrame(frame); }
+    void StopRecording() { history_.StopRecording(); }
+    void Rewind(net::Frame frame)
+    {
+        history_.Rewind(frame, [this](Entity entity, const T& component)
+        {
+            this->components_[entity] = component;
+        });
+    }
+    void ClearHistory() { history_.Clear(); }
+private:
+    ComponentHistory<T> history_;
+};
+}
@@ -47,6 +47,11 @@ struct DestroyedBullet
     net::Frame destroyedFrame = 0;
 };
 
+/**
+ * \brief Keeps the game state of the last simulated frame with the history of the component and entity
+ * mask writes of the frames after the last validated frame, a rollback only rewinds and simulates again
+ * the frames after the first input that changed
+ */
 class RollbackManager : public OnCollisionInterface
 {
 public:
@@ -62,15 +67,25 @@ public:
      */
     void ValidateFrame(net::Frame newValidateFrame);
     /**
-     * \brief Confirm Frame and Check with Physics State checksum, called by the clients when receiving Confirm Frame packet
+     * \brief Confirm Frame and Check with the server state hashes, called by the clients when receiving Confirm Frame packet.
+     * On a desync, the components whose hash differs are dumped to the log
+     */
+    void ConfirmFrame(net::Frame newValidatedFrame, const StateHashes& serverStateHashes);
+    /**
+     * \brief Hashes of the game state at the last validated frame, computed by ValidateFrame
      */
-    void ConfirmFrame(net::Frame newValidatedFrame, const std::array<PhysicsState, maxPlayerNmb>& serverPhysicsState);
-    [[nodiscard]] PhysicsState GetValidatePhysicsState(net::PlayerNumber playerNumber) const;
+    [[nodiscard]] const StateHashes& GetValidateStateHashes() const { return lastValidateStateHashes_; }
+    /**
+     * \brief Hash the rollback components of the live entities, each component array is copied in a contiguous
+     * buffer without the padding bytes and the stale components of the destroyed entities, then hashed at once
+     */
+    StateHashes ComputeStateHashes();
     [[nodiscard]] net::Frame GetLastValidateFrame() const { return lastValidateFrame_; }
     [[nodiscard]] net::Frame GetLastReceivedFrame(net::PlayerNumber playerNumber) const { return lastReceivedFrame_[playerNumber]; }
     [[nodiscard]] net::Frame GetCurrentFrame() const { return currentFrame_; }
     [[nodiscard]] const Transform2dManager& GetTransformManager() const { return currentTransformManager_; }
     [[nodiscard]] const PlayerCharacterManager& GetPlayerCharacterManager() const { return currentPlayerManager_; }
+    [[nodiscard]] const PhysicsManager& GetPhysicsManager() const { return currentPhysicsManager_; }
     void SpawnPlayer(net::PlayerNumber playerNumber, Entity entity, Vec2f position, degree_t rotation);
     void SpawnBullet(net::PlayerNumber playerNumber, Entity entity, Vec2f position, Vec2f velocity);
     /**
@@ -81,23 +96,42 @@ public:
     void OnCollision(Entity entity1, Entity entity2) override;
 private:
     net::PlayerInput GetInputAtFrame(net::PlayerNumber playerNumber, net::Frame frame);
+    void SetInputAtFrame(net::PlayerNumber playerNumber, net::PlayerInput playerInput, net::Frame frame);
+    /**
+     * \brief Restore the game state at the end of frame, frame cannot be older than the last validated frame
+     */
+    void RewindToFrame(net::Frame frame);
+    /**
+     * \brief Simulate the frames after the last simulated frame until lastFrame while recording their history
+     */
+    void SimulateToFrame(net::Frame lastFrame);
+    /**
+     * \brief Log the local values of the components whose hash differs from the server one
+     */
+    void LogStateDiff(net::Frame frame, const StateHashes& serverStateHashes);
     GameManager& gameManager_;
     EntityManager& entityManager_;
     /**
      * \brief Used for rendering
      */
     Transform2dManager currentTransformManager_;
+    ComponentHistory<EntityMask> entityMaskHistory_;
     PhysicsManager currentPhysicsManager_;
     PlayerCharacterManager currentPlayerManager_;
     BulletManager currentBulletManager_;
-    PhysicsManager lastValidatePhysicsManager_;
-    PlayerCharacterManager lastValidatePlayerManager_;
-    BulletManager lastValidateBulletManager_;
+    StateHashes lastValidateStateHashes_{};
+    //Reused buffers of the hashed component arrays
+    std::array<std::vector<std::uint8_t>, std::tuple_size_v<StateHashes>> stateBuffers_;
 
 
     net::Frame lastValidateFrame_ = 0;
     net::Frame currentFrame_ = 0;
     net::Frame testedFrame_ = 0;
+    net::Frame simulatedFrame_ = 0;
+    /**
+     * \brief Oldest frame whose input changed since the last simulation, the frames before are still valid
+     */
+    net::Frame firstChangedInputFrame_ = std::numeric_limits<net::Frame>::max();
 
     static const size_t windowBufferSize = 5 * 50;
     std::array<std::uint32_t, maxPlayerNmb> lastReceivedFrame_{};
@@ -44,9 +44,12 @@ public:
 
 
 private:
-    void ReceivePacket(sf::Packet& packet, PacketSource source);
+    void ReceivePacket(const std::uint8_t* data, std::size_t size, PacketSource source);
     sf::UdpSocket udpSocket_;
     sf::TcpSocket tcpSocket_;
+    asteroid::PacketBuffer sendBuffer_{};
+    //One more byte than the biggest packet, a bigger datagram is truncated and never matches a packet size
+    std::array<std::uint8_t, asteroid::maxPacketSize + 1> receiveBuffer_{};
 
     std::string serverAddress_ = "localhost";
     unsigned short serverTcpPort_ = 12345;
@@ -6,6 +6,7 @@
 #include "asteroid/packet_type.h"
 #include "asteroid/game_manager.h"
 #include "asteroid/server.h"
+#include "asteroid_net/udp_batch_socket.h"
 
 namespace neko::net
 {
@@ -38,6 +39,10 @@ public:
 
     void SetTcpPort(unsigned short i);
 
+    [[nodiscard]] unsigned short GetTcpPort() const { return tcpPort_; }
+    [[nodiscard]] unsigned short GetUdpPort() const { return udpPort_; }
+    [[nodiscard]] std::size_t GetReceivedUdpPacketsNmb() const { return receivedUdpPacketsNmb_; }
+
     bool IsOpen() const;
 protected:
     void SpawnNewPlayer(ClientId clientId, PlayerNumber playerNumber) override;
@@ -47,7 +52,7 @@ private:
         PacketSocketSource packetSource, 
         sf::IpAddress address = "localhost", 
         unsigned short port = 0);
-    void ReceivePacket(sf::Packet& packet, PacketSocketSource packetSource,
+    void ReceivePacket(const std::uint8_t* data, std::size_t size, PacketSocketSource packetSource,
         sf::IpAddress address = "localhost",
         unsigned short port = 0);
 
@@ -57,7 +62,11 @@ private:
         STARTED = 1u << 1u,
         FIRST_PLAYER_CONNECT = 1u << 2u,
     };
-    sf::UdpSocket udpSocket_;
+    //Bound on the datagrams processed in one update, so a flood cannot stall the game update
+    static constexpr std::size_t maxUdpBatchesPerUpdate = 64;
+    UdpBatchSocket udpSocket_;
+    std::vector<UdpEndpoint> udpEndpoints_;
+    asteroid::PacketBuffer sendBuffer_{};
     sf::TcpListener tcpListener_;
     std::array<sf::TcpSocket, asteroid::maxPlayerNmb> tcpSockets_;
 
@@ -67,6 +76,7 @@ private:
     unsigned short tcpPort_ = 12345;
     unsigned short udpPort_ = 12345;
     Index lastSocketIndex_ = 0;
+    std::size_t receivedUdpPacketsNmb_ = 0;
     std::uint8_t status_ = 0;
 };
 }
\ No newline at end of file
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "SFML/Network.hpp"
+#include "asteroid/packet_type.h"
+#include "asteroid/server.h"
+#include "asteroid_net/udp_batch_socket.h"
+#include "engine/jobsystem.h"
+
+namespace neko::net
+{
+using RoomIndex = std::uint32_t;
+const RoomIndex INVALID_ROOM = std::numeric_limits<RoomIndex>::max();
+
+/**
+ * \brief Work done by one room, accumulated over the ticks since the last ResetMetrics
+ */
+struct RoomMetrics
+{
+    std::size_t ticksNmb = 0;
+    //Ticks stopped by the tick budget, their remaining packets are processed at the next tick
+    std::size_t overBudgetTicksNmb = 0;
+    std::size_t processedPacketsNmb = 0;
+    //Packets not decoded, not coming from the player of their endpoint or outside the input window
+    std::size_t invalidPacketsNmb = 0;
+    std::chrono::nanoseconds tickTime{0};
+    std::chrono::nanoseconds maxTickTime{0};
+};
+
+/**
+ * \brief Player of a room, its TCP socket is owned by the room once it joined
+ */
+struct RoomPlayer
+{
+    ClientId clientId = 0;
+    std::unique_ptr<sf::TcpSocket> tcpSocket;
+    UdpEndpoint udpEndpoint;
+};
+
+/**
+ * \brief One match of the room server. The received datagrams are queued by the network thread and processed
+ * by Tick on a job, the packets sent by the match are queued until the network thread sends them.
+ */
+class ServerRoom : public Server
+{
+public:
+    //Bound on the queued datagrams, a room over its tick budget cannot grow its queue forever
+    static constexpr std::size_t maxQueuedDatagramsNmb = 256;
+    struct OutgoingPacket
+    {
+        std::size_t offset = 0;
+        std::size_t size = 0;
+        bool isReliable = false;
+    };
+
+    void Init() override;
+    void Update(seconds dt) override;
+    void Destroy() override;
+
+    void SendReliablePacket(std::unique_ptr<asteroid::Packet> packet) override;
+    void SendUnreliablePacket(std::unique_ptr<asteroid::Packet> packet) override;
+
+    /**
+     * \brief Join the room with the TCP connection of the player, returns the player number
+     */
+    PlayerNumber Join(const asteroid::JoinPacket& joinPacket, std::unique_ptr<sf::TcpSocket> tcpSocket);
+    /**
+     * \brief Copy a datagram received from the player, it is decoded and processed at the next Tick.
+     * Returns false when the queue is full and the datagram is dropped
+     */
+    bool QueueReceivedDatagram(PlayerNumber playerNumber, const std::uint8_t* data, std::size_t size);
+    /**
+     * \brief Process the queued datagrams until the tick budget is spent, called on a job
+     */
+    void Tick(std::chrono::nanoseconds tickBudget);
+
+    [[nodiscard]] PlayerNumber GetPlayersNmb() const { return lastPlayerNumber_; }
+    [[nodiscard]] RoomPlayer& GetPlayer(PlayerNumber playerNumber) { return players_[playerNumber]; }
+    [[nodiscard]] const std::vector<OutgoingPacket>& GetOutgoingPackets() const { return outgoingPackets_; }
+    [[nodiscard]] const std::uint8_t* GetOutgoingData(const OutgoingPacket& outgoingPacket) const
+    {
+        return &outgoingData_[outgoingPacket.offset];
+    }
+    void ClearOutgoingPackets();
+    [[nodiscard]] const RoomMetrics& GetMetrics() const { return metrics_; }
+    void ResetMetrics() { metrics_ = {}; }
+protected:
+    void SpawnNewPlayer(ClientId clientId, PlayerNumber playerNumber) override;
+private:
+    void QueueOutgoingPacket(const asteroid::Packet& packet, bool isReliable);
+    void ProcessReceivedDatagram(const std::uint8_t* data, std::size_t size, PlayerNumber playerNumber);
+
+    struct ReceivedDatagram
+    {
+        std::size_t offset = 0;
+        std::size_t size = 0;
+        PlayerNumber playerNumber = INVALID_PLAYER;
+    };
+    std::array<RoomPlayer, asteroid::maxPlayerNmb> players_{};
+    std::vector<std::uint8_t> receivedData_;
+    std::vector<ReceivedDatagram> receivedDatagrams_;
+    std::vector<std::uint8_t> outgoingData_;
+    std::vector<OutgoingPacket> outgoingPackets_;
+    asteroid::PacketBuffer sendBuffer_{};
+    RoomMetrics metrics_;
+};
+
+/**
+ * \brief Work done by the room server, accumulated over the ticks since the last ResetMetrics
+ */
+struct RoomServerMetrics
+{
+    std::size_t ticksNmb = 0;
+    std::size_t receivedDatagramsNmb = 0;
+    std::size_t sentDatagramsNmb = 0;
+    //Datagrams of unknown endpoints or sent to a full room queue
+    std::size_t droppedDatagramsNmb = 0;
+    //Time spent receiving, routing and sending on the network thread
+    std::chrono::nanoseconds networkTime{0};
+    //Sum of the rooms metrics
+    RoomMetrics rooms;
+};
+
+/**
+ * \brief Headless server hosting many matches in one process. All the rooms share one TCP listener and one
+ * UDP socket, the players are routed to their room by client id when they join, and by UDP endpoint after.
+ * Each update, the rooms process their received packets as independent jobs.
+ */
+class RoomServerNetworkManager : public SystemInterface
+{
+public:
+    void Init() override;
+    void Update(seconds dt) override;
+    void Destroy() override;
+
+    void SetTcpPort(unsigned short tcpPort) { tcpPort_ = tcpPort; }
+    void SetMaxRoomsNmb(std::size_t maxRoomsNmb) { maxRoomsNmb_ = maxRoomsNmb; }
+    /**
+     * \brief Time a room can spend processing its packets in one update
+     */
+    void SetRoomTickBudget(std::chrono::nanoseconds roomTickBudget) { roomTickBudget_ = roomTickBudget; }
+    [[nodiscard]] unsigned short GetTcpPort() const { return tcpPort_; }
+    [[nodiscard]] unsigned short GetUdpPort() const { return udpPort_; }
+    [[nodiscard]] std::size_t GetRoomsNmb() const { return roomsNmb_; }
+    [[nodiscard]] const RoomServerMetrics& GetMetrics() const { return metrics_; }
+    void ResetMetrics() { metrics_ = {}; }
+    bool IsOpen() const { return isOpen_; }
+private:
+    struct ClientSlot
+    {
+        RoomIndex roomIndex = INVALID_ROOM;
+        PlayerNumber playerNumber = INVALID_PLAYER;
+    };
+    void AcceptConnections();
+    void ReceiveTcpPackets();
+    void ReceiveUdpPackets();
+    void JoinRoom(std::size_t connectionIndex, const asteroid::JoinPacket& joinPacket);
+    void JoinUdp(const asteroid::JoinPacket& joinPacket, const UdpEndpoint& endpoint);
+    void SendRoomPackets();
+    void SendReliablePacket(RoomPlayer& player, const std::uint8_t* data, std::size_t size);
+    void CloseRoom(RoomIndex roomIndex);
+    RoomIndex FindFillingRoom();
+    static std::uint64_t GetEndpointKey(const UdpEndpoint& endpoint);
+
+    //Bound on the datagrams processed in one update, so a flood cannot stall the rooms
+    static constexpr std::size_t maxUdpBatchesPerUpdate = 64;
+
+    JobSystem jobSystem_;
+    UdpBatchSocket udpSocket_;
+    sf::TcpListener tcpListener_;
+    std::unique_ptr<sf::TcpSocket> acceptedSocket_;
+    //Connections accepted but not joined to a room yet
+    std::vector<std::unique_ptr<sf::TcpSocket>> connections_;
+    //Free rooms are nullptr, a closed room slot is reused by the next match
+    std::vector<std::unique_ptr<ServerRoom>> rooms_;
+    std::unordered_map<ClientId, ClientSlot> clients_;
+    std::unordered_map<std::uint64_t, ClientSlot> udpClients_;
+    std::vector<UdpDatagram> outgoingDatagrams_;
+    asteroid::PacketBuffer sendBuffer_{};
+    RoomIndex fillingRoomIndex_ = INVALID_ROOM;
+    std::size_t roomsNmb_ = 0;
+    std::size_t maxRoomsNmb_ = 1'000;
+    std::chrono::nanoseconds roomTickBudget_ = std::chrono::milliseconds(2);
+    RoomServerMetrics metrics_;
+    unsigned short tcpPort_ = 12345;
+    unsigned short udpPort_ = 12345;
+    bool isOpen_ = false;
+};
+}
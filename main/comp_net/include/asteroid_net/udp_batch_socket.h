@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "SFML/Network.hpp"
+
+#if defined(__linux__)
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+namespace neko::net
+{
+/**
+ * \brief Remote address of a datagram
+ */
+struct UdpEndpoint
+{
+    sf::IpAddress address;
+    unsigned short port = 0;
+};
+
+/**
+ * \brief Datagram received in the packet arena of the socket, only valid until the next ReceiveBatch
+ */
+struct UdpDatagram
+{
+    const std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+    UdpEndpoint endpoint;
+};
+
+/**
+ * \brief Non blocking UDP socket receiving and sending several datagrams with one system call,
+ * with recvmmsg and sendmmsg on Linux and one datagram at a time elsewhere
+ */
+class UdpBatchSocket : public sf::UdpSocket
+{
+public:
+    static constexpr std::size_t batchSize = 64;
+    //Largest datagram that fits an ethernet frame, bigger datagrams are dropped.
+    //Without recvmmsg a truncated read cannot be told apart, so a datagram filling the buffer is dropped too
+    static constexpr std::size_t maxDatagramSize = 1'472;
+
+    UdpBatchSocket();
+
+    /**
+     * \brief Receive up to batchSize pending datagrams into the packet arena,
+     * returns the number of datagrams read from the socket, including the dropped ones
+     */
+    std::size_t ReceiveBatch();
+    /**
+     * \brief Number of valid datagrams of the last ReceiveBatch
+     */
+    [[nodiscard]] std::size_t GetDatagramsNmb() const { return datagramsNmb_; }
+    [[nodiscard]] const UdpDatagram& GetDatagram(std::size_t index) const { return datagrams_[index]; }
+    /**
+     * \brief Receive batches until the socket is empty or maxBatchesNmb batches were read,
+     * calls onDatagram with each valid datagram and returns their number
+     */
+    template<typename TFunc>
+    std::size_t ReceiveBatches(std::size_t maxBatchesNmb, TFunc onDatagram)
+    {
+        std::size_t datagramsNmb = 0;
+        for (std::size_t batch = 0; batch < maxBatchesNmb; batch++)
+        {
+            const auto readNmb = ReceiveBatch();
+            for (std::size_t i = 0; i < datagramsNmb_; i++)
+            {
+                onDatagram(datagrams_[i]);
+            }
+            datagramsNmb += datagramsNmb_;
+            //Only a partial read means that the socket is empty, dropped datagrams still count
+            if (readNmb < batchSize)
+                break;
+        }
+        return datagramsNmb;
+    }
+
+    /**
+     * \brief Send the same datagram to all the endpoints, returns the number of sent datagrams
+     */
+    std::size_t SendBatch(const void* data, std::size_t size, const std::vector<UdpEndpoint>& endpoints);
+    /**
+     * \brief Send each datagram to its endpoint, returns the number of sent datagrams
+     */
+    std::size_t SendBatch(const std::vector<UdpDatagram>& datagrams);
+private:
+#if defined(__linux__)
+    void SetSendMessage(std::size_t index, const void* data, std::size_t size, const UdpEndpoint& endpoint);
+    std::size_t SendMessages(std::size_t messagesNmb);
+#endif
+    std::vector<std::uint8_t> packetArena_;
+    std::array<UdpDatagram, batchSize> datagrams_{};
+    std::size_t datagramsNmb_ = 0;
+#if defined(__linux__)
+    std::array<mmsghdr, batchSize> messages_{};
+    std::array<iovec, batchSize> iovecs_{};
+    std::array<sockaddr_in, batchSize> addresses_{};
+#endif
+};
+}
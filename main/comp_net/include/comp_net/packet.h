@@ -1,7 +1,87 @@
 #pragma once
 
-#include <array>
+#include <cstdint>
+
+#include "engine/assert.h"
+
 namespace neko::net
 {
+/**
+ * \brief Packs values of a few bits one after the other in a byte buffer, from the least significant bit of each byte
+ */
+class BitWriter
+{
+public:
+    BitWriter(std::uint8_t* data, std::size_t capacity) : data_(data), capacity_(capacity) {}
+    void Write(std::uint32_t value, std::uint32_t bitsNmb)
+    {
+        neko_assert(bitsNmb <= 32u, "Cannot write more than 32 bits at once");
+        neko_assert(size_ * 8u + scratchBitsNmb_ + bitsNmb <= capacity_ * 8u, "Bits do not fit in the buffer");
+        scratch_ |= (std::uint64_t(value) & ((std::uint64_t(1) << bitsNmb) - 1u)) << scratchBitsNmb_;
+        scratchBitsNmb_ += bitsNmb;
+        while (scratchBitsNmb_ >= 8u)
+        {
+            data_[size_++] = std::uint8_t(scratch_);
+            scratch_ >>= 8u;
+            scratchBitsNmb_ -= 8u;
+        }
+        //The last byte is written at each write, its padding bits stay zero
+        if (scratchBitsNmb_ > 0)
+        {
+            data_[size_] = std::uint8_t(scratch_);
+        }
+    }
+    /**
+     * \brief Number of bytes used by the written bits
+     */
+    [[nodiscard]] std::size_t GetSize() const { return size_ + (scratchBitsNmb_ > 0 ? 1u : 0u); }
+private:
+    std::uint8_t* data_;
+    std::size_t capacity_;
+    //Number of complete bytes written
+    std::size_t size_ = 0;
+    //Bits of the last incomplete byte
+    std::uint64_t scratch_ = 0;
+    std::uint32_t scratchBitsNmb_ = 0;
+};
 
+/**
+ * \brief Reads the values packed by a BitWriter, reading past the end of the data invalidates the reader
+ */
+class BitReader
+{
+public:
+    BitReader(const std::uint8_t* data, std::size_t size) : data_(data), size_(size) {}
+    std::uint32_t Read(std::uint32_t bitsNmb)
+    {
+        neko_assert(bitsNmb <= 32u, "Cannot read more than 32 bits at once");
+        if ((size_ - readPos_) * 8u + scratchBitsNmb_ < bitsNmb)
+        {
+            isValid_ = false;
+            return 0;
+        }
+        while (scratchBitsNmb_ < bitsNmb)
+        {
+            scratch_ |= std::uint64_t(data_[readPos_++]) << scratchBitsNmb_;
+            scratchBitsNmb_ += 8u;
+        }
+        const auto value = std::uint32_t(scratch_ & ((std::uint64_t(1) << bitsNmb) - 1u));
+        scratch_ >>= bitsNmb;
+        scratchBitsNmb_ -= bitsNmb;
+        return value;
+    }
+    [[nodiscard]] bool IsValid() const { return isValid_; }
+    /**
+     * \brief Number of bytes used by the read bits
+     */
+    [[nodiscard]] std::size_t GetSize() const { return readPos_; }
+private:
+    const std::uint8_t* data_;
+    std::size_t size_;
+    std::size_t readPos_ = 0;
+    //Bits of the last read byte not returned yet
+    std::uint64_t scratch_ = 0;
+    std::uint32_t scratchBitsNmb_ = 0;
+    bool isValid_ = true;
+};
 } // namespace neko::net
@@ -0,0 +1,256 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "asteroid_net/network_server.h"
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+using namespace neko;
+
+/**
+ * \brief Player joining the server with TCP then UDP, as the network client does
+ */
+struct LoadTestPlayer
+{
+    sf::TcpSocket tcpSocket;
+    sf::UdpSocket udpSocket;
+    bool hasStarted = false;
+    bool hasJoinedUdp = false;
+};
+
+bool IsPacketType(const void* data, std::size_t size, asteroid::PacketType packetType)
+{
+    const auto receivedPacket = asteroid::GenerateReceivedPacket(static_cast<const std::uint8_t*>(data), size);
+    return receivedPacket != nullptr && receivedPacket->packetType == packetType;
+}
+
+std::unique_ptr<asteroid::JoinPacket> CreateJoinPacket(net::ClientId clientId)
+{
+    auto joinPacket = std::make_unique<asteroid::JoinPacket>();
+    joinPacket->clientId = clientId;
+    joinPacket->startTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return joinPacket;
+}
+
+/**
+ * \brief Update the server until all the players passed the condition, returns false after the timeout
+ */
+template<typename Func>
+bool UpdateServerUntil(net::ServerNetworkManager& server, Func isDone)
+{
+    const auto timeout = Clock::now() + std::chrono::seconds(5);
+    while (Clock::now() < timeout)
+    {
+        server.Update(seconds(0.0f));
+        if (isDone())
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+/**
+ * \brief Simulated client sending the input packets of one player to the server, the inputs follow the
+ * fixed frame of the elapsed time and never shoot so the game does not end during the test
+ */
+void RunFloodClient(net::PlayerNumber playerNumber, unsigned short udpPort, std::size_t packetsPerSecond,
+    Clock::time_point startTime, const std::atomic<bool>& isRunning, std::atomic<std::size_t>& sentPacketsNmb)
+{
+    sf::UdpSocket socket;
+    if (socket.bind(sf::Socket::AnyPort) != sf::Socket::Done)
+    {
+        logDebug("[Error] Load test client could not bind its UDP socket");
+        return;
+    }
+    asteroid::PlayerInputPacket inputPacket;
+    inputPacket.playerNumber = playerNumber;
+    asteroid::PacketBuffer sendBuffer{};
+    const auto sendPeriod = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / double(packetsPerSecond)));
+    auto nextSendTime = Clock::now();
+    std::size_t sentNmb = 0;
+    while (isRunning.load(std::memory_order_relaxed))
+    {
+        const auto elapsedTime = std::chrono::duration_cast<seconds>(Clock::now() - startTime);
+        const auto frame = net::Frame(elapsedTime.count() / asteroid::GameManager::FixedPeriod) + 1;
+        inputPacket.currentFrame = frame;
+        //The simulated clients do not read the acknowledgements and always send their whole input window
+        inputPacket.inputsNmb = std::uint8_t(std::min<std::size_t>(asteroid::maxInputNmb, frame + 1));
+        for (std::size_t i = 0; i < inputPacket.inputsNmb; i++)
+        {
+            const auto inputFrame = frame - net::Frame(i);
+            inputPacket.inputs[i] = (inputFrame / 25 + playerNumber) % 2 == 0 ?
+                asteroid::PlayerInput::UP | asteroid::PlayerInput::LEFT :
+                asteroid::PlayerInput::RIGHT;
+        }
+        const auto packetSize = asteroid::GeneratePacket(sendBuffer, inputPacket);
+        if (socket.send(sendBuffer.data(), packetSize, sf::IpAddress::LocalHost, udpPort) == sf::Socket::Done)
+        {
+            sentNmb++;
+        }
+        nextSendTime += sendPeriod;
+        std::this_thread::sleep_until(nextSendTime);
+    }
+    sentPacketsNmb += sentNmb;
+}
+}
+
+/**
+ * \brief Loopback load test of the asteroid server: two players join, then simulated clients flood the
+ * server with input packets. The server updates at the tick rate, or as fast as it can with a tick rate of 0.
+ * Usage: comp_net_load_test [clients number] [packets per second per client] [duration in seconds] [tick rate]
+ */
+int main(int argc, char** argv)
+{
+    const std::size_t clientsNmb = argc > 1 ? std::stoul(argv[1]) : 32;
+    const std::size_t packetsPerSecond = argc > 2 ? std::stoul(argv[2]) : 500;
+    const int durationSeconds = argc > 3 ? std::stoi(argv[3]) : 10;
+    const float tickRate = argc > 4 ? std::stof(argv[4]) : 1.0f / asteroid::GameManager::FixedPeriod;
+
+    net::ServerNetworkManager server;
+    server.Init();
+    std::array<LoadTestPlayer, asteroid::maxPlayerNmb> players;
+    for (net::PlayerNumber playerNumber = 0; playerNumber < asteroid::maxPlayerNmb; playerNumber++)
+    {
+        auto& player = players[playerNumber];
+        if (player.tcpSocket.connect(sf::IpAddress::LocalHost, server.GetTcpPort()) != sf::Socket::Done ||
+            player.udpSocket.bind(sf::Socket::AnyPort) != sf::Socket::Done)
+        {
+            logDebug("[Error] Load test player could not connect to the server");
+            return 1;
+        }
+        asteroid::PacketBuffer sendBuffer{};
+        sf::Packet joinPacket;
+        joinPacket.append(sendBuffer.data(), asteroid::GeneratePacket(sendBuffer, *CreateJoinPacket(playerNumber + 1)));
+        player.tcpSocket.send(joinPacket);
+        player.tcpSocket.setBlocking(false);
+        player.udpSocket.setBlocking(false);
+    }
+    const bool hasStarted = UpdateServerUntil(server, [&players]()
+    {
+        for (auto& player : players)
+        {
+            sf::Packet packet;
+            while (player.tcpSocket.receive(packet) == sf::Socket::Done)
+            {
+                player.hasStarted = player.hasStarted ||
+                    IsPacketType(packet.getData(), packet.getDataSize(), asteroid::PacketType::START_GAME);
+            }
+        }
+        return std::all_of(players.begin(), players.end(), [](const auto& player) { return player.hasStarted; });
+    });
+    for (net::PlayerNumber playerNumber = 0; playerNumber < asteroid::maxPlayerNmb; playerNumber++)
+    {
+        asteroid::PacketBuffer sendBuffer{};
+        const auto packetSize = asteroid::GeneratePacket(sendBuffer, *CreateJoinPacket(playerNumber + 1));
+        players[playerNumber].udpSocket.send(sendBuffer.data(), packetSize, sf::IpAddress::LocalHost, server.GetUdpPort());
+    }
+    const bool hasJoinedUdp = hasStarted && UpdateServerUntil(server, [&players]()
+    {
+        for (auto& player : players)
+        {
+            asteroid::PacketBuffer receiveBuffer{};
+            std::size_t receivedSize = 0;
+            sf::IpAddress address;
+            unsigned short port;
+            while (player.udpSocket.receive(receiveBuffer.data(), receiveBuffer.size(), receivedSize, address, port) ==
+                sf::Socket::Done)
+            {
+                player.hasJoinedUdp = player.hasJoinedUdp ||
+                    IsPacketType(receiveBuffer.data(), receivedSize, asteroid::PacketType::JOIN_ACK);
+            }
+        }
+        return std::all_of(players.begin(), players.end(), [](const auto& player) { return player.hasJoinedUdp; });
+    });
+    if (!hasJoinedUdp)
+    {
+        logDebug("[Error] Load test players could not join the server");
+        return 1;
+    }
+
+    logDebug(fmt::format("[Load Test] {} clients sending {} packets/s each during {}s, server tick rate: {}",
+        clientsNmb, packetsPerSecond, durationSeconds, tickRate));
+    const auto startTime = Clock::now();
+    const auto receivedPacketsNmbAtStart = server.GetReceivedUdpPacketsNmb();
+    std::atomic<bool> isRunning = true;
+    std::atomic<std::size_t> sentPacketsNmb = 0;
+    std::vector<std::thread> clients;
+    clients.reserve(clientsNmb);
+    for (std::size_t i = 0; i < clientsNmb; i++)
+    {
+        clients.emplace_back(RunFloodClient, net::PlayerNumber(i % asteroid::maxPlayerNmb), server.GetUdpPort(),
+            packetsPerSecond, startTime, std::cref(isRunning), std::ref(sentPacketsNmb));
+    }
+    std::vector<double> tickDurations;
+    const auto endTime = startTime + std::chrono::seconds(durationSeconds);
+    const auto tickPeriod = tickRate > 0.0f ? std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<float>(1.0f / tickRate)) : Clock::duration::zero();
+    auto previousTickTime = Clock::now();
+    auto nextTickTime = previousTickTime;
+    while (previousTickTime < endTime && server.IsOpen())
+    {
+        const auto tickTime = Clock::now();
+        server.Update(std::chrono::duration_cast<seconds>(tickTime - previousTickTime));
+        previousTickTime = tickTime;
+        tickDurations.push_back(std::chrono::duration<double, std::micro>(Clock::now() - tickTime).count());
+        nextTickTime += tickPeriod;
+        std::this_thread::sleep_until(nextTickTime);
+    }
+    isRunning = false;
+    for (auto& client : clients)
+    {
+        client.join();
+    }
+    const auto elapsedTime = std::chrono::duration<double>(Clock::now() - startTime).count();
+    const auto receivedPacketsNmb = server.GetReceivedUdpPacketsNmb() - receivedPacketsNmbAtStart;
+
+    std::sort(tickDurations.begin(), tickDurations.end());
+    const auto getPercentile = [&tickDurations](double percentile)
+    {
+        return tickDurations.empty() ? 0.0 :
+            tickDurations[std::size_t(percentile * double(tickDurations.size() - 1))];
+    };
+    double tickDurationsSum = 0.0;
+    for (const auto tickDuration : tickDurations)
+    {
+        tickDurationsSum += tickDuration;
+    }
+    logDebug(fmt::format("[Load Test] Sent: {:.0f} packets/s Received: {:.0f} packets/s ({} / {} packets)",
+        double(sentPacketsNmb) / elapsedTime, double(receivedPacketsNmb) / elapsedTime,
+        receivedPacketsNmb, sentPacketsNmb.load()));
+    logDebug(fmt::format("[Load Test] Ticks: {} Tick latency mean: {:.1f}us p50: {:.1f}us p99: {:.1f}us max: {:.1f}us",
+        tickDurations.size(), tickDurations.empty() ? 0.0 : tickDurationsSum / double(tickDurations.size()),
+        getPercentile(0.5), getPercentile(0.99), getPercentile(1.0)));
+    return 0;
+}
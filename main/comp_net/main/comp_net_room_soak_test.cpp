@@ -0,0 +1,342 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "asteroid_net/room_server.h"
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+using namespace neko;
+
+/**
+ * \brief Client playing a match as the network client does: joins with TCP then UDP,
+ * then sends the inputs not acknowledged by the server at each fixed frame
+ */
+class SoakTestClient
+{
+public:
+    explicit SoakTestClient(net::ClientId clientId) : clientId_(clientId) {}
+
+    bool Connect(unsigned short tcpPort)
+    {
+        if (tcpSocket_.connect(sf::IpAddress::LocalHost, tcpPort) != sf::Socket::Done ||
+            udpSocket_.bind(sf::Socket::AnyPort) != sf::Socket::Done)
+        {
+            return false;
+        }
+        asteroid::JoinPacket joinPacket;
+        joinPacket.clientId = clientId_;
+        joinPacket.startTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        sf::Packet tcpPacket;
+        tcpPacket.append(sendBuffer_.data(), asteroid::GeneratePacket(sendBuffer_, joinPacket));
+        tcpSocket_.send(tcpPacket);
+        tcpSocket_.setBlocking(false);
+        udpSocket_.setBlocking(false);
+        return true;
+    }
+
+    void Update()
+    {
+        sf::Packet tcpPacket;
+        while (tcpSocket_.receive(tcpPacket) == sf::Socket::Done)
+        {
+            ReceivePacket(static_cast<const std::uint8_t*>(tcpPacket.getData()), tcpPacket.getDataSize());
+        }
+        std::size_t receivedSize = 0;
+        sf::IpAddress address;
+        unsigned short port = 0;
+        while (udpSocket_.receive(receiveBuffer_.data(), receiveBuffer_.size(), receivedSize, address, port) ==
+            sf::Socket::Done)
+        {
+            ReceivePacket(receiveBuffer_.data(), receivedSize);
+        }
+        if (serverUdpPort_ != 0 && !hasJoinedUdp_)
+        {
+            asteroid::JoinPacket joinPacket;
+            joinPacket.clientId = clientId_;
+            SendUdpPacket(joinPacket);
+        }
+        if (!IsPlaying())
+            return;
+        //Never shooting, so the match lasts during the whole test
+        const auto currentFrame = net::Frame(double(GetTime() - startTime_) / 1000.0 /
+            double(asteroid::GameManager::FixedPeriod));
+        asteroid::PlayerInputPacket inputPacket;
+        inputPacket.playerNumber = playerNumber_;
+        inputPacket.currentFrame = currentFrame;
+        const auto unacknowledgedFramesNmb = currentFrame - firstUnacknowledgedFrame_ + 1;
+        inputPacket.inputsNmb = std::uint8_t(std::clamp<net::Frame>(unacknowledgedFramesNmb, 1, asteroid::maxInputNmb));
+        for (net::Frame i = 0; i < inputPacket.inputsNmb; i++)
+        {
+            inputPacket.inputs[i] = ((currentFrame - i) / 25 + playerNumber_) % 2 == 0 ?
+                asteroid::PlayerInput::UP | asteroid::PlayerInput::LEFT :
+                asteroid::PlayerInput::RIGHT;
+        }
+        SendUdpPacket(inputPacket);
+    }
+
+    /**
+     * \brief The match countdown is over and the player can send its inputs
+     */
+    [[nodiscard]] bool IsPlaying() const
+    {
+        return startTime_ != 0 && hasJoinedUdp_ && playerNumber_ != net::INVALID_PLAYER && GetTime() >= startTime_;
+    }
+    [[nodiscard]] std::size_t GetValidatedFramesNmb() const { return validatedFramesNmb_; }
+    [[nodiscard]] bool HasLostMatch() const { return hasLostMatch_; }
+private:
+    /**
+     * \brief Same clock as the start time sent by the server and the game clients
+     */
+    static std::uint64_t GetTime()
+    {
+        return std::chrono::duration_cast<milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+    void ReceivePacket(const std::uint8_t* data, std::size_t size)
+    {
+        const auto packet = asteroid::GenerateReceivedPacket(data, size);
+        if (packet == nullptr)
+            return;
+        switch (packet->packetType)
+        {
+        case asteroid::PacketType::JOIN_ACK:
+        {
+            const auto& joinAckPacket = static_cast<const asteroid::JoinAckPacket&>(*packet);
+            hasJoinedUdp_ = serverUdpPort_ != 0;
+            serverUdpPort_ = joinAckPacket.udpPort;
+            break;
+        }
+        case asteroid::PacketType::SPAWN_PLAYER:
+        {
+            const auto& spawnPlayerPacket = static_cast<const asteroid::SpawnPlayerPacket&>(*packet);
+            if (spawnPlayerPacket.clientId == clientId_)
+            {
+                playerNumber_ = spawnPlayerPacket.playerNumber;
+            }
+            break;
+        }
+        case asteroid::PacketType::START_GAME:
+            startTime_ = static_cast<const asteroid::StartGamePacket&>(*packet).startTime;
+            break;
+        case asteroid::PacketType::INPUT:
+        {
+            const auto& inputPacket = static_cast<const asteroid::PlayerInputPacket&>(*packet);
+            if (inputPacket.playerNumber == playerNumber_)
+            {
+                firstUnacknowledgedFrame_ = std::max(firstUnacknowledgedFrame_, inputPacket.currentFrame + 1);
+            }
+            break;
+        }
+        case asteroid::PacketType::VALIDATE_STATE:
+        {
+            const auto& validatePacket = static_cast<const asteroid::ValidateFramePacket&>(*packet);
+            if (validatePacket.newValidateFrame > lastValidateFrame_)
+            {
+                validatedFramesNmb_ += validatePacket.newValidateFrame - lastValidateFrame_;
+                lastValidateFrame_ = validatePacket.newValidateFrame;
+            }
+            break;
+        }
+        case asteroid::PacketType::WIN_GAME:
+            hasLostMatch_ = true;
+            break;
+        default:
+            break;
+        }
+    }
+
+    void SendUdpPacket(const asteroid::Packet& packet)
+    {
+        const auto packetSize = asteroid::GeneratePacket(sendBuffer_, packet);
+        udpSocket_.send(sendBuffer_.data(), packetSize, sf::IpAddress::LocalHost, serverUdpPort_);
+    }
+
+    net::ClientId clientId_;
+    sf::TcpSocket tcpSocket_;
+    sf::UdpSocket udpSocket_;
+    asteroid::PacketBuffer sendBuffer_{};
+    std::array<std::uint8_t, asteroid::maxPacketSize + 1> receiveBuffer_{};
+    unsigned short serverUdpPort_ = 0;
+    bool hasJoinedUdp_ = false;
+    bool hasLostMatch_ = false;
+    net::PlayerNumber playerNumber_ = net::INVALID_PLAYER;
+    std::uint64_t startTime_ = 0;
+    net::Frame firstUnacknowledgedFrame_ = 0;
+    net::Frame lastValidateFrame_ = 0;
+    std::size_t validatedFramesNmb_ = 0;
+};
+
+double ToMicroseconds(std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+}
+
+/**
+ * \brief Loopback soak test of the room server: the simulated clients fill the rooms and play their matches,
+ * the server updates at the tick rate and reports how many rooms one core can update at this rate.
+ * Usage: comp_net_room_soak_test [rooms number] [duration in seconds] [tick rate]
+ */
+int main(int argc, char** argv)
+{
+    const std::size_t roomsNmb = argc > 1 ? std::stoul(argv[1]) : 64;
+    const int durationSeconds = argc > 2 ? std::stoi(argv[2]) : 20;
+    const float tickRate = argc > 3 ? std::stof(argv[3]) : 1.0f / asteroid::GameManager::FixedPeriod;
+    const auto tickPeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(1.0f / tickRate));
+
+    net::RoomServerNetworkManager server;
+    server.SetMaxRoomsNmb(roomsNmb);
+    server.Init();
+
+    //The server runs on its own thread at the tick rate, the metrics are reset when the measure starts
+    std::atomic<bool> isRunning = true;
+    std::atomic<bool> isMeasuring = false;
+    std::vector<double> tickDurations;
+    std::thread serverThread([&server, &isRunning, &isMeasuring, &tickDurations, tickPeriod]()
+    {
+        auto previousTickTime = Clock::now();
+        auto nextTickTime = previousTickTime;
+        bool wasMeasuring = false;
+        while (isRunning.load(std::memory_order_relaxed))
+        {
+            const auto tickTime = Clock::now();
+            if (!wasMeasuring && isMeasuring.load(std::memory_order_relaxed))
+            {
+                server.ResetMetrics();
+                wasMeasuring = true;
+            }
+            server.Update(std::chrono::duration_cast<seconds>(tickTime - previousTickTime));
+            previousTickTime = tickTime;
+            if (wasMeasuring)
+            {
+                tickDurations.push_back(std::chrono::duration<double, std::micro>(Clock::now() - tickTime).count());
+            }
+            nextTickTime += tickPeriod;
+            std::this_thread::sleep_until(nextTickTime);
+        }
+    });
+
+    std::vector<std::unique_ptr<SoakTestClient>> clients;
+    for (std::size_t i = 0; i < roomsNmb * asteroid::maxPlayerNmb; i++)
+    {
+        //Client id 0 is the empty player slot of the server
+        auto client = std::make_unique<SoakTestClient>(net::ClientId(i + 1));
+        if (!client->Connect(server.GetTcpPort()))
+        {
+            logDebug("[Error] Soak test client could not connect to the server");
+            isRunning = false;
+            serverThread.join();
+            return 1;
+        }
+        clients.push_back(std::move(client));
+    }
+
+    //The clients update at the tick rate too, the measure starts when all the matches are played
+    const auto joinTimeout = Clock::now() + std::chrono::seconds(10);
+    bool hasStarted = false;
+    auto nextTickTime = Clock::now();
+    Clock::time_point endTime = Clock::time_point::max();
+    while (Clock::now() < endTime)
+    {
+        for (auto& client : clients)
+        {
+            client->Update();
+        }
+        if (!hasStarted)
+        {
+            hasStarted = std::all_of(clients.begin(), clients.end(),
+                [](const auto& client) { return client->IsPlaying(); });
+            if (hasStarted)
+            {
+                isMeasuring = true;
+                endTime = Clock::now() + std::chrono::seconds(durationSeconds);
+                logDebug(fmt::format("[Soak Test] {} rooms started, measuring during {}s at {} Hz",
+                    roomsNmb, durationSeconds, tickRate));
+            }
+            else if (Clock::now() > joinTimeout)
+            {
+                logDebug("[Error] Soak test clients could not join their rooms");
+                break;
+            }
+        }
+        nextTickTime += tickPeriod;
+        std::this_thread::sleep_until(nextTickTime);
+    }
+    isRunning = false;
+    serverThread.join();
+    if (!hasStarted)
+    {
+        server.Destroy();
+        return 1;
+    }
+
+    const auto& metrics = server.GetMetrics();
+    const auto ticksNmb = double(std::max<std::size_t>(metrics.ticksNmb, 1));
+    //Time spent by the server for one tick of all the rooms, on the network thread and on the jobs
+    const auto networkTimePerTick = ToMicroseconds(metrics.networkTime) / ticksNmb;
+    const auto roomsTimePerTick = ToMicroseconds(metrics.rooms.tickTime) / ticksNmb;
+    const auto serverTimePerTick = networkTimePerTick + roomsTimePerTick;
+    const auto tickPeriodMicroseconds = 1'000'000.0 / double(tickRate);
+    const auto roomsPerCore = serverTimePerTick > 0.0 ?
+        double(server.GetRoomsNmb()) * tickPeriodMicroseconds / serverTimePerTick : 0.0;
+
+    std::size_t validatedFramesNmb = 0;
+    std::size_t lostMatchesNmb = 0;
+    for (const auto& client : clients)
+    {
+        validatedFramesNmb += client->GetValidatedFramesNmb();
+        lostMatchesNmb += client->HasLostMatch() ? 1 : 0;
+    }
+    std::sort(tickDurations.begin(), tickDurations.end());
+    const auto getPercentile = [&tickDurations](double percentile)
+    {
+        return tickDurations.empty() ? 0.0 :
+            tickDurations[std::size_t(percentile * double(tickDurations.size() - 1))];
+    };
+    logDebug(fmt::format("[Soak Test] Rooms: {} Ticks: {} Received: {} Sent: {} Dropped: {} datagrams",
+        server.GetRoomsNmb(), metrics.ticksNmb, metrics.receivedDatagramsNmb, metrics.sentDatagramsNmb,
+        metrics.droppedDatagramsNmb));
+    logDebug(fmt::format("[Soak Test] Room ticks: {} over budget: {} processed packets: {} invalid: {} "
+        "max room tick: {:.1f}us", metrics.rooms.ticksNmb, metrics.rooms.overBudgetTicksNmb,
+        metrics.rooms.processedPacketsNmb, metrics.rooms.invalidPacketsNmb, ToMicroseconds(metrics.rooms.maxTickTime)));
+    logDebug(fmt::format("[Soak Test] Server time per tick: {:.1f}us (network: {:.1f}us rooms: {:.1f}us) "
+        "tick latency p50: {:.1f}us p99: {:.1f}us max: {:.1f}us",
+        serverTimePerTick, networkTimePerTick, roomsTimePerTick,
+        getPercentile(0.5), getPercentile(0.99), getPercentile(1.0)));
+    logDebug(fmt::format("[Soak Test] Validated frames per client: {:.1f} lost matches: {}",
+        double(validatedFramesNmb) / double(clients.size()), lostMatchesNmb));
+    logDebug(fmt::format("[Soak Test] Rooms per core at {} Hz: {:.0f}", tickRate, roomsPerCore));
+    server.Destroy();
+    return 0;
+}
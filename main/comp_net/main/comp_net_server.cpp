@@ -23,18 +23,78 @@
  */
 
 #include <chrono>
+#include <thread>
+
+#include <fmt/format.h>
+
 #include "utils/time_utility.h"
 #include "asteroid_net/network_server.h"
+#include "asteroid_net/room_server.h"
 
+namespace
+{
+/**
+ * \brief Headless mode hosting many matches, the rooms are updated at the game fixed rate
+ */
+int RunRoomServer(unsigned short port, std::size_t maxRoomsNmb)
+{
+    using Clock = std::chrono::steady_clock;
+    neko::net::RoomServerNetworkManager server;
+    if (port != 0)
+    {
+        server.SetTcpPort(port);
+    }
+    server.SetMaxRoomsNmb(maxRoomsNmb);
+    server.Init();
+    const auto tickPeriod = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<float>(neko::asteroid::GameManager::FixedPeriod));
+    const auto metricsPeriod = std::chrono::seconds(10);
+    auto clock = Clock::now();
+    auto nextTickTime = clock;
+    auto nextMetricsTime = clock + metricsPeriod;
+    while (server.IsOpen())
+    {
+        const auto start = Clock::now();
+        const auto dt = std::chrono::duration_cast<neko::seconds>(start - clock);
+        clock = start;
+        server.Update(dt);
+        if (start > nextMetricsTime)
+        {
+            const auto& metrics = server.GetMetrics();
+            const auto ticksNmb = double(std::max<std::size_t>(metrics.ticksNmb, 1));
+            logDebug(fmt::format("[Server] Rooms: {} network: {:.1f}us/tick rooms: {:.1f}us/tick "
+                "max room tick: {:.1f}us over budget: {} dropped: {}",
+                server.GetRoomsNmb(),
+                std::chrono::duration<double, std::micro>(metrics.networkTime).count() / ticksNmb,
+                std::chrono::duration<double, std::micro>(metrics.rooms.tickTime).count() / ticksNmb,
+                std::chrono::duration<double, std::micro>(metrics.rooms.maxTickTime).count(),
+                metrics.rooms.overBudgetTicksNmb, metrics.droppedDatagramsNmb));
+            server.ResetMetrics();
+            nextMetricsTime += metricsPeriod;
+        }
+        nextTickTime += tickPeriod;
+        std::this_thread::sleep_until(nextTickTime);
+    }
+    server.Destroy();
+    return 0;
+}
+}
 
+/**
+ * \brief Usage: comp_net_server [port] [max rooms], with a max rooms number the server hosts many matches
+ */
 int main(int argc, char** argv)
 {
     unsigned short port = 0;
-    if(argc == 2)
+    if(argc >= 2)
     {
         std::string portArg = argv[1];
         port = std::stoi(portArg);
     }
+    if(argc >= 3)
+    {
+        return RunRoomServer(port, std::stoul(argv[2]));
+    }
     neko::net::ServerNetworkManager server;
     if(port != 0)
     {
@@ -27,8 +27,9 @@
 
 namespace neko::asteroid
 {
-BulletManager::BulletManager(EntityManager& entityManager, GameManager& gameManager) :
-    ComponentManager(entityManager), gameManager_(gameManager)
+BulletManager::BulletManager(EntityManager& entityManager, GameManager& gameManager,
+    ComponentHistory<EntityMask>& entityMaskHistory) :
+    RollbackComponentManager(entityManager), gameManager_(gameManager), entityMaskHistory_(entityMaskHistory)
 {
 }
 
@@ -38,10 +39,12 @@ void BulletManager::FixedUpdate(seconds dt)
     {
         if(entityManager_.get().HasComponent(entity, EntityMask(ComponentType::BULLET)))
         {
-            auto& bullet = components_[entity];
+            auto bullet = components_[entity];
             bullet.remainingTime -= dt.count();
+            SetComponent(entity, bullet);
             if(bullet.remainingTime < 0.0f)
             {
+                entityMaskHistory_.get().Record(entity, entityManager_.get().GetMask(entity));
                 entityManager_.get().DestroyEntity(entity);
             }
         }
@@ -1,7 +1,5 @@
 #include "asteroid/client.h"
 
-#include "engine/conversion.h"
-
 namespace neko::net
 {
 void Client::ReceivePacket(const asteroid::Packet* packet)
@@ -12,7 +10,7 @@ void Client::ReceivePacket(const asteroid::Packet* packet)
     case asteroid::PacketType::SPAWN_PLAYER:
     {
         const auto* spawnPlayerPacket = static_cast<const asteroid::SpawnPlayerPacket*>(packet);
-        const auto clientId = ConvertFromBinary<ClientId>(spawnPlayerPacket->clientId);
+        const auto clientId = spawnPlayerPacket->clientId;
 
         const PlayerNumber playerNumber = spawnPlayerPacket->playerNumber;
         if (clientId == clientId_)
@@ -20,8 +18,8 @@ void Client::ReceivePacket(const asteroid::Packet* packet)
             gameManager_.SetClientPlayer(playerNumber);
         }
 
-        const auto pos = ConvertFromBinary<Vec2f>(spawnPlayerPacket->pos);
-        const auto rotation = ConvertFromBinary<degree_t>(spawnPlayerPacket->angle);
+        const auto pos = spawnPlayerPacket->pos;
+        const auto rotation = spawnPlayerPacket->angle;
 
         gameManager_.SpawnPlayer(playerNumber, pos, rotation);
         break;
@@ -29,7 +27,7 @@ void Client::ReceivePacket(const asteroid::Packet* packet)
     case asteroid::PacketType::START_GAME:
     {
         const auto* startGamePacket = static_cast<const asteroid::StartGamePacket*>(packet);
-        unsigned long startingTime = ConvertFromBinary<unsigned long>(startGamePacket->startTime);
+        const unsigned long startingTime = startGamePacket->startTime;
         gameManager_.StartGame(startingTime);
         break;
     }
@@ -37,17 +35,19 @@ void Client::ReceivePacket(const asteroid::Packet* packet)
     {
         const auto* playerInputPacket = static_cast<const asteroid::PlayerInputPacket*>(packet);
         const auto playerNumber = playerInputPacket->playerNumber;
-        const auto inputFrame = ConvertFromBinary<Frame>(playerInputPacket->currentFrame);
+        const auto inputFrame = playerInputPacket->currentFrame;
 
         if (playerNumber == gameManager_.GetPlayerNumber())
         {
+            //The server has received all our inputs up to the frame it sends back
+            gameManager_.AcknowledgeInputFrame(inputFrame);
             //Verify the inputs coming back from the server
             const auto& inputs = gameManager_.GetRollbackManager().GetInputs(playerNumber);
             const auto currentFrame = gameManager_.GetRollbackManager().GetCurrentFrame();
-            for (size_t i = 0; i < playerInputPacket->inputs.size(); i++)
+            for (size_t i = 0; i < playerInputPacket->inputsNmb; i++)
             {
                 const auto index = currentFrame - inputFrame + i;
-                if (index > inputs.size())
+                if (index >= inputs.size())
                 {
                     break;
                 }
@@ -68,7 +68,7 @@ void Client::ReceivePacket(const asteroid::Packet* packet)
         {
             break;
         }
-        for (Frame i = 0; i < playerInputPacket->inputs.size(); i++)
+        for (Frame i = 0; i < playerInputPacket->inputsNmb; i++)
         {
             gameManager_.SetPlayerInput(playerNumber,
                 playerInputPacket->inputs[i],
@@ -84,14 +84,7 @@ void Client::ReceivePacket(const asteroid::Packet* packet)
     case asteroid::PacketType::VALIDATE_STATE:
     {
         const auto* validateFramePacket = static_cast<const asteroid::ValidateFramePacket*>(packet);
-        const auto newValidateFrame = ConvertFromBinary<Frame>(validateFramePacket->newValidateFrame);
-        std::array<asteroid::PhysicsState, asteroid::maxPlayerNmb> physicsStates{};
-        for (size_t i = 0; i < validateFramePacket->physicsState.size(); i++)
-        {
-            auto* statePtr = reinterpret_cast<std::uint8_t*>(physicsStates.data());
-            statePtr[i] = validateFramePacket->physicsState[i];
-        }
-        gameManager_.ConfirmValidateFrame(newValidateFrame, physicsStates);
+        gameManager_.ConfirmValidateFrame(validateFramePacket->newValidateFrame, validateFramePacket->stateHashes);
         //logDebug("Client received validate frame " + std::to_string(newValidateFrame));
         break;
     }
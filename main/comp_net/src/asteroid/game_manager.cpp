@@ -21,7 +21,6 @@
  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  SOFTWARE.
  */
-#include <engine/conversion.h>
 #include "asteroid/game_manager.h"
 #include "engine/engine.h"
 #include "imgui.h"
@@ -368,14 +367,13 @@ void ClientGameManager::FixedUpdate()
     const auto& inputs = rollbackManager_.GetInputs(GetPlayerNumber());
     auto playerInputPacket = std::make_unique<PlayerInputPacket>();
     playerInputPacket->playerNumber = GetPlayerNumber();
-    playerInputPacket->currentFrame = ConvertToBinary(currentFrame_);
-    for (size_t i = 0; i < playerInputPacket->inputs.size(); i++)
+    playerInputPacket->currentFrame = currentFrame_;
+    //Only the inputs not acknowledged by the server are sent, at least the current one
+    const net::Frame unacknowledgedFramesNmb = currentFrame_ - firstUnacknowledgedInputFrame_ + 1;
+    const auto inputsNmb = std::clamp<net::Frame>(unacknowledgedFramesNmb, 1, maxInputNmb);
+    playerInputPacket->inputsNmb = std::uint8_t(inputsNmb);
+    for (size_t i = 0; i < inputsNmb; i++)
     {
-        if (i > currentFrame_)
-        {
-            break;
-        }
-
         playerInputPacket->inputs[i] = inputs[i];
     }
     packetSenderInterface_.SendUnreliablePacket(std::move(playerInputPacket));
@@ -413,8 +411,7 @@ void ClientGameManager::DrawImGui()
     }
 }
 
-void ClientGameManager::ConfirmValidateFrame(net::Frame newValidateFrame,
-    const std::array<PhysicsState, maxPlayerNmb>& physicsStates)
+void ClientGameManager::ConfirmValidateFrame(net::Frame newValidateFrame, const StateHashes& stateHashes)
 {
     if (newValidateFrame < rollbackManager_.GetLastValidateFrame())
     {
@@ -435,7 +432,17 @@ void ClientGameManager::ConfirmValidateFrame(net::Frame newValidateFrame,
             return;
         }
     }
-    rollbackManager_.ConfirmFrame(newValidateFrame, physicsStates);
+    rollbackManager_.ConfirmFrame(newValidateFrame, stateHashes);
+}
+
+void ClientGameManager::AcknowledgeInputFrame(net::Frame inputFrame)
+{
+    //Compared with the frame difference to stay correct when the frame wraps around
+    const auto newFirstUnacknowledgedFrame = inputFrame + 1;
+    if (std::int32_t(newFirstUnacknowledgedFrame - firstUnacknowledgedInputFrame_) > 0)
+    {
+        firstUnacknowledgedInputFrame_ = newFirstUnacknowledgedFrame;
+    }
 }
 
 void ClientGameManager::WinGame(net::PlayerNumber winner)
@@ -24,8 +24,34 @@
 #include "asteroid/physics_manager.h"
 #include "asteroid/game.h"
 
+#include <algorithm>
+
+#ifdef EASY_PROFILE_USE
+#include <easy/profiler.h>
+#endif
+
 namespace neko::asteroid
 {
+namespace
+{
+struct SweepEntry
+{
+    float x = 0.0f;
+    float y = 0.0f;
+    float width = 0.0f;
+    float height = 0.0f;
+    Entity entity = INVALID_ENTITY;
+};
+/**
+ * \brief Broadphase buffers, kept out of the PhysicsManager as it is copied at each rollback
+ */
+struct BroadphaseScratch
+{
+    std::vector<SweepEntry> sweepEntries;
+    std::vector<std::pair<Entity, Entity>> collisionPairs;
+};
+thread_local BroadphaseScratch broadphaseScratch;
+}
 
 PhysicsManager::PhysicsManager(EntityManager& entityManager) :
     bodyManager_(entityManager), boxManager_(entityManager), entityManager_(entityManager)
@@ -43,6 +69,9 @@ bool Box2Box(float r1x, float r1y, float r1w, float r1h, float r2x, float r2y, f
 
 void PhysicsManager::FixedUpdate(seconds dt)
 {
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Physics Fixed Update");
+#endif
     for(Entity entity = 0; entity < entityManager_.get().GetEntitiesSize(); entity++)
     {
         if (!entityManager_.get().HasComponent(entity, EntityMask(neko::ComponentType::BODY2D)))
@@ -52,40 +81,85 @@ void PhysicsManager::FixedUpdate(seconds dt)
         body.rotation += body.angularVelocity * dt.count();
         bodyManager_.SetComponent(entity, body);
     }
-    for (Entity entity = 0; entity < entityManager_.get().GetEntitiesSize(); entity++)
+    FindCollisionPairs();
+    ExecuteCollisionPairs();
+}
+
+void PhysicsManager::FindCollisionPairs() const
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Physics Broadphase");
+#endif
+    const auto& entityManager = entityManager_.get();
+    auto& sweepEntries = broadphaseScratch.sweepEntries;
+    auto& collisionPairs = broadphaseScratch.collisionPairs;
+    sweepEntries.clear();
+    collisionPairs.clear();
+    for (Entity entity = 0; entity < entityManager.GetEntitiesSize(); entity++)
     {
-        if(!entityManager_.get().HasComponent(entity, 
-            EntityMask(neko::ComponentType::BODY2D)|EntityMask(neko::ComponentType::BOX_COLLIDER2D)) ||
-            entityManager_.get().HasComponent(entity, EntityMask(neko::asteroid::ComponentType::DESTROYED)))
+        if (!entityManager.HasComponent(entity,
+            EntityMask(neko::ComponentType::BODY2D) | EntityMask(neko::ComponentType::BOX_COLLIDER2D)))
             continue;
-        for (Entity otherEntity = entity; otherEntity < entityManager_.get().GetEntitiesSize(); otherEntity++)
+        const Body& body = bodyManager_.GetComponent(entity);
+        const Box& box = boxManager_.GetComponent(entity);
+        SweepEntry sweepEntry;
+        sweepEntry.x = body.position.x - box.extends.x;
+        sweepEntry.y = body.position.y - box.extends.y;
+        sweepEntry.width = box.extends.x * 2.0f;
+        sweepEntry.height = box.extends.y * 2.0f;
+        sweepEntry.entity = entity;
+        sweepEntries.push_back(sweepEntry);
+    }
+    //Ties are broken on the entity so that the sweep does not depend on the sort implementation
+    std::sort(sweepEntries.begin(), sweepEntries.end(), [](const SweepEntry& a, const SweepEntry& b)
+    {
+        return a.x < b.x || (a.x == b.x && a.entity < b.entity);
+    });
+    for (std::size_t i = 0; i < sweepEntries.size(); i++)
+    {
+        const auto& sweepEntry = sweepEntries[i];
+        //Same expression as the first Box2Box condition, the boxes after the first one on the right cannot touch
+        const float right = sweepEntry.x + sweepEntry.width;
+        for (std::size_t j = i + 1; j < sweepEntries.size() && right >= sweepEntries[j].x; j++)
         {
-            if(entity == otherEntity)
-                continue;
-            if (!entityManager_.get().HasComponent(otherEntity,
-                EntityMask(neko::ComponentType::BODY2D) | EntityMask(neko::ComponentType::BOX_COLLIDER2D)) ||
-                entityManager_.get().HasComponent(entity, EntityMask(neko::asteroid::ComponentType::DESTROYED)))
-                continue;
-            const Body& body1 = bodyManager_.GetComponent(entity);
-            const Box& box1 = boxManager_.GetComponent(entity);
-
-            const Body& body2 = bodyManager_.GetComponent(otherEntity);
-            const Box& box2 = boxManager_.GetComponent(otherEntity);
-
-            if(Box2Box(
-                body1.position.x - box1.extends.x, 
-                body1.position.y - box1.extends.y,
-                box1.extends.x * 2.0f,
-                box1.extends.y * 2.0f, 
-                body2.position.x - box2.extends.x,
-                body2.position.y - box2.extends.y,
-                box2.extends.x * 2.0f,
-                box2.extends.y * 2.0f))
+            const auto& otherEntry = sweepEntries[j];
+            if (Box2Box(
+                sweepEntry.x, sweepEntry.y, sweepEntry.width, sweepEntry.height,
+                otherEntry.x, otherEntry.y, otherEntry.width, otherEntry.height))
             {
-                onCollisionAction_.Execute(entity, otherEntity);
+                collisionPairs.emplace_back(
+                    std::min(sweepEntry.entity, otherEntry.entity),
+                    std::max(sweepEntry.entity, otherEntry.entity));
             }
+        }
+    }
+    //Same order as the entity by entity brute force loop, needed for the rollback to stay bit-exact
+    std::sort(collisionPairs.begin(), collisionPairs.end());
+}
 
+void PhysicsManager::ExecuteCollisionPairs()
+{
+    const auto& entityManager = entityManager_.get();
+    const auto bodyBoxMask = EntityMask(neko::ComponentType::BODY2D) | EntityMask(neko::ComponentType::BOX_COLLIDER2D);
+    const auto destroyedMask = EntityMask(neko::asteroid::ComponentType::DESTROYED);
+    Entity currentEntity = INVALID_ENTITY;
+    bool isCurrentEntityActive = false;
+    //Bodies are not moved by the collision callbacks, but entities can be destroyed,
+    //so the component checks are done when the pair is reached, like the brute force loop did
+    for (const auto& [entity, otherEntity] : broadphaseScratch.collisionPairs)
+    {
+        if (entity != currentEntity)
+        {
+            currentEntity = entity;
+            isCurrentEntityActive = entityManager.HasComponent(entity, bodyBoxMask) &&
+                !entityManager.HasComponent(entity, destroyedMask);
         }
+        if (!isCurrentEntityActive)
+            continue;
+        if (!entityManager.HasComponent(otherEntity, bodyBoxMask) ||
+            entityManager.HasComponent(entity, destroyedMask))
+            continue;
+        onCollisionAction_.Execute(entity, otherEntity);
     }
 }
 
@@ -124,4 +198,28 @@ void PhysicsManager::RegisterCollisionListener(OnCollisionInterface& collisionIn
     onCollisionAction_.RegisterCallback(
         [&collisionInterface](Entity entity1, Entity entity2) { collisionInterface.OnCollision(entity1, entity2); });
 }
+
+void PhysicsManager::StartFrame(net::Frame frame)
+{
+    bodyManager_.StartFrame(frame);
+    boxManager_.StartFrame(frame);
+}
+
+void PhysicsManager::StopRecording()
+{
+    bodyManager_.StopRecording();
+    boxManager_.StopRecording();
+}
+
+void PhysicsManager::Rewind(net::Frame frame)
+{
+    bodyManager_.Rewind(frame);
+    boxManager_.Rewind(frame);
+}
+
+void PhysicsManager::ClearHistory()
+{
+    bodyManager_.ClearHistory();
+    boxManager_.ClearHistory();
+}
 }
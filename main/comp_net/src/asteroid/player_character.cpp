@@ -28,7 +28,7 @@ namespace neko::asteroid
 {
 
 PlayerCharacterManager::PlayerCharacterManager(EntityManager& entityManager, PhysicsManager& physicsManager, GameManager& gameManager) :
-    ComponentManager(entityManager),
+    RollbackComponentManager(entityManager),
     physicsManager_(physicsManager),
     gameManager_(gameManager)
     
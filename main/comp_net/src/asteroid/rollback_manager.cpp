@@ -22,8 +22,10 @@
  SOFTWARE.
  */
 #include <engine/conversion.h>
+#include <xxhash.hpp>
 #include "asteroid/rollback_manager.h"
 #include "asteroid/game_manager.h"
+#include "engine/log.h"
 
 #ifdef EASY_PROFILE_USE
 #include "easy/profiler.h"
@@ -31,21 +33,31 @@
 
 namespace neko::asteroid
 {
-
+namespace
+{
+/**
+ * \brief Copy a field of a hashed component, the padding bytes of the components are never copied
+ */
+template<typename T>
+std::uint8_t* WriteStateField(std::uint8_t* data, const T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    std::memcpy(data, &value, sizeof(T));
+    return data + sizeof(T);
+}
+}
 
 RollbackManager::RollbackManager(GameManager& gameManager, EntityManager& entityManager) :
     gameManager_(gameManager), entityManager_(entityManager),
     currentTransformManager_(entityManager),
     currentPhysicsManager_(entityManager), currentPlayerManager_(entityManager, currentPhysicsManager_, gameManager_),
-    currentBulletManager_(entityManager, gameManager),
-    lastValidatePhysicsManager_(entityManager),
-    lastValidatePlayerManager_(entityManager, lastValidatePhysicsManager_, gameManager_), lastValidateBulletManager_(entityManager, gameManager)
+    currentBulletManager_(entityManager, gameManager, entityMaskHistory_)
 {
     for (auto& input : inputs_)
     {
         std::fill(input.begin(), input.end(), 0u);
     }
-    lastValidatePhysicsManager_.RegisterCollisionListener(*this);
+    currentPhysicsManager_.RegisterCollisionListener(*this);
 }
 
 void RollbackManager::SimulateToCurrentFrame()
@@ -54,48 +66,16 @@ void RollbackManager::SimulateToCurrentFrame()
     EASY_BLOCK("Simulate To Current Frame");
 #endif
     const auto currentFrame = gameManager_.GetCurrentFrame();
-    const auto lastValidateFrame = gameManager_.GetLastValidateFrame();
-    //Destroying all created Entities after the last validated frame
-    for (const auto& createdEntity : createdEntities_)
-    {
-        if (createdEntity.createdFrame > lastValidateFrame)
-        {
-            entityManager_.DestroyEntity(createdEntity.entity);
-        }
-    }
-    createdEntities_.clear();
-    //Remove DESTROY flags
-    for (Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
-    {
-        if (entityManager_.HasComponent(entity, EntityMask(ComponentType::DESTROYED)))
-        {
-            entityManager_.RemoveComponentType(entity, EntityMask(ComponentType::DESTROYED));
-        }
-    }
-
-    createdEntities_.clear();
-    //Revert the current game state to the last validated game state
-    currentBulletManager_ = lastValidateBulletManager_;
-    currentPhysicsManager_ = lastValidatePhysicsManager_;
-    currentPlayerManager_ = lastValidatePlayerManager_;
-
-    for (net::Frame frame = lastValidateFrame + 1; frame <= currentFrame; frame++)
+    //No new frame nor new input since the last simulation, the transforms are up to date
+    if (firstChangedInputFrame_ > simulatedFrame_ && simulatedFrame_ == currentFrame)
+        return;
+    //The frames before the first changed input were simulated with the same inputs
+    if (firstChangedInputFrame_ <= simulatedFrame_)
     {
-        testedFrame_ = frame;
-        //Copy player inputs to player manager
-        for (net::PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
-        {
-            const auto playerInput = GetInputAtFrame(playerNumber, frame);
-            const auto playerEntity = gameManager_.GetEntityFromPlayerNumber(playerNumber);
-            auto playerCharacter = currentPlayerManager_.GetComponent(playerEntity);
-            playerCharacter.input = playerInput;
-            currentPlayerManager_.SetComponent(playerEntity, playerCharacter);
-        }
-        //Simulate one frame of the game
-        currentBulletManager_.FixedUpdate(seconds(GameManager::FixedPeriod));
-        currentPlayerManager_.FixedUpdate(seconds(GameManager::FixedPeriod));
-        currentPhysicsManager_.FixedUpdate(seconds(GameManager::FixedPeriod));
+        RewindToFrame(std::max(firstChangedInputFrame_, lastValidateFrame_ + 1) - 1);
     }
+    firstChangedInputFrame_ = std::numeric_limits<net::Frame>::max();
+    SimulateToFrame(currentFrame);
     //Copy the physics states to the transforms
     for (Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
     {
@@ -116,14 +96,14 @@ void RollbackManager::SetPlayerInput(net::PlayerNumber playerNumber, net::Player
     {
         StartNewFrame(inputFrame);
     }
-    inputs_[playerNumber][currentFrame_ - inputFrame] = playerInput;
+    SetInputAtFrame(playerNumber, playerInput, inputFrame);
     if (lastReceivedFrame_[playerNumber] < inputFrame)
     {
         lastReceivedFrame_[playerNumber] = inputFrame;
         //Repeat the same inputs until currentFrame
-        for (size_t i = 0; i < currentFrame_ - inputFrame; i++)
+        for (net::Frame frame = inputFrame + 1; frame <= currentFrame_; frame++)
         {
-            inputs_[playerNumber][i] = playerInput;
+            SetInputAtFrame(playerNumber, playerInput, frame);
         }
     }
 }
@@ -157,44 +137,86 @@ void RollbackManager::ValidateFrame(net::Frame newValidateFrame)
 #ifdef EASY_PROFILE_USE
     EASY_BLOCK("Validate Frame");
 #endif
-    const auto lastValidateFrame = gameManager_.GetLastValidateFrame();
-    //Destroying all created Entities after the last validated frame
-    for (const auto& createdEntity : createdEntities_)
+    //We check that we got all the inputs
+    for (net::PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
     {
-        if (createdEntity.createdFrame > lastValidateFrame)
+        if (GetLastReceivedFrame(playerNumber) < newValidateFrame)
         {
-            entityManager_.DestroyEntity(createdEntity.entity);
+            neko_assert(false, "We should not validate a frame if we did not receive all inputs!!!");
+            return;
         }
     }
-    createdEntities_.clear();
-    //Remove DESTROYED flag
-    for (Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+    //Only the frames after the first changed input or after the new validated frame are rewound
+    const auto rewindFrame = std::min(newValidateFrame,
+        std::max(firstChangedInputFrame_, lastValidateFrame_ + 1) - 1);
+    if (rewindFrame < simulatedFrame_)
+    {
+        RewindToFrame(std::max(rewindFrame, lastValidateFrame_));
+    }
+    firstChangedInputFrame_ = std::numeric_limits<net::Frame>::max();
+    //We simulate the frames until the new validated frame
+    SimulateToFrame(newValidateFrame);
+    //Definitely remove DESTROY entities, only the entities in the mask history might have the flag
+    entityMaskHistory_.ForEachRecordedEntity([this](Entity entity)
     {
         if (entityManager_.HasComponent(entity, EntityMask(ComponentType::DESTROYED)))
         {
-            entityManager_.RemoveComponentType(entity, EntityMask(ComponentType::DESTROYED));
+            entityManager_.DestroyEntity(entity);
         }
-
-    }
+    });
+    //The new validated game state is the current game state, its history is not needed anymore
+    entityMaskHistory_.Clear();
+    currentPhysicsManager_.ClearHistory();
+    currentPlayerManager_.ClearHistory();
+    currentBulletManager_.ClearHistory();
+    lastValidateStateHashes_ = ComputeStateHashes();
+    lastValidateFrame_ = newValidateFrame;
     createdEntities_.clear();
-    //We check that we got all the inputs
-    for (net::PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+}
+
+void RollbackManager::RewindToFrame(net::Frame frame)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Rewind To Frame");
+#endif
+    neko_assert(frame >= lastValidateFrame_, "Cannot rewind before the last validated frame");
+    if (frame >= simulatedFrame_)
+        return;
+    currentPhysicsManager_.Rewind(frame);
+    currentPlayerManager_.Rewind(frame);
+    currentBulletManager_.Rewind(frame);
+    //Entities created after frame are destroyed, destroyed entities are created back and DESTROYED flags removed
+    entityMaskHistory_.Rewind(frame, [this](Entity entity, EntityMask entityMask)
     {
-        if (GetLastReceivedFrame(playerNumber) < newValidateFrame)
+        if (entityMask == INVALID_ENTITY_MASK)
         {
-            neko_assert(false, "We should not validate a frame if we did not receive all inputs!!!");
+            entityManager_.DestroyEntity(entity);
             return;
         }
-    }
-    //We use the current game state as the temporary new validate game state
-    currentBulletManager_ = lastValidateBulletManager_;
-    currentPhysicsManager_ = lastValidatePhysicsManager_;
-    currentPlayerManager_ = lastValidatePlayerManager_;
+        if (!entityManager_.EntityExists(entity))
+        {
+            entityManager_.CreateEntity(entity);
+        }
+        entityManager_.RemoveComponentType(entity, entityManager_.GetMask(entity));
+        entityManager_.AddComponentType(entity, entityMask);
+    });
+    createdEntities_.erase(std::remove_if(createdEntities_.begin(), createdEntities_.end(),
+        [frame](const CreatedEntity& createdEntity)
+        {
+            return createdEntity.createdFrame > frame;
+        }), createdEntities_.end());
+    simulatedFrame_ = frame;
+}
 
-    //We simulate the frames until the new validated frame
-    for (net::Frame frame = lastValidateFrame_ + 1; frame <= newValidateFrame; frame++)
+void RollbackManager::SimulateToFrame(net::Frame lastFrame)
+{
+    for (net::Frame frame = simulatedFrame_ + 1; frame <= lastFrame; frame++)
     {
         testedFrame_ = frame;
+        entityMaskHistory_.StartFrame(frame);
+        currentPhysicsManager_.StartFrame(frame);
+        currentPlayerManager_.StartFrame(frame);
+        currentBulletManager_.StartFrame(frame);
         //Copy the players inputs into the player manager
         for (net::PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
         {
@@ -208,70 +230,163 @@ void RollbackManager::ValidateFrame(net::Frame newValidateFrame)
         currentBulletManager_.FixedUpdate(seconds(GameManager::FixedPeriod));
         currentPlayerManager_.FixedUpdate(seconds(GameManager::FixedPeriod));
         currentPhysicsManager_.FixedUpdate(seconds(GameManager::FixedPeriod));
+        simulatedFrame_ = frame;
     }
-    //Definitely remove DESTROY entities
-    for (Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
-    {
-        if (entityManager_.HasComponent(entity, EntityMask(ComponentType::DESTROYED)))
-        {
-            entityManager_.DestroyEntity(entity);
-        }
-    }
-    //Copy back the new validate game state to the last validated game state
-    lastValidateBulletManager_ = currentBulletManager_;
-    lastValidatePlayerManager_ = currentPlayerManager_;
-    lastValidatePhysicsManager_ = currentPhysicsManager_;
-    lastValidateFrame_ = newValidateFrame;
-    createdEntities_.clear();
+    entityMaskHistory_.StopRecording();
+    currentPhysicsManager_.StopRecording();
+    currentPlayerManager_.StopRecording();
+    currentBulletManager_.StopRecording();
 }
-void RollbackManager::ConfirmFrame(net::Frame newValidateFrame, const std::array<PhysicsState, maxPlayerNmb>& serverPhysicsState)
+
+void RollbackManager::ConfirmFrame(net::Frame newValidateFrame, const StateHashes& serverStateHashes)
 {
     ValidateFrame(newValidateFrame);
-    for (net::PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    if (serverStateHashes != lastValidateStateHashes_)
     {
-        const PhysicsState lastPhysicsState = GetValidatePhysicsState(playerNumber);
-        if (serverPhysicsState[playerNumber] != lastPhysicsState)
-        {
-            neko_assert(false, "Physics State are not equal");
-        }
+        LogStateDiff(newValidateFrame, serverStateHashes);
+        neko_assert(false, "State hashes are not equal");
     }
 }
-PhysicsState RollbackManager::GetValidatePhysicsState(net::PlayerNumber playerNumber) const
-{
-    PhysicsState state = 0;
-    const Entity playerEntity = gameManager_.GetEntityFromPlayerNumber(playerNumber);
-    const auto& playerBody = lastValidatePhysicsManager_.GetBody(playerEntity);
 
-    const auto pos = playerBody.position;
-    const auto* posPtr = reinterpret_cast<const PhysicsState*>(&pos);
-    //Adding position
-    for (size_t i = 0; i < sizeof(Vec2f) / sizeof(PhysicsState); i++)
+StateHashes RollbackManager::ComputeStateHashes()
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Compute State Hashes");
+#endif
+    const EntityMask rollbackMask = EntityMask(neko::ComponentType::BODY2D) |
+        EntityMask(neko::ComponentType::BOX_COLLIDER2D) |
+        EntityMask(ComponentType::PLAYER_CHARACTER) |
+        EntityMask(ComponentType::BULLET) |
+        EntityMask(ComponentType::DESTROYED);
+    const auto entitiesSize = entityManager_.GetEntitiesSize();
+    //The written fields are never bigger than their component
+    auto& maskBuffer = stateBuffers_[std::size_t(StateComponent::ENTITY_MASK)];
+    auto& bodyBuffer = stateBuffers_[std::size_t(StateComponent::BODY)];
+    auto& boxBuffer = stateBuffers_[std::size_t(StateComponent::BOX)];
+    auto& playerBuffer = stateBuffers_[std::size_t(StateComponent::PLAYER_CHARACTER)];
+    auto& bulletBuffer = stateBuffers_[std::size_t(StateComponent::BULLET)];
+    maskBuffer.resize(entitiesSize * (sizeof(Entity) + sizeof(EntityMask)));
+    bodyBuffer.resize(entitiesSize * sizeof(Body));
+    boxBuffer.resize(entitiesSize * sizeof(Box));
+    playerBuffer.resize(entitiesSize * sizeof(PlayerCharacter));
+    bulletBuffer.resize(entitiesSize * sizeof(Bullet));
+    std::array<std::uint8_t*, std::tuple_size_v<StateHashes>> writePtrs{};
+    for (std::size_t i = 0; i < writePtrs.size(); i++)
     {
-        state += posPtr[i];
+        writePtrs[i] = stateBuffers_[i].data();
     }
-
-    //Adding velocity
-    const auto velocity = playerBody.velocity;
-    const auto* velocityPtr = reinterpret_cast<const PhysicsState*>(&velocity);
-    for (size_t i = 0; i < sizeof(Vec2f) / sizeof(PhysicsState); i++)
+    auto& maskPtr = writePtrs[std::size_t(StateComponent::ENTITY_MASK)];
+    auto& bodyPtr = writePtrs[std::size_t(StateComponent::BODY)];
+    auto& boxPtr = writePtrs[std::size_t(StateComponent::BOX)];
+    auto& playerPtr = writePtrs[std::size_t(StateComponent::PLAYER_CHARACTER)];
+    auto& bulletPtr = writePtrs[std::size_t(StateComponent::BULLET)];
+    for (Entity entity = 0; entity < entitiesSize; entity++)
     {
-        state += velocityPtr[i];
+        //The rendering components only exist on the clients
+        const auto mask = entityManager_.GetMask(entity) & rollbackMask;
+        if (mask == INVALID_ENTITY_MASK)
+            continue;
+        maskPtr = WriteStateField(WriteStateField(maskPtr, entity), mask);
+        if (mask & EntityMask(neko::ComponentType::BODY2D))
+        {
+            const auto& body = currentPhysicsManager_.GetBody(entity);
+            bodyPtr = WriteStateField(bodyPtr, body.position);
+            bodyPtr = WriteStateField(bodyPtr, body.velocity);
+            bodyPtr = WriteStateField(bodyPtr, body.angularVelocity);
+            bodyPtr = WriteStateField(bodyPtr, body.rotation);
+            bodyPtr = WriteStateField(bodyPtr, body.bodyType);
+        }
+        if (mask & EntityMask(neko::ComponentType::BOX_COLLIDER2D))
+        {
+            const auto& box = currentPhysicsManager_.GetBox(entity);
+            boxPtr = WriteStateField(boxPtr, box.extends);
+            boxPtr = WriteStateField(boxPtr, box.isTrigger);
+        }
+        if (mask & EntityMask(ComponentType::PLAYER_CHARACTER))
+        {
+            const auto& player = currentPlayerManager_.GetComponent(entity);
+            playerPtr = WriteStateField(playerPtr, player.shootingTime);
+            playerPtr = WriteStateField(playerPtr, player.input);
+            playerPtr = WriteStateField(playerPtr, player.playerNumber);
+            playerPtr = WriteStateField(playerPtr, player.health);
+            playerPtr = WriteStateField(playerPtr, player.invincibilityTime);
+        }
+        if (mask & EntityMask(ComponentType::BULLET))
+        {
+            const auto& bullet = currentBulletManager_.GetComponent(entity);
+            bulletPtr = WriteStateField(bulletPtr, bullet.remainingTime);
+            bulletPtr = WriteStateField(bulletPtr, bullet.playerNumber);
+        }
     }
-    //Adding rotation
-    const auto angle = playerBody.rotation.value();
-    const auto* anglePtr = reinterpret_cast<const PhysicsState*>(&angle);
-    for (size_t i = 0; i < sizeof(float) / sizeof(PhysicsState); i++)
+    StateHashes stateHashes{};
+    for (std::size_t i = 0; i < stateHashes.size(); i++)
     {
-        state += anglePtr[i];
+        stateHashes[i] = xxh::xxhash<64>(stateBuffers_[i].data(),
+            std::size_t(writePtrs[i] - stateBuffers_[i].data()));
     }
-    //Adding angular Velocity
-    const auto angularVelocity = playerBody.angularVelocity.value();
-    const auto* angularVelPtr = reinterpret_cast<const PhysicsState*>(&angularVelocity);
-    for (size_t i = 0; i < sizeof(float) / sizeof(PhysicsState); i++)
+    return stateHashes;
+}
+
+void RollbackManager::LogStateDiff(net::Frame frame, const StateHashes& serverStateHashes)
+{
+    const std::array<const char*, std::tuple_size_v<StateHashes>> componentNames{{
+        "entity masks", "bodies", "boxes", "player characters", "bullets"}};
+    for (std::size_t i = 0; i < serverStateHashes.size(); i++)
     {
-        state += angularVelPtr[i];
+        if (serverStateHashes[i] == lastValidateStateHashes_[i])
+            continue;
+        logDebug(fmt::format("[Error] Desync at frame {}, {} hash {:016x} instead of server hash {:016x}",
+            frame, componentNames[i], lastValidateStateHashes_[i], serverStateHashes[i]));
+        for (Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+        {
+            const auto mask = entityManager_.GetMask(entity);
+            switch (StateComponent(i))
+            {
+            case StateComponent::ENTITY_MASK:
+                if (mask != INVALID_ENTITY_MASK)
+                {
+                    logDebug(fmt::format("Entity {} mask {:08x}", entity, mask));
+                }
+                break;
+            case StateComponent::BODY:
+                if (mask & EntityMask(neko::ComponentType::BODY2D))
+                {
+                    const auto& body = currentPhysicsManager_.GetBody(entity);
+                    logDebug(fmt::format("Entity {} position ({}, {}) velocity ({}, {}) rotation {} angular velocity {}",
+                        entity, body.position.x, body.position.y, body.velocity.x, body.velocity.y,
+                        body.rotation.value(), body.angularVelocity.value()));
+                }
+                break;
+            case StateComponent::BOX:
+                if (mask & EntityMask(neko::ComponentType::BOX_COLLIDER2D))
+                {
+                    const auto& box = currentPhysicsManager_.GetBox(entity);
+                    logDebug(fmt::format("Entity {} extends ({}, {}) trigger {}",
+                        entity, box.extends.x, box.extends.y, box.isTrigger));
+                }
+                break;
+            case StateComponent::PLAYER_CHARACTER:
+                if (mask & EntityMask(ComponentType::PLAYER_CHARACTER))
+                {
+                    const auto& player = currentPlayerManager_.GetComponent(entity);
+                    logDebug(fmt::format("Entity {} player {} input {} health {} shooting time {} invincibility time {}",
+                        entity, player.playerNumber, player.input, player.health, player.shootingTime,
+                        player.invincibilityTime));
+                }
+                break;
+            case StateComponent::BULLET:
+                if (mask & EntityMask(ComponentType::BULLET))
+                {
+                    const auto& bullet = currentBulletManager_.GetComponent(entity);
+                    logDebug(fmt::format("Entity {} bullet of player {} remaining time {}",
+                        entity, bullet.playerNumber, bullet.remainingTime));
+                }
+                break;
+            default:
+                break;
+            }
+        }
     }
-    return state;
 }
 
 void RollbackManager::SpawnPlayer(net::PlayerNumber playerNumber, Entity entity, Vec2f position, degree_t rotation)
@@ -293,14 +408,6 @@ void RollbackManager::SpawnPlayer(net::PlayerNumber playerNumber, Entity entity,
     currentPhysicsManager_.AddBox(entity);
     currentPhysicsManager_.SetBox(entity, playerBox);
 
-    lastValidatePlayerManager_.AddComponent(entity);
-    lastValidatePlayerManager_.SetComponent(entity, playerCharacter);
-
-    lastValidatePhysicsManager_.AddBody(entity);
-    lastValidatePhysicsManager_.SetBody(entity, playerBody);
-    lastValidatePhysicsManager_.AddBox(entity);
-    lastValidatePhysicsManager_.SetBox(entity, playerBox);
-
     currentTransformManager_.AddComponent(entity);
     currentTransformManager_.SetPosition(entity, position);
     currentTransformManager_.SetRotation(entity, rotation);
@@ -313,6 +420,16 @@ net::PlayerInput RollbackManager::GetInputAtFrame(net::PlayerNumber playerNumber
     return inputs_[playerNumber][currentFrame_ - frame];
 }
 
+void RollbackManager::SetInputAtFrame(net::PlayerNumber playerNumber, net::PlayerInput playerInput, net::Frame frame)
+{
+    auto& input = inputs_[playerNumber][currentFrame_ - frame];
+    if (input != playerInput)
+    {
+        input = playerInput;
+        firstChangedInputFrame_ = std::min(firstChangedInputFrame_, frame);
+    }
+}
+
 void RollbackManager::OnCollision(Entity entity1, Entity entity2)
 {
     std::function<void(const PlayerCharacter&, Entity, const Bullet&, Entity)> ManageCollision =
@@ -351,6 +468,8 @@ void RollbackManager::OnCollision(Entity entity1, Entity entity2)
 void RollbackManager::SpawnBullet(net::PlayerNumber playerNumber, Entity entity, Vec2f position, Vec2f velocity)
 {
     createdEntities_.push_back({ entity, testedFrame_ });
+    //The game manager already created the entity, it did not exist at the start of the frame
+    entityMaskHistory_.Record(entity, INVALID_ENTITY_MASK);
 
     Body bulletBody;
     bulletBody.position = position;
@@ -381,9 +500,11 @@ void RollbackManager::DestroyEntity(Entity entity)
             return newEntity.entity == entity;
         }) != createdEntities_.end())
     {
+        entityMaskHistory_.Record(entity, entityManager_.GetMask(entity));
         entityManager_.DestroyEntity(entity);
         return;
     }
-        entityManager_.AddComponentType(entity, EntityMask(ComponentType::DESTROYED));
+    entityMaskHistory_.Record(entity, entityManager_.GetMask(entity));
+    entityManager_.AddComponentType(entity, EntityMask(ComponentType::DESTROYED));
 }
 }
@@ -1,6 +1,5 @@
 #include "asteroid/server.h"
 #include "engine/log.h"
-#include "engine/conversion.h"
 
 namespace neko::net
 {
@@ -14,7 +13,7 @@ void Server::ReceivePacket(std::unique_ptr<asteroid::Packet> packet)
     case asteroid::PacketType::JOIN:
     {
         const auto* joinPacket = static_cast<const asteroid::JoinPacket*>(packet.get());
-        const auto clientId = ConvertFromBinary<ClientId>(joinPacket->clientId);
+        const auto clientId = joinPacket->clientId;
         if (std::find(clientMap_.begin(), clientMap_.end(), clientId) != clientMap_.end())
         {
             //Player joined twice!
@@ -31,10 +30,10 @@ void Server::ReceivePacket(std::unique_ptr<asteroid::Packet> packet)
             auto startGamePacket = std::make_unique<asteroid::StartGamePacket>();
             startGamePacket->packetType = asteroid::PacketType::START_GAME;
             using namespace std::chrono;
-            unsigned long ms = (duration_cast<milliseconds>(
+            const std::uint64_t ms = (duration_cast<milliseconds>(
                 system_clock::now().time_since_epoch()
                 ) + milliseconds(3000)).count();
-            startGamePacket->startTime = ConvertToBinary(ms);
+            startGamePacket->startTime = ms;
             SendReliablePacket(std::move(startGamePacket));
         }
 
@@ -45,9 +44,9 @@ void Server::ReceivePacket(std::unique_ptr<asteroid::Packet> packet)
         //Manage internal state
         const auto* playerInputPacket = static_cast<const asteroid::PlayerInputPacket*>(packet.get());
         const auto playerNumber = playerInputPacket->playerNumber;
-        const auto inputFrame = ConvertFromBinary<net::Frame>(playerInputPacket->currentFrame);
+        const auto inputFrame = playerInputPacket->currentFrame;
 
-        for (std::uint32_t i = 0; i < playerInputPacket->inputs.size(); i++)
+        for (std::uint32_t i = 0; i < playerInputPacket->inputsNmb; i++)
         {
             gameManager_.SetPlayerInput(playerNumber,
                 playerInputPacket->inputs[i],
@@ -58,7 +57,29 @@ void Server::ReceivePacket(std::unique_ptr<asteroid::Packet> packet)
             }
         }
 
-        SendUnreliablePacket(std::move(packet));
+        //The client only sends the inputs we did not acknowledge, the other clients may have lost them,
+        //so the whole input window is sent back from the server history
+        const auto& rollbackManager = gameManager_.GetRollbackManager();
+        const auto& inputs = rollbackManager.GetInputs(playerNumber);
+        const auto lastReceivedFrame = rollbackManager.GetLastReceivedFrame(playerNumber);
+        auto relayedInputPacket = std::make_unique<asteroid::PlayerInputPacket>();
+        relayedInputPacket->playerNumber = playerNumber;
+        relayedInputPacket->currentFrame = lastReceivedFrame;
+        for (std::size_t i = 0; i < asteroid::maxInputNmb; i++)
+        {
+            const auto index = rollbackManager.GetCurrentFrame() - lastReceivedFrame + i;
+            if (index >= inputs.size())
+            {
+                break;
+            }
+            relayedInputPacket->inputs[i] = inputs[index];
+            relayedInputPacket->inputsNmb++;
+            if (lastReceivedFrame - i == 0)
+            {
+                break;
+            }
+        }
+        SendUnreliablePacket(std::move(relayedInputPacket));
 
         //Validate new frame if needed
         std::uint32_t lastReceiveFrame = gameManager_.GetRollbackManager().GetLastReceivedFrame(0);
@@ -76,18 +97,8 @@ void Server::ReceivePacket(std::unique_ptr<asteroid::Packet> packet)
             gameManager_.Validate(lastReceiveFrame);
 
             auto validatePacket = std::make_unique<asteroid::ValidateFramePacket>();
-            validatePacket->newValidateFrame = ConvertToBinary(lastReceiveFrame);
-
-            //copy physics state
-            for (PlayerNumber i = 0; i < asteroid::maxPlayerNmb; i++)
-            {
-                auto physicsState = gameManager_.GetRollbackManager().GetValidatePhysicsState(i);
-                const auto* statePtr = reinterpret_cast<const std::uint8_t*>(&physicsState);
-                for (size_t j = 0; j < sizeof(asteroid::PhysicsState); j++)
-                {
-                    validatePacket->physicsState[i * sizeof(asteroid::PhysicsState) + j] = statePtr[j];
-                }
-            }
+            validatePacket->newValidateFrame = lastReceiveFrame;
+            validatePacket->stateHashes = gameManager_.GetRollbackManager().GetValidateStateHashes();
             SendUnreliablePacket(std::move(validatePacket));
             const auto winner = gameManager_.CheckWinner();
             if (winner != INVALID_PLAYER)
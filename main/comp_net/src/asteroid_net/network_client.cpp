@@ -25,7 +25,6 @@
 #include "asteroid_net/network_client.h"
 #include "engine/engine.h"
 #include "imgui.h"
-#include "engine/conversion.h"
 
 namespace neko::net
 {
@@ -61,7 +60,8 @@ void ClientNetworkManager::Update(seconds dt)
             switch (status)
             {
             case sf::Socket::Done:
-                ReceivePacket(packet, PacketSource::TCP);
+                ReceivePacket(static_cast<const std::uint8_t*>(packet.getData()), packet.getDataSize(),
+                    PacketSource::TCP);
                 break;
             case sf::Socket::NotReady:
                 //logDebug("[Client] Error while receiving tcp socket is not ready");
@@ -78,14 +78,14 @@ void ClientNetworkManager::Update(seconds dt)
         status = sf::Socket::Done;
         while (status == sf::Socket::Done)
         {
-            sf::Packet packet;
+            std::size_t receivedSize = 0;
             sf::IpAddress sender;
             unsigned short port;
-            status = udpSocket_.receive(packet, sender, port);
+            status = udpSocket_.receive(receiveBuffer_.data(), receiveBuffer_.size(), receivedSize, sender, port);
             switch (status)
             {
             case sf::Socket::Done:
-                ReceivePacket(packet, PacketSource::UDP);
+                ReceivePacket(receiveBuffer_.data(), receivedSize, PacketSource::UDP);
                 break;
             case sf::Socket::NotReady: break;
             case sf::Socket::Partial:
@@ -108,7 +108,7 @@ void ClientNetworkManager::Update(seconds dt)
             {
                 //Need to send a join packet on the unreliable channel
                 auto joinPacket = std::make_unique<asteroid::JoinPacket>();
-                joinPacket->clientId = ConvertToBinary<ClientId>(clientId_);
+                joinPacket->clientId = clientId_;
                 SendUnreliablePacket(std::move(joinPacket));
             }
             break;
@@ -152,10 +152,9 @@ void ClientNetworkManager::DrawImGui()
         {
             logDebug("[Client] Connect to server " + serverAddress_ + " with port: " + std::to_string(serverTcpPort_));
             auto joinPacket = std::make_unique<asteroid::JoinPacket>();
-            joinPacket->clientId = ConvertToBinary<ClientId>(clientId_);
+            joinPacket->clientId = clientId_;
             using namespace std::chrono;
-            const unsigned long clientTime = (duration_cast<milliseconds>(system_clock::now().time_since_epoch())).count();
-            joinPacket->startTime = ConvertToBinary<unsigned long>(clientTime);
+            joinPacket->startTime = (duration_cast<milliseconds>(system_clock::now().time_since_epoch())).count();
             SendReliablePacket(std::move(joinPacket));
             currentState_ = State::JOINING;
         }
@@ -180,7 +179,7 @@ void ClientNetworkManager::SendReliablePacket(std::unique_ptr<asteroid::Packet>
 
     //logDebug("[Client] Sending reliable packet to server");
     sf::Packet tcpPacket;
-    GeneratePacket(tcpPacket, *packet);
+    tcpPacket.append(sendBuffer_.data(), asteroid::GeneratePacket(sendBuffer_, *packet));
     auto status = sf::Socket::Partial;
     while (status == sf::Socket::Partial)
     {
@@ -191,9 +190,8 @@ void ClientNetworkManager::SendReliablePacket(std::unique_ptr<asteroid::Packet>
 void ClientNetworkManager::SendUnreliablePacket(std::unique_ptr<asteroid::Packet> packet)
 {
 
-    sf::Packet udpPacket;
-    GeneratePacket(udpPacket, *packet);
-    const auto status = udpSocket_.send(udpPacket, serverAddress_, serverUdpPort_);
+    const auto packetSize = asteroid::GeneratePacket(sendBuffer_, *packet);
+    const auto status = udpSocket_.send(sendBuffer_.data(), packetSize, serverAddress_, serverUdpPort_);
     switch (status)
     {
     case sf::Socket::Done:
@@ -226,9 +224,14 @@ void ClientNetworkManager::SetPlayerInput(PlayerInput input)
         currentFrame);
 }
 
-void ClientNetworkManager::ReceivePacket(sf::Packet& packet, PacketSource source)
+void ClientNetworkManager::ReceivePacket(const std::uint8_t* data, std::size_t size, PacketSource source)
 {
-    const auto receivePacket = asteroid::GenerateReceivedPacket(packet);
+    const auto receivePacket = asteroid::GenerateReceivedPacket(data, size);
+    if (receivePacket == nullptr)
+    {
+        logDebug("[Client] Error while decoding received packet of size: " + std::to_string(size));
+        return;
+    }
     Client::ReceivePacket(receivePacket.get());
     switch (receivePacket->packetType)
     {
@@ -237,15 +240,15 @@ void ClientNetworkManager::ReceivePacket(sf::Packet& packet, PacketSource source
         logDebug("[Client] Receive " + std::string(source == PacketSource::UDP ? "UDP" : "TCP") + " Join ACK Packet");
         auto* joinAckPacket = static_cast<asteroid::JoinAckPacket*>(receivePacket.get());
 
-        serverUdpPort_ = ConvertFromBinary<unsigned short>(joinAckPacket->udpPort);
-        const auto clientId = ConvertFromBinary<ClientId>(joinAckPacket->clientId);
+        serverUdpPort_ = joinAckPacket->udpPort;
+        const auto clientId = joinAckPacket->clientId;
         if (clientId != clientId_)
             return;
         if (source == PacketSource::TCP)
         {
             //Need to send a join packet on the unreliable channel
             auto joinPacket = std::make_unique<asteroid::JoinPacket>();
-            joinPacket->clientId = ConvertToBinary<ClientId>(clientId_);
+            joinPacket->clientId = clientId_;
             SendUnreliablePacket(std::move(joinPacket));
         }
         else
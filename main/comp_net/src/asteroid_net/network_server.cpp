@@ -22,7 +22,6 @@
  SOFTWARE.
  */
 #include "asteroid_net/network_server.h"
-#include "engine/conversion.h"
 
 #include <fmt/format.h>
 namespace neko::net
@@ -32,12 +31,12 @@ void ServerNetworkManager::SendReliablePacket(
 {
     logDebug("[Server] Sending TCP packet: " +
         std::to_string(static_cast<int>(packet->packetType)));
+    //The packet is encoded once, the sf::Packet only adds the size prefix of the TCP stream
+    sf::Packet sendingPacket;
+    sendingPacket.append(sendBuffer_.data(), asteroid::GeneratePacket(sendBuffer_, *packet));
     for (PlayerNumber playerNumber = 0; playerNumber < asteroid::maxPlayerNmb;
         playerNumber++)
     {
-        sf::Packet sendingPacket;
-        GeneratePacket(sendingPacket, *packet);
-
         auto status = sf::Socket::Partial;
         while (status == sf::Socket::Partial)
         {
@@ -60,6 +59,7 @@ void ServerNetworkManager::SendReliablePacket(
 void ServerNetworkManager::SendUnreliablePacket(
     std::unique_ptr<asteroid::Packet> packet)
 {
+    udpEndpoints_.clear();
     for (PlayerNumber playerNumber = 0; playerNumber < asteroid::maxPlayerNmb;
         playerNumber++)
     {
@@ -68,37 +68,14 @@ void ServerNetworkManager::SendUnreliablePacket(
             logDebug(fmt::format("[Warning] Trying to send UDP packet, but missing port!"));
             continue;
         }
-
-        sf::Packet sendingPacket;
-        GeneratePacket(sendingPacket, *packet);
-        const auto status = udpSocket_.send(sendingPacket, clientInfoMap_[playerNumber].udpRemoteAddress,
-            clientInfoMap_[playerNumber].udpRemotePort);
-        switch (status)
-        {
-        case sf::Socket::Done:
-            //logDebug("[Server] Sending UDP packet: " +
-                //std::to_string(static_cast<int>(packet->packetType)));
-            break;
-
-        case sf::Socket::Disconnected:
-        {
-            logDebug("[Server] Error while sending UDP packet, DISCONNECTED");
-            break;
-        }
-        case sf::Socket::NotReady:
-            logDebug("[Server] Error while sending UDP packet, NOT READY");
-
-            break;
-
-        case sf::Socket::Error:
-            logDebug("[Server] Error while sending UDP packet, DISCONNECTED");
-            break;
-        default:
-            break;
-        }
-
+        udpEndpoints_.push_back({ clientInfoMap_[playerNumber].udpRemoteAddress,
+            clientInfoMap_[playerNumber].udpRemotePort });
     }
-
+    if (udpEndpoints_.empty())
+        return;
+    //The same datagram is sent to all the players with one system call
+    const auto packetSize = asteroid::GeneratePacket(sendBuffer_, *packet);
+    udpSocket_.SendBatch(sendBuffer_.data(), packetSize, udpEndpoints_);
 }
 
 void ServerNetworkManager::Init()
@@ -162,7 +139,8 @@ void ServerNetworkManager::Update(seconds dt)
         switch (status)
         {
         case sf::Socket::Done:
-            ReceivePacket(tcpPacket, PacketSocketSource::TCP);
+            ReceivePacket(static_cast<const std::uint8_t*>(tcpPacket.getData()), tcpPacket.getDataSize(),
+                PacketSocketSource::TCP);
             break;
         case sf::Socket::Disconnected:
         {
@@ -178,14 +156,13 @@ void ServerNetworkManager::Update(seconds dt)
         default: break;
         }
     }
-    sf::Packet udpPacket;
-    sf::IpAddress address;
-    unsigned short port;
-    const auto status = udpSocket_.receive(udpPacket, address, port);
-    if (status == sf::Socket::Done)
-    {
-        ReceivePacket(udpPacket, PacketSocketSource::UDP, address, port);
-    }
+    //Drain the pending datagrams by batches, the packets are decoded in place from the socket arena
+    receivedUdpPacketsNmb_ += udpSocket_.ReceiveBatches(maxUdpBatchesPerUpdate,
+        [this](const UdpDatagram& datagram)
+        {
+            ReceivePacket(datagram.data, datagram.size, PacketSocketSource::UDP,
+                datagram.endpoint.address, datagram.endpoint.port);
+        });
     gameManager_.Update(dt);
 }
 
@@ -210,14 +187,14 @@ void ServerNetworkManager::SpawnNewPlayer(ClientId clientId, PlayerNumber player
     for (PlayerNumber p = 0; p <= lastPlayerNumber_; p++)
     {
         auto spawnPlayer = std::make_unique<asteroid::SpawnPlayerPacket>();
-        spawnPlayer->clientId = ConvertToBinary(clientMap_[p]);
+        spawnPlayer->clientId = clientMap_[p];
         spawnPlayer->playerNumber = p;
 
         const auto pos = asteroid::spawnPositions[p] * 3.0f;
-        spawnPlayer->pos = ConvertToBinary(pos);
+        spawnPlayer->pos = pos;
 
         const auto rotation = asteroid::spawnRotations[p];
-        spawnPlayer->angle = ConvertToBinary(rotation);
+        spawnPlayer->angle = rotation;
         gameManager_.SpawnPlayer(p, pos, rotation);
 
         SendReliablePacket(std::move(spawnPlayer));
@@ -239,7 +216,7 @@ void ServerNetworkManager::ProcessReceivePacket(
     {
         const auto joinPacket = *static_cast<asteroid::JoinPacket*>(packet.get());
         Server::ReceivePacket(std::move(packet));
-        auto clientId = ConvertFromBinary<ClientId>(joinPacket.clientId);
+        const auto clientId = joinPacket.clientId;
         logDebug(fmt::format("[Server] Received Join Packet from: {} {}", clientId,
             (packetSource == PacketSocketSource::UDP ? fmt::format(" UDP with port: {}", port) : " TCP")));
         const auto it = std::find(clientMap_.begin(), clientMap_.end(), clientId);
@@ -255,8 +232,8 @@ void ServerNetworkManager::ProcessReceivePacket(
         }
 
         auto joinAckPacket = std::make_unique<asteroid::JoinAckPacket>();
-        joinAckPacket->clientId = ConvertToBinary(clientId);
-        joinAckPacket->udpPort = ConvertToBinary(udpPort_);
+        joinAckPacket->clientId = clientId;
+        joinAckPacket->udpPort = udpPort_;
         if (packetSource == PacketSocketSource::UDP)
         {
             auto& clientInfo = clientInfoMap_[playerNumber];
@@ -268,7 +245,7 @@ void ServerNetworkManager::ProcessReceivePacket(
         {
             SendReliablePacket(std::move(joinAckPacket));
             //Calculate time difference
-            const auto clientTime = ConvertFromBinary<unsigned long>(joinPacket.startTime);
+            const auto clientTime = joinPacket.startTime;
             using namespace std::chrono;
             const unsigned long deltaTime = (duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count()) - clientTime;
             logDebug(fmt::format("[Server] Client Server deltaTime: {}", deltaTime));
@@ -282,12 +259,12 @@ void ServerNetworkManager::ProcessReceivePacket(
     }
 }
 
-void ServerNetworkManager::ReceivePacket(sf::Packet& packet,
+void ServerNetworkManager::ReceivePacket(const std::uint8_t* data, std::size_t size,
     PacketSocketSource packetSource,
     sf::IpAddress address,
     unsigned short port)
 {
-    auto receivedPacket = asteroid::GenerateReceivedPacket(packet);
+    auto receivedPacket = asteroid::GenerateReceivedPacket(data, size);
 
     if (receivedPacket != nullptr)
     {
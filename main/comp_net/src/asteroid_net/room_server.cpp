@@ -0,0 +1,533 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "asteroid_net/room_server.h"
+
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include "engine/log.h"
+
+#ifdef EASY_PROFILE_USE
+#include <easy/profiler.h>
+#endif
+
+namespace neko::net
+{
+namespace
+{
+using RoomClock = std::chrono::steady_clock;
+}
+
+void ServerRoom::Init()
+{
+    gameManager_.Init();
+}
+
+void ServerRoom::Update(seconds dt)
+{
+    gameManager_.Update(dt);
+}
+
+void ServerRoom::Destroy()
+{
+    gameManager_.Destroy();
+}
+
+void ServerRoom::SendReliablePacket(std::unique_ptr<asteroid::Packet> packet)
+{
+    QueueOutgoingPacket(*packet, true);
+}
+
+void ServerRoom::SendUnreliablePacket(std::unique_ptr<asteroid::Packet> packet)
+{
+    QueueOutgoingPacket(*packet, false);
+}
+
+PlayerNumber ServerRoom::Join(const asteroid::JoinPacket& joinPacket, std::unique_ptr<sf::TcpSocket> tcpSocket)
+{
+    const auto playerNumber = lastPlayerNumber_;
+    neko_assert(playerNumber < asteroid::maxPlayerNmb, "Joining a full room");
+    auto& player = players_[playerNumber];
+    player.clientId = joinPacket.clientId;
+    player.tcpSocket = std::move(tcpSocket);
+    Server::ReceivePacket(std::make_unique<asteroid::JoinPacket>(joinPacket));
+    return playerNumber;
+}
+
+bool ServerRoom::QueueReceivedDatagram(PlayerNumber playerNumber, const std::uint8_t* data, std::size_t size)
+{
+    if (receivedDatagrams_.size() >= maxQueuedDatagramsNmb)
+        return false;
+    receivedDatagrams_.push_back({ receivedData_.size(), size, playerNumber });
+    receivedData_.insert(receivedData_.end(), data, data + size);
+    return true;
+}
+
+void ServerRoom::Tick(std::chrono::nanoseconds tickBudget)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Room Tick");
+#endif
+    const auto start = RoomClock::now();
+    std::size_t datagramIndex = 0;
+    while (datagramIndex < receivedDatagrams_.size())
+    {
+        //At least one packet is processed each tick
+        if (datagramIndex > 0 && RoomClock::now() - start > tickBudget)
+        {
+            metrics_.overBudgetTicksNmb++;
+            break;
+        }
+        const auto& datagram = receivedDatagrams_[datagramIndex];
+        ProcessReceivedDatagram(&receivedData_[datagram.offset], datagram.size, datagram.playerNumber);
+        datagramIndex++;
+    }
+    if (datagramIndex == receivedDatagrams_.size())
+    {
+        receivedDatagrams_.clear();
+        receivedData_.clear();
+    }
+    else
+    {
+        //The remaining datagrams are processed first at the next tick
+        const auto processedSize = receivedDatagrams_[datagramIndex].offset;
+        receivedData_.erase(receivedData_.begin(), receivedData_.begin() + processedSize);
+        receivedDatagrams_.erase(receivedDatagrams_.begin(), receivedDatagrams_.begin() + datagramIndex);
+        for (auto& datagram : receivedDatagrams_)
+        {
+            datagram.offset -= processedSize;
+        }
+    }
+    const auto tickTime = std::chrono::duration_cast<std::chrono::nanoseconds>(RoomClock::now() - start);
+    metrics_.ticksNmb++;
+    metrics_.tickTime += tickTime;
+    metrics_.maxTickTime = std::max(metrics_.maxTickTime, tickTime);
+}
+
+void ServerRoom::ClearOutgoingPackets()
+{
+    outgoingPackets_.clear();
+    outgoingData_.clear();
+}
+
+void ServerRoom::SpawnNewPlayer([[maybe_unused]] ClientId clientId, [[maybe_unused]] PlayerNumber playerNumber)
+{
+    //Spawning the new player in the arena
+    for (PlayerNumber p = 0; p <= lastPlayerNumber_; p++)
+    {
+        auto spawnPlayer = std::make_unique<asteroid::SpawnPlayerPacket>();
+        spawnPlayer->clientId = clientMap_[p];
+        spawnPlayer->playerNumber = p;
+
+        const auto pos = asteroid::spawnPositions[p] * 3.0f;
+        spawnPlayer->pos = pos;
+
+        const auto rotation = asteroid::spawnRotations[p];
+        spawnPlayer->angle = rotation;
+        gameManager_.SpawnPlayer(p, pos, rotation);
+
+        SendReliablePacket(std::move(spawnPlayer));
+    }
+}
+
+void ServerRoom::QueueOutgoingPacket(const asteroid::Packet& packet, bool isReliable)
+{
+    const auto packetSize = asteroid::GeneratePacket(sendBuffer_, packet);
+    outgoingPackets_.push_back({ outgoingData_.size(), packetSize, isReliable });
+    outgoingData_.insert(outgoingData_.end(), sendBuffer_.begin(), sendBuffer_.begin() + packetSize);
+}
+
+void ServerRoom::ProcessReceivedDatagram(const std::uint8_t* data, std::size_t size, PlayerNumber playerNumber)
+{
+    auto receivedPacket = asteroid::GenerateReceivedPacket(data, size);
+    //Only the inputs of the player of the endpoint go through the rooms queues
+    if (receivedPacket == nullptr || receivedPacket->packetType != asteroid::PacketType::INPUT ||
+        static_cast<const asteroid::PlayerInputPacket&>(*receivedPacket).playerNumber != playerNumber)
+    {
+        metrics_.invalidPacketsNmb++;
+        return;
+    }
+    //The rollback manager does not check the frames, one client must not be able to crash all the rooms
+    const auto& inputPacket = static_cast<const asteroid::PlayerInputPacket&>(*receivedPacket);
+    const auto& rollbackManager = gameManager_.GetRollbackManager();
+    const auto windowSize = rollbackManager.GetInputs(playerNumber).size();
+    const auto currentFrame = rollbackManager.GetCurrentFrame();
+    const bool isInWindow = inputPacket.currentFrame > currentFrame ?
+        inputPacket.currentFrame - currentFrame < windowSize :
+        currentFrame - inputPacket.currentFrame + inputPacket.inputsNmb < windowSize;
+    if (!isInWindow)
+    {
+        metrics_.invalidPacketsNmb++;
+        return;
+    }
+    metrics_.processedPacketsNmb++;
+    Server::ReceivePacket(std::move(receivedPacket));
+}
+
+void RoomServerNetworkManager::Init()
+{
+    sf::Socket::Status status = sf::Socket::Error;
+    while (status != sf::Socket::Done)
+    {
+        status = tcpListener_.listen(tcpPort_);
+        if (status != sf::Socket::Done)
+        {
+            tcpPort_++;
+        }
+    }
+    tcpListener_.setBlocking(false);
+    logDebug(fmt::format("[Server] Tcp Socket on port: {}", tcpPort_));
+
+    status = sf::Socket::Error;
+    while (status != sf::Socket::Done)
+    {
+        status = udpSocket_.bind(udpPort_);
+        if (status != sf::Socket::Done)
+        {
+            udpPort_++;
+        }
+    }
+    udpSocket_.setBlocking(false);
+    logDebug(fmt::format("[Server] Udp Socket on port: {}", udpPort_));
+    jobSystem_.Init();
+    isOpen_ = true;
+}
+
+void RoomServerNetworkManager::Update(seconds dt)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Room Server Update");
+#endif
+    auto networkStart = RoomClock::now();
+    AcceptConnections();
+    ReceiveTcpPackets();
+    ReceiveUdpPackets();
+    auto networkTime = RoomClock::now() - networkStart;
+
+    //The rooms do not share any state, each one is processed by one job
+    jobSystem_.ParallelFor(0, rooms_.size(), 1, [this, dt](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t roomIndex = begin; roomIndex < end; roomIndex++)
+        {
+            auto& room = rooms_[roomIndex];
+            if (room == nullptr)
+                continue;
+            room->Tick(roomTickBudget_);
+            room->Update(dt);
+        }
+    });
+
+    networkStart = RoomClock::now();
+    SendRoomPackets();
+    networkTime += RoomClock::now() - networkStart;
+
+    metrics_.ticksNmb++;
+    metrics_.networkTime += std::chrono::duration_cast<std::chrono::nanoseconds>(networkTime);
+    for (auto& room : rooms_)
+    {
+        if (room == nullptr)
+            continue;
+        const auto& roomMetrics = room->GetMetrics();
+        metrics_.rooms.ticksNmb += roomMetrics.ticksNmb;
+        metrics_.rooms.overBudgetTicksNmb += roomMetrics.overBudgetTicksNmb;
+        metrics_.rooms.processedPacketsNmb += roomMetrics.processedPacketsNmb;
+        metrics_.rooms.invalidPacketsNmb += roomMetrics.invalidPacketsNmb;
+        metrics_.rooms.tickTime += roomMetrics.tickTime;
+        metrics_.rooms.maxTickTime = std::max(metrics_.rooms.maxTickTime, roomMetrics.maxTickTime);
+        room->ResetMetrics();
+    }
+}
+
+void RoomServerNetworkManager::Destroy()
+{
+    for (RoomIndex roomIndex = 0; roomIndex < rooms_.size(); roomIndex++)
+    {
+        if (rooms_[roomIndex] != nullptr)
+        {
+            CloseRoom(roomIndex);
+        }
+    }
+    for (auto& connection : connections_)
+    {
+        connection->disconnect();
+    }
+    connections_.clear();
+    tcpListener_.close();
+    udpSocket_.unbind();
+    jobSystem_.Destroy();
+    isOpen_ = false;
+}
+
+void RoomServerNetworkManager::AcceptConnections()
+{
+    while (true)
+    {
+        if (acceptedSocket_ == nullptr)
+        {
+            acceptedSocket_ = std::make_unique<sf::TcpSocket>();
+        }
+        if (tcpListener_.accept(*acceptedSocket_) != sf::Socket::Done)
+            break;
+        acceptedSocket_->setBlocking(false);
+        connections_.push_back(std::move(acceptedSocket_));
+    }
+}
+
+void RoomServerNetworkManager::ReceiveTcpPackets()
+{
+    //Only the join packets are expected before joining a room
+    for (std::size_t connectionIndex = 0; connectionIndex < connections_.size(); connectionIndex++)
+    {
+        sf::Packet tcpPacket;
+        const auto status = connections_[connectionIndex]->receive(tcpPacket);
+        if (status == sf::Socket::Disconnected)
+        {
+            connections_[connectionIndex] = nullptr;
+            continue;
+        }
+        if (status != sf::Socket::Done)
+            continue;
+        const auto receivedPacket = asteroid::GenerateReceivedPacket(
+            static_cast<const std::uint8_t*>(tcpPacket.getData()), tcpPacket.getDataSize());
+        if (receivedPacket != nullptr && receivedPacket->packetType == asteroid::PacketType::JOIN)
+        {
+            JoinRoom(connectionIndex, static_cast<const asteroid::JoinPacket&>(*receivedPacket));
+        }
+    }
+    connections_.erase(std::remove(connections_.begin(), connections_.end(), nullptr), connections_.end());
+
+    //The players do not send anything else on TCP, a room closes when one of its players disconnects
+    for (RoomIndex roomIndex = 0; roomIndex < rooms_.size(); roomIndex++)
+    {
+        if (rooms_[roomIndex] == nullptr)
+            continue;
+        auto& room = *rooms_[roomIndex];
+        for (PlayerNumber playerNumber = 0; playerNumber < room.GetPlayersNmb(); playerNumber++)
+        {
+            sf::Packet tcpPacket;
+            if (room.GetPlayer(playerNumber).tcpSocket->receive(tcpPacket) == sf::Socket::Disconnected)
+            {
+                logDebug(fmt::format("[Error] Player Number {} of room {} is disconnected when receiving",
+                    playerNumber + 1, roomIndex));
+                CloseRoom(roomIndex);
+                break;
+            }
+        }
+    }
+}
+
+void RoomServerNetworkManager::ReceiveUdpPackets()
+{
+    //Drain the pending datagrams by batches, they are routed to their room by endpoint
+    metrics_.receivedDatagramsNmb += udpSocket_.ReceiveBatches(maxUdpBatchesPerUpdate,
+        [this](const UdpDatagram& datagram)
+        {
+            if (datagram.size > 0 && datagram.data[0] == std::uint8_t(asteroid::PacketType::JOIN))
+            {
+                const auto receivedPacket = asteroid::GenerateReceivedPacket(datagram.data, datagram.size);
+                if (receivedPacket != nullptr)
+                {
+                    JoinUdp(static_cast<const asteroid::JoinPacket&>(*receivedPacket), datagram.endpoint);
+                    return;
+                }
+            }
+            const auto it = udpClients_.find(GetEndpointKey(datagram.endpoint));
+            if (it == udpClients_.end() ||
+                !rooms_[it->second.roomIndex]->QueueReceivedDatagram(it->second.playerNumber, datagram.data, datagram.size))
+            {
+                metrics_.droppedDatagramsNmb++;
+            }
+        });
+}
+
+void RoomServerNetworkManager::JoinRoom(std::size_t connectionIndex, const asteroid::JoinPacket& joinPacket)
+{
+    auto& connection = connections_[connectionIndex];
+    const auto clientId = joinPacket.clientId;
+    if (clients_.find(clientId) != clients_.end())
+    {
+        logDebug(fmt::format("[Error] Client {} already joined a room", clientId));
+        connection->disconnect();
+        connection = nullptr;
+        return;
+    }
+    const auto roomIndex = FindFillingRoom();
+    if (roomIndex == INVALID_ROOM)
+    {
+        logDebug(fmt::format("[Error] Client {} cannot join, all the {} rooms are used", clientId, maxRoomsNmb_));
+        connection->disconnect();
+        connection = nullptr;
+        return;
+    }
+    auto& room = *rooms_[roomIndex];
+    const auto playerNumber = room.Join(joinPacket, std::move(connection));
+    clients_[clientId] = { roomIndex, playerNumber };
+
+    auto joinAckPacket = std::make_unique<asteroid::JoinAckPacket>();
+    joinAckPacket->clientId = clientId;
+    joinAckPacket->udpPort = udpPort_;
+    const auto packetSize = asteroid::GeneratePacket(sendBuffer_, *joinAckPacket);
+    SendReliablePacket(room.GetPlayer(playerNumber), sendBuffer_.data(), packetSize);
+}
+
+void RoomServerNetworkManager::JoinUdp(const asteroid::JoinPacket& joinPacket, const UdpEndpoint& endpoint)
+{
+    const auto it = clients_.find(joinPacket.clientId);
+    if (it == clients_.end())
+    {
+        metrics_.droppedDatagramsNmb++;
+        return;
+    }
+    const auto clientSlot = it->second;
+    auto& player = rooms_[clientSlot.roomIndex]->GetPlayer(clientSlot.playerNumber);
+    if (player.udpEndpoint.port != 0)
+    {
+        udpClients_.erase(GetEndpointKey(player.udpEndpoint));
+    }
+    player.udpEndpoint = endpoint;
+    udpClients_[GetEndpointKey(endpoint)] = clientSlot;
+
+    auto joinAckPacket = std::make_unique<asteroid::JoinAckPacket>();
+    joinAckPacket->clientId = joinPacket.clientId;
+    joinAckPacket->udpPort = udpPort_;
+    const auto packetSize = asteroid::GeneratePacket(sendBuffer_, *joinAckPacket);
+    if (udpSocket_.send(sendBuffer_.data(), packetSize, endpoint.address, endpoint.port) == sf::Socket::Done)
+    {
+        metrics_.sentDatagramsNmb++;
+    }
+}
+
+void RoomServerNetworkManager::SendRoomPackets()
+{
+    //The datagrams of all the rooms are sent together, they point to the rooms outgoing data
+    outgoingDatagrams_.clear();
+    for (auto& room : rooms_)
+    {
+        if (room == nullptr)
+            continue;
+        for (const auto& outgoingPacket : room->GetOutgoingPackets())
+        {
+            const auto* data = room->GetOutgoingData(outgoingPacket);
+            for (PlayerNumber playerNumber = 0; playerNumber < room->GetPlayersNmb(); playerNumber++)
+            {
+                auto& player = room->GetPlayer(playerNumber);
+                if (outgoingPacket.isReliable)
+                {
+                    SendReliablePacket(player, data, outgoingPacket.size);
+                }
+                else if (player.udpEndpoint.port != 0)
+                {
+                    outgoingDatagrams_.push_back({ data, outgoingPacket.size, player.udpEndpoint });
+                }
+            }
+        }
+    }
+    metrics_.sentDatagramsNmb += udpSocket_.SendBatch(outgoingDatagrams_);
+    for (auto& room : rooms_)
+    {
+        if (room != nullptr)
+        {
+            room->ClearOutgoingPackets();
+        }
+    }
+}
+
+void RoomServerNetworkManager::SendReliablePacket(RoomPlayer& player, const std::uint8_t* data, std::size_t size)
+{
+    sf::Packet sendingPacket;
+    sendingPacket.append(data, size);
+    auto status = sf::Socket::Partial;
+    while (status == sf::Socket::Partial)
+    {
+        status = player.tcpSocket->send(sendingPacket);
+        if (status == sf::Socket::NotReady)
+        {
+            logDebug(fmt::format("[Server] Error trying to send packet to client: {} socket is not ready",
+                player.clientId));
+        }
+    }
+}
+
+void RoomServerNetworkManager::CloseRoom(RoomIndex roomIndex)
+{
+    auto& room = *rooms_[roomIndex];
+    logDebug(fmt::format("[Server] Closing room {}", roomIndex));
+    //The pending packets and the end of the game are still sent to the remaining players
+    auto endGame = std::make_unique<asteroid::WinGamePacket>();
+    room.SendReliablePacket(std::move(endGame));
+    for (PlayerNumber playerNumber = 0; playerNumber < room.GetPlayersNmb(); playerNumber++)
+    {
+        auto& player = room.GetPlayer(playerNumber);
+        for (const auto& outgoingPacket : room.GetOutgoingPackets())
+        {
+            if (outgoingPacket.isReliable)
+            {
+                SendReliablePacket(player, room.GetOutgoingData(outgoingPacket), outgoingPacket.size);
+            }
+        }
+        player.tcpSocket->disconnect();
+        clients_.erase(player.clientId);
+        if (player.udpEndpoint.port != 0)
+        {
+            udpClients_.erase(GetEndpointKey(player.udpEndpoint));
+        }
+    }
+    room.Destroy();
+    rooms_[roomIndex] = nullptr;
+    roomsNmb_--;
+    if (fillingRoomIndex_ == roomIndex)
+    {
+        fillingRoomIndex_ = INVALID_ROOM;
+    }
+}
+
+RoomIndex RoomServerNetworkManager::FindFillingRoom()
+{
+    if (fillingRoomIndex_ != INVALID_ROOM && rooms_[fillingRoomIndex_]->GetPlayersNmb() < asteroid::maxPlayerNmb)
+    {
+        return fillingRoomIndex_;
+    }
+    if (roomsNmb_ >= maxRoomsNmb_)
+    {
+        return INVALID_ROOM;
+    }
+    //Reuse the slot of a closed room before adding one
+    const auto it = std::find(rooms_.begin(), rooms_.end(), nullptr);
+    fillingRoomIndex_ = RoomIndex(std::distance(rooms_.begin(), it));
+    if (it == rooms_.end())
+    {
+        rooms_.emplace_back();
+    }
+    rooms_[fillingRoomIndex_] = std::make_unique<ServerRoom>();
+    rooms_[fillingRoomIndex_]->Init();
+    roomsNmb_++;
+    return fillingRoomIndex_;
+}
+
+std::uint64_t RoomServerNetworkManager::GetEndpointKey(const UdpEndpoint& endpoint)
+{
+    return std::uint64_t(endpoint.address.toInteger()) << 16u | endpoint.port;
+}
+}
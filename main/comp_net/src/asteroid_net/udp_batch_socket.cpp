@@ -0,0 +1,214 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "asteroid_net/network_server.h"
+#include "asteroid_net/udp_batch_socket.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fmt/format.h>
+
+#include "engine/log.h"
+
+#ifdef EASY_PROFILE_USE
+#include <easy/profiler.h>
+#endif
+
+namespace neko::net
+{
+UdpBatchSocket::UdpBatchSocket() : packetArena_(batchSize * maxDatagramSize)
+{
+}
+
+std::size_t UdpBatchSocket::ReceiveBatch()
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Receive UDP Batch");
+#endif
+    datagramsNmb_ = 0;
+#if defined(__linux__)
+    if (getHandle() == sf::SocketHandle(-1))
+        return 0;
+    //The headers are shared with SendBatch, they are all written again before each call
+    for (std::size_t i = 0; i < batchSize; i++)
+    {
+        iovecs_[i].iov_base = &packetArena_[i * maxDatagramSize];
+        iovecs_[i].iov_len = maxDatagramSize;
+        messages_[i] = {};
+        messages_[i].msg_hdr.msg_name = &addresses_[i];
+        messages_[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        messages_[i].msg_hdr.msg_iov = &iovecs_[i];
+        messages_[i].msg_hdr.msg_iovlen = 1;
+    }
+    const int receivedNmb = recvmmsg(getHandle(), messages_.data(), batchSize, MSG_DONTWAIT, nullptr);
+    if (receivedNmb < 0)
+    {
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            logDebug(fmt::format("[Error] Could not receive UDP datagrams: {}", std::strerror(errno)));
+        }
+        return 0;
+    }
+    for (int i = 0; i < receivedNmb; i++)
+    {
+        const auto& message = messages_[i];
+        if (message.msg_hdr.msg_flags & MSG_TRUNC)
+        {
+            logDebug(fmt::format("[Warning] Dropping UDP datagram bigger than {} bytes", maxDatagramSize));
+            continue;
+        }
+        auto& datagram = datagrams_[datagramsNmb_];
+        datagram.data = &packetArena_[i * maxDatagramSize];
+        datagram.size = message.msg_len;
+        datagram.endpoint.address = sf::IpAddress(ntohl(addresses_[i].sin_addr.s_addr));
+        datagram.endpoint.port = ntohs(addresses_[i].sin_port);
+        datagramsNmb_++;
+    }
+    return std::size_t(receivedNmb);
+#else
+    //Windows fails the read of an oversized datagram and macOS truncates it to the buffer size,
+    //both are dropped like MSG_TRUNC above and only an empty socket stops the batch
+    std::size_t readNmb = 0;
+    while (readNmb < batchSize)
+    {
+        auto& datagram = datagrams_[datagramsNmb_];
+        std::uint8_t* data = &packetArena_[datagramsNmb_ * maxDatagramSize];
+        const auto status = receive(data, maxDatagramSize, datagram.size, datagram.endpoint.address, datagram.endpoint.port);
+        if (status == NotReady)
+            break;
+        readNmb++;
+        if (status != Done || datagram.size == maxDatagramSize)
+        {
+            logDebug(fmt::format("[Warning] Dropping UDP datagram bigger than {} bytes", maxDatagramSize - 1));
+            continue;
+        }
+        datagram.data = data;
+        datagramsNmb_++;
+    }
+    return readNmb;
+#endif
+}
+
+std::size_t UdpBatchSocket::SendBatch(const void* data, std::size_t size, const std::vector<UdpEndpoint>& endpoints)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Send UDP Batch");
+#endif
+    std::size_t sentNmb = 0;
+#if defined(__linux__)
+    if (getHandle() == sf::SocketHandle(-1))
+        return 0;
+    while (sentNmb < endpoints.size())
+    {
+        const auto messagesNmb = std::min(batchSize, endpoints.size() - sentNmb);
+        for (std::size_t i = 0; i < messagesNmb; i++)
+        {
+            SetSendMessage(i, data, size, endpoints[sentNmb + i]);
+        }
+        const auto messagesSentNmb = SendMessages(messagesNmb);
+        if (messagesSentNmb == 0)
+            break;
+        sentNmb += messagesSentNmb;
+    }
+#else
+    for (const auto& endpoint : endpoints)
+    {
+        const auto status = send(data, size, endpoint.address, endpoint.port);
+        if (status != Done)
+        {
+            logDebug(fmt::format("[Error] Could not send UDP datagram to port: {}", endpoint.port));
+            continue;
+        }
+        sentNmb++;
+    }
+#endif
+    return sentNmb;
+}
+
+std::size_t UdpBatchSocket::SendBatch(const std::vector<UdpDatagram>& datagrams)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Send UDP Batch");
+#endif
+    std::size_t sentNmb = 0;
+#if defined(__linux__)
+    if (getHandle() == sf::SocketHandle(-1))
+        return 0;
+    while (sentNmb < datagrams.size())
+    {
+        const auto messagesNmb = std::min(batchSize, datagrams.size() - sentNmb);
+        for (std::size_t i = 0; i < messagesNmb; i++)
+        {
+            const auto& datagram = datagrams[sentNmb + i];
+            SetSendMessage(i, datagram.data, datagram.size, datagram.endpoint);
+        }
+        const auto messagesSentNmb = SendMessages(messagesNmb);
+        if (messagesSentNmb == 0)
+            break;
+        sentNmb += messagesSentNmb;
+    }
+#else
+    for (const auto& datagram : datagrams)
+    {
+        const auto status = send(datagram.data, datagram.size, datagram.endpoint.address, datagram.endpoint.port);
+        if (status != Done)
+        {
+            logDebug(fmt::format("[Error] Could not send UDP datagram to port: {}", datagram.endpoint.port));
+            continue;
+        }
+        sentNmb++;
+    }
+#endif
+    return sentNmb;
+}
+
+#if defined(__linux__)
+void UdpBatchSocket::SetSendMessage(std::size_t index, const void* data, std::size_t size, const UdpEndpoint& endpoint)
+{
+    addresses_[index] = {};
+    addresses_[index].sin_family = AF_INET;
+    addresses_[index].sin_port = htons(endpoint.port);
+    addresses_[index].sin_addr.s_addr = htonl(endpoint.address.toInteger());
+    iovecs_[index].iov_base = const_cast<void*>(data);
+    iovecs_[index].iov_len = size;
+    messages_[index] = {};
+    messages_[index].msg_hdr.msg_name = &addresses_[index];
+    messages_[index].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    messages_[index].msg_hdr.msg_iov = &iovecs_[index];
+    messages_[index].msg_hdr.msg_iovlen = 1;
+}
+
+std::size_t UdpBatchSocket::SendMessages(std::size_t messagesNmb)
+{
+    const int messagesSentNmb = sendmmsg(getHandle(), messages_.data(), messagesNmb, 0);
+    if (messagesSentNmb <= 0)
+    {
+        logDebug(fmt::format("[Error] Could not send UDP datagrams: {}", std::strerror(errno)));
+        return 0;
+    }
+    return std::size_t(messagesSentNmb);
+}
+#endif
+}
@@ -26,7 +26,6 @@
 #include "asteroid_simulation/simulation_server.h"
 #include "asteroid/packet_type.h"
 #include "engine/engine.h"
-#include "engine/conversion.h"
 
 #include "imgui.h"
 
@@ -90,11 +89,7 @@ void SimulationClient::DrawImGui()
     if(gameManager_.GetPlayerNumber() == INVALID_PLAYER && ImGui::Button("Spawn Player"))
     {
         auto joinPacket = std::make_unique<asteroid::JoinPacket>();
-        auto* clientIdPtr = reinterpret_cast<std::uint8_t*>(&clientId_);
-        for(int i = 0; i < sizeof(clientId_); i++)
-        {
-            joinPacket->clientId[i] = clientIdPtr[i];
-        }
+        joinPacket->clientId = clientId_;
         SendReliablePacket(std::move(joinPacket));
     }
     gameManager_.DrawImGui();
@@ -23,7 +23,6 @@
  */
 
 #include "asteroid_simulation/simulation_server.h"
-#include "engine/conversion.h"
 #include "asteroid_simulation/simulation_client.h"
 #include "asteroid/game_manager.h"
 #include "asteroid/packet_type.h"
@@ -135,13 +134,13 @@ void SimulationServer::SpawnNewPlayer(ClientId clientId, PlayerNumber playerNumb
 
     auto spawnPlayer = std::make_unique<asteroid::SpawnPlayerPacket>();
     spawnPlayer->packetType = asteroid::PacketType::SPAWN_PLAYER;
-    spawnPlayer->clientId = ConvertToBinary(clientId);
+    spawnPlayer->clientId = clientId;
     spawnPlayer->playerNumber = playerNumber;
 
     const auto pos = asteroid::spawnPositions[playerNumber] * 3.0f;
-    spawnPlayer->pos = ConvertToBinary(pos);
+    spawnPlayer->pos = pos;
     const auto rotation = asteroid::spawnRotations[playerNumber];
-    spawnPlayer->angle = ConvertToBinary(rotation);
+    spawnPlayer->angle = rotation;
     gameManager_.SpawnPlayer(playerNumber, pos, rotation);
     SendReliablePacket(std::move(spawnPlayer));
 }
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <random>
+#include <vector>
+
+#include "asteroid/game.h"
+#include "asteroid/physics_manager.h"
+#include "mathematics/checksum.h"
+
+namespace neko::asteroid
+{
+
+namespace
+{
+struct CollisionRecorder : OnCollisionInterface
+{
+    explicit CollisionRecorder(EntityManager& manager) : entityManager(manager) {}
+    void OnCollision(Entity entity1, Entity entity2) override
+    {
+        collisions.emplace_back(entity1, entity2);
+        if (!destroyBullets)
+            return;
+        //Same destructions as the rollback manager, removed entities and DESTROYED flags
+        if (entityManager.HasComponent(entity2, EntityMask(ComponentType::BULLET)))
+        {
+            if (entity2 % 3 == 0)
+            {
+                entityManager.DestroyEntity(entity2);
+            }
+            else
+            {
+                entityManager.AddComponentType(entity2, EntityMask(ComponentType::DESTROYED));
+            }
+        }
+        if (entity1 % 5 == 0 && entityManager.HasComponent(entity1, EntityMask(ComponentType::BULLET)))
+        {
+            entityManager.AddComponentType(entity1, EntityMask(ComponentType::DESTROYED));
+        }
+    }
+    EntityManager& entityManager;
+    std::vector<std::pair<Entity, Entity>> collisions;
+    bool destroyBullets = false;
+};
+
+struct PhysicsWorld
+{
+    PhysicsWorld(std::size_t bodiesNmb, float worldSize, bool destroyBullets) :
+        physicsManager(entityManager), recorder(entityManager)
+    {
+        recorder.destroyBullets = destroyBullets;
+        physicsManager.RegisterCollisionListener(recorder);
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> positionDistribution(-worldSize, worldSize);
+        std::uniform_real_distribution<float> velocityDistribution(-2.0f, 2.0f);
+        for (std::size_t i = 0; i < bodiesNmb; i++)
+        {
+            const auto entity = entityManager.CreateEntity();
+            Body body;
+            body.position = Vec2f(positionDistribution(generator), positionDistribution(generator));
+            body.velocity = Vec2f(velocityDistribution(generator), velocityDistribution(generator));
+            physicsManager.AddBody(entity);
+            physicsManager.SetBody(entity, body);
+            //Some bodies without box and some already destroyed entities
+            if (i % 7 != 0)
+            {
+                Box box;
+                box.extends = Vec2f::one * (i % 2 == 0 ? bulletScale * 0.5f : 0.5f);
+                physicsManager.AddBox(entity);
+                physicsManager.SetBox(entity, box);
+            }
+            entityManager.AddComponentType(entity, EntityMask(i % 2 == 0 ? ComponentType::BULLET : ComponentType::PLAYER_CHARACTER));
+            if (i % 11 == 0)
+            {
+                entityManager.AddComponentType(entity, EntityMask(ComponentType::DESTROYED));
+            }
+        }
+    }
+    EntityManager entityManager;
+    PhysicsManager physicsManager;
+    CollisionRecorder recorder;
+};
+
+/**
+ * \brief Entity by entity physics loop the broadphase has to match
+ */
+void BruteForceFixedUpdate(PhysicsWorld& world, seconds dt)
+{
+    auto& entityManager = world.entityManager;
+    auto& physicsManager = world.physicsManager;
+    for (Entity entity = 0; entity < entityManager.GetEntitiesSize(); entity++)
+    {
+        if (!entityManager.HasComponent(entity, EntityMask(neko::ComponentType::BODY2D)))
+            continue;
+        auto body = physicsManager.GetBody(entity);
+        body.position += body.velocity * dt.count();
+        body.rotation += body.angularVelocity * dt.count();
+        physicsManager.SetBody(entity, body);
+    }
+    const auto bodyBoxMask = EntityMask(neko::ComponentType::BODY2D) | EntityMask(neko::ComponentType::BOX_COLLIDER2D);
+    for (Entity entity = 0; entity < entityManager.GetEntitiesSize(); entity++)
+    {
+        if (!entityManager.HasComponent(entity, bodyBoxMask) ||
+            entityManager.HasComponent(entity, EntityMask(ComponentType::DESTROYED)))
+            continue;
+        for (Entity otherEntity = entity + 1; otherEntity < entityManager.GetEntitiesSize(); otherEntity++)
+        {
+            if (!entityManager.HasComponent(otherEntity, bodyBoxMask) ||
+                entityManager.HasComponent(entity, EntityMask(ComponentType::DESTROYED)))
+                continue;
+            const Body& body1 = physicsManager.GetBody(entity);
+            const Box& box1 = physicsManager.GetBox(entity);
+            const Body& body2 = physicsManager.GetBody(otherEntity);
+            const Box& box2 = physicsManager.GetBox(otherEntity);
+            if (Box2Box(
+                body1.position.x - box1.extends.x,
+                body1.position.y - box1.extends.y,
+                box1.extends.x * 2.0f,
+                box1.extends.y * 2.0f,
+                body2.position.x - box2.extends.x,
+                body2.position.y - box2.extends.y,
+                box2.extends.x * 2.0f,
+                box2.extends.y * 2.0f))
+            {
+                world.recorder.OnCollision(entity, otherEntity);
+            }
+        }
+    }
+}
+
+std::uint32_t GetWorldChecksum(PhysicsWorld& world)
+{
+    std::uint32_t checksum = 0;
+    for (Entity entity = 0; entity < world.entityManager.GetEntitiesSize(); entity++)
+    {
+        checksum += world.entityManager.GetMask(entity);
+        const auto& body = world.physicsManager.GetBody(entity);
+        checksum += Checksum<std::uint32_t>(body.position);
+    }
+    return checksum;
+}
+}
+
+TEST(CompNet, PhysicsBroadphaseDeterminism)
+{
+    const std::size_t bodiesNmb = 2'000;
+    const int framesNmb = 30;
+    const auto dt = seconds(1.0f / 50.0f);
+    for (const bool destroyBullets : {false, true})
+    {
+        PhysicsWorld world(bodiesNmb, 10.0f, destroyBullets);
+        PhysicsWorld referenceWorld(bodiesNmb, 10.0f, destroyBullets);
+        std::size_t collisionsNmb = 0;
+        for (int frame = 0; frame < framesNmb; frame++)
+        {
+            world.physicsManager.FixedUpdate(dt);
+            BruteForceFixedUpdate(referenceWorld, dt);
+            ASSERT_EQ(referenceWorld.recorder.collisions, world.recorder.collisions);
+            ASSERT_EQ(GetWorldChecksum(referenceWorld), GetWorldChecksum(world));
+            collisionsNmb += world.recorder.collisions.size();
+            world.recorder.collisions.clear();
+            referenceWorld.recorder.collisions.clear();
+        }
+        EXPECT_GT(collisionsNmb, 0u);
+    }
+}
+
+TEST(CompNet, PhysicsBroadphaseTouchingBoxes)
+{
+    //Boxes sharing an edge or a corner collide, as with the inclusive Box2Box
+    PhysicsWorld world(0, 0.0f, false);
+    const std::array<Vec2f, 5> positions{{
+        Vec2f(0.0f, 0.0f), Vec2f(2.0f, 0.0f), Vec2f(0.0f, 2.0f), Vec2f(4.0f, 0.0f), Vec2f(0.0f, 10.0f)}};
+    for (const auto& position : positions)
+    {
+        const auto entity = world.entityManager.CreateEntity();
+        Body body;
+        body.position = position;
+        world.physicsManager.AddBody(entity);
+        world.physicsManager.SetBody(entity, body);
+        world.physicsManager.AddBox(entity);
+    }
+    world.physicsManager.FixedUpdate(seconds(0.0f));
+    const std::vector<std::pair<Entity, Entity>> expectedCollisions{{0, 1}, {0, 2}, {1, 2}, {1, 3}};
+    EXPECT_EQ(expectedCollisions, world.recorder.collisions);
+}
+}
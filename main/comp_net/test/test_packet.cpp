@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+
+#include "asteroid/packet_type.h"
+
+namespace neko::asteroid
+{
+
+TEST(CompNet, PacketRoundTrip)
+{
+    PacketBuffer buffer{};
+    SpawnPlayerPacket spawnPlayerPacket;
+    spawnPlayerPacket.clientId = 4'242;
+    spawnPlayerPacket.playerNumber = 1;
+    spawnPlayerPacket.pos = Vec2f(1.5f, -2.0f);
+    spawnPlayerPacket.angle = degree_t(90.0f);
+    auto packetSize = GeneratePacket(buffer, spawnPlayerPacket);
+    EXPECT_EQ(SpawnPlayerPacket::wireSize, packetSize);
+    const auto receivedPacket = GenerateReceivedPacket(buffer.data(), packetSize);
+    ASSERT_NE(nullptr, receivedPacket);
+    ASSERT_EQ(PacketType::SPAWN_PLAYER, receivedPacket->packetType);
+    const auto& receivedSpawnPlayerPacket = static_cast<const SpawnPlayerPacket&>(*receivedPacket);
+    EXPECT_EQ(spawnPlayerPacket.clientId, receivedSpawnPlayerPacket.clientId);
+    EXPECT_EQ(spawnPlayerPacket.playerNumber, receivedSpawnPlayerPacket.playerNumber);
+    EXPECT_EQ(spawnPlayerPacket.pos, receivedSpawnPlayerPacket.pos);
+    EXPECT_EQ(spawnPlayerPacket.angle.value(), receivedSpawnPlayerPacket.angle.value());
+
+    ValidateFramePacket validateFramePacket;
+    validateFramePacket.newValidateFrame = 123'456;
+    validateFramePacket.stateHashes = { 1, 0xFEDC'BA98'7654'3210, 3, 4, 5 };
+    packetSize = GeneratePacket(buffer, validateFramePacket);
+    EXPECT_EQ(ValidateFramePacket::wireSize, packetSize);
+    const auto receivedValidatePacket = GenerateReceivedPacket(buffer.data(), packetSize);
+    ASSERT_NE(nullptr, receivedValidatePacket);
+    ASSERT_EQ(PacketType::VALIDATE_STATE, receivedValidatePacket->packetType);
+    const auto& receivedValidateFramePacket = static_cast<const ValidateFramePacket&>(*receivedValidatePacket);
+    EXPECT_EQ(validateFramePacket.newValidateFrame, receivedValidateFramePacket.newValidateFrame);
+    EXPECT_EQ(validateFramePacket.stateHashes, receivedValidateFramePacket.stateHashes);
+}
+
+TEST(CompNet, PacketWireLayout)
+{
+    //Header bytes followed by the runs of inputs, 5 bits of input, 1 repeat bit and 5 bits of run length
+    PlayerInputPacket inputPacket;
+    inputPacket.playerNumber = 1;
+    inputPacket.currentFrame = 0x01020304;
+    inputPacket.inputsNmb = 4;
+    inputPacket.inputs[0] = PlayerInput::SHOOT;
+    inputPacket.inputs[1] = PlayerInput::UP;
+    inputPacket.inputs[2] = PlayerInput::UP;
+    inputPacket.inputs[3] = PlayerInput::UP;
+    PacketBuffer buffer{};
+    const auto packetSize = GeneratePacket(buffer, inputPacket);
+    ASSERT_EQ(1u + 1u + 4u + 1u + 3u, packetSize);
+    EXPECT_EQ(std::uint8_t(PacketType::INPUT), buffer[0]);
+    EXPECT_EQ(1u, buffer[1]);
+    std::uint32_t currentFrame = 0;
+    std::memcpy(&currentFrame, &buffer[2], sizeof(currentFrame));
+    EXPECT_EQ(inputPacket.currentFrame, currentFrame);
+    EXPECT_EQ(4u, buffer[6]);
+    //SHOOT not repeated, then UP repeated 3 times, from the least significant bit
+    const std::uint32_t bits = 0b00001'1'00001'0'10000u;
+    EXPECT_EQ(std::uint8_t(bits), buffer[7]);
+    EXPECT_EQ(std::uint8_t(bits >> 8u), buffer[8]);
+    EXPECT_EQ(std::uint8_t(bits >> 16u), buffer[9]);
+}
+
+TEST(CompNet, BitPackingRoundTrip)
+{
+    std::array<std::uint8_t, 16> buffer{};
+    buffer.fill(0xFF);
+    net::BitWriter bitWriter(buffer.data(), buffer.size());
+    bitWriter.Write(0b101u, 3);
+    bitWriter.Write(0xDEADBEEFu, 32);
+    bitWriter.Write(0u, 1);
+    bitWriter.Write(0x1Fu, 5);
+    EXPECT_EQ(6u, bitWriter.GetSize());
+    //The padding bits of the last byte are zero
+    EXPECT_EQ(0u, buffer[5] >> 1u);
+
+    net::BitReader bitReader(buffer.data(), bitWriter.GetSize());
+    EXPECT_EQ(0b101u, bitReader.Read(3));
+    EXPECT_EQ(0xDEADBEEFu, bitReader.Read(32));
+    EXPECT_EQ(0u, bitReader.Read(1));
+    EXPECT_EQ(0x1Fu, bitReader.Read(5));
+    EXPECT_TRUE(bitReader.IsValid());
+    EXPECT_EQ(6u, bitReader.GetSize());
+    bitReader.Read(8);
+    EXPECT_FALSE(bitReader.IsValid());
+}
+
+namespace
+{
+net::PlayerInput GetInputAtFrame(net::Frame frame)
+{
+    //The player changes its input every 7 frames, with single frame shots in between
+    if (frame % 11 == 0)
+        return PlayerInput::SHOOT;
+    return net::PlayerInput((frame / 7) % (1u << inputBitsNmb));
+}
+}
+
+TEST(CompNet, InputPacketRoundTrip)
+{
+    PacketBuffer buffer{};
+    //The window of the frames around the wraparound contains the last frames before it
+    for (net::Frame currentFrame = std::numeric_limits<net::Frame>::max() - 200; currentFrame != 200; currentFrame++)
+    {
+        for (const std::size_t inputsNmb : {std::size_t(1), std::size_t(3), std::size_t(50), maxInputNmb})
+        {
+            PlayerInputPacket inputPacket;
+            inputPacket.playerNumber = 1;
+            inputPacket.currentFrame = currentFrame;
+            inputPacket.inputsNmb = std::uint8_t(inputsNmb);
+            for (net::Frame i = 0; i < inputsNmb; i++)
+            {
+                inputPacket.inputs[i] = GetInputAtFrame(currentFrame - i);
+            }
+            const auto packetSize = GeneratePacket(buffer, inputPacket);
+            ASSERT_LE(packetSize, PlayerInputPacket::wireSize);
+            const auto receivedPacket = GenerateReceivedPacket(buffer.data(), packetSize);
+            ASSERT_NE(nullptr, receivedPacket);
+            ASSERT_EQ(PacketType::INPUT, receivedPacket->packetType);
+            const auto& receivedInputPacket = static_cast<const PlayerInputPacket&>(*receivedPacket);
+            ASSERT_EQ(inputPacket.playerNumber, receivedInputPacket.playerNumber);
+            ASSERT_EQ(currentFrame, receivedInputPacket.currentFrame);
+            ASSERT_EQ(inputsNmb, receivedInputPacket.inputsNmb);
+            for (net::Frame i = 0; i < inputsNmb; i++)
+            {
+                ASSERT_EQ(GetInputAtFrame(currentFrame - i), receivedInputPacket.inputs[i]) <<
+                    "Current frame: " << currentFrame << " input frame: " << currentFrame - i;
+            }
+        }
+    }
+}
+
+TEST(CompNet, InputPacketRunLength)
+{
+    PacketBuffer buffer{};
+    PlayerInputPacket inputPacket;
+    inputPacket.playerNumber = 0;
+    inputPacket.inputsNmb = std::uint8_t(maxInputNmb);
+    //Same input for the whole window: runs of maxRunLength inputs
+    inputPacket.inputs.fill(PlayerInput::UP | PlayerInput::LEFT);
+    const std::size_t headerSize = 1u + 1u + 4u + 1u;
+    const auto runsNmb = (maxInputNmb + maxRunLength - 1) / maxRunLength;
+    EXPECT_EQ(headerSize + (runsNmb * (inputBitsNmb + 1u + runLengthBitsNmb) + 7u) / 8u,
+        GeneratePacket(buffer, inputPacket));
+    //Different input every frame: 6 bits per input
+    for (std::size_t i = 0; i < maxInputNmb; i++)
+    {
+        inputPacket.inputs[i] = net::PlayerInput(i % 2 == 0 ? PlayerInput::UP : PlayerInput::DOWN);
+    }
+    EXPECT_EQ(PlayerInputPacket::wireSize, GeneratePacket(buffer, inputPacket));
+}
+
+TEST(CompNet, InputPacketRejectInvalid)
+{
+    PacketBuffer buffer{};
+    PlayerInputPacket inputPacket;
+    inputPacket.playerNumber = 0;
+    inputPacket.currentFrame = 100;
+    inputPacket.inputsNmb = 10;
+    for (std::size_t i = 0; i < inputPacket.inputsNmb; i++)
+    {
+        inputPacket.inputs[i] = net::PlayerInput(i < 5 ? PlayerInput::UP : PlayerInput::SHOOT);
+    }
+    const auto packetSize = GeneratePacket(buffer, inputPacket);
+    ASSERT_NE(nullptr, GenerateReceivedPacket(buffer.data(), packetSize));
+    EXPECT_EQ(nullptr, GenerateReceivedPacket(buffer.data(), packetSize - 1));
+    EXPECT_EQ(nullptr, GenerateReceivedPacket(buffer.data(), packetSize + 1));
+    //Runs longer than the number of inputs
+    buffer[6] = 9;
+    EXPECT_EQ(nullptr, GenerateReceivedPacket(buffer.data(), packetSize));
+    //More inputs than the window
+    buffer[6] = std::uint8_t(maxInputNmb + 1);
+    EXPECT_EQ(nullptr, GenerateReceivedPacket(buffer.data(), packetSize));
+}
+
+TEST(CompNet, PacketRejectWrongSize)
+{
+    PacketBuffer buffer{};
+    WinGamePacket winGamePacket;
+    winGamePacket.winner = 0;
+    const auto packetSize = GeneratePacket(buffer, winGamePacket);
+    EXPECT_NE(nullptr, GenerateReceivedPacket(buffer.data(), packetSize));
+    EXPECT_EQ(nullptr, GenerateReceivedPacket(buffer.data(), packetSize - 1));
+    EXPECT_EQ(nullptr, GenerateReceivedPacket(buffer.data(), packetSize + 1));
+    EXPECT_EQ(nullptr, GenerateReceivedPacket(buffer.data(), 0));
+    buffer[0] = std::uint8_t(PacketType::NONE);
+    EXPECT_EQ(nullptr, GenerateReceivedPacket(buffer.data(), packetSize));
+}
+}
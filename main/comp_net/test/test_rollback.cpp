@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include "asteroid/game_manager.h"
+#include "asteroid/rollback_history.h"
+
+namespace neko::asteroid
+{
+
+namespace
+{
+class TestGameManager : public GameManager
+{
+public:
+    TestGameManager()
+    {
+        Init();
+        for (net::PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+        {
+            SpawnPlayer(playerNumber, spawnPositions[playerNumber], spawnRotations[playerNumber]);
+        }
+    }
+    void StartNewFrame(net::Frame frame)
+    {
+        currentFrame_ = frame;
+        rollbackManager_.StartNewFrame(frame);
+    }
+    void SimulateToCurrentFrame() { rollbackManager_.SimulateToCurrentFrame(); }
+    EntityManager& GetEntityManager() { return entityManager_; }
+    const Body& GetBody(Entity entity) const { return rollbackManager_.GetPhysicsManager().GetBody(entity); }
+};
+
+/**
+ * \brief Players turning and shooting at each other, each player changes its input every few frames
+ */
+net::PlayerInput GetTestInput(net::PlayerNumber playerNumber, net::Frame frame)
+{
+    const net::Frame period = playerNumber == 0 ? 13 : 7;
+    const std::array<net::PlayerInput, 4> inputs{{
+        PlayerInput::SHOOT,
+        PlayerInput::SHOOT | PlayerInput::LEFT,
+        PlayerInput::UP | PlayerInput::SHOOT,
+        PlayerInput::RIGHT | PlayerInput::DOWN}};
+    return inputs[(frame / period + playerNumber) % inputs.size()];
+}
+
+void ExpectSameGameState(TestGameManager& gameManager, TestGameManager& referenceGameManager)
+{
+    auto& entityManager = gameManager.GetEntityManager();
+    auto& referenceEntityManager = referenceGameManager.GetEntityManager();
+    const auto entitiesSize = std::max(entityManager.GetEntitiesSize(), referenceEntityManager.GetEntitiesSize());
+    for (Entity entity = 0; entity < entitiesSize; entity++)
+    {
+        const auto mask = entity < entityManager.GetEntitiesSize() ? entityManager.GetMask(entity) : INVALID_ENTITY_MASK;
+        const auto referenceMask = entity < referenceEntityManager.GetEntitiesSize() ?
+            referenceEntityManager.GetMask(entity) : INVALID_ENTITY_MASK;
+        ASSERT_EQ(referenceMask, mask) << "Entity: " << entity;
+        if (!entityManager.HasComponent(entity, EntityMask(neko::ComponentType::BODY2D)))
+            continue;
+        const auto& body = gameManager.GetBody(entity);
+        const auto& referenceBody = referenceGameManager.GetBody(entity);
+        EXPECT_EQ(referenceBody.position, body.position) << "Entity: " << entity;
+        EXPECT_EQ(referenceBody.velocity, body.velocity) << "Entity: " << entity;
+        EXPECT_EQ(referenceBody.rotation.value(), body.rotation.value()) << "Entity: " << entity;
+    }
+    for (net::PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+    {
+        const auto playerEntity = gameManager.GetEntityFromPlayerNumber(playerNumber);
+        const auto& player = gameManager.GetRollbackManager().GetPlayerCharacterManager().GetComponent(playerEntity);
+        const auto& referencePlayer = referenceGameManager.GetRollbackManager().GetPlayerCharacterManager().GetComponent(playerEntity);
+        EXPECT_EQ(referencePlayer.health, player.health);
+        EXPECT_EQ(referencePlayer.shootingTime, player.shootingTime);
+        EXPECT_EQ(referencePlayer.invincibilityTime, player.invincibilityTime);
+        EXPECT_EQ(GetTestInput(playerNumber, gameManager.GetLastValidateFrame()), player.input);
+    }
+}
+}
+
+TEST(CompNet, ComponentHistoryRewind)
+{
+    ComponentHistory<int> history;
+    std::vector<int> values(4, 0);
+    const auto setValue = [&history, &values](Entity entity, int value)
+    {
+        history.Record(entity, values[entity]);
+        values[entity] = value;
+    };
+    //Not recording outside of a frame
+    setValue(0, 1);
+    EXPECT_EQ(0u, history.GetRecordsNmb());
+    for (net::Frame frame = 1; frame <= 3; frame++)
+    {
+        history.StartFrame(frame);
+        setValue(0, int(frame) * 10);
+        setValue(0, int(frame) * 10 + 1);
+        setValue(frame, int(frame));
+    }
+    history.StopRecording();
+    //Only the first write of an entity in a frame is recorded
+    EXPECT_EQ(6u, history.GetRecordsNmb());
+    const auto restore = [&values](Entity entity, int value) { values[entity] = value; };
+    history.Rewind(2, restore);
+    EXPECT_EQ(std::vector<int>({21, 1, 2, 0}), values);
+    history.StartFrame(3);
+    setValue(0, 50);
+    history.Rewind(1, restore);
+    EXPECT_EQ(std::vector<int>({11, 1, 0, 0}), values);
+    history.Rewind(0, restore);
+    EXPECT_EQ(std::vector<int>({1, 0, 0, 0}), values);
+    EXPECT_EQ(0u, history.GetRecordsNmb());
+}
+
+TEST(CompNet, RollbackMatchesValidatedSimulation)
+{
+    //Long enough for the first bullets to reach the end of their period
+    const net::Frame framesNmb = 400;
+    const net::Frame remoteDelay = 9;
+    const net::Frame validatePeriod = 12;
+    TestGameManager gameManager;
+    TestGameManager referenceGameManager;
+    for (net::Frame frame = 1; frame <= framesNmb; frame++)
+    {
+        //Client predicting the remote player, remote inputs arrive late
+        gameManager.StartNewFrame(frame);
+        gameManager.SetPlayerInput(0, GetTestInput(0, frame), frame);
+        if (frame > remoteDelay)
+        {
+            gameManager.SetPlayerInput(1, GetTestInput(1, frame - remoteDelay), frame - remoteDelay);
+        }
+        gameManager.SimulateToCurrentFrame();
+        gameManager.SimulateToCurrentFrame();
+        if (frame > remoteDelay && frame % validatePeriod == 0)
+        {
+            gameManager.Validate(frame - remoteDelay);
+            gameManager.SimulateToCurrentFrame();
+        }
+        //Server knowing all the inputs
+        referenceGameManager.StartNewFrame(frame);
+        for (net::PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+        {
+            referenceGameManager.SetPlayerInput(playerNumber, GetTestInput(playerNumber, frame), frame);
+        }
+        referenceGameManager.Validate(frame);
+    }
+    for (net::Frame frame = framesNmb - remoteDelay + 1; frame <= framesNmb; frame++)
+    {
+        gameManager.SetPlayerInput(1, GetTestInput(1, frame), frame);
+    }
+    gameManager.Validate(framesNmb);
+    ExpectSameGameState(gameManager, referenceGameManager);
+    //The client rolled back and destroyed predicted bullets, its stale components are not hashed
+    EXPECT_EQ(referenceGameManager.GetRollbackManager().GetValidateStateHashes(),
+        gameManager.GetRollbackManager().GetValidateStateHashes());
+}
+
+TEST(CompNet, StateHashDetectsDesync)
+{
+    const net::Frame framesNmb = 50;
+    TestGameManager gameManager;
+    TestGameManager referenceGameManager;
+    for (net::Frame frame = 1; frame <= framesNmb; frame++)
+    {
+        gameManager.StartNewFrame(frame);
+        referenceGameManager.StartNewFrame(frame);
+        for (net::PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+        {
+            //Only the first input differs, the players end with the same input
+            gameManager.SetPlayerInput(playerNumber, frame == 1 ? PlayerInput::UP : 0, frame);
+            referenceGameManager.SetPlayerInput(playerNumber, 0, frame);
+        }
+        gameManager.Validate(frame);
+        referenceGameManager.Validate(frame);
+    }
+    const auto& stateHashes = gameManager.GetRollbackManager().GetValidateStateHashes();
+    const auto& referenceStateHashes = referenceGameManager.GetRollbackManager().GetValidateStateHashes();
+    EXPECT_NE(referenceStateHashes[std::size_t(StateComponent::BODY)], stateHashes[std::size_t(StateComponent::BODY)]);
+    for (const auto stateComponent : { StateComponent::ENTITY_MASK, StateComponent::BOX,
+        StateComponent::PLAYER_CHARACTER, StateComponent::BULLET })
+    {
+        EXPECT_EQ(referenceStateHashes[std::size_t(stateComponent)], stateHashes[std::size_t(stateComponent)]);
+    }
+}
+}
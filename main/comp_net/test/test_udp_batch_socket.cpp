@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "asteroid_net/udp_batch_socket.h"
+
+namespace neko::net
+{
+
+TEST(CompNet, UdpBatchSocketDrainWithDroppedDatagram)
+{
+    UdpBatchSocket receiver;
+    ASSERT_EQ(sf::Socket::Done, receiver.bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost));
+    receiver.setBlocking(false);
+    sf::UdpSocket sender;
+    ASSERT_EQ(sf::Socket::Done, sender.bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost));
+
+    //One datagram too big for the arena in the first full batch, the drain goes on with the next batch
+    const std::size_t datagramsNmb = UdpBatchSocket::batchSize + 10;
+    const std::size_t bigDatagramIndex = 5;
+    const std::vector<std::uint8_t> bigDatagram(UdpBatchSocket::maxDatagramSize + 1, 0);
+    for (std::size_t i = 0; i < datagramsNmb; i++)
+    {
+        const std::uint8_t data = std::uint8_t(i);
+        if (i == bigDatagramIndex)
+        {
+            ASSERT_EQ(sf::Socket::Done, sender.send(bigDatagram.data(), bigDatagram.size(),
+                sf::IpAddress::LocalHost, receiver.getLocalPort()));
+            continue;
+        }
+        ASSERT_EQ(sf::Socket::Done, sender.send(&data, sizeof(data), sf::IpAddress::LocalHost, receiver.getLocalPort()));
+    }
+
+    std::vector<std::uint8_t> receivedData;
+    const auto receivedNmb = receiver.ReceiveBatches(4, [&receivedData](const UdpDatagram& datagram)
+    {
+        ASSERT_EQ(1u, datagram.size);
+        receivedData.push_back(datagram.data[0]);
+    });
+    EXPECT_EQ(datagramsNmb - 1, receivedNmb);
+    ASSERT_EQ(datagramsNmb - 1, receivedData.size());
+    EXPECT_EQ(std::uint8_t(datagramsNmb - 1), receivedData.back());
+}
+
+}
@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "voxel/chunk_generator.h"
+
+using namespace neko;
+using namespace neko::voxel;
+
+namespace
+{
+//Chunks loaded around the center of the region, like VoxelManager does
+std::vector<Chunk> GenerateChunks(int renderDistance)
+{
+    ChunkGenerator chunkGenerator;
+    std::vector<Chunk> chunks;
+    const int center = static_cast<int>(regionSize / 2);
+    for (int chunkX = center - renderDistance; chunkX <= center + renderDistance; chunkX++)
+    {
+        for (int chunkZ = center - renderDistance; chunkZ <= center + renderDistance; chunkZ++)
+        {
+            const auto height = chunkGenerator.GetHeight(0, Vec2u(chunkX * chunkSize, chunkZ * chunkSize));
+            for (size_t chunkY = height / chunkSize; chunkY <= height / chunkSize + 1 && chunkY < regionHeight; chunkY++)
+            {
+                chunks.push_back(chunkGenerator.GenerateChunk(0, Region::GetChunkId(chunkX, chunkZ, chunkY)));
+            }
+        }
+    }
+    return chunks;
+}
+
+//Previous storage, a dense array of the cube struct for each chunk with cubes
+using DenseChunkContent = std::array<std::array<std::array<Cube, chunkSize>, chunkSize>, chunkSize>;
+}
+
+static void BM_ChunkContentMemory(benchmark::State& state)
+{
+    const auto chunks = GenerateChunks(static_cast<int>(state.range(0)));
+    size_t paletteBytes = 0;
+    size_t denseBytes = 0;
+    for (auto _ : state)
+    {
+        paletteBytes = 0;
+        denseBytes = 0;
+        for (const auto& chunk : chunks)
+        {
+            if (chunk.contents == nullptr)
+            {
+                continue;
+            }
+            paletteBytes += chunk.contents->GetMemoryUsage();
+            denseBytes += sizeof(DenseChunkContent);
+        }
+        benchmark::DoNotOptimize(paletteBytes);
+    }
+    state.counters["chunks"] = double(chunks.size());
+    state.counters["palette_MB"] = double(paletteBytes) / (1024.0 * 1024.0);
+    state.counters["dense_MB"] = double(denseBytes) / (1024.0 * 1024.0);
+}
+BENCHMARK(BM_ChunkContentMemory)->Arg(2)->Arg(5)->Arg(10);
+
+static void BM_ChunkContentNeighbours(benchmark::State& state)
+{
+    const auto chunks = GenerateChunks(1);
+    for (auto _ : state)
+    {
+        size_t visibleFaces = 0;
+        for (const auto& chunk : chunks)
+        {
+            if (chunk.contents == nullptr)
+            {
+                continue;
+            }
+            for (std::uint8_t x = 0; x < chunkSize; x++)
+            {
+                for (std::uint8_t z = 0; z < chunkSize; z++)
+                {
+                    for (std::uint8_t y = 0; y < chunkSize - 1; y++)
+                    {
+                        visibleFaces += chunk.contents->HasCube(Vec3b(x, y, z)) &&
+                                        !chunk.contents->HasCube(Vec3b(x, std::uint8_t(y + 1), z));
+                    }
+                }
+            }
+        }
+        benchmark::DoNotOptimize(visibleFaces);
+    }
+    state.SetItemsProcessed(state.iterations() * chunks.size() * ChunkContent::cubesNmb);
+}
+BENCHMARK(BM_ChunkContentNeighbours);
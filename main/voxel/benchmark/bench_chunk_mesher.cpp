@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "voxel/chunk_generator.h"
+#include "voxel/chunk_mesher.h"
+
+using namespace neko;
+using namespace neko::voxel;
+
+namespace
+{
+std::vector<Chunk> GenerateChunks(size_t chunksNmb)
+{
+    ChunkGenerator chunkGenerator;
+    std::vector<Chunk> chunks;
+    chunks.reserve(chunksNmb);
+    const auto chunkZ = regionSize / 2;
+    for (size_t chunkX = 0; chunks.size() < chunksNmb; chunkX = (chunkX + 1) % regionSize)
+    {
+        const auto height = chunkGenerator.GetHeight(0, Vec2u(chunkX * chunkSize, chunkZ * chunkSize));
+        auto chunk = chunkGenerator.GenerateChunk(0, Region::GetChunkId(chunkX, chunkZ, height / chunkSize));
+        if (chunk.contents != nullptr)
+        {
+            chunks.push_back(std::move(chunk));
+        }
+    }
+    return chunks;
+}
+
+Chunk GenerateCheckerboardChunk()
+{
+    Chunk chunk;
+    chunk.contents = std::make_unique<ChunkContent>();
+    for (size_t x = 0; x < chunkSize; x++)
+    {
+        for (size_t z = 0; z < chunkSize; z++)
+        {
+            for (size_t y = 0; y < chunkSize; y++)
+            {
+                if ((x + y + z) % 2 == 0)
+                {
+                    chunk.contents->SetCubeType(Vec3b(x, y, z), CubeType::ROCK);
+                }
+            }
+        }
+    }
+    return chunk;
+}
+}
+
+static void BM_MeshGeneratedChunk(benchmark::State& state)
+{
+    const auto chunks = GenerateChunks(16);
+    ChunkMesher chunkMesher;
+    ChunkMesh chunkMesh;
+    size_t chunkIndex = 0;
+    size_t meshVerticesNmb = 0;
+    size_t instancedVerticesNmb = 0;
+    for (auto _ : state)
+    {
+        const auto& chunk = chunks[chunkIndex];
+        chunkMesher.GenerateMesh(chunk, chunkMesh);
+        benchmark::DoNotOptimize(chunkMesh.vertices.data());
+        meshVerticesNmb += chunkMesh.vertices.size();
+        instancedVerticesNmb += chunk.visibleCubes.size() * 36;
+        chunkIndex = (chunkIndex + 1) % chunks.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["vertices_per_chunk"] = double(meshVerticesNmb) / double(state.iterations());
+    state.counters["instanced_vertices_per_chunk"] = double(instancedVerticesNmb) / double(state.iterations());
+}
+BENCHMARK(BM_MeshGeneratedChunk)->Unit(benchmark::kMillisecond);
+
+static void BM_MeshCheckerboardChunk(benchmark::State& state)
+{
+    const auto chunk = GenerateCheckerboardChunk();
+    ChunkMesher chunkMesher;
+    ChunkMesh chunkMesh;
+    for (auto _ : state)
+    {
+        chunkMesher.GenerateMesh(chunk, chunkMesh);
+        benchmark::DoNotOptimize(chunkMesh.vertices.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["vertices_per_chunk"] = double(chunkMesh.vertices.size());
+}
+BENCHMARK(BM_MeshCheckerboardChunk)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "voxel/chunk_quadtree.h"
+#include "voxel/frustum.h"
+
+using namespace neko;
+using namespace neko::voxel;
+
+namespace
+{
+//Every chunk of a 64x64x16 region
+struct RegionChunks
+{
+    RegionChunks() : chunks(regionSize * regionSize * regionHeight)
+    {
+        for (size_t i = 0; i < chunks.size(); i++)
+        {
+            chunks[i].chunkId = ChunkId(i);
+            chunkPtrs.push_back(&chunks[i]);
+        }
+    }
+    std::vector<Chunk> chunks;
+    std::vector<const Chunk*> chunkPtrs;
+};
+
+/**
+ * \brief Camera of the voxel sample, turned by range degrees around the vertical axis
+ */
+Frustum CreateFrustum(long angle)
+{
+    Camera3D camera;
+    camera.position = Vec3f(0.0f, 10.0f, 0.0f);
+    const auto direction = Vec3f(Cos(degree_t(float(angle))), -0.2f, Sin(degree_t(float(angle))));
+    camera.WorldLookAt(camera.position + direction);
+    camera.farPlane = 5000.0f;
+    camera.fovY = degree_t(45.0f / 2.0f);
+    camera.SetAspect(1280, 720);
+    Frustum frustum;
+    frustum.SetCamera(camera);
+    return frustum;
+}
+}
+
+static void BM_FrustumContainsPerChunk(benchmark::State& state)
+{
+    const RegionChunks regionChunks;
+    const auto frustum = CreateFrustum(state.range(0));
+    std::vector<const Chunk*> visibleChunks;
+    for (auto _ : state)
+    {
+        visibleChunks.clear();
+        for (const auto* chunk : regionChunks.chunkPtrs)
+        {
+            if (frustum.Contains(Region::GetChunkAabb(chunk->chunkId).lowerLeftBound, 0))
+            {
+                visibleChunks.push_back(chunk);
+            }
+        }
+        benchmark::DoNotOptimize(visibleChunks.data());
+    }
+    state.counters["visible"] = double(visibleChunks.size());
+    state.SetItemsProcessed(state.iterations() * regionChunks.chunkPtrs.size());
+}
+BENCHMARK(BM_FrustumContainsPerChunk)->Arg(0)->Arg(45)->Arg(210);
+
+static void BM_ChunkQuadtreeCull(benchmark::State& state)
+{
+    const RegionChunks regionChunks;
+    const auto frustum = CreateFrustum(state.range(0));
+    ChunkQuadtree chunkQuadtree;
+    chunkQuadtree.Build(regionChunks.chunkPtrs);
+    std::vector<const Chunk*> visibleChunks;
+    for (auto _ : state)
+    {
+        visibleChunks.clear();
+        chunkQuadtree.Cull(frustum, visibleChunks);
+        benchmark::DoNotOptimize(visibleChunks.data());
+    }
+    state.counters["visible"] = double(visibleChunks.size());
+    state.SetItemsProcessed(state.iterations() * regionChunks.chunkPtrs.size());
+}
+BENCHMARK(BM_ChunkQuadtreeCull)->Arg(0)->Arg(45)->Arg(210);
+
+static void BM_ChunkQuadtreeBuild(benchmark::State& state)
+{
+    const RegionChunks regionChunks;
+    ChunkQuadtree chunkQuadtree;
+    for (auto _ : state)
+    {
+        chunkQuadtree.Build(regionChunks.chunkPtrs);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * regionChunks.chunkPtrs.size());
+}
+BENCHMARK(BM_ChunkQuadtreeBuild);
@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "voxel/chunk_generator.h"
+#include "voxel/region_file.h"
+
+using namespace neko;
+using namespace neko::voxel;
+
+namespace
+{
+//Columns loaded at startup by VoxelManager with a render distance of 10
+constexpr int renderDistance = 10;
+const std::string regionFilePath = "bench_region_file.nkr";
+
+template<typename Func>
+void ForEachStartupColumn(Func func)
+{
+    for (int dx = -renderDistance; dx <= renderDistance; dx++)
+    {
+        for (int dz = -renderDistance; dz <= renderDistance; dz++)
+        {
+            func(size_t(int(regionSize / 2) + dx), size_t(int(regionSize / 2) + dz));
+        }
+    }
+}
+
+/**
+ * \brief Write the startup columns in a region file once for all the benchmarks
+ */
+const std::vector<ChunkId>& GetSavedChunkIds()
+{
+    static std::vector<ChunkId> chunkIds;
+    if (!chunkIds.empty())
+    {
+        return chunkIds;
+    }
+    ChunkGenerator chunkGenerator;
+    std::vector<Chunk> chunks;
+    ForEachStartupColumn([&chunkGenerator, &chunks](size_t chunkX, size_t chunkZ)
+    {
+        chunkGenerator.GenerateColumn(0, chunkX, chunkZ, chunks);
+    });
+    std::vector<const Chunk*> savedChunks;
+    for (const auto& chunk : chunks)
+    {
+        savedChunks.push_back(&chunk);
+        chunkIds.push_back(chunk.chunkId);
+    }
+    RegionFile::Save(regionFilePath, savedChunks);
+    return chunkIds;
+}
+}
+
+static void BM_StartupGenerate(benchmark::State& state)
+{
+    ChunkGenerator chunkGenerator;
+    std::vector<Chunk> chunks;
+    for (auto _ : state)
+    {
+        chunks.clear();
+        ForEachStartupColumn([&chunkGenerator, &chunks](size_t chunkX, size_t chunkZ)
+        {
+            chunkGenerator.GenerateColumn(0, chunkX, chunkZ, chunks);
+        });
+        benchmark::DoNotOptimize(chunks.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (2 * renderDistance + 1) * (2 * renderDistance + 1));
+}
+BENCHMARK(BM_StartupGenerate)->Unit(benchmark::kMillisecond);
+
+static void BM_StartupRegionFile(benchmark::State& state)
+{
+    const auto& chunkIds = GetSavedChunkIds();
+    std::vector<Chunk> chunks(chunkIds.size());
+    for (auto _ : state)
+    {
+        RegionFile regionFile;
+        regionFile.Open(regionFilePath);
+        for (size_t i = 0; i < chunkIds.size(); i++)
+        {
+            regionFile.LoadChunk(chunkIds[i], chunks[i]);
+        }
+        benchmark::DoNotOptimize(chunks.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (2 * renderDistance + 1) * (2 * renderDistance + 1));
+}
+BENCHMARK(BM_StartupRegionFile)->Unit(benchmark::kMillisecond);
+
+static void BM_RegionFileSave(benchmark::State& state)
+{
+    const auto& chunkIds = GetSavedChunkIds();
+    RegionFile regionFile;
+    regionFile.Open(regionFilePath);
+    std::vector<Chunk> chunks(chunkIds.size());
+    std::vector<const Chunk*> savedChunks;
+    for (size_t i = 0; i < chunkIds.size(); i++)
+    {
+        regionFile.LoadChunk(chunkIds[i], chunks[i]);
+        savedChunks.push_back(&chunks[i]);
+    }
+    const std::string savePath = "bench_region_file_save.nkr";
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(RegionFile::Save(savePath, savedChunks, int(state.range(0))));
+    }
+    std::remove(savePath.c_str());
+}
+BENCHMARK(BM_RegionFileSave)->Arg(1)->Arg(RegionFile::defaultCompressionLevel)->Arg(9)->Unit(benchmark::kMillisecond);
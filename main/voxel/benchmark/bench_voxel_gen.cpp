@@ -0,0 +1,147 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+
+#include <PerlinNoise.hpp>
+
+#include "voxel/chunk_generator.h"
+
+using namespace neko;
+using namespace neko::voxel;
+
+namespace
+{
+constexpr std::int32_t octave = 5;
+constexpr double scale = 10.0;
+constexpr double elevationPow = 5.0;
+constexpr double maxHeight = regionHeight * chunkSize;
+constexpr auto regionWidthFloat = static_cast<double>(regionSize * chunkSize);
+//Chunk columns around the center of the region, like VoxelManager loads them
+constexpr size_t firstChunk = regionSize / 2 - 8;
+constexpr size_t columnsSide = 16;
+
+size_t ScalarHeight(const siv::PerlinNoise& perlinNoise, size_t x, size_t z)
+{
+    const Vec2df regionOriginPos = Region::GetRegionPos(0);
+    const double voxelX = (static_cast<double>(x) - regionWidthFloat / 2.0 + regionOriginPos.x) / regionWidthFloat * scale;
+    const double voxelZ = (static_cast<double>(z) - regionWidthFloat / 2.0 + regionOriginPos.y) / regionWidthFloat * scale;
+    return static_cast<size_t>(maxHeight * std::pow(perlinNoise.normalizedOctaveNoise2D_0_1(voxelX, voxelZ, octave), elevationPow));
+}
+
+/**
+ * \brief Previous generator of the surface of a chunk, the noise is evaluated again for each neighbour
+ */
+size_t ScalarGenerateSurface(const siv::PerlinNoise& perlinNoise, size_t chunkX, size_t chunkZ)
+{
+    size_t cubesNmb = 0;
+    for (size_t x = chunkX * chunkSize; x < (chunkX + 1) * chunkSize; x++)
+    {
+        for (size_t z = chunkZ * chunkSize; z < (chunkZ + 1) * chunkSize; z++)
+        {
+            const auto y = ScalarHeight(perlinNoise, x, z);
+            cubesNmb++;
+            int maxDiff = 0;
+            for (int dx = -1; dx <= 1; dx++)
+            {
+                if (!(x - dx >= chunkX * chunkSize && x - dx < (chunkX + 1) * chunkSize))
+                    continue;
+                for (int dz = -1; dz <= 1; dz++)
+                {
+                    if (!(z - dz >= chunkZ * chunkSize && z - dz < (chunkZ + 1) * chunkSize))
+                        continue;
+                    if (dx == 0 && dz == 0)
+                        continue;
+                    const int diff = static_cast<int>(y) - static_cast<int>(ScalarHeight(perlinNoise, x - dx, z - dz));
+                    if (maxDiff < diff)
+                    {
+                        cubesNmb += diff - maxDiff;
+                        maxDiff = diff;
+                    }
+                }
+            }
+        }
+    }
+    return cubesNmb;
+}
+}
+
+static void BM_ScalarColumnHeights(benchmark::State& state)
+{
+    const siv::PerlinNoise perlinNoise{};
+    for (auto _ : state)
+    {
+        for (size_t chunkX = firstChunk; chunkX < firstChunk + columnsSide; chunkX++)
+        {
+            for (size_t chunkZ = firstChunk; chunkZ < firstChunk + columnsSide; chunkZ++)
+            {
+                for (size_t x = chunkX * chunkSize; x < (chunkX + 1) * chunkSize; x++)
+                {
+                    for (size_t z = chunkZ * chunkSize; z < (chunkZ + 1) * chunkSize; z++)
+                    {
+                        benchmark::DoNotOptimize(ScalarHeight(perlinNoise, x, z));
+                    }
+                }
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * columnsSide * columnsSide * chunkSize * chunkSize);
+}
+BENCHMARK(BM_ScalarColumnHeights)->Unit(benchmark::kMillisecond);
+
+static void BM_BatchColumnHeights(benchmark::State& state)
+{
+    const ChunkGenerator chunkGenerator;
+    ColumnHeights heights{};
+    for (auto _ : state)
+    {
+        for (size_t chunkX = firstChunk; chunkX < firstChunk + columnsSide; chunkX++)
+        {
+            for (size_t chunkZ = firstChunk; chunkZ < firstChunk + columnsSide; chunkZ++)
+            {
+                chunkGenerator.CalculateColumnHeights(0, chunkX, chunkZ, heights);
+                benchmark::DoNotOptimize(heights.data());
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * columnsSide * columnsSide * chunkSize * chunkSize);
+}
+BENCHMARK(BM_BatchColumnHeights)->Unit(benchmark::kMillisecond);
+
+static void BM_ScalarGenerateChunks(benchmark::State& state)
+{
+    const siv::PerlinNoise perlinNoise{};
+    for (auto _ : state)
+    {
+        for (size_t chunkX = firstChunk; chunkX < firstChunk + columnsSide; chunkX++)
+        {
+            for (size_t chunkZ = firstChunk; chunkZ < firstChunk + columnsSide; chunkZ++)
+            {
+                benchmark::DoNotOptimize(ScalarGenerateSurface(perlinNoise, chunkX, chunkZ));
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * columnsSide * columnsSide * chunkSize * chunkSize);
+}
+BENCHMARK(BM_ScalarGenerateChunks)->Unit(benchmark::kMillisecond);
+
+static void BM_GenerateChunks(benchmark::State& state)
+{
+    ChunkGenerator chunkGenerator;
+    for (auto _ : state)
+    {
+        //Every iteration starts from an empty cache, as a newly visited area would
+        state.PauseTiming();
+        chunkGenerator.ClearHeightsCache();
+        state.ResumeTiming();
+        for (size_t chunkX = firstChunk; chunkX < firstChunk + columnsSide; chunkX++)
+        {
+            for (size_t chunkZ = firstChunk; chunkZ < firstChunk + columnsSide; chunkZ++)
+            {
+                const auto chunkY = chunkGenerator.GetColumnHeights(0, chunkX, chunkZ).front() / chunkSize;
+                benchmark::DoNotOptimize(chunkGenerator.GenerateChunk(0, Region::GetChunkId(chunkX, chunkZ, chunkY)));
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * columnsSide * columnsSide * chunkSize * chunkSize);
+}
+BENCHMARK(BM_GenerateChunks)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,19 @@
+#version 300 es
+precision highp float;
+
+in vec2 TexCoord;
+flat in vec2 TileOrigin;
+out vec4 FragColor;
+
+const uint tileNmbX = 14u;
+const uint tileNmbY = 7u;
+const vec2 tileSize = vec2(1.0 / float(tileNmbX), 1.0 / float(tileNmbY));
+
+uniform sampler2D tilesheet;
+
+void main()
+{
+    // merged faces repeat the tile once per cube
+    vec2 texCoord = TileOrigin + fract(TexCoord) * tileSize;
+    FragColor = vec4(texture(tilesheet, texCoord).rgb, 1.0);
+}
@@ -0,0 +1,41 @@
+#version 300 es
+precision highp float;
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in uint faceType;
+layout(location = 2) in vec2 aTexCoords;
+layout(location = 3) in uint textureId;
+
+const uint TopFace = 1u;
+const uint BottomFace = 2u;
+const uint SideFace = 3u;
+const uint tileNmbX = 14u;
+const uint tileNmbY = 7u;
+const float tileSizeX = 1.0 / float(tileNmbX);
+const float tileSizeY = 1.0 / float(tileNmbY);
+
+out vec2 TexCoord;
+flat out vec2 TileOrigin;
+
+uniform mat4 view;
+uniform mat4 proj;
+// lower corner of the chunk bounds, half a cube before the center of its first cube
+uniform vec3 chunkPosition;
+
+void main()
+{
+    // mesh positions are the corners of the cube grid
+    vec3 worldPos = chunkPosition + aPos;
+    gl_Position = proj * view * vec4(worldPos, 1.0);
+    uint textureIndex =
+        faceType == TopFace ? textureId >> 16u :
+        (faceType == BottomFace ? (textureId >> 8u) & 255u :
+        textureId & 255u);
+
+    uint tileY = textureIndex / tileNmbX;
+    uint tileX = textureIndex - tileY * tileNmbX;
+    TileOrigin = vec2(
+            float(tileX) * tileSizeX,
+            1.0 - float(tileY) * tileSizeY - tileSizeY);
+    TexCoord = aTexCoords;
+}
\ No newline at end of file
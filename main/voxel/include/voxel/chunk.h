@@ -52,6 +52,9 @@ enum class CubeType : std::uint8_t
 using CubeTextureId = std::uint32_t;
 
 CubeTextureId GenerateTextureId(CubeType cubeType);
+/**
+ * \brief Description of a single cube, chunks store their cubes compressed in a ChunkContent
+ */
 struct Cube
 {
     enum CubeFlag : std::uint8_t
@@ -72,7 +75,77 @@ struct Cube
 };
 
 
-using ChunkContent = std::array<std::array<std::array<Cube, chunkSize>, chunkSize>, chunkSize>;
+/**
+ * \brief Palette compressed cubes of a chunk.
+ * Each cube stores an index in the palette of the chunk with 1, 2, 4 or 8 bits,
+ * a chunk with a single cube type does not store any index.
+ */
+class ChunkContent
+{
+    using IndexWord = std::uint64_t;
+    static constexpr size_t indexWordBits = sizeof(IndexWord) * 8;
+public:
+    static constexpr size_t cubesNmb = chunkSize * chunkSize * chunkSize;
+    /**
+     * \brief Upper bound of the blob written by Compress, with 8 bits indices and a run header for each word
+     */
+    static constexpr size_t maxCompressedSize =
+        2 + 256 + cubesNmb * 8 / indexWordBits * (sizeof(IndexWord) + sizeof(std::uint16_t));
+
+    explicit ChunkContent(CubeType cubeType = CubeType::NONE);
+
+    /**
+     * \brief Cube ids are also the index of the cube in the chunk, see Cube::CalculateCubeId
+     */
+    [[nodiscard]] CubeType GetCubeType(CubeId cubeId) const
+    {
+        if (bitsPerIndex_ == 0)
+        {
+            return palette_[0];
+        }
+        const auto bitIndex = size_t(cubeId) * bitsPerIndex_;
+        const auto paletteIndex = (indices_[bitIndex / indexWordBits] >> (bitIndex % indexWordBits)) & indexMask_;
+        return palette_[paletteIndex];
+    }
+    [[nodiscard]] CubeType GetCubeType(Vec3b cubePosition) const
+    {
+        return GetCubeType(Cube::CalculateCubeId(cubePosition));
+    }
+    [[nodiscard]] bool HasCube(Vec3b cubePosition) const
+    {
+        return GetCubeType(cubePosition) != CubeType::NONE;
+    }
+    void SetCubeType(CubeId cubeId, CubeType cubeType);
+    void SetCubeType(Vec3b cubePosition, CubeType cubeType)
+    {
+        SetCubeType(Cube::CalculateCubeId(cubePosition), cubeType);
+    }
+    /**
+     * \brief Set all the cubes of the chunk to the same type, releasing the indices
+     */
+    void Fill(CubeType cubeType);
+
+    [[nodiscard]] bool IsUniform() const { return bitsPerIndex_ == 0; }
+    [[nodiscard]] size_t GetPaletteSize() const { return palette_.size(); }
+    [[nodiscard]] std::uint8_t GetBitsPerIndex() const { return bitsPerIndex_; }
+    [[nodiscard]] size_t GetMemoryUsage() const;
+    /**
+     * \brief Append the palette and the run length encoded index words to the blob
+     */
+    void Compress(std::vector<std::uint8_t>& blob) const;
+    /**
+     * \brief Replace the content with a compressed blob, returns false if the blob is invalid
+     */
+    bool Decompress(const std::uint8_t* blob, size_t blobSize);
+private:
+    static constexpr std::uint16_t literalRunBit = 0x8000u;
+    void Repack(std::uint8_t bitsPerIndex);
+
+    std::vector<CubeType> palette_;
+    std::vector<IndexWord> indices_;
+    IndexWord indexMask_ = 0u;
+    std::uint8_t bitsPerIndex_ = 0;
+};
 using ChunkVisibleArray = std::vector<CubeId>;
 using ChunkId = std::uint16_t;
 struct Chunk
@@ -86,6 +159,10 @@ struct Chunk
     ChunkVisibleArray visibleCubes;
     ChunkId chunkId = 0;
     std::uint8_t flag = NONE;
+    /**
+     * \brief Incremented each time the chunk is replaced, its mesh is only rebuilt when it changes
+     */
+    std::uint32_t version = 0;
 };
 
 
@@ -24,29 +24,64 @@
  SOFTWARE.
  */
 
-#include <PerlinNoise.hpp>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include "chunk.h"
 #include "region.h"
 #include "mathematics/vector.h"
+#include "voxel/perlin_noise.h"
 
 namespace neko::voxel
 {
 
+/**
+ * \brief Terrain heights of a chunk column, indexed by x * chunkSize + z
+ */
+using ColumnHeights = std::array<std::uint16_t, chunkSize * chunkSize>;
+
+/**
+ * \brief Generates the terrain from a Perlin noise height map.
+ * The heights of a chunk column are computed once and cached, so that the chunks of a column
+ * and the height queries share them. GenerateChunk and GetHeight can be called from several threads.
+ */
 class ChunkGenerator
 {
 public:
-    [[nodiscard]] Chunk GenerateChunk(RegionId regionId, ChunkId chunkId) const;
-    [[nodiscard]] Region GenerateRegion(RegionId regionId) const;
-    [[nodiscard]] size_t GetHeight(RegionId regionId, Vec2u cubePos) const;
-private:
-    siv::PerlinNoise perlinNoise_{};
     static constexpr std::int32_t octave = 5;
     static constexpr double scale = 10.0;
-    static constexpr double elevetionPow = 5.0;
+    static constexpr int elevetionPow = 5;
     static constexpr double maxHeight = regionHeight * chunkSize;
     static constexpr int regionWidth = regionSize * chunkSize;
     static constexpr auto regionWidthFloat = static_cast<double>(regionWidth);
+
+    [[nodiscard]] Chunk GenerateChunk(RegionId regionId, ChunkId chunkId) const;
+    /**
+     * \brief Generate the chunks of a column crossed by the terrain, its heights are not cached
+     */
+    void GenerateColumn(RegionId regionId, size_t chunkX, size_t chunkZ, std::vector<Chunk>& chunks) const;
+    [[nodiscard]] Region GenerateRegion(RegionId regionId) const;
+    [[nodiscard]] size_t GetHeight(RegionId regionId, Vec2u cubePos) const;
+    /**
+     * \brief Cached heights of the chunk column.
+     * ClearHeightsCache destroys the heights, so it must not be called while a generation job still reads them.
+     */
+    [[nodiscard]] const ColumnHeights& GetColumnHeights(RegionId regionId, size_t chunkX, size_t chunkZ) const;
+    /**
+     * \brief Computes the heights of the chunk column without going through the cache
+     */
+    void CalculateColumnHeights(RegionId regionId, size_t chunkX, size_t chunkZ, ColumnHeights& heights) const;
+    /**
+     * \brief Invalidate all the references returned by GetColumnHeights
+     */
+    void ClearHeightsCache();
+private:
+    [[nodiscard]] static Chunk GenerateChunk(const ColumnHeights& heights, size_t chunkX, size_t chunkZ, size_t chunkY);
+    BatchPerlinNoise perlinNoise_{};
+    mutable std::mutex heightsCacheMutex_;
+    mutable std::unordered_map<std::uint64_t, std::unique_ptr<ColumnHeights>> heightsCache_;
 };
 
 }
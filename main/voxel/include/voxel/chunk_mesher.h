@@ -0,0 +1,93 @@
+#pragma once
+
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <array>
+#include <limits>
+#include <vector>
+
+#include "voxel/chunk.h"
+
+namespace neko::voxel
+{
+
+struct ChunkVertex
+{
+    enum FaceType : std::uint8_t
+    {
+        NONE = 0,
+        TOP = 1,
+        BOTTOM = 2,
+        SIDE = 3
+    };
+    /**
+     * \brief Corner of the cube grid, from 0 to chunkSize on each axis
+     */
+    Vec3b position{};
+    std::uint8_t faceType = NONE;
+    /**
+     * \brief Texture coordinates in cube units, the texture repeats along a merged face
+     */
+    std::uint8_t texCoordU = 0;
+    std::uint8_t texCoordV = 0;
+    CubeTextureId textureId = 0u;
+};
+
+/**
+ * \brief Quads of the visible faces of a chunk, 4 vertices per quad
+ */
+struct ChunkMesh
+{
+    static constexpr size_t quadVerticesNmb = 4;
+    static constexpr size_t quadIndicesNmb = 6;
+    std::vector<ChunkVertex> vertices;
+    [[nodiscard]] size_t GetQuadsNmb() const { return vertices.size() / quadVerticesNmb; }
+};
+
+/**
+ * \brief Greedy mesher of the chunk contents, does not use the graphics API.
+ * Faces between two cubes are removed and coplanar faces sharing a texture are merged.
+ * The chunk neighbours are not known, so the faces on the chunk border are kept.
+ */
+class ChunkMesher
+{
+public:
+    void GenerateMesh(const Chunk& chunk, ChunkMesh& mesh);
+    void GenerateMesh(const ChunkContent& contents, ChunkMesh& mesh);
+private:
+    static constexpr CubeTextureId noFace = std::numeric_limits<CubeTextureId>::max();
+    /**
+     * \brief One bit per cube along the y axis, indexed by x * chunkSize + z
+     */
+    std::array<std::uint32_t, chunkSize * chunkSize> columns_{};
+    /**
+     * \brief Same layout as the columns, one bit per visible face for each face direction
+     */
+    std::array<std::array<std::uint32_t, chunkSize * chunkSize>, 6> visibleFaces_{};
+    std::array<std::uint32_t, 6> slicesWithFaces_{};
+    std::array<CubeTextureId, chunkSize * chunkSize> faceMask_{};
+};
+
+}
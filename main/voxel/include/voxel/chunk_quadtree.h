@@ -0,0 +1,88 @@
+#pragma once
+
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <array>
+#include <vector>
+
+#include "voxel/chunk.h"
+#include "voxel/frustum.h"
+#include "voxel/region.h"
+
+namespace neko::voxel
+{
+
+/**
+ * \brief Quadtree over the chunk columns of a region used to cull the chunks with the camera frustum.
+ * The four children of a node are tested at once, a child fully inside the frustum accepts
+ * all its chunks without testing them.
+ */
+class ChunkQuadtree
+{
+public:
+    /**
+     * \brief Levels of nodes above the columns, the children of the last level are single columns
+     */
+    static constexpr size_t depth = 6;
+    static_assert(size_t(1u) << depth == regionSize, "The quadtree needs to cover the columns of the region");
+
+    /**
+     * \brief Rebuild the tree from the chunks to cull, they need to stay valid until the next build
+     */
+    void Build(const std::vector<const Chunk*>& chunks);
+    /**
+     * \brief Add the chunks intersecting the frustum to visibleChunks
+     */
+    void Cull(const Frustum& frustum, std::vector<const Chunk*>& visibleChunks) const;
+    [[nodiscard]] size_t GetChunksNmb() const { return chunks_.size(); }
+private:
+    struct Node
+    {
+        FourAabb3d childrenBounds;
+        std::uint8_t childrenMask = 0;
+    };
+
+    bool BuildNode(size_t level, size_t nodeIndex, size_t firstX, size_t firstZ, Aabb3d& bounds);
+    [[nodiscard]] bool CalculateColumnBounds(size_t chunkX, size_t chunkZ, Aabb3d& bounds) const;
+    void CullNode(const Frustum& frustum, size_t level, size_t nodeIndex, size_t firstX, size_t firstZ,
+        std::vector<const Chunk*>& visibleChunks) const;
+    void CullColumn(const Frustum& frustum, size_t chunkX, size_t chunkZ,
+        std::vector<const Chunk*>& visibleChunks) const;
+    void AddChunks(size_t firstX, size_t firstZ, size_t columnsSide, std::vector<const Chunk*>& visibleChunks) const;
+
+    /**
+     * \brief Nodes of each level in z-order, the children of node n are the nodes 4n to 4n+3 of the next level
+     */
+    std::array<std::vector<Node>, depth> levels_;
+    /**
+     * \brief Chunks sorted by id, the chunks of a row of columns are contiguous
+     */
+    std::vector<const Chunk*> chunks_;
+    /**
+     * \brief Index of the first chunk of each column in chunks_, with one more entry for the end
+     */
+    std::vector<std::uint32_t> columnsBegin_;
+};
+}
@@ -24,22 +24,64 @@
  SOFTWARE.
  */
 
+#include <array>
+
 #include "graphics/camera.h"
+#include "mathematics/aabb.h"
 #include "voxel/chunk.h"
 #include "voxel/region.h"
 
 namespace neko::voxel
 {
+
+enum class FrustumTest : std::uint8_t
+{
+    OUTSIDE,
+    INTERSECT,
+    INSIDE
+};
+
+/**
+ * \brief Four AABBs stored coordinate by coordinate to be tested against the frustum planes at once
+ */
+struct alignas(16) FourAabb3d
+{
+    void Set(size_t index, const Aabb3d& aabb);
+
+    std::array<float, 4> minX{}, minY{}, minZ{};
+    std::array<float, 4> maxX{}, maxY{}, maxZ{};
+};
+
+/**
+ * \brief Result of the test of four AABBs, one bit per AABB
+ */
+struct FrustumMasks
+{
+    std::uint8_t visible = 0;
+    std::uint8_t inside = 0;
+};
+
 class Frustum
 {
 public:
+    static constexpr size_t planesNmb = 6;
+
     void SetCamera(const neko::Camera3D& camera);
+    /**
+     * \brief The chunk position is the lower corner of Region::GetChunkAabb
+     */
     [[nodiscard]] bool Contains(Vec3f chunk, RegionId regionId) const;
     [[nodiscard]] bool Contains(const Cube& cube, Vec3f chunkPos, RegionId regionId) const;
+    [[nodiscard]] FrustumTest Test(const Aabb3d& aabb) const;
+    /**
+     * \brief Test the four AABBs against each plane with SSE, falls back on the scalar test otherwise
+     */
+    [[nodiscard]] FrustumMasks Test(const FourAabb3d& aabbs) const;
 private:
-    float near_ = 0.0f, far_ = 0.0f;
-    Vec3f dir_, rightDir_, upDir_, position_;
-    Vec3f rightNormal_, leftNormal_, topNormal_, bottomNormal_;
+    void SetPlane(size_t index, const Vec3f& normal, const Vec3f& point);
 
+    //The normals point inside the frustum, a point is in front of a plane when dot(normal, point) + distance >= 0
+    std::array<float, planesNmb> planeNormalX_{}, planeNormalY_{}, planeNormalZ_{};
+    std::array<float, planesNmb> planeDistance_{};
 };
-}
\ No newline at end of file
+}
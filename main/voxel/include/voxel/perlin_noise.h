@@ -0,0 +1,60 @@
+#pragma once
+
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <array>
+#include <cstdint>
+#include <random>
+
+namespace neko::voxel
+{
+
+/**
+ * \brief Octave Perlin noise on the plane evaluated on batches of samples.
+ * Uses the same permutation and arithmetic as siv::PerlinNoise with the same seed,
+ * with AVX2 four samples are evaluated at once in double precision.
+ */
+class BatchPerlinNoise
+{
+public:
+    static constexpr size_t batchSize = 4;
+    explicit BatchPerlinNoise(std::uint32_t seed = std::default_random_engine::default_seed);
+
+    /**
+     * \brief Octave noise normalized between 0 and 1 of samplesNmb points, see siv::PerlinNoise::normalizedOctaveNoise2D_0_1
+     */
+    void NormalizedOctaveNoise2D01(const double* xs, const double* ys, double* results,
+        size_t samplesNmb, std::int32_t octaves) const;
+    [[nodiscard]] double NormalizedOctaveNoise2D01(double x, double y, std::int32_t octaves) const;
+private:
+    void AccumulateOctaveNoise2D(const double* xs, const double* ys, double* results,
+        std::int32_t octaves) const;
+    /**
+     * \brief Permutation table repeated twice, stored as 32-bit to be gathered
+     */
+    alignas(32) std::array<std::int32_t, 512> permutation_{};
+};
+
+}
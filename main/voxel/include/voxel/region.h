@@ -24,8 +24,11 @@
  SOFTWARE.
  */
 
+#include <atomic>
+#include <memory>
 #include <vector>
 
+#include "mathematics/aabb.h"
 #include "mathematics/vector.h"
 #include "voxel/chunk.h"
 
@@ -42,12 +45,30 @@ public:
     void Init();
     [[nodiscard]] const std::vector<Chunk>& GetChunks() const;
     void GenerateFromHeightMap(const HeightMap& map);
-    void SetChunk(const ChunkId uint16, Chunk&& chunk);
+    /**
+     * \brief Store the chunk and publish it, can be called from any thread.
+     * The chunk must not be loaded and no other thread can access it until it is published.
+     */
+    void SetChunk(ChunkId chunkId, Chunk&& chunk);
+    /**
+     * \brief Release the cubes of the chunk, its version changes so that its mesh is not reused.
+     * Only the thread owning the loaded chunks can unload them.
+     */
+    void UnloadChunk(ChunkId chunkId);
+    /**
+     * \brief Returns true once the chunk is published, its content is then visible from the calling thread
+     */
+    [[nodiscard]] bool IsChunkLoaded(ChunkId chunkId) const;
     [[nodiscard]] const Chunk* GetChunk(ChunkId chunkId);
     [[nodiscard]] static Vec2df GetRegionPos(RegionId regionId);
     [[nodiscard]] static ChunkId GetChunkId(size_t chunkX, size_t chunkZ, size_t chunkY);
+    /**
+     * \brief Bounds of the chunk in world space, the region is centered on the origin
+     */
+    [[nodiscard]] static Aabb3d GetChunkAabb(ChunkId chunkId);
 private:
     std::vector<Chunk> chunks_{};
+    std::unique_ptr<std::atomic<bool>[]> loadedChunks_;
     RegionId regionId_ = 0;
 };
 }
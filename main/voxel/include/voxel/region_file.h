@@ -0,0 +1,94 @@
+#pragma once
+
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <string>
+#include <vector>
+
+#include "voxel/chunk.h"
+#include "voxel/region.h"
+
+namespace neko::voxel
+{
+
+/**
+ * \brief Position of a compressed chunk in the region file, a missing chunk has an offset of 0
+ */
+struct RegionFileEntry
+{
+    std::uint32_t offset = 0;
+    std::uint32_t size = 0;
+};
+
+/**
+ * \brief Chunks of a region compressed one by one with zstd behind a table of offsets.
+ * The file is memory mapped when opened, a chunk is only read and decompressed when loaded.
+ * Integers are written in little endian like the memory of the supported platforms.
+ */
+class RegionFile
+{
+public:
+    static constexpr std::uint32_t magicNumber = 0x47524B4Eu; //NKRG
+    static constexpr std::uint32_t formatVersion = 1u;
+    static constexpr size_t chunksNmb = regionHeight * regionSize * regionSize;
+    static constexpr int defaultCompressionLevel = 3;
+
+    RegionFile() = default;
+    ~RegionFile();
+    RegionFile(const RegionFile&) = delete;
+    RegionFile& operator=(const RegionFile&) = delete;
+
+    /**
+     * \brief Write the chunks in a new file, the other chunks of the region are missing from it
+     */
+    static bool Save(const std::string& path, const std::vector<const Chunk*>& chunks,
+        int compressionLevel = defaultCompressionLevel);
+
+    bool Open(const std::string& path);
+    void Close();
+    [[nodiscard]] bool IsOpen() const { return data_ != nullptr; }
+    [[nodiscard]] bool HasChunk(ChunkId chunkId) const;
+    /**
+     * \brief Decompress a chunk of the file, can be called from several threads at once
+     */
+    bool LoadChunk(ChunkId chunkId, Chunk& chunk) const;
+private:
+    struct Header
+    {
+        std::uint32_t magic = magicNumber;
+        std::uint32_t version = formatVersion;
+        std::uint32_t chunksNmb = 0;
+        std::uint32_t reserved = 0;
+    };
+    static constexpr size_t entriesOffset = sizeof(Header);
+    static constexpr size_t chunksDataOffset = entriesOffset + chunksNmb * sizeof(RegionFileEntry);
+
+    [[nodiscard]] RegionFileEntry GetEntry(ChunkId chunkId) const;
+
+    const std::uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+}
@@ -24,39 +24,160 @@
  SOFTWARE.
  */
 
-#include <queue>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "chunk_generator.h"
+#include "chunk_quadtree.h"
 #include "region.h"
+#include "region_file.h"
 #include "engine/jobsystem.h"
+#include "engine/system.h"
 
 namespace neko::voxel
 {
 
-struct ChunkLoadingJob
+/**
+ * \brief Region column generated or decompressed by a worker thread.
+ * The worker publishes the chunks in the region and pushes the column in the completion queue.
+ */
+struct ColumnLoadingJob
 {
-    Job loadingJob;
-    ChunkId chunkId = 0;
-    RegionId regionId = 0;
+    enum class Source : std::uint8_t
+    {
+        GENERATOR,
+        COMPRESSED_CACHE,
+        REGION_FILE
+    };
+    std::unique_ptr<Job> loadingJob;
+    std::vector<std::uint8_t> compressedColumn;
+    std::vector<ChunkId> chunkIds;
+    size_t memoryUsage = 0;
+    size_t columnIndex = 0;
+    Source source = Source::GENERATOR;
+    bool isInstalled = false;
+    ColumnLoadingJob* next = nullptr;
 };
 
+/**
+ * \brief Streams the chunk columns around the camera.
+ * Columns entering the render distance are loaded nearest first on worker threads
+ * and installed as soon as they are done, in any order.
+ * columns leaving it are compressed in a least recently used cache so that coming back does not generate them again.
+ * The loaded chunks and the compressed columns are kept under the memory budget.
+ * With a region file, the columns it contains are read from it and the generator is only used for the others.
+ */
 class VoxelManager : public SystemInterface
 {
 public:
+    static constexpr size_t defaultMemoryBudget = 64u * 1024u * 1024u;
+    explicit VoxelManager(int renderDistance = 10, size_t memoryBudget = defaultMemoryBudget);
+
     void Init() override;
     void Update(seconds dt) override;
     void Destroy() override;
 
+    /**
+     * \brief Load the columns from the region file when it contains them, returns false if it cannot be opened
+     */
+    bool OpenRegionFile(const std::string& path);
+    /**
+     * \brief Write every column loaded, compressed or in the current region file, the saved file is used afterwards
+     */
+    bool SaveRegionFile(const std::string& path);
+
+    /**
+     * \brief World position of the camera, the render distance is counted in chunks around it
+     */
+    void SetCameraPosition(const Vec3f& position);
+
     [[nodiscard]] const std::vector<const Chunk*>& GetChunks() const;
+    /**
+     * \brief Add the visible chunks with cubes intersecting the frustum to visibleChunks
+     */
+    void CullChunks(const Frustum& frustum, std::vector<const Chunk*>& visibleChunks) const;
+    /**
+     * \brief Chunks unloaded during the last update, their meshes can be released
+     */
+    [[nodiscard]] const std::vector<ChunkId>& GetUnloadedChunks() const;
     [[nodiscard]] float GetInitialHeight() const;
+    /**
+     * \brief Memory used by the loaded chunks and the compressed columns in bytes
+     */
+    [[nodiscard]] size_t GetMemoryUsage() const;
+    [[nodiscard]] size_t GetPeakMemoryUsage() const;
+    [[nodiscard]] size_t GetMemoryBudget() const { return memoryBudget_; }
+    [[nodiscard]] size_t GetGeneratedColumnsNmb() const { return generatedColumnsNmb_; }
+    [[nodiscard]] size_t GetDecompressedColumnsNmb() const { return decompressedColumnsNmb_; }
+    [[nodiscard]] size_t GetRegionFileColumnsNmb() const { return regionFileColumnsNmb_; }
+    [[nodiscard]] bool IsLoading() const;
 
 private:
-    const int renderDistance_ = 10;
+    enum class ColumnState : std::uint8_t
+    {
+        UNLOADED,
+        LOADING,
+        LOADED
+    };
+    struct Column
+    {
+        std::vector<ChunkId> chunkIds;
+        size_t memoryUsage = 0;
+        ColumnState state = ColumnState::UNLOADED;
+    };
+    struct CompressedColumn
+    {
+        std::vector<std::uint8_t> data;
+        size_t columnIndex = 0;
+    };
+
+    [[nodiscard]] static size_t GetColumnIndex(size_t chunkX, size_t chunkZ) { return chunkX * regionSize + chunkZ; }
+    [[nodiscard]] int GetColumnDistance(size_t columnIndex) const;
+    [[nodiscard]] int GetColumnSquareDistance(size_t columnIndex) const;
+    void InstallLoadedColumns();
+    void LoadColumn(ColumnLoadingJob& loadingColumn);
+    void UpdatePendingColumns();
+    void UnloadColumn(size_t columnIndex);
+    void TrimCompressedColumns();
+    void ScheduleColumns();
+    static void CompressColumn(const std::vector<const Chunk*>& chunks, std::vector<std::uint8_t>& data);
+    static bool DecompressColumn(const std::vector<std::uint8_t>& data, std::vector<Chunk>& chunks);
+    bool LoadColumnFromRegionFile(size_t columnIndex, std::vector<Chunk>& chunks) const;
+
+    const int renderDistance_;
+    const size_t memoryBudget_;
     float initialHeight_ = 0.0f;
+    Vec2i cameraColumn_{ int(regionSize / 2), int(regionSize / 2) };
+    bool isCameraColumnDirty_ = true;
     ChunkGenerator chunkGenerator_;
+    Region region_;
+    RegionFile regionFile_;
+    std::string regionFilePath_;
+    std::vector<Column> columns_;
+    std::vector<size_t> loadedColumns_;
+    /**
+     * \brief Columns in the render distance waiting to be loaded, the nearest at the back
+     */
+    std::vector<size_t> pendingColumns_;
+    std::vector<std::unique_ptr<ColumnLoadingJob>> loadingColumns_;
+    MpscQueue<ColumnLoadingJob> completedColumns_;
+    /**
+     * \brief Most recently unloaded columns at the front
+     */
+    std::list<CompressedColumn> compressedColumns_;
+    std::unordered_map<size_t, std::list<CompressedColumn>::iterator> compressedColumnsMap_;
+    size_t chunksMemoryUsage_ = 0;
+    size_t compressedMemoryUsage_ = 0;
+    size_t peakMemoryUsage_ = 0;
+    size_t generatedColumnsNmb_ = 0;
+    size_t decompressedColumnsNmb_ = 0;
+    size_t regionFileColumnsNmb_ = 0;
     std::vector<const Chunk*> currentChunks_;
-    std::vector<Region> regions_;
-    std::queue<ChunkLoadingJob> chunkLoadingQueue_;
-    Job initJob{ []() {} };
+    ChunkQuadtree chunkQuadtree_;
+    bool areChunksDirty_ = false;
+    std::vector<ChunkId> unloadedChunks_;
 };
 }
@@ -24,6 +24,10 @@
  SOFTWARE.
  */
 
+#include <limits>
+#include <memory>
+#include <unordered_map>
+
 #include "region.h"
 #include "engine/system.h"
 #include "engine/component.h"
@@ -32,18 +36,41 @@
 
 #include "gl/gles3_include.h"
 #include "gl/shader.h"
+#include "gl/upload_ring_buffer.h"
 #include "graphics/camera.h"
 #include "voxel/frustum.h"
+#include "voxel/chunk_mesher.h"
+#include "engine/jobsystem.h"
 
 namespace neko::voxel
 {
 
-struct CubeRenderData
+struct ChunkRenderData
 {
     RegionId regionId = 0;
     ChunkId chunkId = 0;
-    CubeId cubeId = 0;
-    CubeTextureId textureId = 0;
+    std::uint32_t version = 0;
+    const Chunk* chunk = nullptr;
+};
+
+/**
+ * \brief Mesh of a chunk cached between frames, the meshing job runs on a worker thread
+ */
+struct ChunkMeshEntry
+{
+    static constexpr std::uint32_t INVALID_VERSION = std::numeric_limits<std::uint32_t>::max();
+    std::unique_ptr<Job> meshingJob;
+    /**
+     * \brief Copy of the chunk read by the meshing job, the chunk can be unloaded while it runs
+     */
+    ChunkContent meshingContent;
+    ChunkMesh mesh;
+    std::uint32_t meshingVersion = INVALID_VERSION;
+    std::uint32_t uploadedVersion = INVALID_VERSION;
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    size_t vboCapacity = 0;
+    GLsizei indicesNmb = 0;
 };
 
 class VoxelRenderProgram :
@@ -66,30 +93,60 @@ public:
 
     void Render() override;
 
+    /**
+     * \brief Add a visible chunk to the next frame, its mesh is built or rebuilt if needed.
+     * The chunk must already be culled with the frustum of the current camera.
+     */
     void AddChunk(const Chunk& chunk, RegionId regionId = 0);
-
-    void AddCube(const Cube& cube, ChunkId chunkId = 0, RegionId regionId = 0);
+    /**
+     * \brief Release the mesh of an unloaded chunk once its meshing job is done
+     */
+    void RemoveChunk(ChunkId chunkId, RegionId regionId = 0);
 
     void SyncBuffers() override;
 
     void DrawImGui() override;
 
     void SetCurrentCamera(const Camera3D& camera);
+    [[nodiscard]] const Frustum& GetFrustum() const;
 
 private:
+    [[nodiscard]] static std::uint64_t GetChunkKey(RegionId regionId, ChunkId chunkId);
+    [[nodiscard]] static Vec3f GetChunkPosition(ChunkId chunkId);
+    /**
+     * \brief Copy the mesh to its vertex buffer through the upload ring, returns false when it has to wait for the next frame
+     */
+    bool UploadChunkMesh(ChunkMeshEntry& entry);
+
     Camera3D currentCamera3D_;
     Camera3D camera3D_;
     Frustum frustum_;
-    std::vector<CubeRenderData> currentRenderData_;
-    std::vector<CubeRenderData> renderData_;
-    gl::Shader cubeShader_;
+    std::vector<ChunkRenderData> currentRenderData_;
+    std::vector<ChunkRenderData> renderData_;
+    std::vector<std::uint64_t> currentRemovedChunks_;
+    std::vector<std::uint64_t> removedChunks_;
+    std::unordered_map<std::uint64_t, ChunkMeshEntry> chunkMeshes_;
+    gl::Shader chunkShader_;
+    gl::UniformHandle<Vec3f> chunkPositionUniform_;
     gl::Shader skyboxShader_;
     GLuint tilesheetTexture_ = 0;
     GLuint skyboxTexture_ = 0;
     GLuint cubeVao_ = 0;
-    GLuint instanceVbo_ = 0;
-    size_t instanceChunkSize_ = 32768;
+    GLuint cubeVbo_ = 0;
+    /**
+     * \brief Index buffer shared by all the chunk meshes, grown to the biggest mesh
+     */
+    GLuint quadEbo_ = 0;
+    size_t quadEboCapacity_ = 0;
+    size_t verticesNmb_ = 0;
     static constexpr size_t cubeVerticesNmb = 36;
+    /**
+     * \brief Mesh bytes copied by frame at most, the bigger meshes are uploaded directly
+     */
+    static constexpr size_t uploadSegmentSize = 4u * 1024u * 1024u;
+    gl::UploadRingBuffer uploadRingBuffer_;
+    size_t uploadedBytes_ = 0;
+    size_t peakUploadedBytes_ = 0;
 
 };
 }
\ No newline at end of file
@@ -62,16 +62,12 @@ public:
             {
                 for (size_t y = 0; y < chunkSize; y++)
                 {
-                    const auto textureId = GenerateTextureId(static_cast<CubeType>(neko::RandomRange(
+                    const auto cubeType = static_cast<CubeType>(neko::RandomRange(
                         static_cast<std::uint16_t>(CubeType::GRASS),
-                        static_cast<std::uint16_t>(CubeType::DIRT))));
-                    auto& cube = (*chunk_.contents)[x][z][y];
-                    cube = {
-                        Cube::CalculateCubeId(Vec3b(x,y,z)),
-                        std::uint8_t(Cube::CubeFlag::IS_VISIBLE),
-                        textureId
-                    };
-                    chunk_.visibleCubes.push_back(cube.cubeId);
+                        static_cast<std::uint16_t>(CubeType::DIRT)));
+                    const auto cubeId = Cube::CalculateCubeId(Vec3b(x,y,z));
+                    chunk_.contents->SetCubeType(cubeId, cubeType);
+                    chunk_.visibleCubes.push_back(cubeId);
                 }
             }
         }
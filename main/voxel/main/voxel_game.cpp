@@ -22,6 +22,7 @@
  SOFTWARE.
  */
 
+#include "engine/log.h"
 #include "engine/system.h"
 #include "fs/physfs.h"
 #include "gl/shape.h"
@@ -57,9 +58,22 @@ public:
                     renderProgram_.Init();
                 });
         BasicEngine::GetInstance()->ScheduleJob(&renderInit, neko::JobThreadType::RENDER_THREAD);
+        const auto& config = BasicEngine::GetInstance()->GetConfig();
+        //The data directory is shipped with the game and can be read-only, the region is saved in the user directory
+        char* prefPath = SDL_GetPrefPath("SAE", "NekoVoxel");
+        if (prefPath != nullptr)
+        {
+            regionFilePath_ = std::string(prefPath) + "region0.nkr";
+            SDL_free(prefPath);
+            //The columns missing from the region file are generated when they are streamed in
+            voxelManager_.OpenRegionFile(regionFilePath_);
+        }
+        else
+        {
+            logDebug(std::string("[Error] No writable directory to save the region: ") + SDL_GetError());
+        }
         voxelManager_.Init();
 
-        const auto& config = BasicEngine::GetInstance()->GetConfig();
         camera3D_.position = Vec3f(0, voxelManager_.GetInitialHeight() + 2.0f, 0);
         camera3D_.WorldLookAt(camera3D_.position + Vec3f::forward + Vec3f::right);
         camera3D_.farPlane = 5000.0f;
@@ -77,17 +91,22 @@ public:
 #ifdef EASY_PROFILE_USE
         EASY_BLOCK("Update Region Manager");
 #endif
-        voxelManager_.Update(dt);
         camera3D_.Update(dt);
+        voxelManager_.SetCameraPosition(camera3D_.position);
+        voxelManager_.Update(dt);
         renderProgram_.SetCurrentCamera(camera3D_);
+        for (const auto chunkId : voxelManager_.GetUnloadedChunks())
+        {
+            renderProgram_.RemoveChunk(chunkId);
+        }
 #ifdef EASY_PROFILE_USE
         EASY_BLOCK("Push Chunks To Renderer");
 #endif
-        for(const auto* chunk : voxelManager_.GetChunks())
+        visibleChunks_.clear();
+        voxelManager_.CullChunks(renderProgram_.GetFrustum(), visibleChunks_);
+        for(const auto* chunk : visibleChunks_)
         {
-            if(chunk->flag & Chunk::IS_VISIBLE)
-                renderProgram_.AddChunk(*chunk);
-
+            renderProgram_.AddChunk(*chunk);
         }
 #ifdef EASY_PROFILE_USE
         EASY_END_BLOCK;
@@ -97,6 +116,11 @@ public:
 
     void Destroy() override
     {
+        if (!regionFilePath_.empty())
+        {
+            voxelManager_.SaveRegionFile(regionFilePath_);
+        }
+        voxelManager_.Destroy();
         Job renderDestroy(
                 [this]()
                 {
@@ -119,6 +143,8 @@ private:
     VoxelRenderProgram renderProgram_;
     sdl::Camera3D camera3D_;
     VoxelManager voxelManager_;
+    std::vector<const Chunk*> visibleChunks_;
+    std::string regionFilePath_;
 };
 
 
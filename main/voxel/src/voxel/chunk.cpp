@@ -24,6 +24,11 @@
 
 #include "voxel/chunk.h"
 
+#include <algorithm>
+#include <cstring>
+
+#include "engine/assert.h"
+
 namespace neko::voxel
 {
 CubeTextureId GenerateTextureId(CubeType cubeType)
@@ -59,4 +64,195 @@ CubeId Cube::CalculateCubeId(Vec3b cubePosition)
 {
     return (cubePosition.x << 10u) + (cubePosition.z << 5u) + cubePosition.y;
 }
+
+ChunkContent::ChunkContent(CubeType cubeType) : palette_{cubeType}
+{
+}
+
+void ChunkContent::SetCubeType(CubeId cubeId, CubeType cubeType)
+{
+    neko_assert(cubeId < cubesNmb, "Cube id outside of the chunk");
+    auto paletteIndex = static_cast<size_t>(
+        std::distance(palette_.cbegin(), std::find(palette_.cbegin(), palette_.cend(), cubeType)));
+    if (paletteIndex == palette_.size())
+    {
+        palette_.push_back(cubeType);
+        if (palette_.size() > (size_t(1) << bitsPerIndex_))
+        {
+            Repack(bitsPerIndex_ == 0 ? 1 : bitsPerIndex_ * 2);
+        }
+    }
+    if (bitsPerIndex_ == 0)
+    {
+        return;
+    }
+    const auto bitIndex = size_t(cubeId) * bitsPerIndex_;
+    const auto shift = bitIndex % indexWordBits;
+    auto& word = indices_[bitIndex / indexWordBits];
+    word = (word & ~(indexMask_ << shift)) | (IndexWord(paletteIndex) << shift);
+}
+
+void ChunkContent::Fill(CubeType cubeType)
+{
+    palette_.clear();
+    palette_.push_back(cubeType);
+    indices_.clear();
+    indices_.shrink_to_fit();
+    bitsPerIndex_ = 0;
+    indexMask_ = 0u;
+}
+
+size_t ChunkContent::GetMemoryUsage() const
+{
+    return sizeof(ChunkContent) +
+           palette_.capacity() * sizeof(CubeType) +
+           indices_.capacity() * sizeof(IndexWord);
+}
+
+void ChunkContent::Compress(std::vector<std::uint8_t>& blob) const
+{
+    blob.push_back(bitsPerIndex_);
+    blob.push_back(static_cast<std::uint8_t>(palette_.size()));
+    for (const auto cubeType : palette_)
+    {
+        blob.push_back(static_cast<std::uint8_t>(cubeType));
+    }
+    //Air above the terrain gives long runs of identical index words. A run header is 15 bits of length
+    //with the high bit set for a run of different words written one after the other.
+    const auto writeHeader = [&blob](std::uint16_t header)
+    {
+        blob.push_back(static_cast<std::uint8_t>(header & 0xFFu));
+        blob.push_back(static_cast<std::uint8_t>(header >> 8u));
+    };
+    const auto writeWords = [&blob](const IndexWord* words, size_t wordsNmb)
+    {
+        const auto wordPos = blob.size();
+        blob.resize(wordPos + wordsNmb * sizeof(IndexWord));
+        std::memcpy(&blob[wordPos], words, wordsNmb * sizeof(IndexWord));
+    };
+    size_t wordIndex = 0;
+    while (wordIndex < indices_.size())
+    {
+        size_t runLength = 1;
+        while (wordIndex + runLength < indices_.size() && indices_[wordIndex + runLength] == indices_[wordIndex])
+        {
+            runLength++;
+        }
+        if (runLength > 1)
+        {
+            writeHeader(static_cast<std::uint16_t>(runLength));
+            writeWords(&indices_[wordIndex], 1);
+            wordIndex += runLength;
+            continue;
+        }
+        size_t literalLength = 1;
+        while (wordIndex + literalLength < indices_.size() &&
+               (wordIndex + literalLength + 1 == indices_.size() ||
+                indices_[wordIndex + literalLength] != indices_[wordIndex + literalLength + 1]))
+        {
+            literalLength++;
+        }
+        writeHeader(static_cast<std::uint16_t>(literalRunBit | literalLength));
+        writeWords(&indices_[wordIndex], literalLength);
+        wordIndex += literalLength;
+    }
+}
+
+bool ChunkContent::Decompress(const std::uint8_t* blob, size_t blobSize)
+{
+    if (blobSize < 2)
+    {
+        return false;
+    }
+    const std::uint8_t bitsPerIndex = blob[0];
+    const size_t paletteSize = blob[1];
+    if ((bitsPerIndex != 0 && indexWordBits % bitsPerIndex != 0) || bitsPerIndex > 8 ||
+        paletteSize == 0 || paletteSize > (size_t(1) << bitsPerIndex) || blobSize < 2 + paletteSize)
+    {
+        return false;
+    }
+    std::vector<CubeType> palette(paletteSize);
+    for (size_t i = 0; i < paletteSize; i++)
+    {
+        palette[i] = static_cast<CubeType>(blob[2 + i]);
+    }
+    const size_t wordsNmb = cubesNmb * bitsPerIndex / indexWordBits;
+    std::vector<IndexWord> indices(wordsNmb);
+    size_t blobIndex = 2 + paletteSize;
+    size_t wordIndex = 0;
+    while (wordIndex < wordsNmb)
+    {
+        if (blobIndex + 2 > blobSize)
+        {
+            return false;
+        }
+        const size_t header = blob[blobIndex] | (size_t(blob[blobIndex + 1]) << 8u);
+        const bool isLiteralRun = (header & literalRunBit) != 0;
+        const size_t runLength = header & ~size_t(literalRunBit);
+        const size_t runSize = (isLiteralRun ? runLength : 1) * sizeof(IndexWord);
+        blobIndex += 2;
+        if (runLength == 0 || wordIndex + runLength > wordsNmb || blobIndex + runSize > blobSize)
+        {
+            return false;
+        }
+        if (isLiteralRun)
+        {
+            std::memcpy(&indices[wordIndex], &blob[blobIndex], runSize);
+        }
+        else
+        {
+            IndexWord word;
+            std::memcpy(&word, &blob[blobIndex], sizeof(IndexWord));
+            std::fill_n(indices.begin() + wordIndex, runLength, word);
+        }
+        blobIndex += runSize;
+        wordIndex += runLength;
+    }
+    if (blobIndex != blobSize)
+    {
+        return false;
+    }
+    //With an incomplete palette, an index could point after its end
+    if (paletteSize < (size_t(1) << bitsPerIndex))
+    {
+        const IndexWord indexMask = (IndexWord(1) << bitsPerIndex) - 1u;
+        for (const auto word : indices)
+        {
+            for (size_t shift = 0; shift < indexWordBits; shift += bitsPerIndex)
+            {
+                if (((word >> shift) & indexMask) >= paletteSize)
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    palette_ = std::move(palette);
+    indices_ = std::move(indices);
+    bitsPerIndex_ = bitsPerIndex;
+    indexMask_ = bitsPerIndex == 0 ? 0u : (IndexWord(1) << bitsPerIndex) - 1u;
+    return true;
+}
+
+void ChunkContent::Repack(std::uint8_t bitsPerIndex)
+{
+    //Indices never straddle two words as the bits per index divide the word size
+    neko_assert(indexWordBits % bitsPerIndex == 0, "Bits per index must divide the index word size");
+    std::vector<IndexWord> indices(cubesNmb * bitsPerIndex / indexWordBits, 0u);
+    const IndexWord indexMask = (IndexWord(1) << bitsPerIndex) - 1u;
+    if (bitsPerIndex_ != 0)
+    {
+        for (size_t cubeIndex = 0; cubeIndex < cubesNmb; cubeIndex++)
+        {
+            const auto oldBitIndex = cubeIndex * bitsPerIndex_;
+            const auto paletteIndex =
+                (indices_[oldBitIndex / indexWordBits] >> (oldBitIndex % indexWordBits)) & indexMask_;
+            const auto bitIndex = cubeIndex * bitsPerIndex;
+            indices[bitIndex / indexWordBits] |= paletteIndex << (bitIndex % indexWordBits);
+        }
+    }
+    indices_ = std::move(indices);
+    indexMask_ = indexMask;
+    bitsPerIndex_ = bitsPerIndex;
+}
 }
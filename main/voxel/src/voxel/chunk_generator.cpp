@@ -24,6 +24,8 @@
 
 #include "voxel/chunk_generator.h"
 
+#include <algorithm>
+#include <cmath>
 
 #include "engine/assert.h"
 #include "mathematics/basic.h"
@@ -36,73 +38,68 @@
 namespace neko::voxel
 {
 
-
-
 Chunk ChunkGenerator::GenerateChunk(RegionId regionId, ChunkId chunkId) const
 {
-    Chunk newChunk;
-    newChunk.chunkId = chunkId;
     const auto chunkX = chunkId / regionHeight / regionSize;
     const auto chunkZ = (chunkId - chunkX * regionHeight * regionSize) / regionHeight;
     const auto chunkY = chunkId % regionHeight;
+    return GenerateChunk(GetColumnHeights(regionId, chunkX, chunkZ), chunkX, chunkZ, chunkY);
+}
 
-    const Vec2df regionOriginPos = Region::GetRegionPos(regionId);
-    for (size_t x = chunkX * chunkSize; x < (chunkX + 1) * chunkSize; x++)
+void ChunkGenerator::GenerateColumn(RegionId regionId, size_t chunkX, size_t chunkZ, std::vector<Chunk>& chunks) const
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Generate Column");
+#endif
+    ColumnHeights heights{};
+    CalculateColumnHeights(regionId, chunkX, chunkZ, heights);
+    const auto [minHeightIt, maxHeightIt] = std::minmax_element(heights.cbegin(), heights.cend());
+    const size_t maxChunkY = std::min<size_t>(*maxHeightIt / chunkSize, regionHeight - 1);
+    for (size_t chunkY = *minHeightIt / chunkSize; chunkY <= maxChunkY; chunkY++)
+    {
+        chunks.push_back(GenerateChunk(heights, chunkX, chunkZ, chunkY));
+    }
+}
+
+Chunk ChunkGenerator::GenerateChunk(const ColumnHeights& heights, size_t chunkX, size_t chunkZ, size_t chunkY)
+{
+    Chunk newChunk;
+    newChunk.chunkId = Region::GetChunkId(chunkX, chunkZ, chunkY);
+    for (size_t cubeX = 0; cubeX < chunkSize; cubeX++)
     {
-        for (size_t z = chunkZ * chunkSize; z < (chunkZ + 1) * chunkSize; z++)
+        for (size_t cubeZ = 0; cubeZ < chunkSize; cubeZ++)
         {
-            const double voxelX =
-                (static_cast<double>(x) - regionWidthFloat / 2.0 + regionOriginPos.x)
-                / regionWidthFloat * scale;
-            const double voxelZ =
-                (static_cast<double>(z) - regionWidthFloat / 2.0 + regionOriginPos.y)
-                / regionWidthFloat * scale;
-            const auto height = pow(
-                perlinNoise_.normalizedOctaveNoise2D_0_1(voxelX, voxelZ, octave),
-                elevetionPow);
-            const auto y = static_cast<size_t>(maxHeight * height);
+            const size_t y = heights[cubeX * chunkSize + cubeZ];
             if (y < chunkY * chunkSize || y >= (chunkY + 1) * chunkSize)
                 continue;
             if (newChunk.contents == nullptr)
             {
                 newChunk.contents = std::make_unique<ChunkContent>();
             }
-            const auto cubeX = x - chunkX * chunkSize;
             const auto cubeY = y - chunkY * chunkSize;
-            const auto cubeZ = z - chunkZ * chunkSize;
 
-            auto& cube = (*newChunk.contents)[cubeX][cubeZ][cubeY];
-            cube.flag = cube.flag | Cube::IS_VISIBLE;
-            cube.cubeTextureId = GenerateTextureId(CubeType::GRASS);
-            cube.cubeId = Cube::CalculateCubeId(Vec3b(cubeX, cubeY, cubeZ));
-            newChunk.visibleCubes.push_back(cube.cubeId);
+            const auto cubeId = Cube::CalculateCubeId(Vec3b(cubeX, cubeY, cubeZ));
+            newChunk.contents->SetCubeType(cubeId, CubeType::GRASS);
+            newChunk.visibleCubes.push_back(cubeId);
 
+            //Only the neighbours inside the chunk are compared, the first column of the region has none
+            if (chunkX * chunkSize + cubeX == 0 || chunkZ * chunkSize + cubeZ == 0)
+                continue;
             int maxDiff = 0;
             for (int dx = -1; dx <= 1; dx++)
             {
-                if (x == 0 || x >= (chunkX + 1) * chunkSize)
-                    continue;
-                if (!(x - dx >= chunkX * chunkSize && x - dx < (chunkX + 1) * chunkSize))
+                const auto otherCubeX = cubeX - dx;
+                if (otherCubeX >= chunkSize)
                     continue;
                 for (int dz = -1; dz <= 1; dz++)
                 {
-                    if (z == 0 || z >= (chunkZ + 1) * chunkSize)
-                        continue;
-                    if (!(z - dz >= chunkZ * chunkSize && z - dz < (chunkZ + 1) * chunkSize))
+                    const auto otherCubeZ = cubeZ - dz;
+                    if (otherCubeZ >= chunkSize)
                         continue;
                     if (dx == 0 && dz == 0)
                         continue;
-                    const double otherVoxelX =
-                        (static_cast<double>(x - dx) - regionWidthFloat / 2.0 + regionOriginPos.x)
-                        / regionWidthFloat * scale;
-                    const double otherVoxelZ =
-                        (static_cast<double>(z - dz) - regionWidthFloat / 2.0 + regionOriginPos.y)
-                        / regionWidthFloat * scale;
-                    const auto otherHeight = pow(
-                        perlinNoise_.normalizedOctaveNoise2D_0_1(otherVoxelX, otherVoxelZ, octave),
-                        elevetionPow);
-                    const auto otherY = static_cast<size_t>(maxHeight * otherHeight);
-                    const int diff = y - otherY;
+                    const size_t otherY = heights[otherCubeX * chunkSize + otherCubeZ];
+                    const int diff = static_cast<int>(y) - static_cast<int>(otherY);
                     if (maxDiff < diff)
                     {
                         for (int dy = maxDiff; dy < diff; dy++)
@@ -112,25 +109,17 @@ Chunk ChunkGenerator::GenerateChunk(RegionId regionId, ChunkId chunkId) const
                             if (y - dy < chunkY * chunkSize || y - dy >= (chunkY + 1) * chunkSize)
                                 continue;
                             //generate below cubes
-                            const auto otherCubeX = x - chunkX * chunkSize;
-                            const auto otherCubeY = y - dy - chunkY * chunkSize;
-                            const auto otherCubeZ = z - chunkZ * chunkSize;
-                            neko_assert(otherCubeX < chunkSize, "Valid cube X");
-                            neko_assert(otherCubeZ < chunkSize, "Valid cube Z");
-                            neko_assert(otherCubeY < chunkSize, "Valid cube Y");
-                            
-                            auto& otherCube = (*newChunk.contents)[otherCubeX][otherCubeZ][otherCubeY];
-                            otherCube.flag = otherCube.flag | Cube::IS_VISIBLE;
-                            otherCube.cubeTextureId = GenerateTextureId(CubeType::ROCK);
-                            otherCube.cubeId = Cube::CalculateCubeId(Vec3b(otherCubeX, otherCubeY, otherCubeZ));
-                            newChunk.visibleCubes.push_back(otherCube.cubeId);
-                            
+                            const auto belowCubeY = y - dy - chunkY * chunkSize;
+                            neko_assert(belowCubeY < chunkSize, "Valid cube Y");
+
+                            const auto belowCubeId = Cube::CalculateCubeId(Vec3b(cubeX, belowCubeY, cubeZ));
+                            newChunk.contents->SetCubeType(belowCubeId, CubeType::ROCK);
+                            newChunk.visibleCubes.push_back(belowCubeId);
                         }
                         maxDiff = diff;
                     }
                 }
             }
-
         }
     }
     return newChunk;
@@ -142,26 +131,22 @@ Region ChunkGenerator::GenerateRegion(RegionId regionId) const
     EASY_BLOCK("Generate Region");
     EASY_BLOCK("Generate Height Map");
 #endif
-
-    const Vec2df regionOriginPos = Region::GetRegionPos(regionId);
     HeightMap heightMap{ regionWidth, {{}} };
-    for (int x = 0; x < regionWidth; x++)
+    ColumnHeights heights{};
+    //The whole region is generated at once, the columns do not go through the cache
+    for (size_t chunkX = 0; chunkX < regionSize; chunkX++)
     {
-        for (int z = 0; z < regionWidth; z++)
+        for (size_t chunkZ = 0; chunkZ < regionSize; chunkZ++)
         {
-            const double voxelX =
-                (static_cast<double>(x) - regionWidthFloat / 2.0 + regionOriginPos.x)
-                / regionWidthFloat * scale;
-            const double voxelZ =
-                (static_cast<double>(z) - regionWidthFloat / 2.0 + regionOriginPos.y)
-                / regionWidthFloat * scale;
-
-
-            const auto height = pow(
-                perlinNoise_.normalizedOctaveNoise2D_0_1(voxelX, voxelZ, octave),
-                elevetionPow);
-            heightMap[x][z] = static_cast<size_t>(maxHeight * height);
-
+            CalculateColumnHeights(regionId, chunkX, chunkZ, heights);
+            for (size_t cubeX = 0; cubeX < chunkSize; cubeX++)
+            {
+                for (size_t cubeZ = 0; cubeZ < chunkSize; cubeZ++)
+                {
+                    heightMap[chunkX * chunkSize + cubeX][chunkZ * chunkSize + cubeZ] =
+                        heights[cubeX * chunkSize + cubeZ];
+                }
+            }
         }
     }
 #ifdef EASY_PROFILE_USE
@@ -176,16 +161,62 @@ Region ChunkGenerator::GenerateRegion(RegionId regionId) const
 
 size_t ChunkGenerator::GetHeight(RegionId regionId, Vec2u cubePos) const
 {
+    const auto& heights = GetColumnHeights(regionId, cubePos.x / chunkSize, cubePos.y / chunkSize);
+    return heights[(cubePos.x % chunkSize) * chunkSize + cubePos.y % chunkSize];
+}
+
+const ColumnHeights& ChunkGenerator::GetColumnHeights(RegionId regionId, size_t chunkX, size_t chunkZ) const
+{
+    const std::uint64_t key = (std::uint64_t(regionId) << 32u) | (std::uint64_t(chunkX) << 16u) | chunkZ;
+    {
+        std::lock_guard<std::mutex> lock(heightsCacheMutex_);
+        const auto it = heightsCache_.find(key);
+        if (it != heightsCache_.end())
+        {
+            return *it->second;
+        }
+    }
+    //Computed outside the lock, if two threads compute the same column the first one inserted is kept
+    auto heights = std::make_unique<ColumnHeights>();
+    CalculateColumnHeights(regionId, chunkX, chunkZ, *heights);
+    std::lock_guard<std::mutex> lock(heightsCacheMutex_);
+    const auto result = heightsCache_.emplace(key, std::move(heights));
+    return *result.first->second;
+}
+
+void ChunkGenerator::CalculateColumnHeights(RegionId regionId, size_t chunkX, size_t chunkZ,
+    ColumnHeights& heights) const
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Calculate Column Heights");
+#endif
     const Vec2df regionOriginPos = Region::GetRegionPos(regionId);
-    const double voxelX =
-        (static_cast<double>(cubePos.x) - regionWidthFloat / 2.0 + regionOriginPos.x)
-        / regionWidthFloat * scale;
-    const double voxelZ =
-        (static_cast<double>(cubePos.y) - regionWidthFloat / 2.0 + regionOriginPos.y)
-        / regionWidthFloat * scale;
-    const auto height = pow(
-        perlinNoise_.normalizedOctaveNoise2D_0_1(voxelX, voxelZ, octave),
-        elevetionPow);
-    return static_cast<size_t>(maxHeight * height);
+    std::array<double, chunkSize * chunkSize> voxelXs{};
+    std::array<double, chunkSize * chunkSize> voxelZs{};
+    std::array<double, chunkSize * chunkSize> noises{};
+    for (size_t cubeX = 0; cubeX < chunkSize; cubeX++)
+    {
+        const double voxelX =
+            (static_cast<double>(chunkX * chunkSize + cubeX) - regionWidthFloat / 2.0 + regionOriginPos.x)
+            / regionWidthFloat * scale;
+        for (size_t cubeZ = 0; cubeZ < chunkSize; cubeZ++)
+        {
+            voxelXs[cubeX * chunkSize + cubeZ] = voxelX;
+            voxelZs[cubeX * chunkSize + cubeZ] =
+                (static_cast<double>(chunkZ * chunkSize + cubeZ) - regionWidthFloat / 2.0 + regionOriginPos.y)
+                / regionWidthFloat * scale;
+        }
+    }
+    perlinNoise_.NormalizedOctaveNoise2D01(voxelXs.data(), voxelZs.data(), noises.data(), noises.size(), octave);
+    for (size_t i = 0; i < noises.size(); i++)
+    {
+        heights[i] = static_cast<std::uint16_t>(maxHeight * std::pow(noises[i], elevetionPow));
+    }
+}
+
+void ChunkGenerator::ClearHeightsCache()
+{
+    std::lock_guard<std::mutex> lock(heightsCacheMutex_);
+    heightsCache_.clear();
 }
 }
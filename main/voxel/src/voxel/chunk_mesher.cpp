@@ -0,0 +1,232 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include "voxel/chunk_mesher.h"
+
+#ifdef EASY_PROFILE_USE
+#include <easy/profiler.h>
+#endif
+
+namespace neko::voxel
+{
+
+namespace
+{
+static_assert(chunkSize == 32, "Chunk columns are stored as 32-bit masks");
+constexpr int chunkSizeInt = static_cast<int>(chunkSize);
+
+struct FaceDirection
+{
+    int axis = 0;
+    bool isPositive = true;
+    //u cross v gives the face normal, so the quads are counter-clockwise from outside
+    int uAxis = 0;
+    int vAxis = 0;
+    ChunkVertex::FaceType faceType = ChunkVertex::NONE;
+    int texCoordUAxis = 0;
+    int texCoordVAxis = 0;
+};
+
+//Axis 0 is x, 1 is y and 2 is z
+constexpr std::array<FaceDirection, 6> faceDirections =
+{{
+    {0, true, 1, 2, ChunkVertex::SIDE, 2, 1},
+    {0, false, 2, 1, ChunkVertex::SIDE, 2, 1},
+    {1, true, 2, 0, ChunkVertex::TOP, 0, 2},
+    {1, false, 0, 2, ChunkVertex::BOTTOM, 0, 2},
+    {2, true, 0, 1, ChunkVertex::SIDE, 0, 1},
+    {2, false, 1, 0, ChunkVertex::SIDE, 0, 1},
+}};
+}
+
+void ChunkMesher::GenerateMesh(const Chunk& chunk, ChunkMesh& mesh)
+{
+    if (chunk.contents == nullptr)
+    {
+        mesh.vertices.clear();
+        return;
+    }
+    GenerateMesh(*chunk.contents, mesh);
+}
+
+void ChunkMesher::GenerateMesh(const ChunkContent& contents, ChunkMesh& mesh)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Generate Chunk Mesh");
+#endif
+    mesh.vertices.clear();
+    if (contents.IsUniform() && contents.GetCubeType(CubeId(0)) == CubeType::NONE)
+    {
+        return;
+    }
+    //Cube ids are ordered by x, z and then y
+    for (size_t column = 0; column < columns_.size(); column++)
+    {
+        std::uint32_t cubes = 0u;
+        for (size_t y = 0; y < chunkSize; y++)
+        {
+            if (contents.GetCubeType(CubeId(column * chunkSize + y)) != CubeType::NONE)
+            {
+                cubes |= 1u << y;
+            }
+        }
+        columns_[column] = cubes;
+    }
+    //Hidden face removal, a face is only visible if its neighbour cube is empty
+    const auto getColumn = [this](int x, int z)
+    {
+        if (x < 0 || x >= chunkSizeInt || z < 0 || z >= chunkSizeInt)
+        {
+            return 0u;
+        }
+        return columns_[x * chunkSizeInt + z];
+    };
+    for (size_t directionIndex = 0; directionIndex < faceDirections.size(); directionIndex++)
+    {
+        const auto& direction = faceDirections[directionIndex];
+        const int offset = direction.isPositive ? 1 : -1;
+        std::uint32_t slicesWithFaces = 0u;
+        for (int x = 0; x < chunkSizeInt; x++)
+        {
+            for (int z = 0; z < chunkSizeInt; z++)
+            {
+                const auto column = columns_[x * chunkSizeInt + z];
+                std::uint32_t neighbourColumn = 0u;
+                switch (direction.axis)
+                {
+                case 0:
+                    neighbourColumn = getColumn(x + offset, z);
+                    break;
+                case 1:
+                    neighbourColumn = direction.isPositive ? column >> 1u : column << 1u;
+                    break;
+                default:
+                    neighbourColumn = getColumn(x, z + offset);
+                    break;
+                }
+                const auto faces = column & ~neighbourColumn;
+                visibleFaces_[directionIndex][x * chunkSizeInt + z] = faces;
+                if (faces != 0u)
+                {
+                    slicesWithFaces |= direction.axis == 0 ? 1u << x : direction.axis == 1 ? faces : 1u << z;
+                }
+            }
+        }
+        slicesWithFaces_[directionIndex] = slicesWithFaces;
+    }
+
+    //The columns are indexed by x * chunkSize + z
+    constexpr std::array<int, 3> columnStrides = {chunkSizeInt, 0, 1};
+    constexpr std::array<int, 3> yStrides = {0, 1, 0};
+    for (size_t directionIndex = 0; directionIndex < faceDirections.size(); directionIndex++)
+    {
+        const auto& direction = faceDirections[directionIndex];
+        const auto& visibleFaces = visibleFaces_[directionIndex];
+        for (int slice = 0; slice < chunkSizeInt; slice++)
+        {
+            if (((slicesWithFaces_[directionIndex] >> slice) & 1u) == 0u)
+            {
+                continue;
+            }
+            for (int v = 0; v < chunkSizeInt; v++)
+            {
+                for (int u = 0; u < chunkSizeInt; u++)
+                {
+                    const int columnIndex = slice * columnStrides[direction.axis] +
+                        u * columnStrides[direction.uAxis] + v * columnStrides[direction.vAxis];
+                    const int y = slice * yStrides[direction.axis] +
+                        u * yStrides[direction.uAxis] + v * yStrides[direction.vAxis];
+                    faceMask_[v * chunkSizeInt + u] = ((visibleFaces[columnIndex] >> y) & 1u) != 0u ?
+                        GenerateTextureId(contents.GetCubeType(CubeId(columnIndex * chunkSizeInt + y))) : noFace;
+                }
+            }
+            //Greedy merge, grow each face along u first and then along v
+            for (int v = 0; v < chunkSizeInt; v++)
+            {
+                for (int u = 0; u < chunkSizeInt; u++)
+                {
+                    const auto textureId = faceMask_[v * chunkSizeInt + u];
+                    if (textureId == noFace)
+                    {
+                        continue;
+                    }
+                    int width = 1;
+                    while (u + width < chunkSizeInt && faceMask_[v * chunkSizeInt + u + width] == textureId)
+                    {
+                        width++;
+                    }
+                    int height = 1;
+                    for (; v + height < chunkSizeInt; height++)
+                    {
+                        bool isSameRow = true;
+                        for (int du = 0; du < width; du++)
+                        {
+                            if (faceMask_[(v + height) * chunkSizeInt + u + du] != textureId)
+                            {
+                                isSameRow = false;
+                                break;
+                            }
+                        }
+                        if (!isSameRow)
+                        {
+                            break;
+                        }
+                    }
+                    for (int dv = 0; dv < height; dv++)
+                    {
+                        for (int du = 0; du < width; du++)
+                        {
+                            faceMask_[(v + dv) * chunkSizeInt + u + du] = noFace;
+                        }
+                    }
+
+                    const std::array<std::array<int, 2>, ChunkMesh::quadVerticesNmb> quadCorners =
+                    {{
+                        {0, 0}, {width, 0}, {width, height}, {0, height}
+                    }};
+                    for (const auto& quadCorner : quadCorners)
+                    {
+                        std::array<int, 3> corner{};
+                        corner[direction.axis] = slice + (direction.isPositive ? 1 : 0);
+                        corner[direction.uAxis] = u + quadCorner[0];
+                        corner[direction.vAxis] = v + quadCorner[1];
+                        ChunkVertex vertex;
+                        vertex.position = Vec3b(corner[0], corner[1], corner[2]);
+                        vertex.faceType = direction.faceType;
+                        vertex.texCoordU = static_cast<std::uint8_t>(
+                            direction.texCoordUAxis == direction.uAxis ? quadCorner[0] : quadCorner[1]);
+                        vertex.texCoordV = static_cast<std::uint8_t>(
+                            direction.texCoordVAxis == direction.uAxis ? quadCorner[0] : quadCorner[1]);
+                        vertex.textureId = textureId;
+                        mesh.vertices.push_back(vertex);
+                    }
+                    u += width - 1;
+                }
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,192 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "voxel/chunk_quadtree.h"
+
+#include <algorithm>
+
+#ifdef EASY_PROFILE_USE
+#include <easy/profiler.h>
+#endif
+
+namespace neko::voxel
+{
+
+void ChunkQuadtree::Build(const std::vector<const Chunk*>& chunks)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Build Chunk Quadtree");
+#endif
+    chunks_ = chunks;
+    std::sort(chunks_.begin(), chunks_.end(), [](const Chunk* chunk, const Chunk* otherChunk)
+    {
+        return chunk->chunkId < otherChunk->chunkId;
+    });
+    columnsBegin_.assign(regionSize * regionSize + 1, 0u);
+    for (const auto* chunk : chunks_)
+    {
+        columnsBegin_[chunk->chunkId / regionHeight + 1]++;
+    }
+    for (size_t i = 1; i < columnsBegin_.size(); i++)
+    {
+        columnsBegin_[i] += columnsBegin_[i - 1];
+    }
+    for (size_t level = 0; level < depth; level++)
+    {
+        levels_[level].assign(size_t(1u) << (2u * level), Node());
+    }
+    Aabb3d bounds;
+    BuildNode(0, 0, 0, 0, bounds);
+}
+
+void ChunkQuadtree::Cull(const Frustum& frustum, std::vector<const Chunk*>& visibleChunks) const
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Cull Chunk Quadtree");
+#endif
+    if (chunks_.empty())
+    {
+        return;
+    }
+    CullNode(frustum, 0, 0, 0, 0, visibleChunks);
+}
+
+bool ChunkQuadtree::BuildNode(size_t level, size_t nodeIndex, size_t firstX, size_t firstZ, Aabb3d& bounds)
+{
+    auto& node = levels_[level][nodeIndex];
+    const size_t childSide = regionSize >> (level + 1);
+    bool isEmpty = true;
+    for (size_t child = 0; child < 4; child++)
+    {
+        const auto childX = firstX + (child & 1u) * childSide;
+        const auto childZ = firstZ + (child >> 1u) * childSide;
+        Aabb3d childBounds;
+        const bool hasChunks = level + 1 == depth ?
+            CalculateColumnBounds(childX, childZ, childBounds) :
+            BuildNode(level + 1, 4 * nodeIndex + child, childX, childZ, childBounds);
+        if (!hasChunks)
+        {
+            continue;
+        }
+        node.childrenMask |= std::uint8_t(1u << child);
+        node.childrenBounds.Set(child, childBounds);
+        if (isEmpty)
+        {
+            bounds = childBounds;
+            isEmpty = false;
+            continue;
+        }
+        bounds.lowerLeftBound = Vec3f(
+            std::min(bounds.lowerLeftBound.x, childBounds.lowerLeftBound.x),
+            std::min(bounds.lowerLeftBound.y, childBounds.lowerLeftBound.y),
+            std::min(bounds.lowerLeftBound.z, childBounds.lowerLeftBound.z));
+        bounds.upperRightBound = Vec3f(
+            std::max(bounds.upperRightBound.x, childBounds.upperRightBound.x),
+            std::max(bounds.upperRightBound.y, childBounds.upperRightBound.y),
+            std::max(bounds.upperRightBound.z, childBounds.upperRightBound.z));
+    }
+    return !isEmpty;
+}
+
+bool ChunkQuadtree::CalculateColumnBounds(size_t chunkX, size_t chunkZ, Aabb3d& bounds) const
+{
+    const auto columnIndex = chunkX * regionSize + chunkZ;
+    const auto begin = columnsBegin_[columnIndex];
+    const auto end = columnsBegin_[columnIndex + 1];
+    if (begin == end)
+    {
+        return false;
+    }
+    //The chunks of the column are sorted from the bottom to the top
+    bounds.lowerLeftBound = Region::GetChunkAabb(chunks_[begin]->chunkId).lowerLeftBound;
+    bounds.upperRightBound = Region::GetChunkAabb(chunks_[end - 1]->chunkId).upperRightBound;
+    return true;
+}
+
+void ChunkQuadtree::CullNode(const Frustum& frustum, size_t level, size_t nodeIndex, size_t firstX, size_t firstZ,
+    std::vector<const Chunk*>& visibleChunks) const
+{
+    const auto& node = levels_[level][nodeIndex];
+    const auto masks = frustum.Test(node.childrenBounds);
+    const size_t childSide = regionSize >> (level + 1);
+    for (size_t child = 0; child < 4; child++)
+    {
+        const auto childBit = std::uint8_t(1u << child);
+        if (!(node.childrenMask & masks.visible & childBit))
+        {
+            continue;
+        }
+        const auto childX = firstX + (child & 1u) * childSide;
+        const auto childZ = firstZ + (child >> 1u) * childSide;
+        if (masks.inside & childBit)
+        {
+            AddChunks(childX, childZ, childSide, visibleChunks);
+        }
+        else if (level + 1 == depth)
+        {
+            CullColumn(frustum, childX, childZ, visibleChunks);
+        }
+        else
+        {
+            CullNode(frustum, level + 1, 4 * nodeIndex + child, childX, childZ, visibleChunks);
+        }
+    }
+}
+
+void ChunkQuadtree::CullColumn(const Frustum& frustum, size_t chunkX, size_t chunkZ,
+    std::vector<const Chunk*>& visibleChunks) const
+{
+    const auto columnIndex = chunkX * regionSize + chunkZ;
+    const auto end = columnsBegin_[columnIndex + 1];
+    for (auto begin = columnsBegin_[columnIndex]; begin < end; begin += 4)
+    {
+        FourAabb3d chunksBounds;
+        const auto chunksNmb = std::min<std::uint32_t>(4u, end - begin);
+        for (std::uint32_t i = 0; i < chunksNmb; i++)
+        {
+            chunksBounds.Set(i, Region::GetChunkAabb(chunks_[begin + i]->chunkId));
+        }
+        const auto masks = frustum.Test(chunksBounds);
+        for (std::uint32_t i = 0; i < chunksNmb; i++)
+        {
+            if (masks.visible & (1u << i))
+            {
+                visibleChunks.push_back(chunks_[begin + i]);
+            }
+        }
+    }
+}
+
+void ChunkQuadtree::AddChunks(size_t firstX, size_t firstZ, size_t columnsSide,
+    std::vector<const Chunk*>& visibleChunks) const
+{
+    //The columns of a node are contiguous along z
+    for (size_t chunkX = firstX; chunkX < firstX + columnsSide; chunkX++)
+    {
+        const auto begin = columnsBegin_[chunkX * regionSize + firstZ];
+        const auto end = columnsBegin_[chunkX * regionSize + firstZ + columnsSide];
+        visibleChunks.insert(visibleChunks.end(), chunks_.begin() + begin, chunks_.begin() + end);
+    }
+}
+}
@@ -24,152 +24,163 @@
 
 #include "voxel/frustum.h"
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
 namespace neko::voxel
 {
 
-void Frustum::SetCamera(const Camera3D& camera)
+void FourAabb3d::Set(size_t index, const Aabb3d& aabb)
 {
-    near_ = camera.nearPlane;
-    far_ = camera.farPlane;
+    minX[index] = aabb.lowerLeftBound.x;
+    minY[index] = aabb.lowerLeftBound.y;
+    minZ[index] = aabb.lowerLeftBound.z;
+    maxX[index] = aabb.upperRightBound.x;
+    maxY[index] = aabb.upperRightBound.y;
+    maxZ[index] = aabb.upperRightBound.z;
+}
 
-    position_ = camera.position;
-    dir_ = -camera.reverseDir;
-    rightDir_ = camera.rightDir;
-    upDir_ = camera.upDir;
+void Frustum::SetCamera(const Camera3D& camera)
+{
+    const auto position = camera.position;
+    const auto dir = -camera.reverseDir;
+    const auto rightDir = camera.rightDir;
+    const auto upDir = camera.upDir;
 
     const auto fovX = camera.GetFovX();
-    const auto rightQuaternion = Quaternion::AngleAxis(fovX / 2.0f, upDir_);
-    rightNormal_ = Vec3f(Transform3d::RotationMatrixFrom(rightQuaternion) * Vec4f(rightDir_));
+    const auto rightQuaternion = Quaternion::AngleAxis(fovX / 2.0f, upDir);
+    const auto rightNormal = Vec3f(Transform3d::RotationMatrixFrom(rightQuaternion) * Vec4f(rightDir));
 
-    const auto leftQuaternion = Quaternion::AngleAxis(-fovX / 2.0f, upDir_);
-    leftNormal_ = Vec3f(Transform3d::RotationMatrixFrom(leftQuaternion) * Vec4f(-rightDir_));
+    const auto leftQuaternion = Quaternion::AngleAxis(-fovX / 2.0f, upDir);
+    const auto leftNormal = Vec3f(Transform3d::RotationMatrixFrom(leftQuaternion) * Vec4f(-rightDir));
 
-    const auto topQuaternion = Quaternion::AngleAxis(camera.fovY / 2.0f, rightDir_);
-    topNormal_ = Vec3f(Transform3d::RotationMatrixFrom(topQuaternion) * Vec4f(-upDir_));
+    const auto topQuaternion = Quaternion::AngleAxis(camera.fovY / 2.0f, rightDir);
+    const auto topNormal = Vec3f(Transform3d::RotationMatrixFrom(topQuaternion) * Vec4f(-upDir));
 
-    const auto bottomQuaternion = Quaternion::AngleAxis(-camera.fovY / 2.0f, rightDir_);
-    bottomNormal_ = Vec3f(Transform3d::RotationMatrixFrom(bottomQuaternion) * Vec4f(upDir_));
+    const auto bottomQuaternion = Quaternion::AngleAxis(-camera.fovY / 2.0f, rightDir);
+    const auto bottomNormal = Vec3f(Transform3d::RotationMatrixFrom(bottomQuaternion) * Vec4f(upDir));
 
+    SetPlane(0, dir, position + dir * camera.nearPlane);
+    SetPlane(1, -dir, position + dir * camera.farPlane);
+    SetPlane(2, rightNormal, position);
+    SetPlane(3, leftNormal, position);
+    SetPlane(4, topNormal, position);
+    SetPlane(5, bottomNormal, position);
 }
 
-bool Frustum::Contains(const Cube& cube, Vec3f chunkPos, RegionId regionId) const
+bool Frustum::Contains(const Cube& cube, Vec3f chunkPos, [[maybe_unused]] RegionId regionId) const
 {
-    constexpr float radius = Sqrt(3.0f*(0.5f*0.5f));
     const auto cubeY = cube.cubeId & 31u;
     const auto cubeX = (cube.cubeId >> 10u) & 31u;
     const auto cubeZ = (cube.cubeId >> 5u) & 31u;
-    const auto cubePos = Vec3f(
+    Aabb3d aabb;
+    aabb.lowerLeftBound = Vec3f(
             float(cubeX),
             float(cubeY),
             float(cubeZ)) + chunkPos;
-    //Near
-    {
-        const auto planePos = position_ + dir_ * near_;
-        const auto asterPos = cubePos - planePos;
-        const auto v = Vec3f::Dot(dir_, asterPos);
-        if( v < -radius)
-            return false;
-    }
-    //Far
-    {
-        const auto planePos = position_ + dir_ * far_;
-        const auto asterPos = cubePos - planePos;
-        const auto v = Vec3f::Dot(-dir_, asterPos);
-        if (v < -radius)
-            return false;
-    }
-    const auto deltaCubePos = cubePos - position_;
-    //Right
-    {
-        const auto v = Vec3f::Dot(rightNormal_, deltaCubePos);
-        if(v < -radius)
-        {
-            return false;
-        }
-    }
-    //Left
-    {
-        const auto v = Vec3f::Dot(leftNormal_, deltaCubePos);
-        if (v < -radius)
-        {
-            return false;
-        }
-    }
-    //Top
-    {
+    aabb.upperRightBound = aabb.lowerLeftBound + Vec3f::one;
+    return Test(aabb) != FrustumTest::OUTSIDE;
+}
 
+bool Frustum::Contains(Vec3f chunkPos, [[maybe_unused]] RegionId regionId) const
+{
+    Aabb3d aabb;
+    aabb.lowerLeftBound = chunkPos;
+    aabb.upperRightBound = chunkPos + Vec3f::one * static_cast<float>(chunkSize);
+    return Test(aabb) != FrustumTest::OUTSIDE;
+}
 
-        const auto v = Vec3f::Dot(topNormal_, deltaCubePos);
-        if (v < -radius)
+FrustumTest Frustum::Test(const Aabb3d& aabb) const
+{
+    auto result = FrustumTest::INSIDE;
+    for (size_t i = 0; i < planesNmb; i++)
+    {
+        //The corner the farthest along the normal is the last one to leave the plane
+        const Vec3f normal(planeNormalX_[i], planeNormalY_[i], planeNormalZ_[i]);
+        const Vec3f positiveCorner(
+                normal.x >= 0.0f ? aabb.upperRightBound.x : aabb.lowerLeftBound.x,
+                normal.y >= 0.0f ? aabb.upperRightBound.y : aabb.lowerLeftBound.y,
+                normal.z >= 0.0f ? aabb.upperRightBound.z : aabb.lowerLeftBound.z);
+        if (Vec3f::Dot(normal, positiveCorner) + planeDistance_[i] < 0.0f)
         {
-            return false;
+            return FrustumTest::OUTSIDE;
         }
-    }
-    //Bottom
-    {
-        const auto v = Vec3f::Dot(bottomNormal_, deltaCubePos);
-        if (v < -radius)
+        const Vec3f negativeCorner(
+                normal.x >= 0.0f ? aabb.lowerLeftBound.x : aabb.upperRightBound.x,
+                normal.y >= 0.0f ? aabb.lowerLeftBound.y : aabb.upperRightBound.y,
+                normal.z >= 0.0f ? aabb.lowerLeftBound.z : aabb.upperRightBound.z);
+        if (Vec3f::Dot(normal, negativeCorner) + planeDistance_[i] < 0.0f)
         {
-            return false;
+            result = FrustumTest::INTERSECT;
         }
     }
-    return true;
+    return result;
 }
 
-bool Frustum::Contains(Vec3f chunkPos, RegionId regionId) const
+FrustumMasks Frustum::Test(const FourAabb3d& aabbs) const
 {
-    constexpr float radius = Sqrt(3.0f * static_cast<float>(chunkSize / 2u * chunkSize / 2u));
-    const auto chunkHalfSize = Vec3f::one * static_cast<float>(chunkSize / 2u);
-    const auto center = chunkPos + chunkHalfSize;
-    //Near
-    {
-        const auto planePos = position_ + dir_ * near_;
-        const auto chunkDeltaPos = chunkPos - planePos;
-        const auto v = Vec3f::Dot(dir_, chunkDeltaPos);
-        if( v < -radius)
-            return false;
-    }
-    //Far
-    {
-        const auto planePos = position_ + dir_ * far_;
-        const auto chunkDeltaPos = chunkPos - planePos;
-        const auto v = Vec3f::Dot(-dir_, chunkDeltaPos);
-        if (v < -radius)
-            return false;
-    }
-    const auto chunkDeltaPos = center - position_;
-    //Right
-    {
-        const auto v = Vec3f::Dot(rightNormal_, chunkDeltaPos);
-        if(v < -radius)
-        {
-            return false;
-        }
-    }
-    //Left
+    FrustumMasks masks;
+#ifdef __SSE__
+    const __m128 minX = _mm_load_ps(aabbs.minX.data());
+    const __m128 minY = _mm_load_ps(aabbs.minY.data());
+    const __m128 minZ = _mm_load_ps(aabbs.minZ.data());
+    const __m128 maxX = _mm_load_ps(aabbs.maxX.data());
+    const __m128 maxY = _mm_load_ps(aabbs.maxY.data());
+    const __m128 maxZ = _mm_load_ps(aabbs.maxZ.data());
+    const __m128 zero = _mm_setzero_ps();
+    __m128 outside = zero;
+    __m128 intersect = zero;
+    for (size_t i = 0; i < planesNmb; i++)
     {
-        const auto v = Vec3f::Dot(leftNormal_, chunkDeltaPos);
-        if (v < -radius)
-        {
-            return false;
-        }
+        //The sign of the normal is the same for the four AABBs, the corners are chosen once per plane
+        const bool positiveX = planeNormalX_[i] >= 0.0f;
+        const bool positiveY = planeNormalY_[i] >= 0.0f;
+        const bool positiveZ = planeNormalZ_[i] >= 0.0f;
+        const __m128 normalX = _mm_set1_ps(planeNormalX_[i]);
+        const __m128 normalY = _mm_set1_ps(planeNormalY_[i]);
+        const __m128 normalZ = _mm_set1_ps(planeNormalZ_[i]);
+        const __m128 distance = _mm_set1_ps(planeDistance_[i]);
+        const __m128 positiveDistance = _mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(normalX, positiveX ? maxX : minX),
+                _mm_mul_ps(normalY, positiveY ? maxY : minY)),
+                _mm_add_ps(_mm_mul_ps(normalZ, positiveZ ? maxZ : minZ), distance));
+        const __m128 negativeDistance = _mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(normalX, positiveX ? minX : maxX),
+                _mm_mul_ps(normalY, positiveY ? minY : maxY)),
+                _mm_add_ps(_mm_mul_ps(normalZ, positiveZ ? minZ : maxZ), distance));
+        outside = _mm_or_ps(outside, _mm_cmplt_ps(positiveDistance, zero));
+        intersect = _mm_or_ps(intersect, _mm_cmplt_ps(negativeDistance, zero));
     }
-    //Top
+    const auto outsideMask = static_cast<std::uint8_t>(_mm_movemask_ps(outside));
+    const auto intersectMask = static_cast<std::uint8_t>(_mm_movemask_ps(intersect));
+    masks.visible = static_cast<std::uint8_t>(~outsideMask & 0xFu);
+    masks.inside = static_cast<std::uint8_t>(masks.visible & ~intersectMask);
+#else
+    for (size_t i = 0; i < 4; i++)
     {
-        const auto v = Vec3f::Dot(topNormal_, chunkDeltaPos);
-        if (v < -radius)
+        Aabb3d aabb;
+        aabb.lowerLeftBound = Vec3f(aabbs.minX[i], aabbs.minY[i], aabbs.minZ[i]);
+        aabb.upperRightBound = Vec3f(aabbs.maxX[i], aabbs.maxY[i], aabbs.maxZ[i]);
+        const auto result = Test(aabb);
+        if (result != FrustumTest::OUTSIDE)
         {
-            return false;
+            masks.visible |= 1u << i;
         }
-    }
-    //Bottom
-    {
-        const auto v = Vec3f::Dot(bottomNormal_, chunkDeltaPos);
-        if (v < -radius)
+        if (result == FrustumTest::INSIDE)
         {
-            return false;
+            masks.inside |= 1u << i;
         }
     }
-    return true;
+#endif
+    return masks;
+}
+
+void Frustum::SetPlane(size_t index, const Vec3f& normal, const Vec3f& point)
+{
+    planeNormalX_[index] = normal.x;
+    planeNormalY_[index] = normal.y;
+    planeNormalZ_[index] = normal.z;
+    planeDistance_[index] = -Vec3f::Dot(normal, point);
+}
 }
-}
\ No newline at end of file
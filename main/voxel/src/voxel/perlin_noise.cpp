@@ -0,0 +1,236 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "voxel/perlin_noise.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace neko::voxel
+{
+
+namespace
+{
+constexpr double Weight(std::int32_t octaves)
+{
+    double amp = 1.0;
+    double value = 0.0;
+    for (std::int32_t i = 0; i < octaves; ++i)
+    {
+        value += amp;
+        amp /= 2.0;
+    }
+    return value;
+}
+
+#if defined(__AVX2__)
+__m256d Fade(__m256d t)
+{
+    const auto six = _mm256_set1_pd(6.0);
+    const auto fifteen = _mm256_set1_pd(15.0);
+    const auto ten = _mm256_set1_pd(10.0);
+    const auto polynom = _mm256_add_pd(
+        _mm256_mul_pd(t, _mm256_sub_pd(_mm256_mul_pd(t, six), fifteen)), ten);
+    return _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(t, t), t), polynom);
+}
+
+__m256d Lerp(__m256d t, __m256d a, __m256d b)
+{
+    return _mm256_add_pd(a, _mm256_mul_pd(t, _mm256_sub_pd(b, a)));
+}
+
+/**
+ * \brief Gradient with z = 0, the branches of the scalar version become blends and sign flips
+ */
+__m256d Grad(__m128i hash, __m256d x, __m256d y)
+{
+    const auto h = _mm256_cvtepi32_epi64(_mm_and_si128(hash, _mm_set1_epi32(15)));
+    const auto lowerThan8 = _mm256_castsi256_pd(_mm256_cmpgt_epi64(_mm256_set1_epi64x(8), h));
+    const auto lowerThan4 = _mm256_castsi256_pd(_mm256_cmpgt_epi64(_mm256_set1_epi64x(4), h));
+    const auto is12Or14 = _mm256_castsi256_pd(_mm256_or_si256(
+        _mm256_cmpeq_epi64(h, _mm256_set1_epi64x(12)),
+        _mm256_cmpeq_epi64(h, _mm256_set1_epi64x(14))));
+    const auto u = _mm256_blendv_pd(y, x, lowerThan8);
+    const auto v = _mm256_blendv_pd(_mm256_blendv_pd(_mm256_setzero_pd(), x, is12Or14), y, lowerThan4);
+    const auto signU = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(h, _mm256_set1_epi64x(1)), 63));
+    const auto signV = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(h, _mm256_set1_epi64x(2)), 62));
+    return _mm256_add_pd(_mm256_xor_pd(u, signU), _mm256_xor_pd(v, signV));
+}
+
+__m256d Noise2D(const std::int32_t* permutation, __m256d x, __m256d y)
+{
+    const auto floorX = _mm256_floor_pd(x);
+    const auto floorY = _mm256_floor_pd(y);
+    const auto mask = _mm_set1_epi32(255);
+    const auto one = _mm_set1_epi32(1);
+    const auto cellX = _mm_and_si128(_mm256_cvttpd_epi32(floorX), mask);
+    const auto cellY = _mm_and_si128(_mm256_cvttpd_epi32(floorY), mask);
+    x = _mm256_sub_pd(x, floorX);
+    y = _mm256_sub_pd(y, floorY);
+    const auto u = Fade(x);
+    const auto v = Fade(y);
+
+    const auto a = _mm_add_epi32(_mm_i32gather_epi32(permutation, cellX, 4), cellY);
+    const auto aa = _mm_i32gather_epi32(permutation, a, 4);
+    const auto ab = _mm_i32gather_epi32(permutation, _mm_add_epi32(a, one), 4);
+    const auto b = _mm_add_epi32(_mm_i32gather_epi32(permutation, _mm_add_epi32(cellX, one), 4), cellY);
+    const auto ba = _mm_i32gather_epi32(permutation, b, 4);
+    const auto bb = _mm_i32gather_epi32(permutation, _mm_add_epi32(b, one), 4);
+
+    const auto xMinusOne = _mm256_sub_pd(x, _mm256_set1_pd(1.0));
+    const auto yMinusOne = _mm256_sub_pd(y, _mm256_set1_pd(1.0));
+    return Lerp(v,
+        Lerp(u, Grad(_mm_i32gather_epi32(permutation, aa, 4), x, y),
+            Grad(_mm_i32gather_epi32(permutation, ba, 4), xMinusOne, y)),
+        Lerp(u, Grad(_mm_i32gather_epi32(permutation, ab, 4), x, yMinusOne),
+            Grad(_mm_i32gather_epi32(permutation, bb, 4), xMinusOne, yMinusOne)));
+}
+#else
+double Fade(double t)
+{
+    return t * t * t * (t * (t * 6.0 - 15.0) + 10.0);
+}
+
+double Lerp(double t, double a, double b)
+{
+    return a + t * (b - a);
+}
+
+double Grad(std::int32_t hash, double x, double y)
+{
+    const std::int32_t h = hash & 15;
+    const double u = h < 8 ? x : y;
+    const double v = h < 4 ? y : h == 12 || h == 14 ? x : 0.0;
+    return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
+}
+
+double Noise2D(const std::int32_t* permutation, double x, double y)
+{
+    const std::int32_t cellX = static_cast<std::int32_t>(std::floor(x)) & 255;
+    const std::int32_t cellY = static_cast<std::int32_t>(std::floor(y)) & 255;
+    x -= std::floor(x);
+    y -= std::floor(y);
+    const double u = Fade(x);
+    const double v = Fade(y);
+    const std::int32_t a = permutation[cellX] + cellY, aa = permutation[a], ab = permutation[a + 1];
+    const std::int32_t b = permutation[cellX + 1] + cellY, ba = permutation[b], bb = permutation[b + 1];
+    return Lerp(v,
+        Lerp(u, Grad(permutation[aa], x, y), Grad(permutation[ba], x - 1.0, y)),
+        Lerp(u, Grad(permutation[ab], x, y - 1.0), Grad(permutation[bb], x - 1.0, y - 1.0)));
+}
+#endif
+}
+
+BatchPerlinNoise::BatchPerlinNoise(std::uint32_t seed)
+{
+    //Same shuffle as siv::PerlinNoise::reseed so that both generate the same terrain
+    std::array<std::uint8_t, 256> permutation{};
+    for (size_t i = 0; i < permutation.size(); ++i)
+    {
+        permutation[i] = static_cast<std::uint8_t>(i);
+    }
+    std::shuffle(permutation.begin(), permutation.end(), std::default_random_engine(seed));
+    for (size_t i = 0; i < permutation.size(); ++i)
+    {
+        permutation_[i] = permutation[i];
+        permutation_[permutation.size() + i] = permutation[i];
+    }
+}
+
+void BatchPerlinNoise::NormalizedOctaveNoise2D01(const double* xs, const double* ys, double* results,
+    size_t samplesNmb, std::int32_t octaves) const
+{
+    const double weight = Weight(octaves);
+    size_t i = 0;
+    for (; i + batchSize <= samplesNmb; i += batchSize)
+    {
+        AccumulateOctaveNoise2D(xs + i, ys + i, results + i, octaves);
+    }
+    if (i < samplesNmb)
+    {
+        //The remaining samples go through the same kernel to get the same values as a full batch
+        std::array<double, batchSize> tailXs{};
+        std::array<double, batchSize> tailYs{};
+        std::array<double, batchSize> tailResults{};
+        const auto tailNmb = samplesNmb - i;
+        std::copy_n(xs + i, tailNmb, tailXs.begin());
+        std::copy_n(ys + i, tailNmb, tailYs.begin());
+        AccumulateOctaveNoise2D(tailXs.data(), tailYs.data(), tailResults.data(), octaves);
+        std::copy_n(tailResults.cbegin(), tailNmb, results + i);
+    }
+    for (i = 0; i < samplesNmb; i++)
+    {
+        results[i] = results[i] / weight * 0.5 + 0.5;
+    }
+}
+
+double BatchPerlinNoise::NormalizedOctaveNoise2D01(double x, double y, std::int32_t octaves) const
+{
+    double result = 0.0;
+    NormalizedOctaveNoise2D01(&x, &y, &result, 1, octaves);
+    return result;
+}
+
+void BatchPerlinNoise::AccumulateOctaveNoise2D(const double* xs, const double* ys, double* results,
+    std::int32_t octaves) const
+{
+#if defined(__AVX2__)
+    auto x = _mm256_loadu_pd(xs);
+    auto y = _mm256_loadu_pd(ys);
+    auto result = _mm256_setzero_pd();
+    const auto two = _mm256_set1_pd(2.0);
+    double amp = 1.0;
+    for (std::int32_t octave = 0; octave < octaves; ++octave)
+    {
+        result = _mm256_add_pd(result,
+            _mm256_mul_pd(Noise2D(permutation_.data(), x, y), _mm256_set1_pd(amp)));
+        x = _mm256_mul_pd(x, two);
+        y = _mm256_mul_pd(y, two);
+        amp /= 2.0;
+    }
+    _mm256_storeu_pd(results, result);
+#else
+    for (size_t i = 0; i < batchSize; i++)
+    {
+        double x = xs[i];
+        double y = ys[i];
+        double result = 0.0;
+        double amp = 1.0;
+        for (std::int32_t octave = 0; octave < octaves; ++octave)
+        {
+            result += Noise2D(permutation_.data(), x, y) * amp;
+            x *= 2.0;
+            y *= 2.0;
+            amp /= 2.0;
+        }
+        results[i] = result;
+    }
+#endif
+}
+
+}
@@ -24,7 +24,7 @@
 
 #include "voxel/region.h"
 
-#include <mutex>
+#include "engine/assert.h"
 
 #ifdef EASY_PROFILE_USE
 #include <easy/profiler.h>
@@ -34,7 +34,13 @@ namespace neko::voxel
 {
 void Region::Init()
 {
-    chunks_.resize(regionHeight * regionSize * regionSize);
+    const auto chunksNmb = regionHeight * regionSize * regionSize;
+    chunks_.resize(chunksNmb);
+    loadedChunks_ = std::make_unique<std::atomic<bool>[]>(chunksNmb);
+    for (size_t i = 0; i < chunksNmb; i++)
+    {
+        loadedChunks_[i].store(false, std::memory_order_relaxed);
+    }
 }
 
 const std::vector<Chunk>& Region::GetChunks() const
@@ -67,21 +73,40 @@ void Region::GenerateFromHeightMap(const HeightMap& map)
             {
                 chunk.contents = std::make_unique<ChunkContent>();
             }
-            auto& cube = (*chunk.contents)[cubeX][cubeZ][cubeY];
-            cube.flag = cube.flag | Cube::IS_VISIBLE;
-            cube.cubeTextureId = GenerateTextureId(CubeType::GRASS);
-            cube.cubeId = Cube::CalculateCubeId(Vec3b(cubeX, cubeY, cubeZ));
-            chunk.visibleCubes.push_back(cube.cubeId);
+            const auto cubeId = Cube::CalculateCubeId(Vec3b(cubeX, cubeY, cubeZ));
+            chunk.contents->SetCubeType(cubeId, CubeType::GRASS);
+            chunk.visibleCubes.push_back(cubeId);
+        }
+    }
+    for (size_t i = 0; i < chunks_.size(); i++)
+    {
+        if (chunks_[i].contents != nullptr)
+        {
+            loadedChunks_[i].store(true, std::memory_order_release);
         }
     }
 }
 
 void Region::SetChunk(const ChunkId chunkId, Chunk&& chunk)
 {
-    static std::mutex localMutex;
-    std::lock_guard<std::mutex> lock(localMutex);
+    neko_assert(!loadedChunks_[chunkId].load(std::memory_order_relaxed), "Chunk is already loaded");
+    //Each chunk is written by a single thread, only its publication needs to be synchronized
+    const auto version = chunks_[chunkId].version + 1;
     chunks_[chunkId] = std::move(chunk);
     chunks_[chunkId].flag = Chunk::IS_VISIBLE;
+    chunks_[chunkId].version = version;
+    loadedChunks_[chunkId].store(true, std::memory_order_release);
+}
+
+void Region::UnloadChunk(ChunkId chunkId)
+{
+    loadedChunks_[chunkId].store(false, std::memory_order_relaxed);
+    auto& chunk = chunks_[chunkId];
+    chunk.contents = nullptr;
+    chunk.visibleCubes.clear();
+    chunk.visibleCubes.shrink_to_fit();
+    chunk.flag = Chunk::NONE;
+    chunk.version++;
 }
 
 const Chunk* Region::GetChunk(ChunkId chunkId)
@@ -89,6 +114,11 @@ const Chunk* Region::GetChunk(ChunkId chunkId)
     return &chunks_[chunkId];
 }
 
+bool Region::IsChunkLoaded(ChunkId chunkId) const
+{
+    return loadedChunks_[chunkId].load(std::memory_order_acquire);
+}
+
 Vec2df Region::GetRegionPos(RegionId regionId)
 {
     return Vec2df();
@@ -98,4 +128,20 @@ ChunkId Region::GetChunkId(size_t chunkX, size_t chunkZ, size_t chunkY)
 {
     return chunkX * regionHeight * regionSize + chunkZ * regionHeight + chunkY;
 }
+
+Aabb3d Region::GetChunkAabb(ChunkId chunkId)
+{
+    const auto chunkY = chunkId % regionHeight;
+    const auto chunkX = chunkId / regionHeight / regionSize;
+    const auto chunkZ = (chunkId - chunkX * regionHeight * regionSize) / regionHeight;
+    const float chunkLength = float(chunkSize);
+    Aabb3d aabb;
+    //Cubes are centered on their position, the chunk starts half a cube before its first cube
+    aabb.lowerLeftBound = Vec3f(
+            float(chunkX) * chunkLength - float(regionSize) * 0.5f * chunkLength - 0.5f,
+            float(chunkY) * chunkLength - float(regionHeight) * 0.5f * chunkLength - 0.5f,
+            float(chunkZ) * chunkLength - float(regionSize) * 0.5f * chunkLength - 0.5f);
+    aabb.upperRightBound = aabb.lowerLeftBound + Vec3f::one * chunkLength;
+    return aabb;
+}
 }
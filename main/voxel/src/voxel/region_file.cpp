@@ -0,0 +1,279 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "voxel/region_file.h"
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+
+#include <zstd.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "engine/log.h"
+
+#ifdef EASY_PROFILE_USE
+#include <easy/profiler.h>
+#endif
+
+namespace neko::voxel
+{
+namespace
+{
+struct DecompressionContextDeleter
+{
+    void operator()(ZSTD_DCtx* context) const { ZSTD_freeDCtx(context); }
+};
+
+ZSTD_DCtx* GetDecompressionContext()
+{
+    //One context per thread instead of allocating one for each chunk
+    thread_local std::unique_ptr<ZSTD_DCtx, DecompressionContextDeleter> context(ZSTD_createDCtx());
+    return context.get();
+}
+}
+
+RegionFile::~RegionFile()
+{
+    Close();
+}
+
+bool RegionFile::Save(const std::string& path, const std::vector<const Chunk*>& chunks, int compressionLevel)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Save Region File");
+#endif
+    std::vector<RegionFileEntry> entries(chunksNmb);
+    std::vector<std::uint8_t> chunksData;
+    std::vector<std::uint8_t> blob;
+    for (const auto* chunk : chunks)
+    {
+        if (chunk->chunkId >= chunksNmb)
+        {
+            logDebug("[Error] Chunk id outside of the region file: " + std::to_string(chunk->chunkId));
+            return false;
+        }
+        auto& entry = entries[chunk->chunkId];
+        entry.offset = static_cast<std::uint32_t>(chunksDataOffset + chunksData.size());
+        entry.size = 0;
+        //A chunk without cubes is present in the file with an empty blob
+        if (chunk->contents == nullptr)
+        {
+            continue;
+        }
+        blob.clear();
+        chunk->contents->Compress(blob);
+        const auto dataPos = chunksData.size();
+        chunksData.resize(dataPos + ZSTD_compressBound(blob.size()));
+        const auto compressedSize = ZSTD_compress(&chunksData[dataPos], chunksData.size() - dataPos,
+            blob.data(), blob.size(), compressionLevel);
+        if (ZSTD_isError(compressedSize))
+        {
+            logDebug(std::string("[Error] Could not compress chunk: ") + ZSTD_getErrorName(compressedSize));
+            return false;
+        }
+        chunksData.resize(dataPos + compressedSize);
+        entry.size = static_cast<std::uint32_t>(compressedSize);
+    }
+    if (chunksDataOffset + chunksData.size() > std::numeric_limits<std::uint32_t>::max())
+    {
+        logDebug("[Error] Region file is too big: " + path);
+        return false;
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        logDebug("[Error] Could not open region file for writing: " + path);
+        return false;
+    }
+    Header header;
+    header.chunksNmb = static_cast<std::uint32_t>(chunksNmb);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    file.write(reinterpret_cast<const char*>(entries.data()), std::streamsize(entries.size() * sizeof(RegionFileEntry)));
+    file.write(reinterpret_cast<const char*>(chunksData.data()), std::streamsize(chunksData.size()));
+    return file.good();
+}
+
+bool RegionFile::Open(const std::string& path)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Open Region File");
+#endif
+    Close();
+#ifdef _WIN32
+    const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize) || size_t(fileSize.QuadPart) < chunksDataOffset)
+    {
+        CloseHandle(file);
+        logDebug("[Error] Region file is too small: " + path);
+        return false;
+    }
+    const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+    {
+        logDebug("[Error] Could not map region file: " + path);
+        return false;
+    }
+    //The view keeps the mapping alive
+    const auto* data = static_cast<const std::uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+    if (data == nullptr)
+    {
+        logDebug("[Error] Could not map region file: " + path);
+        return false;
+    }
+    const auto size = size_t(fileSize.QuadPart);
+#else
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+    struct stat fileStat{};
+    if (fstat(file, &fileStat) != 0 || size_t(fileStat.st_size) < chunksDataOffset)
+    {
+        close(file);
+        logDebug("[Error] Region file is too small: " + path);
+        return false;
+    }
+    const auto size = size_t(fileStat.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    //The mapping stays valid after closing the file descriptor
+    close(file);
+    if (mapping == MAP_FAILED)
+    {
+        logDebug("[Error] Could not map region file: " + path);
+        return false;
+    }
+    const auto* data = static_cast<const std::uint8_t*>(mapping);
+#endif
+    data_ = data;
+    size_ = size;
+    Header header;
+    std::memcpy(&header, data_, sizeof(Header));
+    if (header.magic != magicNumber || header.version != formatVersion || header.chunksNmb != chunksNmb)
+    {
+        logDebug("[Error] Invalid region file header: " + path);
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void RegionFile::Close()
+{
+    if (data_ == nullptr)
+    {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+#else
+    munmap(const_cast<std::uint8_t*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool RegionFile::HasChunk(ChunkId chunkId) const
+{
+    return IsOpen() && chunkId < chunksNmb && GetEntry(chunkId).offset != 0;
+}
+
+bool RegionFile::LoadChunk(ChunkId chunkId, Chunk& chunk) const
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Load Region File Chunk");
+#endif
+    if (!HasChunk(chunkId))
+    {
+        return false;
+    }
+    const auto entry = GetEntry(chunkId);
+    chunk.chunkId = chunkId;
+    chunk.contents = nullptr;
+    chunk.visibleCubes.clear();
+    if (entry.size == 0)
+    {
+        return true;
+    }
+    if (entry.offset < chunksDataOffset || size_t(entry.offset) + entry.size > size_)
+    {
+        logDebug("[Error] Chunk outside of the region file: " + std::to_string(chunkId));
+        return false;
+    }
+    const auto* compressedData = data_ + entry.offset;
+    const auto blobSize = ZSTD_getFrameContentSize(compressedData, entry.size);
+    //A corrupted frame header could ask for any size
+    if (blobSize == ZSTD_CONTENTSIZE_ERROR || blobSize == ZSTD_CONTENTSIZE_UNKNOWN ||
+        blobSize > ChunkContent::maxCompressedSize)
+    {
+        logDebug("[Error] Invalid compressed chunk in region file: " + std::to_string(chunkId));
+        return false;
+    }
+    thread_local std::vector<std::uint8_t> blob;
+    blob.resize(blobSize);
+    const auto decompressedSize = ZSTD_decompressDCtx(GetDecompressionContext(),
+        blob.data(), blob.size(), compressedData, entry.size);
+    if (ZSTD_isError(decompressedSize) || decompressedSize != blobSize)
+    {
+        logDebug("[Error] Could not decompress chunk: " + std::to_string(chunkId));
+        return false;
+    }
+    chunk.contents = std::make_unique<ChunkContent>();
+    if (!chunk.contents->Decompress(blob.data(), blob.size()))
+    {
+        chunk.contents = nullptr;
+        logDebug("[Error] Invalid chunk content in region file: " + std::to_string(chunkId));
+        return false;
+    }
+    return true;
+}
+
+RegionFileEntry RegionFile::GetEntry(ChunkId chunkId) const
+{
+    RegionFileEntry entry;
+    std::memcpy(&entry, data_ + entriesOffset + chunkId * sizeof(RegionFileEntry), sizeof(RegionFileEntry));
+    return entry;
+}
+
+}
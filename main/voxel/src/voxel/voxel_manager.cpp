@@ -24,7 +24,11 @@
 
 #include <voxel/voxel_manager.h>
 
+#include <algorithm>
+#include <cmath>
+
 #include "engine/engine.h"
+#include "engine/log.h"
 
 #ifdef EASY_PROFILE_USE
 #include "easy/profiler.h"
@@ -32,101 +36,204 @@
 
 namespace neko::voxel
 {
+namespace
+{
+size_t CalculateChunkMemoryUsage(const Chunk& chunk)
+{
+    return (chunk.contents == nullptr ? 0 : chunk.contents->GetMemoryUsage()) +
+           chunk.visibleCubes.capacity() * sizeof(CubeId);
+}
+
+void WriteUint16(std::vector<std::uint8_t>& data, std::uint16_t value)
+{
+    data.push_back(static_cast<std::uint8_t>(value & 0xFFu));
+    data.push_back(static_cast<std::uint8_t>(value >> 8u));
+}
+
+std::uint16_t ReadUint16(const std::uint8_t* data)
+{
+    return static_cast<std::uint16_t>(data[0] | (data[1] << 8u));
+}
+}
+
+VoxelManager::VoxelManager(int renderDistance, size_t memoryBudget) :
+    renderDistance_(renderDistance), memoryBudget_(memoryBudget)
+{
+}
+
 void VoxelManager::Init()
 {
 #ifdef EASY_PROFILE_USE
     EASY_BLOCK("Init Voxel Manager");
 #endif
-    regions_.emplace_back();
-    auto& region = regions_.front();
-    const auto chunkX = regionSize / 2;
-    const auto chunkZ = regionSize / 2;
-    region.Init();
-    {
+    region_.Init();
+    columns_.resize(regionSize * regionSize);
+    const Vec2u cubePos(unsigned(cameraColumn_.x) * chunkSize, unsigned(cameraColumn_.y) * chunkSize);
+    const auto height = chunkGenerator_.GetHeight(0, cubePos);
+    initialHeight_ = float(height) - float(regionHeight / 2 * chunkSize);
+    isCameraColumnDirty_ = true;
+}
 
-        const Vec2u cubePos(chunkX * chunkSize, chunkZ * chunkSize);
-        const auto height = chunkGenerator_.GetHeight(0, cubePos);
-        initialHeight_ = float(height) - float(regionHeight / 2 * chunkSize);
-    }
-    const auto workerNumber = BasicEngine::GetInstance()->GetWorkersNumber();
-    initJob = Job([this, chunkX, chunkZ, workerNumber]()
-        {
+void VoxelManager::Update([[maybe_unused]] seconds dt)
+{
 #ifdef EASY_PROFILE_USE
-            EASY_BLOCK("Init Job Voxel Manager");
+    EASY_BLOCK("Update Voxel Manager");
 #endif
-            for (int dx = -renderDistance_; dx <= renderDistance_; dx++)
+    unloadedChunks_.clear();
+    InstallLoadedColumns();
+    if (isCameraColumnDirty_)
+    {
+        //One column of margin so that moving back and forth on a chunk border does not reload columns
+        for (size_t i = loadedColumns_.size(); i > 0; i--)
+        {
+            const auto columnIndex = loadedColumns_[i - 1];
+            if (GetColumnDistance(columnIndex) > renderDistance_ + 1)
             {
-                for (int dz = -renderDistance_; dz <= renderDistance_; dz++)
+                UnloadColumn(columnIndex);
+            }
+        }
+        UpdatePendingColumns();
+        isCameraColumnDirty_ = false;
+    }
+    if (chunksMemoryUsage_ > memoryBudget_)
+    {
+        //The loading stops until the camera changes column, otherwise the farthest columns would be loaded again
+        pendingColumns_.clear();
+        while (chunksMemoryUsage_ > memoryBudget_ && !loadedColumns_.empty())
+        {
+            const auto farthestIt = std::max_element(loadedColumns_.cbegin(), loadedColumns_.cend(),
+                [this](size_t columnIndex, size_t otherIndex)
+                {
+                    return GetColumnSquareDistance(columnIndex) < GetColumnSquareDistance(otherIndex);
+                });
+            UnloadColumn(*farthestIt);
+        }
+    }
+    TrimCompressedColumns();
+    peakMemoryUsage_ = std::max(peakMemoryUsage_, GetMemoryUsage());
+    ScheduleColumns();
+    if (areChunksDirty_)
+    {
+        currentChunks_.clear();
+        std::vector<const Chunk*> culledChunks;
+        for (const auto columnIndex : loadedColumns_)
+        {
+            for (const auto chunkId : columns_[columnIndex].chunkIds)
+            {
+                const auto* chunk = region_.GetChunk(chunkId);
+                currentChunks_.push_back(chunk);
+                if ((chunk->flag & Chunk::IS_VISIBLE) && chunk->contents != nullptr)
                 {
-                    const auto newChunkX = chunkX + dx;
-                    const auto newChunkZ = chunkZ + dz;
-                    const Vec2u cubePos(newChunkX * chunkSize, newChunkZ * chunkSize);
-
-                    const auto height = chunkGenerator_.GetHeight(0, cubePos);
-
-                    auto minHeight = height;
-                    auto maxHeight = height;
-                    for (unsigned int cubeDx = 0; cubeDx < chunkSize; cubeDx++)
-                    {
-                        for (unsigned int cubeDz = 0; cubeDz < chunkSize; cubeDz++)
-                        {
-                            const auto tmpHeight = chunkGenerator_.GetHeight(0, cubePos + Vec2u(cubeDx, cubeDz));
-                            if (tmpHeight > maxHeight)
-                            {
-                                maxHeight = tmpHeight;
-                            }
-                            if (tmpHeight < minHeight)
-                            {
-                                minHeight = tmpHeight;
-                            }
-                        }
-                    }
-                    const int minDiff = int(minHeight) - int(height);
-                    const int maxDiff = int(maxHeight) - int(height);
-                    for (int dy = minDiff; dy <= maxDiff; dy++)
-                    {
-                        const auto newChunkY = (height + dy) / chunkSize;
-                        const auto chunkId = Region::GetChunkId(newChunkX, newChunkZ, newChunkY);
-                        chunkLoadingQueue_.push(ChunkLoadingJob{ Job{ [this, chunkId]()
-                        {
-                            #ifdef EASY_PROFILE_USE
-                                EASY_BLOCK("Generating Chunk");
-                            #endif
-                            regions_.front().SetChunk(chunkId, chunkGenerator_.GenerateChunk(0, chunkId));
-                        } }, chunkId, 0 });
-
-                        BasicEngine::GetInstance()->ScheduleJob(&chunkLoadingQueue_.back().loadingJob,
-                                                            JobThreadType::OTHER_THREAD);
-                    }
+                    culledChunks.push_back(chunk);
                 }
             }
-        });
-    BasicEngine::GetInstance()->ScheduleJob(&initJob, JobThreadType::RESOURCE_THREAD);
-    
+        }
+        chunkQuadtree_.Build(culledChunks);
+        areChunksDirty_ = false;
+    }
+}
+
+void VoxelManager::Destroy()
+{
+    for (auto& loadingColumn : loadingColumns_)
+    {
+        loadingColumn->loadingJob->Join();
+    }
+    completedColumns_.PopAll();
+    loadingColumns_.clear();
+}
+
+void VoxelManager::CullChunks(const Frustum& frustum, std::vector<const Chunk*>& visibleChunks) const
+{
+    chunkQuadtree_.Cull(frustum, visibleChunks);
+}
+
+bool VoxelManager::OpenRegionFile(const std::string& path)
+{
+    //The loading jobs read the region file
+    for (auto& loadingColumn : loadingColumns_)
+    {
+        loadingColumn->loadingJob->Join();
+    }
+    if (!regionFile_.Open(path))
+    {
+        regionFilePath_.clear();
+        return false;
+    }
+    regionFilePath_ = path;
+    return true;
 }
 
-void VoxelManager::Update(seconds dt)
+bool VoxelManager::SaveRegionFile(const std::string& path)
 {
-    if (!initJob.IsDone())
-        return;
-    while (!chunkLoadingQueue_.empty())
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Save Region File");
+#endif
+    for (auto& loadingColumn : loadingColumns_)
+    {
+        loadingColumn->loadingJob->Join();
+    }
+    InstallLoadedColumns();
+    //The columns that are not loaded are read back from the compressed cache and the region file
+    std::vector<Chunk> unloadedChunks;
+    for (const auto& compressedColumn : compressedColumns_)
     {
-        if(chunkLoadingQueue_.front().loadingJob.IsDone())
+        if (!DecompressColumn(compressedColumn.data, unloadedChunks))
         {
-            const auto& chunkLoadingJob = chunkLoadingQueue_.front();
-            currentChunks_.push_back(regions_[chunkLoadingJob.regionId]
-                .GetChunk(chunkLoadingJob.chunkId));
-            chunkLoadingQueue_.pop();
+            logDebug("[Error] Invalid compressed column: " + std::to_string(compressedColumn.columnIndex));
+            return false;
         }
-        else
+    }
+    for (size_t columnIndex = 0; columnIndex < columns_.size(); columnIndex++)
+    {
+        if (columns_[columnIndex].state == ColumnState::UNLOADED &&
+            compressedColumnsMap_.find(columnIndex) == compressedColumnsMap_.end())
         {
-            break;
+            LoadColumnFromRegionFile(columnIndex, unloadedChunks);
         }
     }
+    size_t loadedChunksNmb = 0;
+    for (const auto columnIndex : loadedColumns_)
+    {
+        loadedChunksNmb += columns_[columnIndex].chunkIds.size();
+    }
+    std::vector<const Chunk*> chunks;
+    chunks.reserve(loadedChunksNmb + unloadedChunks.size());
+    for (const auto columnIndex : loadedColumns_)
+    {
+        for (const auto chunkId : columns_[columnIndex].chunkIds)
+        {
+            chunks.push_back(region_.GetChunk(chunkId));
+        }
+    }
+    for (const auto& chunk : unloadedChunks)
+    {
+        chunks.push_back(&chunk);
+    }
+    //The current region file can be the one being written
+    regionFile_.Close();
+    const bool isSaved = RegionFile::Save(path, chunks);
+    const auto& openedPath = isSaved ? path : regionFilePath_;
+    if (!openedPath.empty() && !OpenRegionFile(openedPath))
+    {
+        logDebug("[Error] Could not open region file: " + openedPath);
+    }
+    return isSaved;
 }
 
-void VoxelManager::Destroy()
+void VoxelManager::SetCameraPosition(const Vec3f& position)
 {
+    const auto toColumn = [](float coordinate)
+    {
+        const auto column = static_cast<int>(std::floor(coordinate / float(chunkSize))) + int(regionSize / 2);
+        return std::clamp(column, 0, int(regionSize) - 1);
+    };
+    const Vec2i cameraColumn(toColumn(position.x), toColumn(position.z));
+    if (cameraColumn != cameraColumn_)
+    {
+        cameraColumn_ = cameraColumn;
+        isCameraColumnDirty_ = true;
+    }
 }
 
 const std::vector<const Chunk*>& VoxelManager::GetChunks() const
@@ -134,8 +241,319 @@ const std::vector<const Chunk*>& VoxelManager::GetChunks() const
     return currentChunks_;
 }
 
+const std::vector<ChunkId>& VoxelManager::GetUnloadedChunks() const
+{
+    return unloadedChunks_;
+}
+
 float VoxelManager::GetInitialHeight() const
 {
     return initialHeight_;
 }
+
+size_t VoxelManager::GetMemoryUsage() const
+{
+    return chunksMemoryUsage_ + compressedMemoryUsage_;
+}
+
+size_t VoxelManager::GetPeakMemoryUsage() const
+{
+    return peakMemoryUsage_;
+}
+
+bool VoxelManager::IsLoading() const
+{
+    return isCameraColumnDirty_ || !pendingColumns_.empty() || !loadingColumns_.empty();
+}
+
+int VoxelManager::GetColumnDistance(size_t columnIndex) const
+{
+    const int dx = std::abs(int(columnIndex / regionSize) - cameraColumn_.x);
+    const int dz = std::abs(int(columnIndex % regionSize) - cameraColumn_.y);
+    return std::max(dx, dz);
+}
+
+int VoxelManager::GetColumnSquareDistance(size_t columnIndex) const
+{
+    const int dx = int(columnIndex / regionSize) - cameraColumn_.x;
+    const int dz = int(columnIndex % regionSize) - cameraColumn_.y;
+    return dx * dx + dz * dz;
+}
+
+void VoxelManager::InstallLoadedColumns()
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Install Loaded Columns");
+#endif
+    //The columns are installed in the order the workers completed them
+    for (auto* loadingColumn = completedColumns_.PopAll(); loadingColumn != nullptr; loadingColumn = loadingColumn->next)
+    {
+        auto& column = columns_[loadingColumn->columnIndex];
+        column.chunkIds = std::move(loadingColumn->chunkIds);
+        column.memoryUsage = loadingColumn->memoryUsage;
+        column.state = ColumnState::LOADED;
+        chunksMemoryUsage_ += column.memoryUsage;
+        loadedColumns_.push_back(loadingColumn->columnIndex);
+        switch (loadingColumn->source)
+        {
+        case ColumnLoadingJob::Source::COMPRESSED_CACHE:
+            decompressedColumnsNmb_++;
+            break;
+        case ColumnLoadingJob::Source::REGION_FILE:
+            regionFileColumnsNmb_++;
+            break;
+        default:
+            generatedColumnsNmb_++;
+            break;
+        }
+        loadingColumn->isInstalled = true;
+        areChunksDirty_ = true;
+    }
+    //The job can still be finishing after pushing its column
+    const auto loadedEnd = std::remove_if(loadingColumns_.begin(), loadingColumns_.end(),
+        [](const std::unique_ptr<ColumnLoadingJob>& loadingColumn)
+        {
+            return loadingColumn->isInstalled && loadingColumn->loadingJob->IsDone();
+        });
+    loadingColumns_.erase(loadedEnd, loadingColumns_.end());
+}
+
+void VoxelManager::LoadColumn(ColumnLoadingJob& loadingColumn)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Load Column");
+#endif
+    const auto chunkX = loadingColumn.columnIndex / regionSize;
+    const auto chunkZ = loadingColumn.columnIndex % regionSize;
+    std::vector<Chunk> chunks;
+    if (!loadingColumn.compressedColumn.empty() && DecompressColumn(loadingColumn.compressedColumn, chunks))
+    {
+        loadingColumn.source = ColumnLoadingJob::Source::COMPRESSED_CACHE;
+    }
+    else
+    {
+        chunks.clear();
+        if (LoadColumnFromRegionFile(loadingColumn.columnIndex, chunks))
+        {
+            loadingColumn.source = ColumnLoadingJob::Source::REGION_FILE;
+        }
+        else
+        {
+            chunks.clear();
+            loadingColumn.source = ColumnLoadingJob::Source::GENERATOR;
+            chunkGenerator_.GenerateColumn(0, chunkX, chunkZ, chunks);
+        }
+    }
+    loadingColumn.compressedColumn.clear();
+    loadingColumn.compressedColumn.shrink_to_fit();
+    //The chunks of the column are only written by this job, they are published one by one
+    for (auto& chunk : chunks)
+    {
+        const auto chunkId = chunk.chunkId;
+        loadingColumn.memoryUsage += CalculateChunkMemoryUsage(chunk);
+        loadingColumn.chunkIds.push_back(chunkId);
+        region_.SetChunk(chunkId, std::move(chunk));
+    }
+    completedColumns_.Push(&loadingColumn);
+}
+
+void VoxelManager::UpdatePendingColumns()
+{
+    pendingColumns_.clear();
+    for (int dx = -renderDistance_; dx <= renderDistance_; dx++)
+    {
+        for (int dz = -renderDistance_; dz <= renderDistance_; dz++)
+        {
+            const int chunkX = cameraColumn_.x + dx;
+            const int chunkZ = cameraColumn_.y + dz;
+            if (chunkX < 0 || chunkX >= int(regionSize) || chunkZ < 0 || chunkZ >= int(regionSize))
+            {
+                continue;
+            }
+            const auto columnIndex = GetColumnIndex(size_t(chunkX), size_t(chunkZ));
+            if (columns_[columnIndex].state == ColumnState::UNLOADED)
+            {
+                pendingColumns_.push_back(columnIndex);
+            }
+        }
+    }
+    std::sort(pendingColumns_.begin(), pendingColumns_.end(), [this](size_t columnIndex, size_t otherIndex)
+    {
+        return GetColumnSquareDistance(columnIndex) > GetColumnSquareDistance(otherIndex);
+    });
+}
+
+void VoxelManager::UnloadColumn(size_t columnIndex)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Unload Column");
+#endif
+    auto& column = columns_[columnIndex];
+    std::vector<const Chunk*> chunks;
+    chunks.reserve(column.chunkIds.size());
+    for (const auto chunkId : column.chunkIds)
+    {
+        chunks.push_back(region_.GetChunk(chunkId));
+    }
+    compressedColumns_.push_front({ {}, columnIndex });
+    auto& compressedColumn = compressedColumns_.front();
+    CompressColumn(chunks, compressedColumn.data);
+    compressedColumn.data.shrink_to_fit();
+    compressedMemoryUsage_ += compressedColumn.data.capacity();
+    compressedColumnsMap_[columnIndex] = compressedColumns_.begin();
+
+    for (const auto chunkId : column.chunkIds)
+    {
+        region_.UnloadChunk(chunkId);
+        unloadedChunks_.push_back(chunkId);
+    }
+    chunksMemoryUsage_ -= column.memoryUsage;
+    column.chunkIds.clear();
+    column.memoryUsage = 0;
+    column.state = ColumnState::UNLOADED;
+    const auto it = std::find(loadedColumns_.begin(), loadedColumns_.end(), columnIndex);
+    *it = loadedColumns_.back();
+    loadedColumns_.pop_back();
+    areChunksDirty_ = true;
+}
+
+void VoxelManager::TrimCompressedColumns()
+{
+    while (GetMemoryUsage() > memoryBudget_ && !compressedColumns_.empty())
+    {
+        const auto& leastRecentColumn = compressedColumns_.back();
+        compressedMemoryUsage_ -= leastRecentColumn.data.capacity();
+        compressedColumnsMap_.erase(leastRecentColumn.columnIndex);
+        compressedColumns_.pop_back();
+    }
+}
+
+void VoxelManager::ScheduleColumns()
+{
+    auto* engine = BasicEngine::GetInstance();
+    //A few columns in flight per worker keep the nearest columns first when the camera moves
+    const size_t maxLoadingColumnsNmb = size_t(engine->GetWorkersNumber()) * 2 + 1;
+    while (!pendingColumns_.empty() &&
+           loadingColumns_.size() < maxLoadingColumnsNmb &&
+           chunksMemoryUsage_ < memoryBudget_)
+    {
+        const auto columnIndex = pendingColumns_.back();
+        pendingColumns_.pop_back();
+        auto& column = columns_[columnIndex];
+        if (column.state != ColumnState::UNLOADED)
+        {
+            continue;
+        }
+        column.state = ColumnState::LOADING;
+        auto loadingColumn = std::make_unique<ColumnLoadingJob>();
+        loadingColumn->columnIndex = columnIndex;
+        auto* loadingColumnPtr = loadingColumn.get();
+        const auto compressedIt = compressedColumnsMap_.find(columnIndex);
+        if (compressedIt != compressedColumnsMap_.end())
+        {
+            compressedMemoryUsage_ -= compressedIt->second->data.capacity();
+            loadingColumn->compressedColumn = std::move(compressedIt->second->data);
+            compressedColumns_.erase(compressedIt->second);
+            compressedColumnsMap_.erase(compressedIt);
+        }
+        loadingColumn->loadingJob = std::make_unique<Job>([this, loadingColumnPtr]
+        {
+            LoadColumn(*loadingColumnPtr);
+        });
+        engine->ScheduleJob(loadingColumn->loadingJob.get(), JobThreadType::OTHER_THREAD);
+        loadingColumns_.push_back(std::move(loadingColumn));
+    }
+}
+
+void VoxelManager::CompressColumn(const std::vector<const Chunk*>& chunks, std::vector<std::uint8_t>& data)
+{
+    WriteUint16(data, static_cast<std::uint16_t>(chunks.size()));
+    for (const auto* chunk : chunks)
+    {
+        WriteUint16(data, chunk->chunkId);
+        if (chunk->contents == nullptr)
+        {
+            data.push_back(0u);
+            continue;
+        }
+        data.push_back(1u);
+        //The size of the chunk blob is written once it is known
+        const auto sizePos = data.size();
+        data.resize(sizePos + 2 * sizeof(std::uint16_t));
+        chunk->contents->Compress(data);
+        const auto blobSize = static_cast<std::uint32_t>(data.size() - sizePos - 2 * sizeof(std::uint16_t));
+        data[sizePos] = static_cast<std::uint8_t>(blobSize & 0xFFu);
+        data[sizePos + 1] = static_cast<std::uint8_t>((blobSize >> 8u) & 0xFFu);
+        data[sizePos + 2] = static_cast<std::uint8_t>((blobSize >> 16u) & 0xFFu);
+        data[sizePos + 3] = static_cast<std::uint8_t>(blobSize >> 24u);
+    }
+}
+
+bool VoxelManager::LoadColumnFromRegionFile(size_t columnIndex, std::vector<Chunk>& chunks) const
+{
+    if (!regionFile_.IsOpen())
+    {
+        return false;
+    }
+    const auto chunkX = columnIndex / regionSize;
+    const auto chunkZ = columnIndex % regionSize;
+    bool hasChunks = false;
+    for (size_t chunkY = 0; chunkY < regionHeight; chunkY++)
+    {
+        const auto chunkId = Region::GetChunkId(chunkX, chunkZ, chunkY);
+        if (!regionFile_.HasChunk(chunkId))
+        {
+            continue;
+        }
+        auto& chunk = chunks.emplace_back();
+        if (!regionFile_.LoadChunk(chunkId, chunk))
+        {
+            return false;
+        }
+        hasChunks = true;
+    }
+    return hasChunks;
+}
+
+bool VoxelManager::DecompressColumn(const std::vector<std::uint8_t>& data, std::vector<Chunk>& chunks)
+{
+    if (data.size() < sizeof(std::uint16_t))
+    {
+        return false;
+    }
+    const size_t chunksNmb = ReadUint16(data.data());
+    size_t dataIndex = sizeof(std::uint16_t);
+    for (size_t i = 0; i < chunksNmb; i++)
+    {
+        if (dataIndex + sizeof(std::uint16_t) + 1 > data.size())
+        {
+            return false;
+        }
+        auto& chunk = chunks.emplace_back();
+        chunk.chunkId = ReadUint16(&data[dataIndex]);
+        const bool hasContents = data[dataIndex + sizeof(std::uint16_t)] != 0;
+        dataIndex += sizeof(std::uint16_t) + 1;
+        if (!hasContents)
+        {
+            continue;
+        }
+        if (dataIndex + 2 * sizeof(std::uint16_t) > data.size())
+        {
+            return false;
+        }
+        const size_t blobSize = ReadUint16(&data[dataIndex]) | (size_t(ReadUint16(&data[dataIndex + 2])) << 16u);
+        dataIndex += 2 * sizeof(std::uint16_t);
+        if (dataIndex + blobSize > data.size())
+        {
+            return false;
+        }
+        chunk.contents = std::make_unique<ChunkContent>();
+        if (!chunk.contents->Decompress(&data[dataIndex], blobSize))
+        {
+            return false;
+        }
+        dataIndex += blobSize;
+    }
+    return dataIndex == data.size();
+}
 }
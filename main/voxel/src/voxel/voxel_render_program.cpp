@@ -25,6 +25,8 @@
 #include <gl/texture.h>
 #include "voxel/voxel_render_program.h"
 
+#include <algorithm>
+
 #include <imgui.h>
 
 #include "mathematics/vector.h"
@@ -46,8 +48,9 @@ void VoxelRenderProgram::Init()
     glEnable(GL_CULL_FACE);
 
     const auto& config = BasicEngine::GetInstance()->GetConfig();
-    cubeShader_.LoadFromFile(config.dataRootPath+"shaders/voxel/cube.vert",
-                             config.dataRootPath+"shaders/voxel/cube.frag");
+    chunkShader_.LoadFromFile(config.dataRootPath+"shaders/voxel/chunk.vert",
+                              config.dataRootPath+"shaders/voxel/chunk.frag");
+    chunkPositionUniform_ = chunkShader_.GetUniformHandle<Vec3f>("chunkPosition");
     skyboxShader_.LoadFromFile(
         config.dataRootPath + "shaders/voxel/skybox.vert", 
         config.dataRootPath + "shaders/voxel/skybox.frag");
@@ -119,14 +122,12 @@ void VoxelRenderProgram::Init()
                     {Vec3f(-0.5f, -0.5f, -0.5f), Vec2f(0.0f, 0.0f),Vertex::SIDE},
                     {Vec3f(-0.5f, 0.5f, -0.5f),  Vec2f(0.0f, 1.0f),Vertex::SIDE},
             };
-    GLuint cubeVbo = 0;
-
     glGenVertexArrays(1, &cubeVao_);
-    glGenBuffers(1, &cubeVbo);
+    glGenBuffers(1, &cubeVbo_);
     glBindVertexArray(cubeVao_);
 
     //Setup vertices
-    glBindBuffer(GL_ARRAY_BUFFER, cubeVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, cubeVbo_);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
     // position attribute
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), nullptr);
@@ -137,29 +138,11 @@ void VoxelRenderProgram::Init()
     //face type
     glVertexAttribIPointer(2, 1, GL_UNSIGNED_BYTE, sizeof(Vertex), (void*)offsetof(Vertex, faceType));
     glEnableVertexAttribArray(2);
+    glBindVertexArray(0);
 
-    //Initialize the instanced vbo
-    glGenBuffers(1, &instanceVbo_);
-    glBindBuffer(GL_ARRAY_BUFFER, instanceVbo_);
-    // region id attribute
-    glEnableVertexAttribArray(3);
-    glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(CubeRenderData), nullptr);
-    glVertexAttribDivisor(3, 1);
-    // chunk id attribute
-    glEnableVertexAttribArray(4);
-    glVertexAttribIPointer(4, 1, GL_UNSIGNED_SHORT, sizeof(CubeRenderData),
-                          (void*)offsetof(CubeRenderData, chunkId));
-    glVertexAttribDivisor(4, 1);
-    // cube id attribute
-    glEnableVertexAttribArray(5);
-    glVertexAttribIPointer(5, 1, GL_UNSIGNED_SHORT, sizeof(CubeRenderData),
-                          (void*)offsetof(CubeRenderData, cubeId));
-    glVertexAttribDivisor(5, 1);
-    // texture id attribute
-    glEnableVertexAttribArray(6);
-    glVertexAttribIPointer(6, 1, GL_UNSIGNED_INT, sizeof(CubeRenderData),
-                          (void*)offsetof(CubeRenderData, textureId));
-    glVertexAttribDivisor(6, 1);
+    glGenBuffers(1, &quadEbo_);
+    quadEboCapacity_ = 0;
+    uploadRingBuffer_.Init(uploadSegmentSize);
 }
 
 void VoxelRenderProgram::Update(seconds dt)
@@ -169,8 +152,22 @@ void VoxelRenderProgram::Update(seconds dt)
 
 void VoxelRenderProgram::Destroy()
 {
+    for (auto& [key, entry] : chunkMeshes_)
+    {
+        if (entry.meshingJob != nullptr && !entry.meshingJob->IsDone())
+        {
+            entry.meshingJob->Join();
+        }
+        glDeleteVertexArrays(1, &entry.vao);
+        glDeleteBuffers(1, &entry.vbo);
+    }
+    chunkMeshes_.clear();
+    glDeleteBuffers(1, &quadEbo_);
+    quadEboCapacity_ = 0;
+    uploadRingBuffer_.Destroy();
     glDeleteVertexArrays(1, &cubeVao_);
-    cubeShader_.Destroy();
+    glDeleteBuffers(1, &cubeVbo_);
+    chunkShader_.Destroy();
     skyboxShader_.Destroy();
     glDeleteTextures(1, &tilesheetTexture_);
     glDeleteTextures(1, &skyboxTexture_);
@@ -182,31 +179,62 @@ void VoxelRenderProgram::Render()
 #ifdef EASY_PROFILE_USE
     EASY_BLOCK("Voxel Render");
 #endif
-    cubeShader_.Bind();
-    cubeShader_.SetTexture("tilesheet", tilesheetTexture_);
+    //Meshes of unloaded chunks are kept until their meshing job is done
+    const auto removedEnd = std::remove_if(removedChunks_.begin(), removedChunks_.end(), [this](std::uint64_t chunkKey)
+    {
+        const auto it = chunkMeshes_.find(chunkKey);
+        if (it == chunkMeshes_.end())
+        {
+            return true;
+        }
+        auto& entry = it->second;
+        if (entry.meshingJob != nullptr && !entry.meshingJob->IsDone())
+        {
+            return false;
+        }
+        if (entry.vao != 0)
+        {
+            glDeleteVertexArrays(1, &entry.vao);
+            glDeleteBuffers(1, &entry.vbo);
+        }
+        chunkMeshes_.erase(it);
+        return true;
+    });
+    removedChunks_.erase(removedEnd, removedChunks_.end());
+    uploadRingBuffer_.BeginFrame();
+    chunkShader_.Bind();
+    chunkShader_.SetTexture("tilesheet", tilesheetTexture_);
     // set view and proj matrix
     const auto view = camera3D_.GenerateViewMatrix();
     const auto projection = camera3D_.GenerateProjectionMatrix();
-    cubeShader_.SetMat4("view", view);
-    cubeShader_.SetMat4("proj", projection);
-    for (size_t chunk = 0; chunk < renderData_.size() / instanceChunkSize_ + 1; chunk++)
+    chunkShader_.SetMat4("view", view);
+    chunkShader_.SetMat4("proj", projection);
+    verticesNmb_ = 0;
+    for (const auto& renderData : renderData_)
     {
 #ifdef EASY_PROFILE_USE
         EASY_BLOCK("Chunk Render");
 #endif
-        const size_t chunkBeginIndex = chunk * instanceChunkSize_ ;
-        const size_t chunkEndIndex = std::min(renderData_.size() , (chunk + 1) * instanceChunkSize_ );
-        if (chunkEndIndex > chunkBeginIndex)
+        auto& entry = chunkMeshes_[GetChunkKey(renderData.regionId, renderData.chunkId)];
+        if (entry.meshingJob != nullptr &&
+            entry.uploadedVersion != entry.meshingVersion &&
+            entry.meshingJob->IsDone())
         {
-            const size_t tmpChunkSize = chunkEndIndex-chunkBeginIndex;
-            glBindBuffer(GL_ARRAY_BUFFER, instanceVbo_);
-            glBufferData(GL_ARRAY_BUFFER, sizeof(CubeRenderData) * tmpChunkSize, &renderData_[chunkBeginIndex], GL_DYNAMIC_DRAW);
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-            glBindVertexArray(cubeVao_);
-            glDrawArraysInstanced(GL_TRIANGLES, 0, cubeVerticesNmb, tmpChunkSize);
+            UploadChunkMesh(entry);
         }
+        //The previous mesh is drawn until the new one is uploaded
+        if (entry.indicesNmb == 0)
+        {
+            continue;
+        }
+        chunkShader_.SetUniform(chunkPositionUniform_, GetChunkPosition(renderData.chunkId));
+        glBindVertexArray(entry.vao);
+        glDrawElements(GL_TRIANGLES, entry.indicesNmb, GL_UNSIGNED_INT, nullptr);
+        verticesNmb_ += size_t(entry.indicesNmb) / ChunkMesh::quadIndicesNmb * ChunkMesh::quadVerticesNmb;
     }
+    uploadRingBuffer_.EndFrame();
+    uploadedBytes_ = uploadRingBuffer_.GetFrameUploadedBytes();
+    peakUploadedBytes_ = std::max(peakUploadedBytes_, uploadedBytes_);
     //Draw skybox
     glDepthFunc(GL_LEQUAL);
     glDisable(GL_CULL_FACE);
@@ -220,43 +248,96 @@ void VoxelRenderProgram::Render()
     glDepthFunc(GL_LESS);
 }
 
-void VoxelRenderProgram::AddChunk(const Chunk& chunk, RegionId regionId)
+bool VoxelRenderProgram::UploadChunkMesh(ChunkMeshEntry& entry)
 {
-    if(!(chunk.flag & Chunk::IS_VISIBLE))
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Upload Chunk Mesh");
+#endif
+    const auto quadsNmb = entry.mesh.GetQuadsNmb();
+    const auto verticesSize = entry.mesh.vertices.size() * sizeof(ChunkVertex);
+    glBindVertexArray(0);
+    if (quadsNmb > quadEboCapacity_)
     {
-        return;   
+        std::vector<std::uint32_t> indices;
+        indices.reserve(quadsNmb * ChunkMesh::quadIndicesNmb);
+        for (std::uint32_t quad = 0; quad < quadsNmb; quad++)
+        {
+            const auto first = quad * std::uint32_t(ChunkMesh::quadVerticesNmb);
+            for (const auto index : {0u, 1u, 2u, 2u, 3u, 0u})
+            {
+                indices.push_back(first + index);
+            }
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadEbo_);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(std::uint32_t), indices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        quadEboCapacity_ = quadsNmb;
     }
-    if (chunk.contents == nullptr)
+    if (entry.vao == 0)
     {
-        return;
+        glGenVertexArrays(1, &entry.vao);
+        glGenBuffers(1, &entry.vbo);
+        glBindVertexArray(entry.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, entry.vbo);
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_BYTE, GL_FALSE, sizeof(ChunkVertex),
+                              (void*)offsetof(ChunkVertex, position));
+        glEnableVertexAttribArray(0);
+        glVertexAttribIPointer(1, 1, GL_UNSIGNED_BYTE, sizeof(ChunkVertex),
+                               (void*)offsetof(ChunkVertex, faceType));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(2, 2, GL_UNSIGNED_BYTE, GL_FALSE, sizeof(ChunkVertex),
+                              (void*)offsetof(ChunkVertex, texCoordU));
+        glEnableVertexAttribArray(2);
+        glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(ChunkVertex),
+                               (void*)offsetof(ChunkVertex, textureId));
+        glEnableVertexAttribArray(3);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadEbo_);
+        glBindVertexArray(0);
+    }
+    //Checked before the storage is specified again, the previous mesh is drawn until the next frame
+    if (!uploadRingBuffer_.CanUpload(verticesSize))
+    {
+        return false;
+    }
+    //The storage of the vertex buffer is only specified again when the mesh grows
+    if (verticesSize > entry.vboCapacity)
+    {
+        entry.vboCapacity = verticesSize + verticesSize / 2;
+        glBindBuffer(GL_ARRAY_BUFFER, entry.vbo);
+        glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(entry.vboCapacity), nullptr, GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        //The previous mesh is gone with the old storage
+        entry.indicesNmb = 0;
+    }
+    if (!uploadRingBuffer_.Upload(entry.vbo, 0, entry.mesh.vertices.data(), verticesSize))
+    {
+        return false;
     }
+    entry.indicesNmb = GLsizei(quadsNmb * ChunkMesh::quadIndicesNmb);
+    entry.uploadedVersion = entry.meshingVersion;
+    //The vertices live on the GPU now
+    entry.mesh.vertices.clear();
+    entry.mesh.vertices.shrink_to_fit();
+    entry.meshingContent.Fill(CubeType::NONE);
+    return true;
+}
 
-    const auto chunkY = chunk.chunkId % regionHeight;
-    const auto chunkX = chunk.chunkId / regionHeight / regionSize;
-    const auto chunkZ = (chunk.chunkId - chunkX * regionHeight * regionSize) / regionHeight;
-    const float chunkLength = float(chunkSize);
-    const Vec3f chunkPos = Vec3f(
-            float(chunkX) * chunkLength - float(regionSize) * 0.5f * chunkLength,
-            float(chunkY) * chunkLength - float(regionHeight) * 0.5f * chunkLength,
-            float(chunkZ) * chunkLength - float(regionSize) * 0.5f * chunkLength);
-    if(!frustum_.Contains(chunkPos, regionId))
+void VoxelRenderProgram::AddChunk(const Chunk& chunk, RegionId regionId)
+{
+    if(!(chunk.flag & Chunk::IS_VISIBLE))
     {
-        return;
+        return;   
     }
-    for(const auto cubeId : chunk.visibleCubes)
+    if (chunk.contents == nullptr)
     {
-        const auto cubePosition = Cube::CalculateCubePosition(cubeId);
-        const auto& cube = (*chunk.contents)[cubePosition.x][cubePosition.z][cubePosition.y];
-        if(frustum_.Contains(cube, chunkPos, regionId))
-        {
-            currentRenderData_.push_back({ regionId, chunk.chunkId, cubeId, cube.cubeTextureId });
-        };
+        return;
     }
+    currentRenderData_.push_back({ regionId, chunk.chunkId, chunk.version, &chunk });
 }
 
-void VoxelRenderProgram::AddCube(const Cube& cube, ChunkId chunkId, RegionId regionId)
+void VoxelRenderProgram::RemoveChunk(ChunkId chunkId, RegionId regionId)
 {
-    currentRenderData_.push_back({regionId, chunkId, cube.cubeId, cube.cubeTextureId});
+    currentRemovedChunks_.push_back(GetChunkKey(regionId, chunkId));
 }
 
 void VoxelRenderProgram::SyncBuffers()
@@ -267,20 +348,61 @@ void VoxelRenderProgram::SyncBuffers()
     std::swap(renderData_, currentRenderData_);
     std::swap(camera3D_, currentCamera3D_);
     currentRenderData_.clear();
+    removedChunks_.insert(removedChunks_.end(), currentRemovedChunks_.cbegin(), currentRemovedChunks_.cend());
+    currentRemovedChunks_.clear();
+    //Only new or changed chunks are meshed, a chunk being meshed waits for its current job
+    for (const auto& renderData : renderData_)
+    {
+        auto& entry = chunkMeshes_[GetChunkKey(renderData.regionId, renderData.chunkId)];
+        if (entry.meshingVersion == renderData.version)
+        {
+            continue;
+        }
+        if (entry.meshingJob != nullptr && !entry.meshingJob->IsDone())
+        {
+            continue;
+        }
+        entry.meshingVersion = renderData.version;
+        entry.meshingContent = *renderData.chunk->contents;
+        entry.meshingJob = std::make_unique<Job>([&entry]
+        {
+            ChunkMesher chunkMesher;
+            chunkMesher.GenerateMesh(entry.meshingContent, entry.mesh);
+        });
+        BasicEngine::GetInstance()->ScheduleJob(entry.meshingJob.get(), JobThreadType::OTHER_THREAD);
+    }
 }
 
 void VoxelRenderProgram::DrawImGui()
 {
     ImGui::Begin("Voxel Render Program");
-    ImGui::Text("Cubes: %u", renderData_.size());
+    ImGui::Text("Chunks: %zu", renderData_.size());
+    ImGui::Text("Vertices: %zu", verticesNmb_);
+    ImGui::Text("Cached chunk meshes: %zu", chunkMeshes_.size());
+    ImGui::Text("Uploaded: %zu bytes (peak %zu bytes)", uploadedBytes_, peakUploadedBytes_);
     ImGui::End();
 }
 
+std::uint64_t VoxelRenderProgram::GetChunkKey(RegionId regionId, ChunkId chunkId)
+{
+    return (std::uint64_t(regionId) << 16u) | chunkId;
+}
+
+Vec3f VoxelRenderProgram::GetChunkPosition(ChunkId chunkId)
+{
+    return Region::GetChunkAabb(chunkId).lowerLeftBound;
+}
+
 void VoxelRenderProgram::SetCurrentCamera(const Camera3D& camera)
 {
     currentCamera3D_ = camera;
     frustum_.SetCamera(camera);
 }
 
+const Frustum& VoxelRenderProgram::GetFrustum() const
+{
+    return frustum_;
+}
+
 
 }
\ No newline at end of file
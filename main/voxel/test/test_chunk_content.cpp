@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "voxel/chunk.h"
+
+namespace neko::voxel
+{
+
+TEST(Voxel, ChunkContentUniform)
+{
+    ChunkContent emptyContent;
+    EXPECT_TRUE(emptyContent.IsUniform());
+    EXPECT_EQ(CubeType::NONE, emptyContent.GetCubeType(Vec3b(31, 31, 31)));
+    emptyContent.SetCubeType(Vec3b(1, 2, 3), CubeType::NONE);
+    EXPECT_TRUE(emptyContent.IsUniform());
+
+    ChunkContent solidContent(CubeType::ROCK);
+    EXPECT_TRUE(solidContent.IsUniform());
+    EXPECT_TRUE(solidContent.HasCube(Vec3b(0, 0, 0)));
+    EXPECT_EQ(CubeType::ROCK, solidContent.GetCubeType(Vec3b(5, 6, 7)));
+    EXPECT_LT(solidContent.GetMemoryUsage(), 128u);
+}
+
+TEST(Voxel, ChunkContentPalette)
+{
+    ChunkContent chunkContent;
+    std::vector<CubeType> expectedCubes(ChunkContent::cubesNmb, CubeType::NONE);
+    const auto cubeTypesNmb = static_cast<size_t>(CubeType::LENGTH);
+    //Every new cube type can grow the bits per index, the previous cubes must be kept
+    for (CubeId cubeId = 0; cubeId < ChunkContent::cubesNmb; cubeId += 7)
+    {
+        const auto cubeType = static_cast<CubeType>((cubeId / 7) % cubeTypesNmb);
+        chunkContent.SetCubeType(cubeId, cubeType);
+        expectedCubes[cubeId] = cubeType;
+    }
+    EXPECT_EQ(cubeTypesNmb, chunkContent.GetPaletteSize());
+    EXPECT_EQ(4u, chunkContent.GetBitsPerIndex());
+    for (size_t x = 0; x < chunkSize; x++)
+    {
+        for (size_t y = 0; y < chunkSize; y++)
+        {
+            for (size_t z = 0; z < chunkSize; z++)
+            {
+                const auto cubeId = Cube::CalculateCubeId(Vec3b(x, y, z));
+                EXPECT_EQ(expectedCubes[cubeId], chunkContent.GetCubeType(Vec3b(x, y, z)));
+            }
+        }
+    }
+    //4 bits per cube instead of a dense array of Cube
+    EXPECT_LT(chunkContent.GetMemoryUsage(), ChunkContent::cubesNmb / 2u + 256u);
+
+    chunkContent.Fill(CubeType::NONE);
+    EXPECT_TRUE(chunkContent.IsUniform());
+    EXPECT_FALSE(chunkContent.HasCube(Vec3b(0, 0, 0)));
+}
+
+TEST(Voxel, ChunkContentBitsPerIndex)
+{
+    ChunkContent chunkContent;
+    chunkContent.SetCubeType(Vec3b(0, 0, 0), CubeType::GRASS);
+    EXPECT_EQ(1u, chunkContent.GetBitsPerIndex());
+    chunkContent.SetCubeType(Vec3b(31, 0, 0), CubeType::ROCK);
+    EXPECT_EQ(2u, chunkContent.GetBitsPerIndex());
+    chunkContent.SetCubeType(Vec3b(0, 31, 0), CubeType::DIRT);
+    EXPECT_EQ(2u, chunkContent.GetBitsPerIndex());
+    chunkContent.SetCubeType(Vec3b(0, 0, 31), CubeType::SNOW);
+    EXPECT_EQ(4u, chunkContent.GetBitsPerIndex());
+    EXPECT_EQ(CubeType::GRASS, chunkContent.GetCubeType(Vec3b(0, 0, 0)));
+    EXPECT_EQ(CubeType::ROCK, chunkContent.GetCubeType(Vec3b(31, 0, 0)));
+    EXPECT_EQ(CubeType::DIRT, chunkContent.GetCubeType(Vec3b(0, 31, 0)));
+    EXPECT_EQ(CubeType::SNOW, chunkContent.GetCubeType(Vec3b(0, 0, 31)));
+    EXPECT_EQ(CubeType::NONE, chunkContent.GetCubeType(Vec3b(1, 1, 1)));
+}
+
+TEST(Voxel, ChunkContentCompress)
+{
+    ChunkContent chunkContent;
+    std::vector<std::uint8_t> blob;
+    chunkContent.Compress(blob);
+    ChunkContent decompressedContent(CubeType::ROCK);
+    ASSERT_TRUE(decompressedContent.Decompress(blob.data(), blob.size()));
+    EXPECT_TRUE(decompressedContent.IsUniform());
+    EXPECT_EQ(CubeType::NONE, decompressedContent.GetCubeType(CubeId(0)));
+
+    //A terrain like content, the air above the ground gives runs of identical index words
+    for (size_t x = 0; x < chunkSize; x++)
+    {
+        for (size_t z = 0; z < chunkSize; z++)
+        {
+            const auto height = x % 8;
+            for (size_t y = 0; y < height; y++)
+            {
+                chunkContent.SetCubeType(Vec3b(x, y, z), y + 1 == height ? CubeType::GRASS : CubeType::DIRT);
+            }
+        }
+    }
+    blob.clear();
+    chunkContent.Compress(blob);
+    EXPECT_LT(blob.size(), chunkContent.GetMemoryUsage());
+    ASSERT_TRUE(decompressedContent.Decompress(blob.data(), blob.size()));
+    EXPECT_EQ(chunkContent.GetBitsPerIndex(), decompressedContent.GetBitsPerIndex());
+    for (CubeId cubeId = 0; cubeId < ChunkContent::cubesNmb; cubeId++)
+    {
+        ASSERT_EQ(chunkContent.GetCubeType(cubeId), decompressedContent.GetCubeType(cubeId));
+    }
+    EXPECT_FALSE(decompressedContent.Decompress(blob.data(), blob.size() - 1));
+}
+
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <PerlinNoise.hpp>
+
+#include "voxel/chunk_generator.h"
+#include "voxel/perlin_noise.h"
+
+namespace neko::voxel
+{
+
+TEST(Voxel, BatchPerlinNoiseSameAsScalar)
+{
+    const siv::PerlinNoise scalarNoise{};
+    const BatchPerlinNoise batchNoise{};
+    const std::int32_t octaves = 5;
+    //Not a multiple of the batch size to go through the remaining samples
+    const size_t samplesNmb = 1'001;
+    std::vector<double> xs(samplesNmb);
+    std::vector<double> ys(samplesNmb);
+    std::vector<double> results(samplesNmb);
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> distribution(-300.0, 300.0);
+    for (size_t i = 0; i < samplesNmb; i++)
+    {
+        xs[i] = distribution(generator);
+        ys[i] = distribution(generator);
+    }
+    batchNoise.NormalizedOctaveNoise2D01(xs.data(), ys.data(), results.data(), samplesNmb, octaves);
+    for (size_t i = 0; i < samplesNmb; i++)
+    {
+        const auto expected = scalarNoise.normalizedOctaveNoise2D_0_1(xs[i], ys[i], octaves);
+        EXPECT_EQ(expected, results[i]);
+        EXPECT_DOUBLE_EQ(results[i], batchNoise.NormalizedOctaveNoise2D01(xs[i], ys[i], octaves));
+    }
+}
+
+TEST(Voxel, ChunkGeneratorColumnHeights)
+{
+    ChunkGenerator chunkGenerator;
+    const size_t chunkX = regionSize / 2;
+    const size_t chunkZ = regionSize / 2 + 1;
+    const auto& heights = chunkGenerator.GetColumnHeights(0, chunkX, chunkZ);
+    //The second query is served by the cache
+    EXPECT_EQ(&heights, &chunkGenerator.GetColumnHeights(0, chunkX, chunkZ));
+    ColumnHeights uncachedHeights{};
+    chunkGenerator.CalculateColumnHeights(0, chunkX, chunkZ, uncachedHeights);
+    EXPECT_EQ(uncachedHeights, heights);
+    for (size_t cubeX = 0; cubeX < chunkSize; cubeX++)
+    {
+        for (size_t cubeZ = 0; cubeZ < chunkSize; cubeZ++)
+        {
+            const Vec2u cubePos(unsigned(chunkX * chunkSize + cubeX), unsigned(chunkZ * chunkSize + cubeZ));
+            EXPECT_EQ(heights[cubeX * chunkSize + cubeZ], chunkGenerator.GetHeight(0, cubePos));
+        }
+    }
+}
+
+TEST(Voxel, ChunkGeneratorSameHeightsAsScalarNoise)
+{
+    //The heights of the generator before the batch noise, with one scalar noise per cube
+    const siv::PerlinNoise scalarNoise{};
+    ChunkGenerator chunkGenerator;
+    for (const auto& column : { Vec2u(0, 0), Vec2u(regionSize / 2, regionSize / 2 + 1), Vec2u(regionSize - 1, 3) })
+    {
+        ColumnHeights heights{};
+        chunkGenerator.CalculateColumnHeights(0, column.x, column.y, heights);
+        for (size_t cubeX = 0; cubeX < chunkSize; cubeX++)
+        {
+            for (size_t cubeZ = 0; cubeZ < chunkSize; cubeZ++)
+            {
+                const double voxelX = (static_cast<double>(column.x * chunkSize + cubeX) -
+                    ChunkGenerator::regionWidthFloat / 2.0) / ChunkGenerator::regionWidthFloat * ChunkGenerator::scale;
+                const double voxelZ = (static_cast<double>(column.y * chunkSize + cubeZ) -
+                    ChunkGenerator::regionWidthFloat / 2.0) / ChunkGenerator::regionWidthFloat * ChunkGenerator::scale;
+                const auto height = std::pow(
+                    scalarNoise.normalizedOctaveNoise2D_0_1(voxelX, voxelZ, ChunkGenerator::octave),
+                    ChunkGenerator::elevetionPow);
+                EXPECT_EQ(static_cast<std::uint16_t>(ChunkGenerator::maxHeight * height),
+                    heights[cubeX * chunkSize + cubeZ]);
+            }
+        }
+    }
+}
+
+TEST(Voxel, ChunkGeneratorSurface)
+{
+    ChunkGenerator chunkGenerator;
+    const size_t chunkX = regionSize / 2;
+    const size_t chunkZ = regionSize / 2;
+    const auto& heights = chunkGenerator.GetColumnHeights(0, chunkX, chunkZ);
+    const auto chunkY = heights.front() / chunkSize;
+    const auto chunk = chunkGenerator.GenerateChunk(0, Region::GetChunkId(chunkX, chunkZ, chunkY));
+    ASSERT_NE(nullptr, chunk.contents);
+    for (size_t cubeX = 0; cubeX < chunkSize; cubeX++)
+    {
+        for (size_t cubeZ = 0; cubeZ < chunkSize; cubeZ++)
+        {
+            const size_t height = heights[cubeX * chunkSize + cubeZ];
+            if (height / chunkSize != chunkY)
+                continue;
+            const Vec3b cubePos(cubeX, height % chunkSize, cubeZ);
+            EXPECT_EQ(CubeType::GRASS, chunk.contents->GetCubeType(cubePos));
+            if (height % chunkSize + 1 < chunkSize)
+            {
+                EXPECT_FALSE(chunk.contents->HasCube(cubePos + Vec3b(0, 1, 0)));
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <functional>
+
+#include "voxel/chunk_generator.h"
+#include "voxel/chunk_mesher.h"
+
+namespace neko::voxel
+{
+
+namespace
+{
+Chunk GenerateTestChunk(const std::function<CubeType(size_t x, size_t y, size_t z)>& cubeTypeFunc)
+{
+    Chunk chunk;
+    chunk.flag = Chunk::IS_VISIBLE;
+    chunk.contents = std::make_unique<ChunkContent>();
+    for (size_t x = 0; x < chunkSize; x++)
+    {
+        for (size_t z = 0; z < chunkSize; z++)
+        {
+            for (size_t y = 0; y < chunkSize; y++)
+            {
+                const auto cubeType = cubeTypeFunc(x, y, z);
+                if (cubeType == CubeType::NONE)
+                {
+                    continue;
+                }
+                const auto cubeId = Cube::CalculateCubeId(Vec3b(x, y, z));
+                chunk.contents->SetCubeType(cubeId, cubeType);
+                chunk.visibleCubes.push_back(cubeId);
+            }
+        }
+    }
+    return chunk;
+}
+
+size_t GetMeshVerticesNmb(const Chunk& chunk)
+{
+    ChunkMesher chunkMesher;
+    ChunkMesh chunkMesh;
+    chunkMesher.GenerateMesh(chunk, chunkMesh);
+    return chunkMesh.vertices.size();
+}
+}
+
+TEST(Voxel, ChunkMesherGoldenVerticesNmb)
+{
+    const Chunk emptyChunk;
+    EXPECT_EQ(0u, GetMeshVerticesNmb(emptyChunk));
+
+    const auto singleCube = GenerateTestChunk([](size_t x, size_t y, size_t z)
+    {
+        return x == 3 && y == 4 && z == 5 ? CubeType::GRASS : CubeType::NONE;
+    });
+    EXPECT_EQ(6u * 4u, GetMeshVerticesNmb(singleCube));
+
+    //Hidden face between the two cubes is removed, the other faces are merged
+    const auto twoCubes = GenerateTestChunk([](size_t x, size_t y, size_t z)
+    {
+        return (x == 3 || x == 4) && y == 4 && z == 5 ? CubeType::GRASS : CubeType::NONE;
+    });
+    EXPECT_EQ(6u * 4u, GetMeshVerticesNmb(twoCubes));
+
+    const auto twoTextures = GenerateTestChunk([](size_t x, size_t y, size_t z)
+    {
+        if (y != 4 || z != 5)
+            return CubeType::NONE;
+        return x == 3 ? CubeType::GRASS : x == 4 ? CubeType::ROCK : CubeType::NONE;
+    });
+    EXPECT_EQ(10u * 4u, GetMeshVerticesNmb(twoTextures));
+
+    const auto floor = GenerateTestChunk([](size_t, size_t y, size_t)
+    {
+        return y == 0 ? CubeType::GRASS : CubeType::NONE;
+    });
+    EXPECT_EQ(6u * 4u, GetMeshVerticesNmb(floor));
+
+    const auto fullChunk = GenerateTestChunk([](size_t, size_t, size_t)
+    {
+        return CubeType::ROCK;
+    });
+    EXPECT_EQ(6u * 4u, GetMeshVerticesNmb(fullChunk));
+
+    const auto halfChunks = GenerateTestChunk([](size_t x, size_t, size_t)
+    {
+        return x < chunkSize / 2 ? CubeType::ROCK : CubeType::DIRT;
+    });
+    EXPECT_EQ(10u * 4u, GetMeshVerticesNmb(halfChunks));
+
+    //Worst case, no face can be hidden or merged
+    const auto checkerboard = GenerateTestChunk([](size_t x, size_t y, size_t z)
+    {
+        return (x + y + z) % 2 == 0 ? CubeType::BRICK : CubeType::NONE;
+    });
+    EXPECT_EQ(chunkSize * chunkSize * chunkSize / 2u * 6u * 4u, GetMeshVerticesNmb(checkerboard));
+}
+
+TEST(Voxel, ChunkMesherWinding)
+{
+    const auto singleCube = GenerateTestChunk([](size_t x, size_t y, size_t z)
+    {
+        return x == 0 && y == 0 && z == 0 ? CubeType::GRASS : CubeType::NONE;
+    });
+    ChunkMesher chunkMesher;
+    ChunkMesh chunkMesh;
+    chunkMesher.GenerateMesh(singleCube, chunkMesh);
+    ASSERT_EQ(6u, chunkMesh.GetQuadsNmb());
+    const auto center = Vec3f(0.5f, 0.5f, 0.5f);
+    for (size_t quad = 0; quad < chunkMesh.GetQuadsNmb(); quad++)
+    {
+        const auto* vertices = &chunkMesh.vertices[quad * ChunkMesh::quadVerticesNmb];
+        const auto toVec3f = [](Vec3b v) { return Vec3f(float(v.x), float(v.y), float(v.z)); };
+        const auto p0 = toVec3f(vertices[0].position);
+        const auto normal = Vec3f::Cross(toVec3f(vertices[1].position) - p0, toVec3f(vertices[2].position) - p0);
+        //Counter-clockwise seen from outside of the cube
+        EXPECT_GT(Vec3f::Dot(normal, p0 - center), 0.0f);
+        EXPECT_EQ(normal.y > 0.0f ? ChunkVertex::TOP : normal.y < 0.0f ? ChunkVertex::BOTTOM : ChunkVertex::SIDE,
+                  vertices[0].faceType);
+    }
+}
+
+TEST(Voxel, ChunkMesherGeneratedChunk)
+{
+    ChunkGenerator chunkGenerator;
+    const auto chunkX = regionSize / 2;
+    const auto chunkZ = regionSize / 2;
+    const auto height = chunkGenerator.GetHeight(0, Vec2u(chunkX * chunkSize, chunkZ * chunkSize));
+    const auto chunk = chunkGenerator.GenerateChunk(0, Region::GetChunkId(chunkX, chunkZ, height / chunkSize));
+    ASSERT_FALSE(chunk.visibleCubes.empty());
+    const size_t instancedVerticesNmb = chunk.visibleCubes.size() * 36u;
+    const auto meshVerticesNmb = GetMeshVerticesNmb(chunk);
+    EXPECT_GT(meshVerticesNmb, 0u);
+    EXPECT_LT(meshVerticesNmb * 4u, instancedVerticesNmb);
+}
+
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "voxel/chunk_quadtree.h"
+#include "voxel/frustum.h"
+
+namespace neko::voxel
+{
+
+namespace
+{
+std::vector<Chunk> CreateRegionChunks()
+{
+    std::vector<Chunk> chunks(regionSize * regionSize * regionHeight);
+    for (size_t i = 0; i < chunks.size(); i++)
+    {
+        chunks[i].chunkId = ChunkId(i);
+    }
+    return chunks;
+}
+
+Camera3D CreateCamera(const Vec3f& position, const Vec3f& target)
+{
+    Camera3D camera;
+    camera.position = position;
+    camera.WorldLookAt(target);
+    camera.farPlane = 500.0f;
+    camera.fovY = degree_t(45.0f / 2.0f);
+    camera.SetAspect(1280, 720);
+    return camera;
+}
+}
+
+TEST(Voxel, FrustumFourAabbs)
+{
+    Frustum frustum;
+    frustum.SetCamera(CreateCamera(Vec3f(0.0f, 10.0f, 0.0f), Vec3f(100.0f, 0.0f, 30.0f)));
+    std::default_random_engine generator(42);
+    std::uniform_real_distribution<float> positionDistribution(-600.0f, 600.0f);
+    std::uniform_real_distribution<float> sizeDistribution(0.5f, 200.0f);
+    for (int i = 0; i < 1024; i++)
+    {
+        FourAabb3d aabbs;
+        std::array<FrustumTest, 4> expectedResults{};
+        for (size_t j = 0; j < 4; j++)
+        {
+            Aabb3d aabb;
+            aabb.lowerLeftBound = Vec3f(positionDistribution(generator), positionDistribution(generator) / 4.0f,
+                                        positionDistribution(generator));
+            aabb.upperRightBound = aabb.lowerLeftBound + Vec3f(sizeDistribution(generator),
+                sizeDistribution(generator), sizeDistribution(generator));
+            aabbs.Set(j, aabb);
+            expectedResults[j] = frustum.Test(aabb);
+        }
+        const auto masks = frustum.Test(aabbs);
+        for (size_t j = 0; j < 4; j++)
+        {
+            EXPECT_EQ(expectedResults[j] != FrustumTest::OUTSIDE, bool(masks.visible & (1u << j)));
+            EXPECT_EQ(expectedResults[j] == FrustumTest::INSIDE, bool(masks.inside & (1u << j)));
+        }
+    }
+}
+
+TEST(Voxel, FrustumPlanes)
+{
+    Frustum frustum;
+    const auto camera = CreateCamera(Vec3f::zero, Vec3f(0.0f, 0.0f, 100.0f));
+    frustum.SetCamera(camera);
+    Aabb3d inside;
+    inside.FromCenterExtends(Vec3f(0.0f, 0.0f, 50.0f), Vec3f::one);
+    EXPECT_EQ(FrustumTest::INSIDE, frustum.Test(inside));
+    Aabb3d behind;
+    behind.FromCenterExtends(Vec3f(0.0f, 0.0f, -50.0f), Vec3f::one);
+    EXPECT_EQ(FrustumTest::OUTSIDE, frustum.Test(behind));
+    Aabb3d tooFar;
+    tooFar.FromCenterExtends(Vec3f(0.0f, 0.0f, camera.farPlane + 10.0f), Vec3f::one);
+    EXPECT_EQ(FrustumTest::OUTSIDE, frustum.Test(tooFar));
+    Aabb3d onFarPlane;
+    onFarPlane.FromCenterExtends(Vec3f(0.0f, 0.0f, camera.farPlane), Vec3f::one);
+    EXPECT_EQ(FrustumTest::INTERSECT, frustum.Test(onFarPlane));
+    Aabb3d aside;
+    aside.FromCenterExtends(Vec3f(200.0f, 0.0f, 50.0f), Vec3f::one);
+    EXPECT_EQ(FrustumTest::OUTSIDE, frustum.Test(aside));
+}
+
+TEST(Voxel, ChunkAabbCoversMesh)
+{
+    //The mesh vertices are on the corners of the cubes, the cubes are centered on their position
+    const auto firstCubeCenter = Vec3f(
+            -float(regionSize) * 0.5f * float(chunkSize),
+            -float(regionHeight) * 0.5f * float(chunkSize),
+            -float(regionSize) * 0.5f * float(chunkSize));
+    const auto aabb = Region::GetChunkAabb(0);
+    EXPECT_EQ(aabb.lowerLeftBound, firstCubeCenter - Vec3f::one * 0.5f);
+    EXPECT_EQ(aabb.upperRightBound, firstCubeCenter + Vec3f::one * (float(chunkSize) - 0.5f));
+}
+
+TEST(Voxel, ChunkQuadtreeCulling)
+{
+    const auto chunks = CreateRegionChunks();
+    std::vector<const Chunk*> chunkPtrs;
+    for (const auto& chunk : chunks)
+    {
+        //Holes in the region, some columns are missing
+        if ((chunk.chunkId / regionHeight) % 7 != 3)
+        {
+            chunkPtrs.push_back(&chunk);
+        }
+    }
+    ChunkQuadtree chunkQuadtree;
+    chunkQuadtree.Build(chunkPtrs);
+    EXPECT_EQ(chunkPtrs.size(), chunkQuadtree.GetChunksNmb());
+
+    const std::array<Vec3f, 4> targets = {
+        Vec3f(100.0f, 0.0f, 0.0f), Vec3f(-30.0f, -100.0f, 20.0f),
+        Vec3f(10.0f, 20.0f, -100.0f), Vec3f(-100.0f, 5.0f, 100.0f)};
+    for (const auto& target : targets)
+    {
+        Frustum frustum;
+        frustum.SetCamera(CreateCamera(Vec3f(5.0f, 20.0f, -3.0f), target));
+        std::vector<const Chunk*> visibleChunks;
+        chunkQuadtree.Cull(frustum, visibleChunks);
+        std::vector<const Chunk*> expectedChunks;
+        for (const auto* chunk : chunkPtrs)
+        {
+            if (frustum.Test(Region::GetChunkAabb(chunk->chunkId)) != FrustumTest::OUTSIDE)
+            {
+                expectedChunks.push_back(chunk);
+            }
+        }
+        EXPECT_GT(expectedChunks.size(), 0u);
+        EXPECT_LT(expectedChunks.size(), chunkPtrs.size());
+        std::sort(visibleChunks.begin(), visibleChunks.end());
+        std::sort(expectedChunks.begin(), expectedChunks.end());
+        EXPECT_EQ(expectedChunks, visibleChunks);
+    }
+}
+
+}
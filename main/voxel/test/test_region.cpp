@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "engine/jobsystem.h"
+#include "voxel/region.h"
+
+namespace neko::voxel
+{
+
+namespace
+{
+struct ChunkCompletion
+{
+    ChunkId chunkId = 0;
+    size_t producer = 0;
+    ChunkCompletion* next = nullptr;
+};
+
+CubeType GetChunkCubeType(ChunkId chunkId)
+{
+    return static_cast<CubeType>(1 + chunkId % (static_cast<size_t>(CubeType::LENGTH) - 1));
+}
+}
+
+TEST(Voxel, RegionConcurrentSetChunk)
+{
+    Region region;
+    region.Init();
+    const size_t producersNmb = 16;
+    const size_t chunksNmb = regionHeight * regionSize * regionSize;
+    std::vector<ChunkCompletion> completions(chunksNmb);
+    MpscQueue<ChunkCompletion> completionQueue;
+    std::atomic<bool> start = false;
+    std::vector<std::thread> producers;
+    for (size_t producer = 0; producer < producersNmb; producer++)
+    {
+        producers.emplace_back([&, producer]
+        {
+            while (!start)
+            {
+                std::this_thread::yield();
+            }
+            for (size_t i = producer; i < chunksNmb; i += producersNmb)
+            {
+                const auto chunkId = ChunkId(i);
+                Chunk chunk;
+                chunk.chunkId = chunkId;
+                chunk.contents = std::make_unique<ChunkContent>(GetChunkCubeType(chunkId));
+                chunk.contents->SetCubeType(CubeId(chunkId % ChunkContent::cubesNmb), CubeType::NONE);
+                region.SetChunk(chunkId, std::move(chunk));
+                completions[chunkId].chunkId = chunkId;
+                completions[chunkId].producer = producer;
+                completionQueue.Push(&completions[chunkId]);
+            }
+        });
+    }
+    start = true;
+    //The chunks are read while the producers are still publishing the other ones
+    size_t completedChunksNmb = 0;
+    std::vector<ChunkId> lastChunkIds(producersNmb, 0);
+    std::vector<bool> hasCompleted(producersNmb, false);
+    while (completedChunksNmb < chunksNmb)
+    {
+        for (auto* completion = completionQueue.PopAll(); completion != nullptr; completion = completion->next)
+        {
+            const auto chunkId = completion->chunkId;
+            ASSERT_TRUE(region.IsChunkLoaded(chunkId));
+            const auto* chunk = region.GetChunk(chunkId);
+            ASSERT_EQ(chunkId, chunk->chunkId);
+            ASSERT_NE(nullptr, chunk->contents);
+            EXPECT_EQ(1u, chunk->version);
+            EXPECT_EQ(GetChunkCubeType(chunkId), chunk->contents->GetCubeType(CubeId((chunkId + 1) % ChunkContent::cubesNmb)));
+            EXPECT_EQ(CubeType::NONE, chunk->contents->GetCubeType(CubeId(chunkId % ChunkContent::cubesNmb)));
+            //The completions of a producer come in the order it pushed them
+            if (hasCompleted[completion->producer])
+            {
+                EXPECT_LT(lastChunkIds[completion->producer], chunkId);
+            }
+            hasCompleted[completion->producer] = true;
+            lastChunkIds[completion->producer] = chunkId;
+            completedChunksNmb++;
+        }
+    }
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+    EXPECT_TRUE(completionQueue.IsEmpty());
+    EXPECT_EQ(chunksNmb, completedChunksNmb);
+
+    region.UnloadChunk(0);
+    EXPECT_FALSE(region.IsChunkLoaded(0));
+    EXPECT_EQ(nullptr, region.GetChunk(0)->contents);
+    EXPECT_EQ(2u, region.GetChunk(0)->version);
+}
+
+}
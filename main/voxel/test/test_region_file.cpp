@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine/engine.h"
+#include "engine/filesystem.h"
+#include "voxel/chunk_generator.h"
+#include "voxel/region_file.h"
+#include "voxel/voxel_manager.h"
+
+namespace neko::voxel
+{
+
+namespace
+{
+class RegionFileEngine : public BasicEngine
+{
+public:
+    explicit RegionFileEngine(const FilesystemInterface& filesystem) : BasicEngine(filesystem) {}
+    void ManageEvent() override {}
+};
+
+void ExpectSameContents(const Chunk& expectedChunk, const Chunk& chunk)
+{
+    ASSERT_EQ(expectedChunk.chunkId, chunk.chunkId);
+    ASSERT_EQ(expectedChunk.contents == nullptr, chunk.contents == nullptr);
+    if (chunk.contents == nullptr)
+        return;
+    for (CubeId cubeId = 0; cubeId < ChunkContent::cubesNmb; cubeId++)
+    {
+        ASSERT_EQ(expectedChunk.contents->GetCubeType(cubeId), chunk.contents->GetCubeType(cubeId));
+    }
+}
+}
+
+TEST(Voxel, RegionFileSaveLoad)
+{
+    const std::string path = "test_region_file.nkr";
+    ChunkGenerator chunkGenerator;
+    std::vector<Chunk> columnChunks;
+    chunkGenerator.GenerateColumn(0, regionSize / 2, regionSize / 2, columnChunks);
+    ASSERT_FALSE(columnChunks.empty());
+    //A chunk in the air without any cube
+    Chunk emptyChunk;
+    emptyChunk.chunkId = Region::GetChunkId(0, 0, regionHeight - 1);
+    std::vector<const Chunk*> chunks;
+    for (const auto& chunk : columnChunks)
+    {
+        chunks.push_back(&chunk);
+    }
+    chunks.push_back(&emptyChunk);
+    ASSERT_TRUE(RegionFile::Save(path, chunks));
+
+    RegionFile regionFile;
+    ASSERT_TRUE(regionFile.Open(path));
+    for (const auto* expectedChunk : chunks)
+    {
+        Chunk chunk;
+        ASSERT_TRUE(regionFile.HasChunk(expectedChunk->chunkId));
+        ASSERT_TRUE(regionFile.LoadChunk(expectedChunk->chunkId, chunk));
+        ExpectSameContents(*expectedChunk, chunk);
+    }
+    const auto missingChunkId = Region::GetChunkId(1, 1, 0);
+    Chunk missingChunk;
+    EXPECT_FALSE(regionFile.HasChunk(missingChunkId));
+    EXPECT_FALSE(regionFile.LoadChunk(missingChunkId, missingChunk));
+
+    //The chunks can be loaded from several threads at once
+    std::vector<std::thread> threads;
+    std::vector<bool> results(4, false);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        threads.emplace_back([&regionFile, &columnChunks, &results, i]
+        {
+            bool result = true;
+            for (const auto& expectedChunk : columnChunks)
+            {
+                Chunk chunk;
+                result = result && regionFile.LoadChunk(expectedChunk.chunkId, chunk) &&
+                    chunk.contents->GetCubeType(CubeId(0)) == expectedChunk.contents->GetCubeType(CubeId(0));
+            }
+            results[i] = result;
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    for (const auto result : results)
+    {
+        EXPECT_TRUE(result);
+    }
+    regionFile.Close();
+    EXPECT_FALSE(regionFile.IsOpen());
+    std::remove(path.c_str());
+}
+
+TEST(Voxel, RegionFileInvalid)
+{
+    const std::string path = "test_invalid_region_file.nkr";
+    RegionFile regionFile;
+    EXPECT_FALSE(regionFile.Open("missing_region_file.nkr"));
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "not a region file";
+    }
+    EXPECT_FALSE(regionFile.Open(path));
+    {
+        //Right size but wrong magic number
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        const std::vector<char> zeros(16 + RegionFile::chunksNmb * sizeof(RegionFileEntry), 0);
+        file.write(zeros.data(), std::streamsize(zeros.size()));
+    }
+    EXPECT_FALSE(regionFile.Open(path));
+    EXPECT_FALSE(regionFile.IsOpen());
+    std::remove(path.c_str());
+}
+
+TEST(Voxel, RegionFileCorruptedChunk)
+{
+    const std::string path = "test_corrupted_region_file.nkr";
+    ChunkGenerator chunkGenerator;
+    std::vector<Chunk> columnChunks;
+    chunkGenerator.GenerateColumn(0, regionSize / 2, regionSize / 2, columnChunks);
+    ASSERT_FALSE(columnChunks.empty());
+    const auto& chunk = columnChunks.front();
+    ASSERT_TRUE(RegionFile::Save(path, { &chunk }));
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        RegionFileEntry entry;
+        file.seekg(std::streamoff(16 + chunk.chunkId * sizeof(RegionFileEntry)));
+        file.read(reinterpret_cast<char*>(&entry), sizeof(RegionFileEntry));
+        //Zstd frame header with a single segment and an 8 bytes content size of 1TiB
+        const std::array<std::uint8_t, 13> frameHeader = {
+            0x28, 0xB5, 0x2F, 0xFD, 0xE0, 0, 0, 0, 0, 0, 1, 0, 0 };
+        ASSERT_GE(entry.size, frameHeader.size());
+        file.seekp(std::streamoff(entry.offset));
+        file.write(reinterpret_cast<const char*>(frameHeader.data()), std::streamsize(frameHeader.size()));
+    }
+    RegionFile regionFile;
+    ASSERT_TRUE(regionFile.Open(path));
+    Chunk loadedChunk;
+    EXPECT_FALSE(regionFile.LoadChunk(chunk.chunkId, loadedChunk));
+    regionFile.Close();
+    std::remove(path.c_str());
+}
+
+TEST(Voxel, VoxelManagerRegionFile)
+{
+    const std::string path = "test_voxel_manager_region.nkr";
+    Filesystem filesystem;
+    RegionFileEngine engine(filesystem);
+    engine.Init();
+    const int renderDistance = 2;
+    const size_t columnsNmb = size_t((2 * renderDistance + 1) * (2 * renderDistance + 1));
+    {
+        VoxelManager voxelManager(renderDistance);
+        voxelManager.Init();
+        voxelManager.SetCameraPosition(Vec3f(0.0f, voxelManager.GetInitialHeight(), 0.0f));
+        while (voxelManager.IsLoading())
+        {
+            voxelManager.Update(seconds(0.001f));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_EQ(columnsNmb, voxelManager.GetGeneratedColumnsNmb());
+        ASSERT_TRUE(voxelManager.SaveRegionFile(path));
+        voxelManager.Destroy();
+    }
+    //The saved columns are read from the region file instead of being generated
+    VoxelManager voxelManager(renderDistance);
+    ASSERT_TRUE(voxelManager.OpenRegionFile(path));
+    voxelManager.Init();
+    voxelManager.SetCameraPosition(Vec3f(0.0f, voxelManager.GetInitialHeight(), 0.0f));
+    while (voxelManager.IsLoading())
+    {
+        voxelManager.Update(seconds(0.001f));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(0u, voxelManager.GetGeneratedColumnsNmb());
+    EXPECT_EQ(columnsNmb, voxelManager.GetRegionFileColumnsNmb());
+    ChunkGenerator chunkGenerator;
+    for (const auto* chunk : voxelManager.GetChunks())
+    {
+        ExpectSameContents(chunkGenerator.GenerateChunk(0, chunk->chunkId), *chunk);
+    }
+    voxelManager.Destroy();
+    engine.Destroy();
+    std::remove(path.c_str());
+}
+
+}
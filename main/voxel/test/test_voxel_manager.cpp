@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+
+#include "engine/engine.h"
+#include "engine/filesystem.h"
+#include "voxel/voxel_manager.h"
+
+namespace neko::voxel
+{
+
+namespace
+{
+class HeadlessEngine : public BasicEngine
+{
+public:
+    explicit HeadlessEngine(const FilesystemInterface& filesystem) : BasicEngine(filesystem) {}
+    void ManageEvent() override {}
+};
+
+struct FlyThroughResult
+{
+    microseconds maxUpdateDuration{0};
+    size_t maxColumnDistance = 0;
+};
+
+int GetCameraColumn(float coordinate)
+{
+    return static_cast<int>(std::floor(coordinate / float(chunkSize))) + int(regionSize / 2);
+}
+
+size_t GetColumnDistance(const Chunk& chunk, const Vec3f& cameraPosition)
+{
+    const int chunkX = chunk.chunkId / regionHeight / regionSize;
+    const int chunkZ = (chunk.chunkId - chunkX * regionHeight * regionSize) / regionHeight;
+    return size_t(std::max(std::abs(chunkX - GetCameraColumn(cameraPosition.x)),
+                           std::abs(chunkZ - GetCameraColumn(cameraPosition.z))));
+}
+
+/**
+ * \brief Move the camera along the x axis, one frame lasts a millisecond to let the workers load the columns
+ */
+FlyThroughResult FlyThrough(VoxelManager& voxelManager, Vec3f& cameraPosition, float distance, int framesNmb)
+{
+    FlyThroughResult result;
+    const float speed = distance / float(framesNmb);
+    for (int frame = 0; frame < framesNmb; frame++)
+    {
+        cameraPosition.x += speed;
+        voxelManager.SetCameraPosition(cameraPosition);
+        const auto start = std::chrono::steady_clock::now();
+        voxelManager.Update(seconds(0.001f));
+        const auto updateDuration = std::chrono::duration_cast<microseconds>(std::chrono::steady_clock::now() - start);
+        result.maxUpdateDuration = std::max(result.maxUpdateDuration, updateDuration);
+        for (const auto* chunk : voxelManager.GetChunks())
+        {
+            result.maxColumnDistance = std::max(result.maxColumnDistance, GetColumnDistance(*chunk, cameraPosition));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return result;
+}
+
+void WaitLoading(VoxelManager& voxelManager)
+{
+    while (voxelManager.IsLoading())
+    {
+        voxelManager.Update(seconds(0.001f));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+}
+
+TEST(Voxel, VoxelManagerFlyThrough)
+{
+    Filesystem filesystem;
+    HeadlessEngine engine(filesystem);
+    engine.Init();
+    const int renderDistance = 4;
+    const size_t memoryBudget = 4u * 1024u * 1024u;
+    VoxelManager voxelManager(renderDistance, memoryBudget);
+    voxelManager.Init();
+    Vec3f cameraPosition(0.0f, voxelManager.GetInitialHeight(), 0.0f);
+    voxelManager.SetCameraPosition(cameraPosition);
+    WaitLoading(voxelManager);
+    const auto loadedChunksNmb = voxelManager.GetChunks().size();
+    EXPECT_GT(loadedChunksNmb, 0u);
+    EXPECT_EQ(size_t((2 * renderDistance + 1) * (2 * renderDistance + 1)), voxelManager.GetGeneratedColumnsNmb());
+
+    //Fly 16 chunks away and come back, the columns of the way back are decompressed instead of generated
+    const float distance = float(16 * chunkSize);
+    const auto forward = FlyThrough(voxelManager, cameraPosition, distance, 256);
+    WaitLoading(voxelManager);
+    const auto generatedColumnsNmb = voxelManager.GetGeneratedColumnsNmb();
+    const auto backward = FlyThrough(voxelManager, cameraPosition, -distance, 256);
+    WaitLoading(voxelManager);
+
+    EXPECT_EQ(generatedColumnsNmb, voxelManager.GetGeneratedColumnsNmb());
+    EXPECT_GT(voxelManager.GetDecompressedColumnsNmb(), 0u);
+    //The columns one chunk outside of the render distance are kept until the camera moves further
+    const auto& chunks = voxelManager.GetChunks();
+    EXPECT_EQ(loadedChunksNmb, size_t(std::count_if(chunks.cbegin(), chunks.cend(), [&cameraPosition](const Chunk* chunk)
+    {
+        return GetColumnDistance(*chunk, cameraPosition) <= size_t(renderDistance);
+    })));
+    EXPECT_LE(voxelManager.GetPeakMemoryUsage(), memoryBudget);
+    EXPECT_LE(forward.maxColumnDistance, size_t(renderDistance + 1));
+    EXPECT_LE(backward.maxColumnDistance, size_t(renderDistance + 1));
+    //The columns are loaded by the workers, the update only installs and compresses them
+    EXPECT_LT(forward.maxUpdateDuration.count(), 8'000u);
+    EXPECT_LT(backward.maxUpdateDuration.count(), 8'000u);
+
+    //The decompressed chunks are the same as the generated ones
+    ChunkGenerator chunkGenerator;
+    for (const auto* chunk : voxelManager.GetChunks())
+    {
+        const auto generatedChunk = chunkGenerator.GenerateChunk(0, chunk->chunkId);
+        ASSERT_EQ(generatedChunk.contents == nullptr, chunk->contents == nullptr);
+        if (chunk->contents == nullptr)
+            continue;
+        for (CubeId cubeId = 0; cubeId < ChunkContent::cubesNmb; cubeId++)
+        {
+            ASSERT_EQ(generatedChunk.contents->GetCubeType(cubeId), chunk->contents->GetCubeType(cubeId));
+        }
+    }
+    voxelManager.Destroy();
+    engine.Destroy();
+}
+
+TEST(Voxel, VoxelManagerMemoryBudget)
+{
+    Filesystem filesystem;
+    HeadlessEngine engine(filesystem);
+    engine.Init();
+    //Not enough memory for the whole render distance, the farthest columns are not kept
+    const int renderDistance = 6;
+    const size_t memoryBudget = 512u * 1024u;
+    VoxelManager voxelManager(renderDistance, memoryBudget);
+    voxelManager.Init();
+    Vec3f cameraPosition(0.0f, voxelManager.GetInitialHeight(), 0.0f);
+    voxelManager.SetCameraPosition(cameraPosition);
+    WaitLoading(voxelManager);
+    FlyThrough(voxelManager, cameraPosition, float(8 * chunkSize), 100);
+    WaitLoading(voxelManager);
+
+    EXPECT_GT(voxelManager.GetChunks().size(), 0u);
+    EXPECT_LT(voxelManager.GetGeneratedColumnsNmb(), size_t((2 * renderDistance + 1) * (2 * renderDistance + 9)));
+    EXPECT_LE(voxelManager.GetPeakMemoryUsage(), memoryBudget);
+    EXPECT_LE(voxelManager.GetMemoryUsage(), memoryBudget);
+    voxelManager.Destroy();
+    engine.Destroy();
+}
+
+}